@@ -46,9 +46,11 @@ static enum
     OBJECT_HIGH_LIMIT,
     OBJECT_CHANGE_BY,
     OBJECT_TRANSFORM,
+    OBJECT_AGGREGATION,
     OBJECT_BUFFER_SIZE,
     OBJECT_BACKUP_PERIOD,
     OBJECT_JSON_EXTRACTION,
+    OBJECT_HISTOGRAM,
     OBJECT_OBSERVATION,
     OBJECT_MIN,
     OBJECT_MAX,
@@ -99,6 +101,7 @@ static void HandleHelpRequest
         "    dhub set bufferSize PATH\n"
         "    dhub set backupPeriod PATH\n"
         "    dhub set jsonExtraction PATH\n"
+        "    dhub set histogram PATH BOUND ...\n"
         "    dhub remove OBJECT PATH\n"
         "    dhub push PATH [[--json] VALUE]\n"
         "    dhub push PATH --file [--json] FILE_PATH\n"
@@ -149,7 +152,7 @@ static void HandleHelpRequest
         "            an Observation resource at PATH if one does not already exist\n"
         "            there.\n"
         "\n"
-        "    dhub set transform PATH TYPE\n"
+        "    dhub set transform PATH TYPE [PARAM ...]\n"
         "            Sets the numeric transform for an Observation buffer.\n"
         "            PATH is expected to be under /obs/.  Setting this will create\n"
         "            an Observation resource at PATH if one does not already exist\n"
@@ -160,6 +163,39 @@ static void HandleHelpRequest
         "            2 : standard deviation\n"
         "            3 : maximum\n"
         "            4 : minimum\n"
+        "            5 : moving mean (PARAMs: PERIOD COUNT)\n"
+        "            6 : moving standard deviation (PARAMs: PERIOD COUNT)\n"
+        "            7 : moving maximum (PARAMs: PERIOD COUNT)\n"
+        "            8 : moving minimum (PARAMs: PERIOD COUNT)\n"
+        "            9 : exponentially weighted moving average (PARAM: WEIGHT)\n"
+        "            10 : rate of change per second\n"
+        "            The moving window holds the values received in the last PERIOD\n"
+        "            seconds, up to a maximum of COUNT values (0 = no limit).\n"
+        "            WEIGHT is the weight given to the newest value (0 < WEIGHT <= 1).\n"
+        "\n"
+        "    dhub set aggregation PATH TYPE [PERIOD]\n"
+        "            Sets an Observation to update its value only once every PERIOD\n"
+        "            seconds, with an aggregate of the values it accepted during that\n"
+        "            time.  PATH is expected to be under /obs/.  Setting this will create\n"
+        "            an Observation resource at PATH if one does not already exist\n"
+        "            there.\n"
+        "            Available aggregation types:\n"
+        "            0 : none (PERIOD not needed)\n"
+        "            1 : mean\n"
+        "            2 : minimum\n"
+        "            3 : maximum\n"
+        "            4 : count\n"
+        "            5 : last value\n"
+        "            6 : histogram (buckets set using 'dhub set histogram')\n"
+        "\n"
+        "    dhub set histogram PATH BOUND ...\n"
+        "            Sets an Observation to count the values it receives in a\n"
+        "            histogram, with one bucket below the first BOUND, one between\n"
+        "            each pair of BOUNDs and one from the last BOUND up.  The BOUNDs\n"
+        "            must be in increasing order (up to 31 of them).  Counts so far\n"
+        "            are discarded.  PATH is expected to be under /obs/.  Setting\n"
+        "            this will create an Observation resource at PATH if one does not\n"
+        "            already exist there.\n"
         "\n"
         "    dhub set bufferSize PATH VALUE\n"
         "            Sets the maximum number of samples that an Observation will buffer.\n"
@@ -227,7 +263,9 @@ static void HandleHelpRequest
         "              highLimit\n"
         "              changeBy\n"
         "              transform\n"
+        "              aggregation\n"
         "              jsonExtraction\n"
+        "              histogram\n"
         "              min\n"
         "              max\n"
         "              mean\n"
@@ -237,6 +275,9 @@ static void HandleHelpRequest
         "            absolute (beginning with '/'). The other objects are only found\n"
         "            on Observations, so their PATH can be relative to /obs/.\n"
         "\n"
+        "            For the histogram, the bucket boundaries are printed on one line\n"
+        "            and the number of values counted in each bucket on the next.\n"
+        "\n"
         "            When getting statistical measurements on an Observations' buffer\n"
         "            of data samples (min, max, mean, and stddev), a start time (START)\n"
         "            can optionally be specified.  If START is specified, then START is\n"
@@ -300,6 +341,25 @@ static const char* SrcPathArg = NULL;
 static const char* ValueArg = NULL;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ptrs to the optional arguments that follow the TYPE argument of the 'set transform' and
+ * 'set aggregation' commands.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* ParamArgs[ADMIN_MAX_TRANSFORM_PARAMETERS];
+static size_t ParamArgCount = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ptrs to the BOUND arguments of the 'set histogram' command.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* BoundArgs[IO_MAX_HISTOGRAM_BUCKETS - 1];
+static size_t BoundArgCount = 0;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Start timestamp argument for 'read' and 'get min/max/mean/stddev' commands.
@@ -720,9 +780,65 @@ static void PrintTransformSetting
         "standard deviation (2)",
         "maximum (3)",
         "minimum (4)",
+        "moving mean (5)",
+        "moving standard deviation (6)",
+        "moving maximum (7)",
+        "moving minimum (8)",
+        "exponentially weighted moving average (9)",
+        "rate of change (10)",
+    };
+
+    if ((value >= 0) && (value < (int)NUM_ARRAY_MEMBERS(transformNameStr)))
+    {
+        printf("%s: %s\n", label, transformNameStr[value]);
+    }
+    else
+    {
+        printf("%s: unknown (%d)\n", label, value);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print out the aggregation setting of an Observation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintAggregationSetting
+(
+    const char* path
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char *aggregationNameStr[] =
+    {
+        "none (0)",
+        "mean (1)",
+        "minimum (2)",
+        "maximum (3)",
+        "count (4)",
+        "last value (5)",
+        "histogram (6)",
     };
 
-    printf("%s: %s\n", label, transformNameStr[value]);
+    double period;
+    int value = admin_GetAggregation(path, &period);
+
+    if ((value >= 0) && (value < (int)NUM_ARRAY_MEMBERS(aggregationNameStr)))
+    {
+        printf("aggregation: %s", aggregationNameStr[value]);
+    }
+    else
+    {
+        printf("aggregation: unknown (%d)", value);
+    }
+
+    if (value != ADMIN_OBS_AGGREGATION_TYPE_NONE)
+    {
+        printf(" every %lf seconds", period);
+    }
+
+    putchar('\n');
 }
 
 
@@ -923,6 +1039,8 @@ static void PrintEntry
         Indent(depth);
         PrintTransformSetting("transform", admin_GetTransform(path));
         Indent(depth);
+        PrintAggregationSetting(path);
+        Indent(depth);
         printf("bufferSize: %u entries\n", admin_GetBufferMaxCount(path));
         Indent(depth);
         uint32_t backupPeriod = admin_GetBufferBackupPeriod(path);
@@ -1244,7 +1362,54 @@ static void SetIntegerSetting
 static void SetTransformSetting
 (
     const char* path,
-    const char* valueStr
+    const char* valueStr,
+    const char** paramStrs,     ///< Transform parameter strings.
+    size_t paramCount           ///< Number of transform parameter strings.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int value;
+    if ((le_utf8_ParseInt(&value, valueStr) != LE_OK) || (value < 0))
+    {
+        fprintf(stderr, "Non-negative integer value required.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    double params[ADMIN_MAX_TRANSFORM_PARAMETERS];
+    size_t i;
+    for (i = 0; i < paramCount; i++)
+    {
+        params[i] = ParseDouble(paramStrs[i]);
+        if (errno != 0)
+        {
+            fprintf(stderr, "Transform parameters must be numeric ('%s' is not).\n", paramStrs[i]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (admin_CreateObs(path) != LE_OK)
+    {
+        fprintf(stderr, "Invalid resource path for Observation.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    admin_SetTransform(path, (admin_TransformType_t)value, params, paramCount);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set an aggregation setting.
+ *
+ * @note Has the side-effect of creating the Observation if it does not yet exist.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetAggregationSetting
+(
+    const char* path,
+    const char* valueStr,
+    const char** argStrs,   ///< Arguments following the TYPE (the PERIOD).
+    size_t argCount         ///< Number of arguments following the TYPE.
 )
 //--------------------------------------------------------------------------------------------------
 {
@@ -1255,13 +1420,35 @@ static void SetTransformSetting
         exit(EXIT_FAILURE);
     }
 
+    double period = 0;
+    if (value != ADMIN_OBS_AGGREGATION_TYPE_NONE)
+    {
+        if (argCount != 1)
+        {
+            fprintf(stderr, "Aggregation PERIOD required.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        period = ParseDouble(argStrs[0]);
+        if ((errno != 0) || (!(period > 0)))
+        {
+            fprintf(stderr, "PERIOD must be a positive number ('%s' is not).\n", argStrs[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (argCount > 0)
+    {
+        fprintf(stderr, "Too many arguments.\n");
+        exit(EXIT_FAILURE);
+    }
+
     if (admin_CreateObs(path) != LE_OK)
     {
         fprintf(stderr, "Invalid resource path for Observation.\n");
         exit(EXIT_FAILURE);
     }
 
-    admin_SetTransform(path, (admin_TransformType_t)value, NULL, 0);
+    admin_SetAggregation(path, (admin_AggregationType_t)value, period);
 }
 
 
@@ -1282,6 +1469,107 @@ static void GetIntegerSetting
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get an aggregation setting.  Prints the aggregation type and period.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetAggregationSetting
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    double period;
+    admin_AggregationType_t aggregationType = admin_GetAggregation(PathArg, &period);
+
+    printf("%d %lf\n", aggregationType, period);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the bucket boundaries of an Observation's histogram.
+ *
+ * @note Has the side-effect of creating the Observation if it does not yet exist.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetHistogramSetting
+(
+    const char* path,
+    const char** boundStrs,     ///< Bucket boundary strings.
+    size_t boundCount           ///< Number of bucket boundary strings.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    double bounds[IO_MAX_HISTOGRAM_BUCKETS - 1];
+    size_t i;
+    for (i = 0; i < boundCount; i++)
+    {
+        bounds[i] = ParseDouble(boundStrs[i]);
+        if ((errno != 0) || !isfinite(bounds[i]))
+        {
+            fprintf(stderr, "BOUNDs must be numeric ('%s' is not).\n", boundStrs[i]);
+            exit(EXIT_FAILURE);
+        }
+
+        if ((i > 0) && !(bounds[i] > bounds[i - 1]))
+        {
+            fprintf(stderr, "BOUNDs must be in increasing order.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (admin_CreateObs(path) != LE_OK)
+    {
+        fprintf(stderr, "Invalid resource path for Observation.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    admin_SetHistogram(path, bounds, boundCount);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get an Observation's histogram.  Prints the bucket boundaries on one line and the counts on the
+ * next.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetHistogramSetting
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint64_t counts[IO_MAX_HISTOGRAM_BUCKETS];
+    size_t countCount = NUM_ARRAY_MEMBERS(counts);
+
+    if (query_GetHistogram(PathArg, counts, &countCount) != LE_OK)
+    {
+        fprintf(stderr, "No histogram kept at resource path '%s'.\n", PathArg);
+        exit(EXIT_FAILURE);
+    }
+
+    double bounds[IO_MAX_HISTOGRAM_BUCKETS];
+    size_t boundCount = NUM_ARRAY_MEMBERS(bounds);
+    admin_GetHistogram(PathArg, bounds, &boundCount);
+
+    size_t i;
+    for (i = 0; i < boundCount; i++)
+    {
+        printf("%s%lf", (i > 0) ? " " : "", bounds[i]);
+    }
+    putchar('\n');
+
+    for (i = 0; i < countCount; i++)
+    {
+        printf("%s%" PRIu64, (i > 0) ? " " : "", counts[i]);
+    }
+    putchar('\n');
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get a buffer statistic.
@@ -1651,6 +1939,59 @@ static void ValueArgHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Command-line argument handler call-back for an argument following a transform or aggregation
+ * TYPE argument.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ParamArgHandler
+(
+    const char* arg
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (ParamArgCount >= NUM_ARRAY_MEMBERS(ParamArgs))
+    {
+        fprintf(stderr, "Too many arguments.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    ParamArgs[ParamArgCount] = arg;
+    ParamArgCount++;
+
+    // There may be more.
+    le_arg_AddPositionalCallback(ParamArgHandler);
+    le_arg_AllowLessPositionalArgsThanCallbacks();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Command-line argument handler call-back for a BOUND argument of the 'set histogram' command.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BoundArgHandler
+(
+    const char* arg
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (BoundArgCount >= NUM_ARRAY_MEMBERS(BoundArgs))
+    {
+        fprintf(stderr, "Too many BOUNDs.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    BoundArgs[BoundArgCount] = arg;
+    BoundArgCount++;
+
+    // There may be more.
+    le_arg_AddPositionalCallback(BoundArgHandler);
+    le_arg_AllowLessPositionalArgsThanCallbacks();
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Command-line argument handler call-back for a PATH argument.
@@ -1692,9 +2033,11 @@ static void PathArgHandler
         case OBJECT_HIGH_LIMIT:
         case OBJECT_CHANGE_BY:
         case OBJECT_TRANSFORM:
+        case OBJECT_AGGREGATION:
         case OBJECT_BUFFER_SIZE:
         case OBJECT_BACKUP_PERIOD:
         case OBJECT_JSON_EXTRACTION:
+        case OBJECT_HISTOGRAM:
         case OBJECT_OBSERVATION:
         case OBJECT_MIN:
         case OBJECT_MAX:
@@ -1781,6 +2124,10 @@ static void ObjectTypeArgHandler
     {
         Object = OBJECT_TRANSFORM;
     }
+    else if (strcmp(arg, "aggregation") == 0)
+    {
+        Object = OBJECT_AGGREGATION;
+    }
     else if (strcmp(arg, "bufferSize") == 0)
     {
         Object = OBJECT_BUFFER_SIZE;
@@ -1793,6 +2140,10 @@ static void ObjectTypeArgHandler
     {
         Object = OBJECT_JSON_EXTRACTION;
     }
+    else if (strcmp(arg, "histogram") == 0)
+    {
+        Object = OBJECT_HISTOGRAM;
+    }
     else if ((strcmp(arg, "obs") == 0) || (strcmp(arg, "observation") == 0))
     {
         Object = OBJECT_OBSERVATION;
@@ -1843,10 +2194,22 @@ static void ObjectTypeArgHandler
             fprintf(stderr, "Can't 'set' a buffer statistic.\n");
             exit(EXIT_FAILURE);
         }
+        else if (Object == OBJECT_HISTOGRAM)
+        {
+            // The "set histogram" command needs at least one BOUND.
+            le_arg_AddPositionalCallback(BoundArgHandler);
+        }
         else
         {
             // Everything else needs a VALUE.
             le_arg_AddPositionalCallback(ValueArgHandler);
+
+            // A transform or aggregation TYPE can be followed by optional PARAMs (or a PERIOD).
+            if ((Object == OBJECT_TRANSFORM) || (Object == OBJECT_AGGREGATION))
+            {
+                le_arg_AddPositionalCallback(ParamArgHandler);
+                le_arg_AllowLessPositionalArgsThanCallbacks();
+            }
         }
     }
     else if (Action == ACTION_GET)
@@ -2042,6 +2405,11 @@ COMPONENT_INIT
                     GetIntegerSetting(admin_GetTransform);
                     break;
 
+                case OBJECT_AGGREGATION:
+
+                    GetAggregationSetting();
+                    break;
+
                 case OBJECT_BUFFER_SIZE:
 
                     GetIntegerSetting(admin_GetBufferMaxCount);
@@ -2068,6 +2436,11 @@ COMPONENT_INIT
                     break;
                 }
 
+                case OBJECT_HISTOGRAM:
+
+                    GetHistogramSetting();
+                    break;
+
                 case OBJECT_OBSERVATION:
 
                     fprintf(stderr, "Can't 'get' an Observation.\n");
@@ -2138,7 +2511,15 @@ COMPONENT_INIT
 
                 case OBJECT_TRANSFORM:
 
-                    SetTransformSetting(PathArg, ValueArg);
+                    SetTransformSetting(PathArg,
+                                        ValueArg,
+                                        ParamArgs,
+                                        ParamArgCount);
+                    break;
+
+                case OBJECT_AGGREGATION:
+
+                    SetAggregationSetting(PathArg, ValueArg, ParamArgs, ParamArgCount);
                     break;
 
                 case OBJECT_BUFFER_SIZE:
@@ -2156,6 +2537,11 @@ COMPONENT_INIT
                     admin_SetJsonExtraction(PathArg, ValueArg);
                     break;
 
+                case OBJECT_HISTOGRAM:
+
+                    SetHistogramSetting(PathArg, BoundArgs, BoundArgCount);
+                    break;
+
                 case OBJECT_OBSERVATION:
 
                     fprintf(stderr, "Can't 'set' an Observation.\n");
@@ -2224,6 +2610,11 @@ COMPONENT_INIT
                     admin_SetTransform(PathArg, ADMIN_OBS_TRANSFORM_TYPE_NONE, NULL, 0);
                     break;
 
+                case OBJECT_AGGREGATION:
+
+                    admin_SetAggregation(PathArg, ADMIN_OBS_AGGREGATION_TYPE_NONE, 0);
+                    break;
+
                 case OBJECT_BUFFER_SIZE:
                 case OBJECT_BACKUP_PERIOD:
 
@@ -2235,6 +2626,11 @@ COMPONENT_INIT
                     admin_SetJsonExtraction(PathArg, "");
                     break;
 
+                case OBJECT_HISTOGRAM:
+
+                    admin_SetHistogram(PathArg, NULL, 0);
+                    break;
+
                 case OBJECT_OBSERVATION:
 
                     admin_DeleteObs(PathArg);
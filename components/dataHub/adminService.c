@@ -671,6 +671,12 @@ void admin_DeleteObs
 )
 //--------------------------------------------------------------------------------------------------
 {
+    // Like the other Observation functions, take an absolute path under /obs/ too.
+    if (strncmp(path, "/obs/", 5) == 0)
+    {
+        path += 5;
+    }
+
     resTree_EntryRef_t obsNamespace = resTree_FindEntry(resTree_GetRoot(), "obs");
 
     if (obsNamespace != NULL)
@@ -975,6 +981,68 @@ admin_TransformType_t admin_GetTransform
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set an Observation to aggregate the samples it accepts over fixed-length (tumbling) windows
+ * of wall-clock time.  The Observation's value is only updated at the end of each window, with
+ * the aggregate of the samples accepted during the window.
+ */
+//--------------------------------------------------------------------------------------------------
+void admin_SetAggregation
+(
+    const char* path,
+        ///< [IN] Path within the /obs/ namespace.
+    admin_AggregationType_t aggregationType,
+        ///< [IN] Type of aggregate to report
+    double period
+        ///< [IN] Length of the aggregation windows (seconds)
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t obsEntry = GetObservation(path);
+
+    if (obsEntry == NULL)
+    {
+        LE_ERROR("Malformed observation path '%s'.", path);
+    }
+    else
+    {
+        resTree_SetAggregation(obsEntry, aggregationType, period);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the type of aggregation currently applied to an Observation.
+ *
+ * @return The AggregationType
+ */
+//--------------------------------------------------------------------------------------------------
+admin_AggregationType_t admin_GetAggregation
+(
+    const char* path,
+        ///< [IN] Path within the /obs/ namespace.
+    double* periodPtr
+        ///< [OUT] Length of the aggregation windows (seconds)
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t obsEntry = GetObservation(path);
+
+    if (obsEntry == NULL)
+    {
+        LE_ERROR("Malformed observation path '%s'.", path);
+        *periodPtr = 0;
+        return ADMIN_OBS_AGGREGATION_TYPE_NONE;
+    }
+    else
+    {
+        return resTree_GetAggregation(obsEntry, periodPtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the JSON member/element specifier for extraction of data from within a structured JSON
@@ -1103,6 +1171,126 @@ uint32_t admin_GetBufferMaxCount
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set whether a given Observation's numeric data samples should be buffered compressed.
+ * Compressed samples take much less memory (often only a few bits each), but reading or querying
+ * the buffer means decoding them.
+ */
+//--------------------------------------------------------------------------------------------------
+void admin_SetBufferCompression
+(
+    const char* path,
+        ///< [IN] Path within the /obs/ namespace.
+    bool compress
+        ///< [IN] true = compress numeric samples, false = don't (the default).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t obsEntry = GetObservation(path);
+
+    if (obsEntry == NULL)
+    {
+        LE_ERROR("Malformed observation path '%s'.", path);
+    }
+    else
+    {
+        resTree_SetBufferCompression(obsEntry, compress);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a given Observation's numeric data samples are set to be buffered compressed.
+ * See admin_SetBufferCompression() for more information.
+ *
+ * @return true if they are, false if not or the Observation does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+bool admin_GetBufferCompression
+(
+    const char* path
+        ///< [IN] Path within the /obs/ namespace.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t resEntry = FindObservation(path);
+
+    if (resEntry == NULL)
+    {
+        return false;
+    }
+    else
+    {
+        return resTree_GetBufferCompression(resEntry);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set whether a given Observation's trigger, Boolean and numeric data samples should be buffered in
+ * a memory-mapped file in non-volatile storage, so the buffer survives a restart of the Data Hub
+ * without having to be backed up.  Changes are flushed to non-volatile storage at most once per
+ * sync period, or whenever the operating system chooses to, if the sync period is zero.
+ */
+//--------------------------------------------------------------------------------------------------
+void admin_SetBufferPersistence
+(
+    const char* path,
+        ///< [IN] Path within the /obs/ namespace.
+    bool persist,
+        ///< [IN] true = keep the buffer in a file, false = in memory only (the default).
+    uint32_t syncPeriod
+        ///< [IN] Minimum number of seconds between syncs of the file (0 = leave it to the OS).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t obsEntry = GetObservation(path);
+
+    if (obsEntry == NULL)
+    {
+        LE_ERROR("Malformed observation path '%s'.", path);
+    }
+    else
+    {
+        resTree_SetBufferPersistence(obsEntry, persist, syncPeriod);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a given Observation's buffer is set to be kept in a memory-mapped file.
+ * See admin_SetBufferPersistence() for more information.
+ *
+ * @return true if it is, false if not or the Observation does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+bool admin_GetBufferPersistence
+(
+    const char* path,
+        ///< [IN] Path within the /obs/ namespace.
+    uint32_t* syncPeriodPtr
+        ///< [OUT] Minimum number of seconds between syncs of the file.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t resEntry = FindObservation(path);
+
+    if (resEntry == NULL)
+    {
+        *syncPeriodPtr = 0;
+        return false;
+    }
+    else
+    {
+        return resTree_GetBufferPersistence(resEntry, syncPeriodPtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the minimum time between backups of an Observation's buffer to non-volatile storage.
@@ -1162,6 +1350,191 @@ uint32_t admin_GetBufferBackupPeriod
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set up a rollup tier of an Observation, which keeps a fixed number of buckets summarizing the
+ * numerical values received during consecutive fixed-length periods.
+ */
+//--------------------------------------------------------------------------------------------------
+void admin_SetRollupTier
+(
+    const char* path,
+        ///< [IN] Path within the /obs/ namespace.
+    uint32_t tier,
+        ///< [IN] Tier number (0 = finest, < MAX_ROLLUP_TIERS).
+    double period,
+        ///< [IN] Length of each bucket's period (seconds).
+    uint32_t maxCount
+        ///< [IN] Number of buckets to keep (0 = remove the tier).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t obsEntry = GetObservation(path);
+
+    if (obsEntry == NULL)
+    {
+        LE_ERROR("Malformed observation path '%s'.", path);
+    }
+    else
+    {
+        resTree_SetRollupTier(obsEntry, tier, period, maxCount);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the settings of a rollup tier of an Observation.
+ * See admin_SetRollupTier() for more information.
+ *
+ * @return The number of buckets kept in the tier, or 0 if the tier is not set or the Observation
+ *         does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t admin_GetRollupTier
+(
+    const char* path,
+        ///< [IN] Path within the /obs/ namespace.
+    uint32_t tier,
+        ///< [IN] Tier number (0 = finest).
+    double* periodPtr
+        ///< [OUT] Length of each bucket's period (seconds).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t obsEntry = GetObservation(path);
+
+    if (obsEntry == NULL)
+    {
+        LE_ERROR("Malformed observation path '%s'.", path);
+        *periodPtr = NAN;
+        return 0;
+    }
+    else
+    {
+        return resTree_GetRollupTier(obsEntry, tier, periodPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the size of the quantile sketch an Observation keeps of the numerical values in its buffer.
+ * See admin_SetQuantileSketch() in the API for more information.
+ */
+//--------------------------------------------------------------------------------------------------
+void admin_SetQuantileSketch
+(
+    const char* path,
+        ///< [IN] Path within the /obs/ namespace.
+    uint32_t size
+        ///< [IN] Size of the sketch (0 = don't keep one).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t obsEntry = GetObservation(path);
+
+    if (obsEntry == NULL)
+    {
+        LE_ERROR("Malformed observation path '%s'.", path);
+    }
+    else
+    {
+        resTree_SetQuantileSketch(obsEntry, size);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the size of an Observation's quantile sketch.
+ * See admin_SetQuantileSketch() for more information.
+ *
+ * @return The size, or 0 if no sketch is kept or the Observation does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t admin_GetQuantileSketch
+(
+    const char* path
+        ///< [IN] Path within the /obs/ namespace.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t obsEntry = GetObservation(path);
+
+    if (obsEntry == NULL)
+    {
+        LE_ERROR("Malformed observation path '%s'.", path);
+        return 0;
+    }
+    else
+    {
+        return resTree_GetQuantileSketch(obsEntry);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the bucket boundaries of the histogram an Observation keeps of the numerical values it
+ * receives.  See admin_SetHistogram() in the API for more information.
+ */
+//--------------------------------------------------------------------------------------------------
+void admin_SetHistogram
+(
+    const char* path,
+        ///< [IN] Path within the /obs/ namespace.
+    const double* boundsPtr,
+        ///< [IN] Bucket boundaries, in increasing order.
+    size_t boundsSize
+        ///< [IN]
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t obsEntry = GetObservation(path);
+
+    if (obsEntry == NULL)
+    {
+        LE_ERROR("Malformed observation path '%s'.", path);
+    }
+    else
+    {
+        resTree_SetHistogram(obsEntry, boundsPtr, boundsSize);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the bucket boundaries of an Observation's histogram.
+ * See admin_SetHistogram() for more information.
+ */
+//--------------------------------------------------------------------------------------------------
+void admin_GetHistogram
+(
+    const char* path,
+        ///< [IN] Path within the /obs/ namespace.
+    double* boundsPtr,
+        ///< [OUT] Bucket boundaries (none if not kept).
+    size_t* boundsSizePtr
+        ///< [INOUT]
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t obsEntry = GetObservation(path);
+
+    if (obsEntry == NULL)
+    {
+        LE_ERROR("Malformed observation path '%s'.", path);
+        *boundsSizePtr = 0;
+    }
+    else
+    {
+        resTree_GetHistogram(obsEntry, boundsPtr, boundsSizePtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Check if a given resource is a mandatory output.  If so, it means that this is an output resource
@@ -0,0 +1,302 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file atom.c
+ *
+ * Implementation of interned strings ("atoms").
+ *
+ * The atom table is a hash table of chained atoms, which doubles its number of buckets whenever
+ * there get to be more atoms than buckets.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "dataHub.h"
+#include "atom.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * An atom.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct atom_Atom
+{
+    struct atom_Atom* nextPtr;  ///< Next atom in the same bucket of the table (NULL if last).
+    uint32_t hash;              ///< Hash of the string.
+    char string[0];             ///< Space for the string follows this struct.
+                                ///< @warning This MUST BE the LAST MEMBER of Atom_t.
+}
+Atom_t;
+
+/// The maximum number of bytes in a small atom's string, including the null terminator.
+/// Most entry names and units fit in this.
+#define SMALL_ATOM_BYTES 16
+
+/// Initial number of buckets in the atom table (a power of 2).
+#define MIN_BUCKET_COUNT 64
+
+/// Pool of atoms holding strings of up to SMALL_ATOM_BYTES.
+static le_mem_PoolRef_t SmallAtomPool = NULL;
+
+/// Pool of atoms holding strings of up to ATOM_MAX_BYTES.
+/// @note This is a separate pool so that the majority case of short strings doesn't waste memory.
+static le_mem_PoolRef_t LargeAtomPool = NULL;
+
+/// Buckets of the atom table.
+static Atom_t** BucketsPtr = NULL;
+
+/// Number of buckets in the atom table (a power of 2).
+static size_t BucketCount = 0;
+
+/// Number of atoms in the atom table.
+static size_t AtomCount = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Destructor for atoms.  Removes the atom from the atom table.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AtomDestructor
+(
+    void* objPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Atom_t* atomPtr = objPtr;
+    Atom_t** linkPtrPtr = &BucketsPtr[atomPtr->hash & (BucketCount - 1)];
+
+    while (*linkPtrPtr != atomPtr)
+    {
+        LE_ASSERT(*linkPtrPtr != NULL);
+        linkPtrPtr = &((*linkPtrPtr)->nextPtr);
+    }
+
+    *linkPtrPtr = atomPtr->nextPtr;
+    AtomCount--;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Double the number of buckets in the atom table.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GrowTable
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t newCount = BucketCount * 2;
+    Atom_t** newBucketsPtr = calloc(newCount, sizeof(Atom_t*));
+    LE_ASSERT(newBucketsPtr != NULL);
+
+    size_t i;
+    for (i = 0; i < BucketCount; i++)
+    {
+        Atom_t* atomPtr = BucketsPtr[i];
+
+        while (atomPtr != NULL)
+        {
+            Atom_t* nextPtr = atomPtr->nextPtr;
+            Atom_t** bucketPtr = &newBucketsPtr[atomPtr->hash & (newCount - 1)];
+
+            atomPtr->nextPtr = *bucketPtr;
+            *bucketPtr = atomPtr;
+
+            atomPtr = nextPtr;
+        }
+    }
+
+    free(BucketsPtr);
+    BucketsPtr = newBucketsPtr;
+    BucketCount = newCount;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look up a string in the atom table.
+ *
+ * @return Ptr to the atom, or NULL if not found.
+ */
+//--------------------------------------------------------------------------------------------------
+static Atom_t* Lookup
+(
+    const char* string,
+    uint32_t hash   ///< Hash of the string.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Atom_t* atomPtr = BucketsPtr[hash & (BucketCount - 1)];
+
+    while (atomPtr != NULL)
+    {
+        if ((atomPtr->hash == hash) && (strcmp(atomPtr->string, string) == 0))
+        {
+            return atomPtr;
+        }
+
+        atomPtr = atomPtr->nextPtr;
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Atom module.
+ *
+ * @warning This function must be called before any others in this module.
+ */
+//--------------------------------------------------------------------------------------------------
+void atom_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    SmallAtomPool = le_mem_CreatePool("Small Atom", offsetof(Atom_t, string) + SMALL_ATOM_BYTES);
+    le_mem_SetDestructor(SmallAtomPool, AtomDestructor);
+
+    LargeAtomPool = le_mem_CreatePool("Large Atom", offsetof(Atom_t, string) + ATOM_MAX_BYTES);
+    le_mem_SetDestructor(LargeAtomPool, AtomDestructor);
+
+    BucketsPtr = calloc(MIN_BUCKET_COUNT, sizeof(Atom_t*));
+    LE_ASSERT(BucketsPtr != NULL);
+    BucketCount = MIN_BUCKET_COUNT;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the hash of a string, as used by the atom table (32-bit FNV-1a).
+ *
+ * @return The hash.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t atom_HashString
+(
+    const char* string
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint32_t hash = 2166136261u;
+
+    while (*string != '\0')
+    {
+        hash ^= (uint8_t)(*string);
+        hash *= 16777619u;
+        string++;
+    }
+
+    return hash;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the atom for a given string, creating it if it doesn't exist yet.
+ *
+ * @return Reference to the atom.  The caller owns a reference and must release it using
+ *         le_mem_Release() when done with it.
+ *
+ * @note The string must be shorter than ATOM_MAX_BYTES.
+ */
+//--------------------------------------------------------------------------------------------------
+atom_Ref_t atom_Get
+(
+    const char* string
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint32_t hash = atom_HashString(string);
+
+    Atom_t* atomPtr = Lookup(string, hash);
+    if (atomPtr != NULL)
+    {
+        le_mem_AddRef(atomPtr);
+        return atomPtr;
+    }
+
+    size_t size = strlen(string) + 1;
+    LE_ASSERT(size <= ATOM_MAX_BYTES);
+
+    if (size <= SMALL_ATOM_BYTES)
+    {
+        atomPtr = le_mem_ForceAlloc(SmallAtomPool);
+    }
+    else
+    {
+        atomPtr = le_mem_ForceAlloc(LargeAtomPool);
+    }
+
+    memcpy(atomPtr->string, string, size);
+    atomPtr->hash = hash;
+
+    if (AtomCount >= BucketCount)
+    {
+        GrowTable();
+    }
+
+    Atom_t** bucketPtr = &BucketsPtr[hash & (BucketCount - 1)];
+    atomPtr->nextPtr = *bucketPtr;
+    *bucketPtr = atomPtr;
+    AtomCount++;
+
+    return atomPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the atom for a given string, if there is one.  Doesn't create an atom or take a reference.
+ *
+ * @return Reference to the atom, or NULL if the string hasn't been interned.
+ */
+//--------------------------------------------------------------------------------------------------
+atom_Ref_t atom_Find
+(
+    const char* string
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return Lookup(string, atom_HashString(string));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the string an atom holds.
+ *
+ * @return Ptr to the string.  Only valid while the atom exists.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* atom_GetString
+(
+    atom_Ref_t atomRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return atomRef->string;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the hash of the string an atom holds (see atom_HashString()).
+ *
+ * @return The hash.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t atom_GetHash
+(
+    atom_Ref_t atomRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return atomRef->hash;
+}
@@ -0,0 +1,115 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file atom.h
+ *
+ * Interned strings ("atoms"), used for strings that are repeated many times over in the resource
+ * tree, such as entry names ("value", "enable", "period", ...), units and JSON extraction
+ * specifiers.  Each distinct string is stored only once, and two atoms hold the same string if
+ * and only if they are the same atom, so they can be compared by reference.
+ *
+ * Atoms are reference counted.  Use le_mem_AddRef() to take another reference to an atom and
+ * le_mem_Release() to drop one.  An atom is removed from the table when its last reference is
+ * released.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef ATOM_H_INCLUDE_GUARD
+#define ATOM_H_INCLUDE_GUARD
+
+
+/// Maximum number of bytes (including null terminator) in an atom's string.
+#define ATOM_MAX_BYTES 64
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to an atom.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct atom_Atom* atom_Ref_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Atom module.
+ *
+ * @warning This function must be called before any others in this module.
+ */
+//--------------------------------------------------------------------------------------------------
+void atom_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the hash of a string, as used by the atom table (32-bit FNV-1a).
+ *
+ * @return The hash.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t atom_HashString
+(
+    const char* string
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the atom for a given string, creating it if it doesn't exist yet.
+ *
+ * @return Reference to the atom.  The caller owns a reference and must release it using
+ *         le_mem_Release() when done with it.
+ *
+ * @note The string must be shorter than ATOM_MAX_BYTES.
+ */
+//--------------------------------------------------------------------------------------------------
+atom_Ref_t atom_Get
+(
+    const char* string
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the atom for a given string, if there is one.  Doesn't create an atom or take a reference.
+ *
+ * @return Reference to the atom, or NULL if the string hasn't been interned.
+ */
+//--------------------------------------------------------------------------------------------------
+atom_Ref_t atom_Find
+(
+    const char* string
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the string an atom holds.
+ *
+ * @return Ptr to the string.  Only valid while the atom exists.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* atom_GetString
+(
+    atom_Ref_t atomRef
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the hash of the string an atom holds (see atom_HashString()).
+ *
+ * @return The hash.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t atom_GetHash
+(
+    atom_Ref_t atomRef
+);
+
+
+#endif // ATOM_H_INCLUDE_GUARD
@@ -0,0 +1,675 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file backupFile.c
+ *
+ * Implementation of the Backup File module.
+ *
+ * The data sample buffer backup file format looks like this (little-endian byte order):
+ *
+ * - header (16 bytes):
+ *       - file format version byte = 3
+ *       - data type byte containing one of the following ASCII characters:
+ *             t = trigger
+ *             b = Boolean
+ *             n = numeric
+ *             s = string
+ *             j = JSON
+ *       - record encoding byte: 0 = record table, 1 = compressed blocks (numeric only)
+ *       - number of records = 4-byte unsigned integer
+ *       - number of rollup tiers byte
+ *       - size of the record section in bytes = 4-byte unsigned integer
+ *       - size of the string heap in bytes = 4-byte unsigned integer
+ * - record section, which is either:
+ *       - if the records are compressed:
+ *             - number of blocks = 4-byte unsigned integer
+ *             - number of records to skip at the start of the first block = 2-byte unsigned int
+ *             - array of blocks, oldest-first, each containing:
+ *                   - number of records = 2-byte unsigned integer
+ *                   - number of bits of encoded records = 2-byte unsigned integer
+ *                   - the encoded records, as held in memory (padded to a whole number of bytes)
+ *       - otherwise, a table of fixed-size (16-byte) records, sorted oldest-first, each containing:
+ *             - timestamp (8-byte IEEE double-precision floating point value)
+ *             - value, depending on data type, as follows (padded with zeros to 8 bytes):
+ *                   t -> no value
+ *                   b -> 1 byte, 0 = false, 1 = true
+ *                   n -> 8-byte IEEE double-precision floating point value
+ *                   s, j -> offset of the value in the string heap = 4-byte unsigned integer,
+ *                           followed by its length = 4-byte unsigned integer
+ * - string heap: the string and JSON values of the records, each null-terminated
+ * - array of rollup tiers, finest first, each containing:
+ *       - bucket period in seconds (8-byte IEEE double-precision floating point value)
+ *       - number of buckets = 4-byte unsigned integer
+ *       - array of buckets, sorted oldest-first, each containing:
+ *             - start time (8-byte IEEE double)
+ *             - number of values = 4-byte unsigned integer
+ *             - mean, sum of squared differences from the mean, minimum and maximum
+ *               (8-byte IEEE doubles)
+ *
+ * A backup file is laid out in memory by the Backup Thread and then written with a single system
+ * call.  It is restored by mapping it into memory, so string and JSON values are read straight
+ * out of the string heap.
+ *
+ * Backup files in the older formats can still be restored.  Up to the number of records, their
+ * header is the same, except that version 0 and 1 files have no record encoding byte.  The records
+ * follow directly (compressed blocks as above, or a variable-length record as in the backup
+ * journal, below), and then (except in version 0) a number of rollup tiers byte and the tiers.
+ *
+ * The backup journal file format looks like this (little-endian byte order):
+ *
+ * - file format version byte = 0
+ * - data type byte (as in the backup file)
+ * - buffer size (maximum number of records) = 4-byte unsigned integer
+ * - number of records in the backup file this journal follows = 4-byte unsigned integer
+ * - timestamp of the newest record in that backup file (8-byte IEEE double, NAN if none)
+ * - array of records added since that backup file was written, oldest first, each containing:
+ *       - timestamp (8-byte IEEE double-precision floating point value)
+ *       - value, depending on data type, as follows:
+ *             t -> no value
+ *             b -> 1 byte, 0 = false, 1 = true
+ *             n -> 8-byte IEEE double-precision floating point value
+ *             s -> 4-byte unsigned integer length, followed by string content (no null-terminator)
+ *             j -> 4-byte unsigned integer length, followed by JSON string content (no term char)
+ *   The last record may be incomplete, if the Data Hub was interrupted while appending it.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "dataSample.h"
+#include "backupFile.h"
+#include <sys/mman.h>
+
+/// Backup file format version written by this implementation.
+#define BACKUP_FORMAT_VERSION 3
+
+/// Backup journal file format version written by this implementation.
+#define JOURNAL_FORMAT_VERSION 0
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the data type code byte to be written into a backup file.
+ *
+ * @return the data type code byte.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t GetDataTypeCode
+(
+    io_DataType_t dataType
+)
+//--------------------------------------------------------------------------------------------------
+{
+    switch (dataType)
+    {
+        case IO_DATA_TYPE_TRIGGER:  return 't';
+        case IO_DATA_TYPE_BOOLEAN:  return 'b';
+        case IO_DATA_TYPE_NUMERIC:  return 'n';
+        case IO_DATA_TYPE_STRING:   return 's';
+        case IO_DATA_TYPE_JSON:     return 'j';
+    }
+
+    LE_FATAL("Invalid data type %d.", dataType);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the data type represented by the code byte read from a backup file.
+ *
+ * @return true if successful, false on error.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool GetDataTypeFromCode
+(
+    io_DataType_t* dataTypePtr, ///< [OUT] Ptr to where the result will be put on success.
+    uint8_t code
+)
+//--------------------------------------------------------------------------------------------------
+{
+    switch (code)
+    {
+        case 't': *dataTypePtr = IO_DATA_TYPE_TRIGGER; return true;
+        case 'b': *dataTypePtr = IO_DATA_TYPE_BOOLEAN; return true;
+        case 'n': *dataTypePtr = IO_DATA_TYPE_NUMERIC; return true;
+        case 's': *dataTypePtr = IO_DATA_TYPE_STRING;  return true;
+        case 'j': *dataTypePtr = IO_DATA_TYPE_JSON;    return true;
+    }
+
+    LE_CRIT("Invalid data type code %d.", (int)code);
+
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a buffer load of data from a backup file.
+ *
+ * On error, logs an error message and closes the file.
+ *
+ * @return LE_OK if successful, LE_UNDERFLOW if the end of file was reached, LE_FAULT if failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t backupFile_Read
+(
+    void* buffPtr,
+    size_t buffSize,
+    FILE* file
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t bytesRead = fread(buffPtr, 1, buffSize, file);
+
+    le_result_t result = LE_OK;
+
+    if (bytesRead < buffSize)
+    {
+        if (feof(file))
+        {
+            result = LE_UNDERFLOW;
+        }
+        else
+        {
+            LE_CRIT("Failed to read (%m).");
+            result = LE_FAULT;
+        }
+
+        le_atomFile_CancelStream(file);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a backup file for reading, if there is one, and reads its header up to the number of
+ * records.
+ *
+ * @return The backup file, positioned after the number of records, or NULL if there is no backup
+ *         file or its header couldn't be read.
+ */
+//--------------------------------------------------------------------------------------------------
+FILE* backupFile_Open
+(
+    const char* path,
+    backupFile_Header_t* headerPtr  ///< [OUT] The header.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Open the file for reading.
+    le_result_t result;
+    FILE* file = le_atomFile_OpenStream(path, LE_FLOCK_READ, &result);
+    if (result != LE_OK)
+    {
+        LE_DEBUG("Unable to open '%s' for reading (%s).", path, LE_RESULT_TXT(result));
+        return NULL;
+    }
+
+    // Read the version byte.
+    uint8_t byte;
+    if (backupFile_Read(&byte, 1, file) != LE_OK)
+    {
+        LE_ERROR("Failed to read version byte.");
+        return NULL;
+    }
+    if (byte > BACKUP_FORMAT_VERSION)
+    {
+        LE_CRIT("Backup file format version %d unrecognized.", (int)byte);
+        le_atomFile_CancelStream(file);
+        return NULL;
+    }
+    headerPtr->version = byte;
+
+    // Read the data type code.
+    if (backupFile_Read(&byte, 1, file) != LE_OK)
+    {
+        LE_ERROR("Failed to read data type code.");
+        return NULL;
+    }
+    if (!GetDataTypeFromCode(&headerPtr->dataType, byte))
+    {
+        le_atomFile_CancelStream(file);
+        return NULL;
+    }
+
+    // Read the record encoding (if the file has it).
+    headerPtr->isCompressed = false;
+    if (headerPtr->version > 1)
+    {
+        if (backupFile_Read(&byte, 1, file) != LE_OK)
+        {
+            LE_ERROR("Failed to read record encoding.");
+            return NULL;
+        }
+        if ((byte > 1) || ((byte == 1) && (headerPtr->dataType != IO_DATA_TYPE_NUMERIC)))
+        {
+            LE_CRIT("Invalid record encoding %d.", (int)byte);
+            le_atomFile_CancelStream(file);
+            return NULL;
+        }
+        headerPtr->isCompressed = (byte == 1);
+    }
+
+    // Read the number of samples.
+    if (backupFile_Read(&headerPtr->count, 4, file) != LE_OK)
+    {
+        LE_ERROR("Failed to read number of samples.");
+        return NULL;
+    }
+
+    return file;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lays out the header of a backup file in the current format.
+ *
+ * @return Pointer to the byte after the header.
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t* backupFile_WriteHeader
+(
+    uint8_t* posPtr,                        ///< Start of the image.
+    const backupFile_Header_t* headerPtr,   ///< The header (the version is ignored).
+    size_t tierCount,                       ///< Number of rollup tiers.
+    size_t dataBytes,                       ///< Size of the record section, in bytes.
+    size_t heapBytes                        ///< Size of the string heap, in bytes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint8_t byte = BACKUP_FORMAT_VERSION;
+    uint32_t size;
+    posPtr = backupFile_CopyToImage(posPtr, &byte, 1);
+    byte = GetDataTypeCode(headerPtr->dataType);
+    posPtr = backupFile_CopyToImage(posPtr, &byte, 1);
+    byte = headerPtr->isCompressed;
+    posPtr = backupFile_CopyToImage(posPtr, &byte, 1);
+    posPtr = backupFile_CopyToImage(posPtr, &headerPtr->count, 4);
+    byte = tierCount;
+    posPtr = backupFile_CopyToImage(posPtr, &byte, 1);
+    size = dataBytes;
+    posPtr = backupFile_CopyToImage(posPtr, &size, 4);
+    size = heapBytes;
+    return backupFile_CopyToImage(posPtr, &size, 4);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps a backup file (in the current format) into memory and checks the sizes in its header.
+ *
+ * On error, logs an error message.  Doesn't close the file.
+ *
+ * @return true if successful, false if failed.
+ */
+//--------------------------------------------------------------------------------------------------
+bool backupFile_MapImage
+(
+    FILE* file,
+    backupFile_Image_t* imagePtr    ///< [OUT] The mapped image.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    struct stat st;
+    if (fstat(fileno(file), &st) != 0)
+    {
+        LE_CRIT("Failed to get backup file size (%m).");
+        return false;
+    }
+    imagePtr->size = st.st_size;
+    if (imagePtr->size < BACKUP_HEADER_BYTES)
+    {
+        LE_CRIT("Backup file header is truncated.");
+        return false;
+    }
+
+    imagePtr->basePtr = mmap(NULL, imagePtr->size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+    if (imagePtr->basePtr == MAP_FAILED)
+    {
+        LE_CRIT("Failed to map backup file (%m).");
+        return false;
+    }
+
+    // Skip the part of the header that is common to all format versions.
+    const uint8_t* posPtr = imagePtr->basePtr + 1 + 1 + 1 + 4;
+    uint8_t tierCount;
+    uint32_t dataBytes;
+    uint32_t heapBytes;
+    posPtr = backupFile_CopyFromImage(&tierCount, posPtr, 1);
+    posPtr = backupFile_CopyFromImage(&dataBytes, posPtr, 4);
+    posPtr = backupFile_CopyFromImage(&heapBytes, posPtr, 4);
+
+    if (tierCount > ADMIN_MAX_ROLLUP_TIERS)
+    {
+        LE_CRIT("Too many rollup tiers (%d).", (int)tierCount);
+    }
+    else if (((uint64_t)BACKUP_HEADER_BYTES + dataBytes + heapBytes) > imagePtr->size)
+    {
+        LE_CRIT("Backup file was truncated.");
+    }
+    else
+    {
+        imagePtr->tierCount = tierCount;
+        imagePtr->dataPtr = posPtr;
+        imagePtr->dataBytes = dataBytes;
+        imagePtr->heapPtr = (const char*)posPtr + dataBytes;
+        imagePtr->heapBytes = heapBytes;
+
+        return true;
+    }
+
+    munmap((void*)imagePtr->basePtr, imagePtr->size);
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unmaps a backup file image mapped by backupFile_MapImage().
+ */
+//--------------------------------------------------------------------------------------------------
+void backupFile_UnmapImage
+(
+    const backupFile_Image_t* imagePtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    munmap((void*)imagePtr->basePtr, imagePtr->size);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a data sample record from a given backup (or backup journal) file.
+ *
+ * On error, logs an error message and closes the file.
+ *
+ * @return LE_OK if successful, LE_UNDERFLOW if the end of the file was reached before the start of
+ *         a record (the file is closed), LE_FAULT if failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t backupFile_ReadRecord
+(
+    FILE* file,
+    io_DataType_t dataType,
+    dataSample_Ref_t* sampleRefPtr  ///< [OUT] New data sample (which the caller must release).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Read the timestamp.
+    double timestamp;
+    le_result_t result = backupFile_Read(&timestamp, sizeof(timestamp), file);
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    switch (dataType)
+    {
+        case IO_DATA_TYPE_TRIGGER:
+
+            // No Value.
+            *sampleRefPtr = dataSample_CreateTrigger(timestamp);
+            break;
+
+        case IO_DATA_TYPE_BOOLEAN:
+        {
+            bool value;
+            if (backupFile_Read(&value, sizeof(value), file) != LE_OK)
+            {
+                LE_CRIT("Failed to read boolean value.");
+                return LE_FAULT;
+            }
+            *sampleRefPtr = dataSample_CreateBoolean(timestamp, value);
+            break;
+        }
+        case IO_DATA_TYPE_NUMERIC:
+        {
+            double value;
+            if (backupFile_Read(&value, sizeof(value), file) != LE_OK)
+            {
+                LE_CRIT("Failed to read numeric value.");
+                return LE_FAULT;
+            }
+            *sampleRefPtr = dataSample_CreateNumeric(timestamp, value);
+            break;
+        }
+        case IO_DATA_TYPE_STRING:
+        {
+            char value[IO_MAX_STRING_VALUE_LEN + 1];
+
+            uint32_t stringLen;
+            if (backupFile_Read(&stringLen, 4, file) != LE_OK)
+            {
+                LE_CRIT("Failed to read string length.");
+                return LE_FAULT;
+            }
+            if (stringLen > (sizeof(value) - 1))
+            {
+                LE_CRIT("String length (%zu) is larger than permitted (%zu).",
+                        (size_t)stringLen,
+                        sizeof(value) - 1);
+                le_atomFile_CancelStream(file);
+                return LE_FAULT;
+            }
+            if (backupFile_Read(value, stringLen, file) != LE_OK)
+            {
+                LE_CRIT("Failed to read string value of length %zu.", (size_t)stringLen);
+                return LE_FAULT;
+            }
+            value[stringLen] = '\0';
+            *sampleRefPtr = dataSample_CreateString(timestamp, value);
+            break;
+        }
+        case IO_DATA_TYPE_JSON:
+        {
+            char value[IO_MAX_STRING_VALUE_LEN + 1];
+
+            uint32_t stringLen;
+            if (backupFile_Read(&stringLen, 4, file) != LE_OK)
+            {
+                LE_CRIT("Failed to read JSON object length.");
+                return LE_FAULT;
+            }
+            if (stringLen > (sizeof(value) - 1))
+            {
+                LE_CRIT("JSON string length (%zu) is larger than permitted (%zu).",
+                        (size_t)stringLen,
+                        sizeof(value) - 1);
+                le_atomFile_CancelStream(file);
+                return LE_FAULT;
+            }
+            if (backupFile_Read(value, stringLen, file) != LE_OK)
+            {
+                LE_CRIT("Failed to read JSON value of length %zu.", (size_t)stringLen);
+                return LE_FAULT;
+            }
+            value[stringLen] = '\0';
+            *sampleRefPtr = dataSample_CreateJson(timestamp, value);
+            break;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a data sample from a record in the record table of a backup file image.  String and
+ * JSON values are created straight from the image's string heap.
+ *
+ * @return The new data sample (which the caller must release), or NULL if the record is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+dataSample_Ref_t backupFile_CreateSampleFromRecord
+(
+    const uint8_t* recordPtr,
+    io_DataType_t dataType,
+    const char* heapPtr,
+    size_t heapBytes
+)
+//--------------------------------------------------------------------------------------------------
+{
+    double timestamp;
+    const uint8_t* valuePtr = backupFile_CopyFromImage(&timestamp, recordPtr, 8);
+
+    switch (dataType)
+    {
+        case IO_DATA_TYPE_TRIGGER:
+
+            return dataSample_CreateTrigger(timestamp);
+
+        case IO_DATA_TYPE_BOOLEAN:
+
+            return dataSample_CreateBoolean(timestamp, (*valuePtr != 0));
+
+        case IO_DATA_TYPE_NUMERIC:
+        {
+            double value;
+            backupFile_CopyFromImage(&value, valuePtr, 8);
+            return dataSample_CreateNumeric(timestamp, value);
+        }
+        case IO_DATA_TYPE_STRING:
+        case IO_DATA_TYPE_JSON:
+        {
+            uint32_t offset;
+            uint32_t stringLen;
+            valuePtr = backupFile_CopyFromImage(&offset, valuePtr, 4);
+            backupFile_CopyFromImage(&stringLen, valuePtr, 4);
+
+            // The value must be null-terminated inside the heap.
+            if (   (offset >= heapBytes)
+                || (stringLen >= (heapBytes - offset))
+                || (heapPtr[offset + stringLen] != '\0')  )
+            {
+                LE_CRIT("Invalid string value location (%u bytes at %u).",
+                        (unsigned int)stringLen,
+                        (unsigned int)offset);
+                return NULL;
+            }
+            if (stringLen > IO_MAX_STRING_VALUE_LEN)
+            {
+                LE_CRIT("String length (%u) is larger than permitted (%u).",
+                        (unsigned int)stringLen,
+                        (unsigned int)IO_MAX_STRING_VALUE_LEN);
+                return NULL;
+            }
+
+            if (dataType == IO_DATA_TYPE_STRING)
+            {
+                return dataSample_CreateString(timestamp, heapPtr + offset);
+            }
+            return dataSample_CreateJson(timestamp, heapPtr + offset);
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a backup journal file for reading, if there is one, and reads its header.
+ *
+ * @return The journal file, positioned at its first record, or NULL if there is no journal or its
+ *         header couldn't be read.
+ */
+//--------------------------------------------------------------------------------------------------
+FILE* backupFile_OpenJournal
+(
+    const char* path,
+    backupFile_JournalHeader_t* headerPtr   ///< [OUT] The header.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result;
+    FILE* file = le_atomFile_OpenStream(path, LE_FLOCK_READ, &result);
+    if (result != LE_OK)
+    {
+        LE_DEBUG("Unable to open '%s' for reading (%s).", path, LE_RESULT_TXT(result));
+        return NULL;
+    }
+
+    uint8_t version;
+    uint8_t typeCode;
+    if (   (backupFile_Read(&version, 1, file) != LE_OK)
+        || (backupFile_Read(&typeCode, 1, file) != LE_OK)
+        || (backupFile_Read(&headerPtr->maxCount, 4, file) != LE_OK)
+        || (backupFile_Read(&headerPtr->count, 4, file) != LE_OK)
+        || (backupFile_Read(&headerPtr->newestTimestamp, 8, file) != LE_OK)  )
+    {
+        LE_ERROR("Failed to read backup journal header from '%s'.", path);
+        return NULL;
+    }
+    if (version > JOURNAL_FORMAT_VERSION)
+    {
+        LE_CRIT("Backup journal file format version %d unrecognized.", (int)version);
+        le_atomFile_CancelStream(file);
+        return NULL;
+    }
+    if (!GetDataTypeFromCode(&headerPtr->dataType, typeCode))
+    {
+        le_atomFile_CancelStream(file);
+        return NULL;
+    }
+
+    return file;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a new, empty backup journal with a given header, replacing the existing one (if any).
+ *
+ * @return true if successful, false if failed (in which case there is no journal).
+ */
+//--------------------------------------------------------------------------------------------------
+bool backupFile_StartJournal
+(
+    const char* path,
+    const backupFile_JournalHeader_t* headerPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result;
+    FILE* file = le_flock_CreateStream(path,
+                                       LE_FLOCK_WRITE,
+                                       LE_FLOCK_REPLACE_IF_EXIST,
+                                       0600,
+                                       &result);
+    if (result != LE_OK)
+    {
+        LE_CRIT("Unable to open file '%s' for writing (%s).", path, LE_RESULT_TXT(result));
+        unlink(path);
+        return false;
+    }
+
+    uint8_t version = JOURNAL_FORMAT_VERSION;
+    uint8_t typeCode = GetDataTypeCode(headerPtr->dataType);
+
+    bool ok = (   (fwrite(&version, 1, 1, file) == 1)
+               && (fwrite(&typeCode, 1, 1, file) == 1)
+               && (fwrite(&headerPtr->maxCount, 4, 1, file) == 1)
+               && (fwrite(&headerPtr->count, 4, 1, file) == 1)
+               && (fwrite(&headerPtr->newestTimestamp, 8, 1, file) == 1)
+               && (fflush(file) == 0)  );
+    if (!ok)
+    {
+        LE_CRIT("Failed to write '%s' (%m).", path);
+    }
+
+    le_flock_CloseStream(file);
+
+    if (!ok)
+    {
+        // A journal that doesn't follow on from the backup file would be ignored anyway.
+        unlink(path);
+    }
+
+    return ok;
+}
@@ -0,0 +1,247 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file backupFile.h
+ *
+ * Interface to the Backup File module, which reads and writes the headers of data sample buffer
+ * backup files and backup journals, maps backup files into memory, and decodes the data sample
+ * records they hold.  Laying out an Observation's buffer and rollup tiers in a backup file is left
+ * to the Observation module.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef BACKUP_FILE_H_INCLUDE_GUARD
+#define BACKUP_FILE_H_INCLUDE_GUARD
+
+
+/// Size of the header of a backup file, in bytes.
+#define BACKUP_HEADER_BYTES 16
+
+/// Size of each entry in the record table of a backup file, in bytes.
+#define BACKUP_RECORD_BYTES 16
+
+/// Size of each rollup bucket in a backup file, in bytes.
+#define BACKUP_BUCKET_BYTES 44
+
+
+/// Header of a backup file, up to the number of records (which is common to all format versions).
+typedef struct
+{
+    uint8_t version;        ///< File format version.
+    io_DataType_t dataType; ///< Data type of the records.
+    bool isCompressed;      ///< true if the records are in compressed blocks.
+    uint32_t count;         ///< Number of records.
+}
+backupFile_Header_t;
+
+
+/// Backup file (in the current format) mapped into memory, with the sizes from its header.
+typedef struct
+{
+    const uint8_t* basePtr; ///< Start of the mapping.
+    size_t size;            ///< Size of the file, in bytes.
+    size_t tierCount;       ///< Number of rollup tiers.
+    const uint8_t* dataPtr; ///< Start of the record section.
+    size_t dataBytes;       ///< Size of the record section, in bytes.
+    const char* heapPtr;    ///< Start of the string heap.
+    size_t heapBytes;       ///< Size of the string heap, in bytes.
+}
+backupFile_Image_t;
+
+
+/// Header of a backup journal, identifying the backup file that the journal follows on from.
+typedef struct
+{
+    io_DataType_t dataType; ///< Data type of the records.
+    uint32_t maxCount;      ///< Buffer size when the journal was started.
+    uint32_t count;         ///< Number of records in the backup file.
+    double newestTimestamp; ///< Timestamp of the newest record in the backup file (NAN if none).
+}
+backupFile_JournalHeader_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies bytes into a backup file image being laid out in memory.
+ *
+ * @return Pointer to the byte after the ones copied.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint8_t* backupFile_CopyToImage
+(
+    uint8_t* destPtr,
+    const void* srcPtr,
+    size_t byteCount
+)
+//--------------------------------------------------------------------------------------------------
+{
+    memcpy(destPtr, srcPtr, byteCount);
+
+    return destPtr + byteCount;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies bytes out of a backup file image mapped into memory.
+ *
+ * @return Pointer to the byte after the ones copied.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline const uint8_t* backupFile_CopyFromImage
+(
+    void* destPtr,
+    const uint8_t* srcPtr,
+    size_t byteCount
+)
+//--------------------------------------------------------------------------------------------------
+{
+    memcpy(destPtr, srcPtr, byteCount);
+
+    return srcPtr + byteCount;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a buffer load of data from a backup file.
+ *
+ * On error, logs an error message and closes the file.
+ *
+ * @return LE_OK if successful, LE_UNDERFLOW if the end of file was reached, LE_FAULT if failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t backupFile_Read
+(
+    void* buffPtr,
+    size_t buffSize,
+    FILE* file
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a backup file for reading, if there is one, and reads its header up to the number of
+ * records.
+ *
+ * @return The backup file, positioned after the number of records, or NULL if there is no backup
+ *         file or its header couldn't be read.
+ */
+//--------------------------------------------------------------------------------------------------
+FILE* backupFile_Open
+(
+    const char* path,
+    backupFile_Header_t* headerPtr  ///< [OUT] The header.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lays out the header of a backup file in the current format.
+ *
+ * @return Pointer to the byte after the header.
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t* backupFile_WriteHeader
+(
+    uint8_t* posPtr,                        ///< Start of the image.
+    const backupFile_Header_t* headerPtr,   ///< The header (the version is ignored).
+    size_t tierCount,                       ///< Number of rollup tiers.
+    size_t dataBytes,                       ///< Size of the record section, in bytes.
+    size_t heapBytes                        ///< Size of the string heap, in bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps a backup file (in the current format) into memory and checks the sizes in its header.
+ *
+ * On error, logs an error message.  Doesn't close the file.
+ *
+ * @return true if successful, false if failed.
+ */
+//--------------------------------------------------------------------------------------------------
+bool backupFile_MapImage
+(
+    FILE* file,
+    backupFile_Image_t* imagePtr    ///< [OUT] The mapped image.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unmaps a backup file image mapped by backupFile_MapImage().
+ */
+//--------------------------------------------------------------------------------------------------
+void backupFile_UnmapImage
+(
+    const backupFile_Image_t* imagePtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a data sample record from a given backup (or backup journal) file.
+ *
+ * On error, logs an error message and closes the file.
+ *
+ * @return LE_OK if successful, LE_UNDERFLOW if the end of the file was reached before the start of
+ *         a record (the file is closed), LE_FAULT if failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t backupFile_ReadRecord
+(
+    FILE* file,
+    io_DataType_t dataType,
+    dataSample_Ref_t* sampleRefPtr  ///< [OUT] New data sample (which the caller must release).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a data sample from a record in the record table of a backup file image.  String and
+ * JSON values are created straight from the image's string heap.
+ *
+ * @return The new data sample (which the caller must release), or NULL if the record is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+dataSample_Ref_t backupFile_CreateSampleFromRecord
+(
+    const uint8_t* recordPtr,
+    io_DataType_t dataType,
+    const char* heapPtr,
+    size_t heapBytes
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a backup journal file for reading, if there is one, and reads its header.
+ *
+ * @return The journal file, positioned at its first record, or NULL if there is no journal or its
+ *         header couldn't be read.
+ */
+//--------------------------------------------------------------------------------------------------
+FILE* backupFile_OpenJournal
+(
+    const char* path,
+    backupFile_JournalHeader_t* headerPtr   ///< [OUT] The header.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a new, empty backup journal with a given header, replacing the existing one (if any).
+ *
+ * @return true if successful, false if failed (in which case there is no journal).
+ */
+//--------------------------------------------------------------------------------------------------
+bool backupFile_StartJournal
+(
+    const char* path,
+    const backupFile_JournalHeader_t* headerPtr
+);
+
+
+#endif // BACKUP_FILE_H_INCLUDE_GUARD
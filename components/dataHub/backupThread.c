@@ -0,0 +1,252 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file backupThread.c
+ *
+ * Implementation of the Backup Thread module.
+ *
+ * Jobs are queued to the Backup Thread's event loop, so it does them (and any functions queued to
+ * it) in order.  Each job is also kept in the Unfinished Job List until the Backup Thread passes
+ * it back, so the main thread can find the newest job on a given file.  Once that job is done, all
+ * the jobs before it are too.  To wait for a job, the main thread swaps a semaphore into the job's
+ * waiterSem, and the Backup Thread posts it when the job is done; whichever thread swaps second
+ * sees what the other one put there, so a job finishing in the meantime is never waited for.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "backupThread.h"
+
+/// Value of a job's waiterSem once the Backup Thread has done the job.
+#define JOB_DONE ((le_sem_Ref_t)(uintptr_t)1)
+
+
+/// Thread that does the backup file I/O.
+static le_thread_Ref_t BackupThread = NULL;
+
+/// The Data Hub's main thread, which jobs are passed back to when they are done.
+static le_thread_Ref_t MainThread = NULL;
+
+/// Jobs queued to the Backup Thread that haven't been passed back yet, oldest first.
+static le_dls_List_t UnfinishedJobList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the newest job on a given file that the Backup Thread hasn't passed back yet.
+ *
+ * @return Pointer to the job, or NULL if there is none.
+ */
+//--------------------------------------------------------------------------------------------------
+static backupThread_Job_t* FindUnfinishedJob
+(
+    const char* path    ///< Path of the file.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* linkPtr = le_dls_PeekTail(&UnfinishedJobList);
+    while (linkPtr != NULL)
+    {
+        backupThread_Job_t* jobPtr = CONTAINER_OF(linkPtr, backupThread_Job_t, link);
+
+        if (   (strcmp(jobPtr->pathPtr, path) == 0)
+            || ((jobPtr->otherPathPtr != NULL) && (strcmp(jobPtr->otherPathPtr, path) == 0))  )
+        {
+            return jobPtr;
+        }
+
+        linkPtr = le_dls_PeekPrev(&UnfinishedJobList, linkPtr);
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish a job passed back by the Backup Thread.  Runs in the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompleteJob
+(
+    void* jobPtr,   ///< [IN] The job.
+    void* unused    ///< [IN] Unused parameter.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_UNUSED(unused);
+
+    backupThread_Job_t* threadJobPtr = jobPtr;
+
+    le_dls_Remove(&UnfinishedJobList, &threadJobPtr->link);
+
+    threadJobPtr->completeFunc(threadJobPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Do a job.  Runs in the Backup Thread, and then passes the job back to the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunJob
+(
+    void* jobPtr,   ///< [IN] The job.
+    void* unused    ///< [IN] Unused parameter.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_UNUSED(unused);
+
+    backupThread_Job_t* threadJobPtr = jobPtr;
+
+    threadJobPtr->runFunc(threadJobPtr);
+
+    // Wake up the main thread if it is waiting for the file.  This must be done before the job is
+    // passed back, because the main thread may release it then.
+    le_sem_Ref_t semRef = __atomic_exchange_n(&threadJobPtr->waiterSem,
+                                              JOB_DONE,
+                                              __ATOMIC_ACQ_REL);
+    if (semRef != NULL)
+    {
+        le_sem_Post(semRef);
+    }
+
+    le_event_QueueFunctionToThread(MainThread, CompleteJob, threadJobPtr, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of the Backup Thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* BackupThreadMain
+(
+    void* contextPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_UNUSED(contextPtr);
+
+    le_event_RunLoop();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Backup Thread module, and start the Backup Thread.  The thread calling this is
+ * the one that jobs are passed back to.
+ *
+ * @warning This function must be called before any others in this module.
+ */
+//--------------------------------------------------------------------------------------------------
+void backupThread_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    MainThread = le_thread_GetCurrent();
+    BackupThread = le_thread_Create("Backup", BackupThreadMain, NULL);
+    le_thread_Start(BackupThread);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a job to the Backup Thread.  Once the Backup Thread has run the job's run function, the
+ * job is passed back to the main thread, which runs its complete function (which may free it).
+ */
+//--------------------------------------------------------------------------------------------------
+void backupThread_QueueJob
+(
+    backupThread_Job_t* jobPtr,
+    backupThread_JobFunc_t runFunc,     ///< Does the job, in the Backup Thread.
+    backupThread_JobFunc_t completeFunc ///< Finishes the job, in the main thread.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    jobPtr->runFunc = runFunc;
+    jobPtr->completeFunc = completeFunc;
+    jobPtr->waiterSem = NULL;
+    jobPtr->link = LE_DLS_LINK_INIT;
+    le_dls_Queue(&UnfinishedJobList, &jobPtr->link);
+
+    le_event_QueueFunctionToThread(BackupThread, RunJob, jobPtr, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a function to the Backup Thread, to be run after the jobs (and functions) already queued.
+ * Nothing is passed back to the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void backupThread_QueueFunction
+(
+    le_event_DeferredFunc_t func,
+    void* param1Ptr,
+    void* param2Ptr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_event_QueueFunctionToThread(BackupThread, func, param1Ptr, param2Ptr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Block until the Backup Thread has done all the jobs queued to it on a given file, so that the
+ * file can be used by the main thread.  Jobs on other files queued after them aren't waited for.
+ */
+//--------------------------------------------------------------------------------------------------
+void backupThread_WaitForFile
+(
+    const char* path    ///< Path of the file.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // The Backup Thread does the jobs in order, so once the newest one is done, they all are.
+    backupThread_Job_t* jobPtr = FindUnfinishedJob(path);
+    if (   (jobPtr == NULL)
+        || (__atomic_load_n(&jobPtr->waiterSem, __ATOMIC_ACQUIRE) == JOB_DONE)  )
+    {
+        return;
+    }
+
+    le_sem_Ref_t semRef = le_sem_Create("BackupJobDone", 0);
+
+    // If the job got done in the meantime, the Backup Thread won't post the semaphore.
+    if (__atomic_exchange_n(&jobPtr->waiterSem, semRef, __ATOMIC_ACQ_REL) == JOB_DONE)
+    {
+        __atomic_store_n(&jobPtr->waiterSem, JOB_DONE, __ATOMIC_RELEASE);
+    }
+    else
+    {
+        le_sem_Wait(semRef);
+    }
+
+    le_sem_Delete(semRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the Backup Thread still has to do any of the jobs queued to it on a given file.
+ *
+ * @return true if the file is still in use by the Backup Thread.
+ */
+//--------------------------------------------------------------------------------------------------
+bool backupThread_IsFileBusy
+(
+    const char* path    ///< Path of the file.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    backupThread_Job_t* jobPtr = FindUnfinishedJob(path);
+
+    return (   (jobPtr != NULL)
+            && (__atomic_load_n(&jobPtr->waiterSem, __ATOMIC_ACQUIRE) != JOB_DONE));
+}
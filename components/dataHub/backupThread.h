@@ -0,0 +1,119 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file backupThread.h
+ *
+ * Interface to the Backup Thread module, which runs a thread that does the backup file I/O, so
+ * that the main thread can keep routing data samples while backups are written.  Jobs queued to
+ * the Backup Thread are done in the order they were queued, and then passed back to the main
+ * thread.  The main thread can wait for the jobs on a given file only.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef BACKUP_THREAD_H_INCLUDE_GUARD
+#define BACKUP_THREAD_H_INCLUDE_GUARD
+
+
+typedef struct backupThread_Job backupThread_Job_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function that does a job, or finishes it once it has been passed back to the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*backupThread_JobFunc_t)
+(
+    backupThread_Job_t* jobPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Job passed to the Backup Thread.  Meant to be embedded in a record holding everything the job
+ * needs, which can be found with CONTAINER_OF().  The owner fills in the paths of the files the
+ * job uses before queueing it; the rest of the fields belong to this module.
+ */
+//--------------------------------------------------------------------------------------------------
+struct backupThread_Job
+{
+    const char* pathPtr;        ///< Path of a file the job uses.
+    const char* otherPathPtr;   ///< Path of another file the job uses (NULL if none).
+    backupThread_JobFunc_t runFunc;         ///< Does the job, in the Backup Thread.
+    backupThread_JobFunc_t completeFunc;    ///< Finishes the job, in the main thread.
+    le_dls_Link_t link;     ///< Link in the Unfinished Job List.  Main thread only.
+    le_sem_Ref_t waiterSem; ///< Semaphore the main thread is waiting on for the job (NULL if
+                            ///  none), or a marker value once the Backup Thread has done the job.
+                            ///  Only accessed atomically.
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Backup Thread module, and start the Backup Thread.  The thread calling this is
+ * the one that jobs are passed back to.
+ *
+ * @warning This function must be called before any others in this module.
+ */
+//--------------------------------------------------------------------------------------------------
+void backupThread_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a job to the Backup Thread.  Once the Backup Thread has run the job's run function, the
+ * job is passed back to the main thread, which runs its complete function (which may free it).
+ */
+//--------------------------------------------------------------------------------------------------
+void backupThread_QueueJob
+(
+    backupThread_Job_t* jobPtr,
+    backupThread_JobFunc_t runFunc,     ///< Does the job, in the Backup Thread.
+    backupThread_JobFunc_t completeFunc ///< Finishes the job, in the main thread.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a function to the Backup Thread, to be run after the jobs (and functions) already queued.
+ * Nothing is passed back to the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void backupThread_QueueFunction
+(
+    le_event_DeferredFunc_t func,
+    void* param1Ptr,
+    void* param2Ptr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Block until the Backup Thread has done all the jobs queued to it on a given file, so that the
+ * file can be used by the main thread.  Jobs on other files queued after them aren't waited for.
+ */
+//--------------------------------------------------------------------------------------------------
+void backupThread_WaitForFile
+(
+    const char* path    ///< Path of the file.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the Backup Thread still has to do any of the jobs queued to it on a given file.
+ *
+ * @return true if the file is still in use by the Backup Thread.
+ */
+//--------------------------------------------------------------------------------------------------
+bool backupThread_IsFileBusy
+(
+    const char* path    ///< Path of the file.
+);
+
+
+#endif // BACKUP_THREAD_H_INCLUDE_GUARD
@@ -15,6 +15,8 @@
  *
  * Data Samples are implemented by the dataSample module.
  *
+ * Interned strings (entry names, units, etc.) are implemented by the atom module.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 //--------------------------------------------------------------------------------------------------
@@ -23,13 +25,19 @@
 #include "interfaces.h"
 #include "dataHub.h"
 #include "nan.h"
+#include "atom.h"
 #include "dataSample.h"
+#include "backupThread.h"
+#include "gorilla.h"
+#include "quantile.h"
+#include "histogram.h"
 #include "handler.h"
 #include "resource.h"
 #include "resTree.h"
 #include "ioPoint.h"
 #include "obs.h"
 #include "ioService.h"
+#include "queryService.h"
 #include "adminService.h"
 #include "snapshot.h"
 
@@ -45,13 +53,19 @@ COMPONENT_INIT
 void initDataHub(void)
 #endif
 {
+    atom_Init();
     dataSample_Init();
     handler_Init();
     res_Init();
     ioPoint_Init();
+    gorilla_Init();
+    quantile_Init();
+    histogram_Init();
+    backupThread_Init();
     obs_Init();
     resTree_Init();
     ioService_Init();
+    queryService_Init();
     adminService_Init();
     snapshot_Init();
 
@@ -32,6 +32,7 @@ typedef struct hub_Handler* hub_HandlerRef_t;
 
 
 #include "interfaces.h"
+#include "atom.h"
 #include "dataSample.h"
 #include "resTree.h"
 
@@ -0,0 +1,688 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file gorilla.c
+ *
+ * Implementation of the Gorilla codec module.
+ *
+ * Numeric samples are encoded into a list of fixed-size blocks using Gorilla-style encoding:
+ * delta-of-delta encoded timestamps (in microseconds, when they are whole numbers of microseconds)
+ * and values XOR-encoded against the previous value.  Each block starts with an unencoded sample,
+ * so blocks can be decoded (and discarded) on their own.  Slowly-changing sensor values at regular
+ * intervals typically take a few bits per sample.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "gorilla.h"
+
+
+/// Largest number of bits a sample can take up when encoded: an escaped raw timestamp (5 + 64 bits)
+/// followed by a value with a new XOR window (2 + 5 + 6 + 64 bits).
+#define MAX_ENCODED_SAMPLE_BITS (5 + 64 + 2 + 5 + 6 + 64)
+
+/// Value of gorilla_State_t.leading when there is no XOR window to reuse.
+#define NO_XOR_WINDOW 0xFF
+
+/// Pool of compressed buffers.
+static le_mem_PoolRef_t BufferPool = NULL;
+
+/// Pool of compressed buffer blocks.
+static le_mem_PoolRef_t BlockPool = NULL;
+
+/// Codes used to encode the delta-of-delta of a timestamp in a compressed buffer, tried in order.
+/// A code is prefixed by as many 1 bits as its index in this table, then a 0 bit.  Five 1 bits
+/// prefix an unencoded timestamp.
+static const uint8_t DeltaOfDeltaBits[] = { 0, 7, 9, 12, 32 };
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert a timestamp to a whole number of microseconds.
+ *
+ * @return true if the timestamp is exactly that number of microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool GetTimeUs
+(
+    double timestamp,
+    int64_t* timeUsPtr  ///< [OUT] Rounded number of microseconds (0 if out of range).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    double timeUs = round(timestamp * 1000000);
+
+    // Stay well within the range where a double can hold every whole number.
+    if (!(fabs(timeUs) < 4.0e15))
+    {
+        *timeUsPtr = 0;
+        return false;
+    }
+
+    *timeUsPtr = (int64_t)timeUs;
+
+    return ((((double)(*timeUsPtr)) / 1000000) == timestamp);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append bits to the data in a compressed buffer block.  The block must have room for them.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteBits
+(
+    gorilla_Block_t* blockPtr,
+    uint64_t bits,          ///< Bits to append, in the least significant bitCount bits.
+    unsigned int bitCount   ///< Number of bits to append (up to 64).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    while (bitCount > 0)
+    {
+        uint8_t* bytePtr = &blockPtr->data[blockPtr->bitCount / 8];
+        unsigned int freeBits = 8 - (blockPtr->bitCount % 8);
+        unsigned int n = (bitCount < freeBits) ? bitCount : freeBits;
+
+        if (freeBits == 8)
+        {
+            *bytePtr = 0;
+        }
+
+        *bytePtr |= ((bits >> (bitCount - n)) & ((1u << n) - 1)) << (freeBits - n);
+
+        blockPtr->bitCount += n;
+        bitCount -= n;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read bits from the data in a compressed buffer block.
+ *
+ * @return true if successful, false if the block doesn't hold that many more bits.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReadBits
+(
+    const gorilla_Block_t* blockPtr,
+    uint16_t* bitPosPtr,    ///< [IN/OUT] Bit offset to read from (advanced past the bits read).
+    unsigned int bitCount,  ///< Number of bits to read (up to 64).
+    uint64_t* bitsPtr       ///< [OUT] Bits read, in the least significant bitCount bits.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if ((*bitPosPtr + bitCount) > blockPtr->bitCount)
+    {
+        return false;
+    }
+
+    uint64_t bits = 0;
+
+    while (bitCount > 0)
+    {
+        uint8_t byte = blockPtr->data[*bitPosPtr / 8];
+        unsigned int availableBits = 8 - (*bitPosPtr % 8);
+        unsigned int n = (bitCount < availableBits) ? bitCount : availableBits;
+
+        bits = (bits << n) | ((byte >> (availableBits - n)) & ((1u << n) - 1));
+
+        *bitPosPtr += n;
+        bitCount -= n;
+    }
+
+    *bitsPtr = bits;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reset a codec state to the first sample of a block, which is stored unencoded.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartCodecState
+(
+    gorilla_State_t* statePtr,
+    double timestamp,
+    uint64_t valueBits
+)
+//--------------------------------------------------------------------------------------------------
+{
+    statePtr->timestamp = timestamp;
+    (void)GetTimeUs(timestamp, &statePtr->timeUs);
+    statePtr->deltaUs = 0;
+    statePtr->valueBits = valueBits;
+    statePtr->leading = NO_XOR_WINDOW;
+    statePtr->trailing = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encode a sample's timestamp as the delta-of-delta from the previous two samples' timestamps
+ * (or unencoded, if it isn't a whole number of microseconds or the delta-of-delta is too big).
+ */
+//--------------------------------------------------------------------------------------------------
+static void EncodeTimestamp
+(
+    gorilla_Block_t* blockPtr,
+    gorilla_State_t* statePtr,
+    double timestamp
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int64_t timeUs;
+    bool isExact = GetTimeUs(timestamp, &timeUs);
+    int64_t deltaUs = timeUs - statePtr->timeUs;
+    int64_t deltaOfDelta = deltaUs - statePtr->deltaUs;
+
+    size_t i;
+    for (i = 0; isExact && (i < NUM_ARRAY_MEMBERS(DeltaOfDeltaBits)); i++)
+    {
+        unsigned int bitCount = DeltaOfDeltaBits[i];
+        bool fits;
+
+        if (bitCount == 0)
+        {
+            fits = (deltaOfDelta == 0);
+        }
+        else
+        {
+            int64_t limit = (int64_t)1 << (bitCount - 1);
+
+            fits = ((deltaOfDelta >= -limit) && (deltaOfDelta < limit));
+        }
+
+        if (fits)
+        {
+            // i 1 bits followed by a 0 bit, then the delta-of-delta.
+            WriteBits(blockPtr, ((1u << i) - 1) << 1, i + 1);
+            WriteBits(blockPtr, (uint64_t)deltaOfDelta, bitCount);
+            break;
+        }
+    }
+
+    if ((!isExact) || (i == NUM_ARRAY_MEMBERS(DeltaOfDeltaBits)))
+    {
+        uint64_t bits;
+        memcpy(&bits, &timestamp, sizeof(bits));
+
+        WriteBits(blockPtr, 0x1F, 5);
+        WriteBits(blockPtr, bits, 64);
+    }
+
+    statePtr->timestamp = timestamp;
+    statePtr->timeUs = timeUs;
+    statePtr->deltaUs = deltaUs;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode a sample's timestamp encoded by EncodeTimestamp().
+ *
+ * @return true if successful, false if the block data is corrupt.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool DecodeTimestamp
+(
+    gorilla_Cursor_t* cursorPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    gorilla_State_t* statePtr = &cursorPtr->state;
+    uint64_t bits;
+
+    // Count the 1 bits before the first 0 bit (up to 5).
+    size_t i;
+    for (i = 0; i < NUM_ARRAY_MEMBERS(DeltaOfDeltaBits); i++)
+    {
+        if (!ReadBits(cursorPtr->blockPtr, &cursorPtr->nextBit, 1, &bits))
+        {
+            return false;
+        }
+        if (bits == 0)
+        {
+            break;
+        }
+    }
+
+    int64_t timeUs;
+    int64_t deltaUs;
+
+    if (i == NUM_ARRAY_MEMBERS(DeltaOfDeltaBits))
+    {
+        if (!ReadBits(cursorPtr->blockPtr, &cursorPtr->nextBit, 64, &bits))
+        {
+            return false;
+        }
+        memcpy(&statePtr->timestamp, &bits, sizeof(bits));
+
+        (void)GetTimeUs(statePtr->timestamp, &timeUs);
+        deltaUs = timeUs - statePtr->timeUs;
+    }
+    else
+    {
+        unsigned int bitCount = DeltaOfDeltaBits[i];
+        int64_t deltaOfDelta = 0;
+
+        if (bitCount > 0)
+        {
+            if (!ReadBits(cursorPtr->blockPtr, &cursorPtr->nextBit, bitCount, &bits))
+            {
+                return false;
+            }
+
+            // Sign-extend.
+            deltaOfDelta = ((int64_t)(bits << (64 - bitCount))) >> (64 - bitCount);
+        }
+
+        deltaUs = statePtr->deltaUs + deltaOfDelta;
+        timeUs = statePtr->timeUs + deltaUs;
+        statePtr->timestamp = ((double)timeUs) / 1000000;
+    }
+
+    statePtr->timeUs = timeUs;
+    statePtr->deltaUs = deltaUs;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encode a sample's value as the XOR of its bit pattern with the previous value's.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EncodeValue
+(
+    gorilla_Block_t* blockPtr,
+    gorilla_State_t* statePtr,
+    uint64_t valueBits
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint64_t xorBits = valueBits ^ statePtr->valueBits;
+
+    if (xorBits == 0)
+    {
+        // Same value.
+        WriteBits(blockPtr, 0, 1);
+    }
+    else
+    {
+        unsigned int leading = __builtin_clzll(xorBits);
+        unsigned int trailing = __builtin_ctzll(xorBits);
+
+        // The number of leading zeros is stored in 5 bits.
+        if (leading > 31)
+        {
+            leading = 31;
+        }
+
+        if (   (statePtr->leading != NO_XOR_WINDOW)
+            && (leading >= statePtr->leading)
+            && (trailing >= statePtr->trailing)  )
+        {
+            // The meaningful bits fit in the previous XOR window.
+            WriteBits(blockPtr, 0x2, 2);
+            WriteBits(blockPtr,
+                      xorBits >> statePtr->trailing,
+                      64 - statePtr->leading - statePtr->trailing);
+        }
+        else
+        {
+            // New XOR window.  Its length (1 to 64) is stored in 6 bits, with 64 stored as 0.
+            unsigned int length = 64 - leading - trailing;
+
+            WriteBits(blockPtr, 0x3, 2);
+            WriteBits(blockPtr, leading, 5);
+            WriteBits(blockPtr, length & 0x3F, 6);
+            WriteBits(blockPtr, xorBits >> trailing, length);
+
+            statePtr->leading = leading;
+            statePtr->trailing = trailing;
+        }
+    }
+
+    statePtr->valueBits = valueBits;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode a sample's value encoded by EncodeValue().
+ *
+ * @return true if successful, false if the block data is corrupt.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool DecodeValue
+(
+    gorilla_Cursor_t* cursorPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    gorilla_State_t* statePtr = &cursorPtr->state;
+    uint64_t bits;
+
+    if (!ReadBits(cursorPtr->blockPtr, &cursorPtr->nextBit, 1, &bits))
+    {
+        return false;
+    }
+    if (bits == 0)
+    {
+        // Same value.
+        return true;
+    }
+
+    if (!ReadBits(cursorPtr->blockPtr, &cursorPtr->nextBit, 1, &bits))
+    {
+        return false;
+    }
+    if (bits == 1)
+    {
+        uint64_t leading;
+        uint64_t length;
+
+        if (   (!ReadBits(cursorPtr->blockPtr, &cursorPtr->nextBit, 5, &leading))
+            || (!ReadBits(cursorPtr->blockPtr, &cursorPtr->nextBit, 6, &length))  )
+        {
+            return false;
+        }
+        if (length == 0)
+        {
+            length = 64;
+        }
+        if ((leading + length) > 64)
+        {
+            return false;
+        }
+
+        statePtr->leading = leading;
+        statePtr->trailing = 64 - leading - length;
+    }
+    else if (statePtr->leading == NO_XOR_WINDOW)
+    {
+        return false;
+    }
+
+    unsigned int length = 64 - statePtr->leading - statePtr->trailing;
+
+    if (!ReadBits(cursorPtr->blockPtr, &cursorPtr->nextBit, length, &bits))
+    {
+        return false;
+    }
+
+    statePtr->valueBits ^= (bits << statePtr->trailing);
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Gorilla codec module.
+ *
+ * @warning This function must be called before any others in this module.
+ */
+//--------------------------------------------------------------------------------------------------
+void gorilla_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    BufferPool = le_mem_CreatePool("Compressed Buffer", sizeof(gorilla_Buffer_t));
+    BlockPool = le_mem_CreatePool("Compressed Block", sizeof(gorilla_Block_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an empty compressed buffer.
+ *
+ * @return Pointer to the buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+gorilla_Buffer_t* gorilla_CreateBuffer
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    gorilla_Buffer_t* bufPtr = le_mem_ForceAlloc(BufferPool);
+
+    bufPtr->blockList = LE_SLS_LIST_INIT;
+
+    return bufPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a compressed buffer and all its blocks.
+ */
+//--------------------------------------------------------------------------------------------------
+void gorilla_DeleteBuffer
+(
+    gorilla_Buffer_t* bufPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_sls_Link_t* linkPtr;
+    while ((linkPtr = le_sls_Pop(&bufPtr->blockList)) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, gorilla_Block_t, link));
+    }
+
+    le_mem_Release(bufPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a sample to a compressed buffer, starting a new block if the newest one is full.
+ */
+//--------------------------------------------------------------------------------------------------
+void gorilla_Append
+(
+    gorilla_Buffer_t* bufPtr,
+    double timestamp,
+    double value
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint64_t valueBits;
+    memcpy(&valueBits, &value, sizeof(valueBits));
+
+    gorilla_Block_t* blockPtr = NULL;
+
+    le_sls_Link_t* linkPtr = le_sls_PeekTail(&bufPtr->blockList);
+    if (linkPtr != NULL)
+    {
+        blockPtr = CONTAINER_OF(linkPtr, gorilla_Block_t, link);
+    }
+
+    if (   (blockPtr == NULL)
+        || ((blockPtr->bitCount + MAX_ENCODED_SAMPLE_BITS) > GORILLA_BLOCK_BITS)  )
+    {
+        blockPtr = le_mem_ForceAlloc(BlockPool);
+
+        blockPtr->link = LE_SLS_LINK_INIT;
+        blockPtr->firstTimestamp = timestamp;
+        blockPtr->count = 0;
+        blockPtr->bitCount = 0;
+
+        le_sls_Queue(&bufPtr->blockList, &blockPtr->link);
+
+        // The first sample in a block is stored unencoded.
+        uint64_t timeBits;
+        memcpy(&timeBits, &timestamp, sizeof(timeBits));
+
+        WriteBits(blockPtr, timeBits, 64);
+        WriteBits(blockPtr, valueBits, 64);
+
+        StartCodecState(&bufPtr->newest, timestamp, valueBits);
+    }
+    else
+    {
+        EncodeTimestamp(blockPtr, &bufPtr->newest, timestamp);
+        EncodeValue(blockPtr, &bufPtr->newest, valueBits);
+    }
+
+    (blockPtr->count)++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position a block cursor on the first sample in a compressed buffer block.
+ *
+ * @return true if successful, false if the block is empty or its data is corrupt.
+ */
+//--------------------------------------------------------------------------------------------------
+bool gorilla_StartCursor
+(
+    gorilla_Cursor_t* cursorPtr,
+    gorilla_Block_t* blockPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    cursorPtr->blockPtr = blockPtr;
+    cursorPtr->nextIndex = 0;
+    cursorPtr->nextBit = 0;
+
+    return gorilla_DecodeNext(cursorPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode the next sample in a compressed buffer block.
+ *
+ * @return true if successful, false if there are no more samples in the block or its data is
+ *         corrupt.
+ */
+//--------------------------------------------------------------------------------------------------
+bool gorilla_DecodeNext
+(
+    gorilla_Cursor_t* cursorPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (cursorPtr->nextIndex >= cursorPtr->blockPtr->count)
+    {
+        return false;
+    }
+
+    if (cursorPtr->nextIndex == 0)
+    {
+        uint64_t timeBits;
+        uint64_t valueBits;
+
+        if (   (!ReadBits(cursorPtr->blockPtr, &cursorPtr->nextBit, 64, &timeBits))
+            || (!ReadBits(cursorPtr->blockPtr, &cursorPtr->nextBit, 64, &valueBits))  )
+        {
+            return false;
+        }
+
+        double timestamp;
+        memcpy(&timestamp, &timeBits, sizeof(timestamp));
+
+        StartCodecState(&cursorPtr->state, timestamp, valueBits);
+    }
+    else if ((!DecodeTimestamp(cursorPtr)) || (!DecodeValue(cursorPtr)))
+    {
+        return false;
+    }
+
+    (cursorPtr->nextIndex)++;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move a block cursor on to the next sample in a compressed buffer, in the same block or the next.
+ *
+ * @return true if successful, false if there are no more samples.
+ */
+//--------------------------------------------------------------------------------------------------
+bool gorilla_AdvanceCursor
+(
+    gorilla_Buffer_t* bufPtr,
+    gorilla_Cursor_t* cursorPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (cursorPtr->nextIndex < cursorPtr->blockPtr->count)
+    {
+        return gorilla_DecodeNext(cursorPtr);
+    }
+
+    le_sls_Link_t* linkPtr = le_sls_PeekNext(&bufPtr->blockList, &cursorPtr->blockPtr->link);
+    if (linkPtr == NULL)
+    {
+        return false;
+    }
+
+    return gorilla_StartCursor(cursorPtr, CONTAINER_OF(linkPtr, gorilla_Block_t, link));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the value of the sample a block cursor is positioned on.
+ *
+ * @return The value.
+ */
+//--------------------------------------------------------------------------------------------------
+double gorilla_GetValue
+(
+    const gorilla_State_t* statePtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    double value;
+
+    memcpy(&value, &statePtr->valueBits, sizeof(value));
+
+    return value;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the oldest block of a compressed buffer, along with the samples still buffered in it,
+ * and move the buffer's oldest cursor on to the first sample in the next block.
+ *
+ * @return The number of buffered samples released.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t gorilla_ReleaseOldestBlock
+(
+    gorilla_Buffer_t* bufPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    gorilla_Cursor_t* oldestPtr = &bufPtr->oldest;
+
+    // The sample the cursor is positioned on is still buffered, as are the ones after it.
+    size_t count = oldestPtr->blockPtr->count - oldestPtr->nextIndex + 1;
+
+    le_sls_Pop(&bufPtr->blockList);
+    le_mem_Release(oldestPtr->blockPtr);
+
+    le_sls_Link_t* linkPtr = le_sls_Peek(&bufPtr->blockList);
+    if (linkPtr != NULL)
+    {
+        (void)gorilla_StartCursor(oldestPtr, CONTAINER_OF(linkPtr, gorilla_Block_t, link));
+    }
+
+    return count;
+}
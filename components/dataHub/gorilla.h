@@ -0,0 +1,189 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file gorilla.h
+ *
+ * Interface to the Gorilla codec module, which encodes numeric data samples into the blocks of
+ * compressed data sample buffers, and decodes them again.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef GORILLA_H_INCLUDE_GUARD
+#define GORILLA_H_INCLUDE_GUARD
+
+
+/// Number of bytes of encoded samples held in each block of a compressed buffer.
+#define GORILLA_BLOCK_BYTES 240
+
+/// Number of bits of encoded samples held in each block of a compressed buffer.
+#define GORILLA_BLOCK_BITS (GORILLA_BLOCK_BYTES * 8)
+
+
+/// Encoder (or decoder) state of a compressed buffer block, as of the last sample encoded (or
+/// decoded).
+typedef struct
+{
+    double timestamp;   ///< Timestamp of the last sample.
+    int64_t timeUs;     ///< Timestamp of the last sample in whole microseconds (rounded).
+    int64_t deltaUs;    ///< Difference between the timeUs of the last two samples.
+    uint64_t valueBits; ///< Bit pattern of the last sample's value.
+    uint8_t leading;    ///< Leading zero bits of the last XOR window (NO_XOR_WINDOW if none).
+    uint8_t trailing;   ///< Trailing zero bits of the last XOR window.
+}
+gorilla_State_t;
+
+
+/// Block of encoded samples in a compressed buffer.
+typedef struct
+{
+    le_sls_Link_t link;     ///< Link in the compressed buffer's list of blocks.
+    double firstTimestamp;  ///< Timestamp of the first sample in the block.
+    uint16_t count;         ///< Number of samples encoded in the block.
+    uint16_t bitCount;      ///< Number of bits of data in use.
+    uint8_t data[GORILLA_BLOCK_BYTES]; ///< Encoded samples (most significant bit first).
+}
+gorilla_Block_t;
+
+
+/// Position of a decoded sample in a block of a compressed buffer.
+typedef struct
+{
+    gorilla_Block_t* blockPtr;  ///< Block holding the sample.
+    uint16_t nextIndex;         ///< Index within the block of the sample after this one.
+    uint16_t nextBit;           ///< Bit offset within the block's data of the next sample.
+    gorilla_State_t state;      ///< Decoder state, holding this sample's timestamp and value.
+}
+gorilla_Cursor_t;
+
+
+/// Numeric data sample buffer held as a list of blocks of encoded samples.
+typedef struct
+{
+    le_sls_List_t blockList;    ///< Blocks of encoded samples, oldest first.
+    gorilla_Cursor_t oldest;    ///< Position of the oldest buffered sample (if not empty).
+    gorilla_State_t newest;     ///< Encoder state as of the newest buffered sample.
+}
+gorilla_Buffer_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Gorilla codec module.
+ *
+ * @warning This function must be called before any others in this module.
+ */
+//--------------------------------------------------------------------------------------------------
+void gorilla_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an empty compressed buffer.
+ *
+ * @return Pointer to the buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+gorilla_Buffer_t* gorilla_CreateBuffer
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a compressed buffer and all its blocks.
+ */
+//--------------------------------------------------------------------------------------------------
+void gorilla_DeleteBuffer
+(
+    gorilla_Buffer_t* bufPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a sample to a compressed buffer, starting a new block if the newest one is full.
+ */
+//--------------------------------------------------------------------------------------------------
+void gorilla_Append
+(
+    gorilla_Buffer_t* bufPtr,
+    double timestamp,
+    double value
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position a block cursor on the first sample in a compressed buffer block.
+ *
+ * @return true if successful, false if the block is empty or its data is corrupt.
+ */
+//--------------------------------------------------------------------------------------------------
+bool gorilla_StartCursor
+(
+    gorilla_Cursor_t* cursorPtr,
+    gorilla_Block_t* blockPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode the next sample in a compressed buffer block.
+ *
+ * @return true if successful, false if there are no more samples in the block or its data is
+ *         corrupt.
+ */
+//--------------------------------------------------------------------------------------------------
+bool gorilla_DecodeNext
+(
+    gorilla_Cursor_t* cursorPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move a block cursor on to the next sample in a compressed buffer, in the same block or the next.
+ *
+ * @return true if successful, false if there are no more samples.
+ */
+//--------------------------------------------------------------------------------------------------
+bool gorilla_AdvanceCursor
+(
+    gorilla_Buffer_t* bufPtr,
+    gorilla_Cursor_t* cursorPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the value of the sample a block cursor is positioned on.
+ *
+ * @return The value.
+ */
+//--------------------------------------------------------------------------------------------------
+double gorilla_GetValue
+(
+    const gorilla_State_t* statePtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the oldest block of a compressed buffer, along with the samples still buffered in it,
+ * and move the buffer's oldest cursor on to the first sample in the next block.
+ *
+ * @return The number of buffered samples released.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t gorilla_ReleaseOldestBlock
+(
+    gorilla_Buffer_t* bufPtr
+);
+
+
+#endif // GORILLA_H_INCLUDE_GUARD
@@ -0,0 +1,271 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file histogram.c
+ *
+ * Implementation of the Histogram module.
+ *
+ * Bucket 0 counts the values below the first boundary, and each boundary is the lowest value
+ * counted in the bucket above it.  Values are counted as they are added and can't be removed
+ * again, so a histogram takes the same (fixed) amount of memory however many values it counts.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "dataHub.h"
+#include "histogram.h"
+
+
+/// Histogram of numerical values.  Allocated from the Histogram Pool.
+typedef struct histogram_Histogram
+{
+    size_t boundCount;  ///< Number of bucket boundaries (one less than the number of buckets).
+    double bounds[IO_MAX_HISTOGRAM_BUCKETS - 1]; ///< Bucket boundaries, in increasing order.
+    uint64_t counts[IO_MAX_HISTOGRAM_BUCKETS];   ///< Number of values counted in each bucket.
+    uint64_t windowCounts[IO_MAX_HISTOGRAM_BUCKETS]; ///< Counts in the aggregation window.
+}
+Histogram_t;
+
+
+/// Pool of Histogram objects.
+static le_mem_PoolRef_t HistogramPool = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the histogram bucket that a value falls into.
+ *
+ * @return The bucket's index.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetBucket
+(
+    const Histogram_t* histogramPtr,
+    double value
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t low = 0;
+    size_t high = histogramPtr->boundCount;
+
+    // Count the boundaries that are less than or equal to the value.
+    while (low < high)
+    {
+        size_t middle = low + ((high - low) / 2);
+
+        if (value >= histogramPtr->bounds[middle])
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Histogram module.
+ *
+ * @warning This function must be called before any others in this module.
+ */
+//--------------------------------------------------------------------------------------------------
+void histogram_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    HistogramPool = le_mem_CreatePool("Histogram", sizeof(Histogram_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a histogram with all its counts at zero.
+ *
+ * @return Reference to the histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+histogram_Ref_t histogram_Create
+(
+    const double* boundsPtr,    ///< Bucket boundaries, finite and in increasing order.
+    size_t boundCount           ///< Number of boundaries (< IO_MAX_HISTOGRAM_BUCKETS).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(boundCount < IO_MAX_HISTOGRAM_BUCKETS);
+
+    Histogram_t* histogramPtr = le_mem_ForceAlloc(HistogramPool);
+
+    memset(histogramPtr, 0, sizeof(*histogramPtr));
+    memcpy(histogramPtr->bounds, boundsPtr, boundCount * sizeof(double));
+    histogramPtr->boundCount = boundCount;
+
+    return histogramPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+void histogram_Delete
+(
+    histogram_Ref_t histogramRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_mem_Release(histogramRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count a value in a histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+void histogram_Add
+(
+    histogram_Ref_t histogramRef,
+    double value        ///< The (non-NAN) value.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    (histogramRef->counts[GetBucket(histogramRef, value)])++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count a value in a histogram's current aggregation window.
+ */
+//--------------------------------------------------------------------------------------------------
+void histogram_AddToWindow
+(
+    histogram_Ref_t histogramRef,
+    double value        ///< The (non-NAN) value.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    (histogramRef->windowCounts[GetBucket(histogramRef, value)])++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a new (empty) aggregation window for a histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+void histogram_ResetWindow
+(
+    histogram_Ref_t histogramRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    memset(histogramRef->windowCounts, 0, sizeof(histogramRef->windowCounts));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a JSON data sample holding the boundaries of a histogram and the counts in its buckets
+ * for the current aggregation window, such as {"bounds":[10,20],"counts":[3,5,0]}.
+ *
+ * @return Reference to the new data sample.
+ */
+//--------------------------------------------------------------------------------------------------
+dataSample_Ref_t histogram_CreateWindowSample
+(
+    histogram_Ref_t histogramRef,
+    double timestamp    ///< Seconds since the Epoch.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Room for every boundary and count (at most 24 characters each, with the comma), plus the
+    // member names and brackets.
+    char json[(IO_MAX_HISTOGRAM_BUCKETS * 2 * 24) + 32];
+    size_t len = 0;
+    size_t i;
+
+    len += snprintf(json + len, sizeof(json) - len, "{\"bounds\":[");
+    for (i = 0; i < histogramRef->boundCount; i++)
+    {
+        len += snprintf(json + len,
+                        sizeof(json) - len,
+                        "%s%.15g",
+                        (i > 0) ? "," : "",
+                        histogramRef->bounds[i]);
+    }
+
+    len += snprintf(json + len, sizeof(json) - len, "],\"counts\":[");
+    for (i = 0; i <= histogramRef->boundCount; i++)
+    {
+        len += snprintf(json + len,
+                        sizeof(json) - len,
+                        "%s%" PRIu64,
+                        (i > 0) ? "," : "",
+                        histogramRef->windowCounts[i]);
+    }
+
+    snprintf(json + len, sizeof(json) - len, "]}");
+
+    return dataSample_CreateJson(timestamp, json);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the bucket boundaries of a histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+void histogram_GetBounds
+(
+    histogram_Ref_t histogramRef,
+    double* boundsPtr,      ///< [OUT] Bucket boundaries, in increasing order.
+    size_t* boundsSizePtr   ///< [INOUT] Room in the array, then number of boundaries.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (*boundsSizePtr > histogramRef->boundCount)
+    {
+        *boundsSizePtr = histogramRef->boundCount;
+    }
+
+    memcpy(boundsPtr, histogramRef->bounds, *boundsSizePtr * sizeof(double));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the counts in each bucket of a histogram.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_OVERFLOW if the array is too small to hold all the counts.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t histogram_GetCounts
+(
+    histogram_Ref_t histogramRef,
+    uint64_t* countsPtr,    ///< [OUT] Number of values in each bucket, lowest bucket first.
+    size_t* countsSizePtr   ///< [INOUT] Room in the array, then number of buckets.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t bucketCount = histogramRef->boundCount + 1;
+    if (*countsSizePtr < bucketCount)
+    {
+        return LE_OVERFLOW;
+    }
+
+    memcpy(countsPtr, histogramRef->counts, bucketCount * sizeof(uint64_t));
+    *countsSizePtr = bucketCount;
+
+    return LE_OK;
+}
@@ -0,0 +1,143 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file histogram.h
+ *
+ * Interface to the Histogram module, which counts numerical values in buckets with fixed
+ * boundaries.  As well as the counts of every value added since the histogram was created, a
+ * histogram keeps the counts for the current aggregation window.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef HISTOGRAM_H_INCLUDE_GUARD
+#define HISTOGRAM_H_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a Histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct histogram_Histogram* histogram_Ref_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Histogram module.
+ *
+ * @warning This function must be called before any others in this module.
+ */
+//--------------------------------------------------------------------------------------------------
+void histogram_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a histogram with all its counts at zero.
+ *
+ * @return Reference to the histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+histogram_Ref_t histogram_Create
+(
+    const double* boundsPtr,    ///< Bucket boundaries, finite and in increasing order.
+    size_t boundCount           ///< Number of boundaries (< IO_MAX_HISTOGRAM_BUCKETS).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+void histogram_Delete
+(
+    histogram_Ref_t histogramRef
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count a value in a histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+void histogram_Add
+(
+    histogram_Ref_t histogramRef,
+    double value        ///< The (non-NAN) value.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count a value in a histogram's current aggregation window.
+ */
+//--------------------------------------------------------------------------------------------------
+void histogram_AddToWindow
+(
+    histogram_Ref_t histogramRef,
+    double value        ///< The (non-NAN) value.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a new (empty) aggregation window for a histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+void histogram_ResetWindow
+(
+    histogram_Ref_t histogramRef
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a JSON data sample holding the boundaries of a histogram and the counts in its buckets
+ * for the current aggregation window, such as {"bounds":[10,20],"counts":[3,5,0]}.
+ *
+ * @return Reference to the new data sample.
+ */
+//--------------------------------------------------------------------------------------------------
+dataSample_Ref_t histogram_CreateWindowSample
+(
+    histogram_Ref_t histogramRef,
+    double timestamp    ///< Seconds since the Epoch.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the bucket boundaries of a histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+void histogram_GetBounds
+(
+    histogram_Ref_t histogramRef,
+    double* boundsPtr,      ///< [OUT] Bucket boundaries, in increasing order.
+    size_t* boundsSizePtr   ///< [INOUT] Room in the array, then number of boundaries.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the counts in each bucket of a histogram.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_OVERFLOW if the array is too small to hold all the counts.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t histogram_GetCounts
+(
+    histogram_Ref_t histogramRef,
+    uint64_t* countsPtr,    ///< [OUT] Number of values in each bucket, lowest bucket first.
+    size_t* countsSizePtr   ///< [INOUT] Room in the array, then number of buckets.
+);
+
+
+#endif // HISTOGRAM_H_INCLUDE_GUARD
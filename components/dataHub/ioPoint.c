@@ -23,10 +23,28 @@ typedef struct ioResource
     io_DataType_t dataType;     ///< Data type of this resource.
     le_dls_List_t pollHandlerList;  ///< List of Poll Handler callbacks the client app registered.
     bool isMandatory;   ///< true = this is a mandatory output; false otherwise.
+    le_dls_List_t handleList;   ///< List of handles open on this resource.
 }
 IoResource_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * A handle open on an Input or Output Resource, so that data samples can be pushed to it without
+ * looking up its path in the resource tree every time.
+ *
+ * A handle outlives the resource it was opened on, so if the resource is deleted, the handle is
+ * detached from it (ioPtr is set to NULL) rather than being left dangling.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct ioPoint_Handle
+{
+    le_dls_Link_t link;     ///< Used to link into the resource's handleList.
+    IoResource_t* ioPtr;    ///< Resource the handle is open on (NULL if the resource was deleted).
+}
+IoHandle_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Pool from which I/O Resource objects are allocated.
@@ -35,6 +53,14 @@ IoResource_t;
 static le_mem_PoolRef_t IoResourcePool = NULL;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool from which I/O Handle objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t IoHandlePool = NULL;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Destructor for IoResource_t objects.
@@ -48,6 +74,13 @@ static void IoResourceDestructor
 {
     IoResource_t* ioPtr = objPtr;
 
+    // Detach any handles still open on this resource, so pushes through them will be dropped.
+    le_dls_Link_t* linkPtr;
+    while ((linkPtr = le_dls_Pop(&ioPtr->handleList)) != NULL)
+    {
+        CONTAINER_OF(linkPtr, IoHandle_t, link)->ioPtr = NULL;
+    }
+
     res_Destruct(&ioPtr->resource);
 }
 
@@ -67,6 +100,8 @@ void ioPoint_Init
 {
     IoResourcePool = le_mem_CreatePool("I/O Resource", sizeof(IoResource_t));
     le_mem_SetDestructor(IoResourcePool, IoResourceDestructor);
+
+    IoHandlePool = le_mem_CreatePool("I/O Handle", sizeof(IoHandle_t));
 }
 
 
@@ -89,6 +124,7 @@ IoResource_t* Create
     res_Construct(&ioPtr->resource, entryRef);
 
     ioPtr->pollHandlerList = LE_DLS_LIST_INIT;
+    ioPtr->handleList = LE_DLS_LIST_INIT;
 
     ioPtr->dataType = dataType;
     ioPtr->isMandatory = false;
@@ -343,3 +379,71 @@ bool ioPoint_IsMandatory
 
     return ioPtr->isMandatory;
 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a handle on an Input or Output resource.
+ *
+ * @return Reference to the handle.  Must be closed using ioPoint_CloseHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+ioPoint_HandleRef_t ioPoint_OpenHandle
+(
+    res_Resource_t* resPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    IoResource_t* ioPtr = CONTAINER_OF(resPtr, IoResource_t, resource);
+
+    IoHandle_t* handlePtr = le_mem_ForceAlloc(IoHandlePool);
+
+    handlePtr->link = LE_DLS_LINK_INIT;
+    handlePtr->ioPtr = ioPtr;
+
+    le_dls_Queue(&ioPtr->handleList, &handlePtr->link);
+
+    return handlePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a handle opened using ioPoint_OpenHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+void ioPoint_CloseHandle
+(
+    ioPoint_HandleRef_t handleRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (handleRef->ioPtr != NULL)
+    {
+        le_dls_Remove(&handleRef->ioPtr->handleList, &handleRef->link);
+    }
+
+    le_mem_Release(handleRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the resource a handle is open on.
+ *
+ * @return Ptr to the resource, or NULL if the resource has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+res_Resource_t* ioPoint_GetHandleResource
+(
+    ioPoint_HandleRef_t handleRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (handleRef->ioPtr == NULL)
+    {
+        return NULL;
+    }
+
+    return &(handleRef->ioPtr->resource);
+}
@@ -128,4 +128,41 @@ bool ioPoint_IsMandatory
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a handle on an Input or Output resource.
+ *
+ * @return Reference to the handle.  Must be closed using ioPoint_CloseHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+ioPoint_HandleRef_t ioPoint_OpenHandle
+(
+    res_Resource_t* resPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a handle opened using ioPoint_OpenHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+void ioPoint_CloseHandle
+(
+    ioPoint_HandleRef_t handleRef
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the resource a handle is open on.
+ *
+ * @return Ptr to the resource, or NULL if the resource has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+res_Resource_t* ioPoint_GetHandleResource
+(
+    ioPoint_HandleRef_t handleRef
+);
+
+
 #endif // IO_POINT_H_INCLUDE_GUARD
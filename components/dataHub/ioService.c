@@ -43,6 +43,47 @@ static le_dls_List_t UpdateStartEndHandlerList = LE_DLS_LIST_INIT;
 static le_mem_PoolRef_t UpdateStartEndHandlerPool = NULL;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resource handle obtained by a client through the I/O API.
+ *
+ * These are allocated from the ResourceHandlePool.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t link; ///< Used to link into the ResourceHandleList.
+    io_ResourceHandleRef_t safeRef; ///< Safe reference passed to the client.
+    le_msg_SessionRef_t sessionRef; ///< IPC session of the client that got the handle.
+    ioPoint_HandleRef_t ioHandleRef; ///< Handle open on the Input or Output resource.
+}
+ResourceHandle_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of resource handles held by clients.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t ResourceHandleList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of ResourceHandle objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ResourceHandlePool = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Safe reference map for ResourceHandle objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_ref_MapRef_t ResourceHandleRefMap = NULL;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the resource at a given path within the app's namespace.
@@ -470,6 +511,297 @@ void io_PushJson
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a handle on an Input or Output resource in the client app's namespace, for pushing data
+ * samples to it without having its path looked up for every push.
+ *
+ * @return Reference to the handle, or NULL if the resource doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+io_ResourceHandleRef_t io_GetResourceHandle
+(
+    const char* path
+        ///< [IN] Resource path within the client app's namespace.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t resRef = FindResource(path);
+    if (resRef == NULL)
+    {
+        return NULL;
+    }
+
+    ResourceHandle_t* handlePtr = le_mem_ForceAlloc(ResourceHandlePool);
+
+    handlePtr->link = LE_DLS_LINK_INIT;
+    handlePtr->safeRef = le_ref_CreateRef(ResourceHandleRefMap, handlePtr);
+    handlePtr->sessionRef = io_GetClientSessionRef();
+    handlePtr->ioHandleRef = resTree_OpenHandle(resRef);
+
+    le_dls_Queue(&ResourceHandleList, &handlePtr->link);
+
+    return handlePtr->safeRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look up a resource handle held by the client.  Kills the client if the reference is invalid.
+ *
+ * @return Ptr to the handle, or NULL if the reference is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static ResourceHandle_t* GetResourceHandle
+(
+    io_ResourceHandleRef_t handleRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ResourceHandle_t* handlePtr = le_ref_Lookup(ResourceHandleRefMap, handleRef);
+
+    if ((handlePtr == NULL) || (handlePtr->sessionRef != io_GetClientSessionRef()))
+    {
+        LE_KILL_CLIENT("Invalid resource handle reference %p.", handleRef);
+        return NULL;
+    }
+
+    return handlePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a resource handle and free it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteResourceHandle
+(
+    ResourceHandle_t* handlePtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Remove(&ResourceHandleList, &handlePtr->link);
+
+    resTree_CloseHandle(handlePtr->ioHandleRef);
+
+    le_ref_DeleteRef(ResourceHandleRefMap, handlePtr->safeRef);
+
+    le_mem_Release(handlePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a handle obtained using io_GetResourceHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+void io_ReleaseResourceHandle
+(
+    io_ResourceHandleRef_t handle
+        ///< [IN]
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ResourceHandle_t* handlePtr = GetResourceHandle(handle);
+
+    if (handlePtr != NULL)
+    {
+        DeleteResourceHandle(handlePtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the resource a client's resource handle is open on, for pushing to it.
+ *
+ * @return Reference to the resource, or NULL if the handle is invalid (client has been killed)
+ *         or the resource has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+static resTree_EntryRef_t GetHandleResource
+(
+    io_ResourceHandleRef_t handleRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ResourceHandle_t* handlePtr = GetResourceHandle(handleRef);
+    if (handlePtr == NULL)
+    {
+        return NULL;
+    }
+
+    resTree_EntryRef_t resRef = resTree_GetHandleEntry(handlePtr->ioHandleRef);
+    if (resRef == NULL)
+    {
+        LE_ERROR("Client tried to push data through a handle on a deleted resource.");
+    }
+
+    return resRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a trigger type data sample through a resource handle.
+ */
+//--------------------------------------------------------------------------------------------------
+void io_PushTriggerH
+(
+    io_ResourceHandleRef_t handle,
+        ///< [IN] Handle obtained using io_GetResourceHandle().
+    double timestamp
+        ///< [IN] Timestamp in seconds since the Epoch 1970-01-01 00:00:00 +0000 (UTC).
+        ///< Zero = now.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t resRef = GetHandleResource(handle);
+    if (resRef == NULL)
+    {
+        return;
+    }
+
+    // Create a Data Sample object for this new sample.
+    dataSample_Ref_t sampleRef = dataSample_CreateTrigger(timestamp);
+
+    // Push the sample to the Resource.
+    resTree_Push(resRef, IO_DATA_TYPE_TRIGGER, sampleRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a Boolean type data sample through a resource handle.
+ */
+//--------------------------------------------------------------------------------------------------
+void io_PushBooleanH
+(
+    io_ResourceHandleRef_t handle,
+        ///< [IN] Handle obtained using io_GetResourceHandle().
+    double timestamp,
+        ///< [IN] Timestamp in seconds since the Epoch 1970-01-01 00:00:00 +0000 (UTC).
+        ///< Zero = now.
+    bool value
+        ///< [IN]
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t resRef = GetHandleResource(handle);
+    if (resRef == NULL)
+    {
+        return;
+    }
+
+    // Create a Data Sample object for this new sample.
+    dataSample_Ref_t sampleRef = dataSample_CreateBoolean(timestamp, value);
+
+    // Push the sample to the Resource.
+    resTree_Push(resRef, IO_DATA_TYPE_BOOLEAN, sampleRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a numeric type data sample through a resource handle.
+ */
+//--------------------------------------------------------------------------------------------------
+void io_PushNumericH
+(
+    io_ResourceHandleRef_t handle,
+        ///< [IN] Handle obtained using io_GetResourceHandle().
+    double timestamp,
+        ///< [IN] Timestamp in seconds since the Epoch 1970-01-01 00:00:00 +0000 (UTC).
+        ///< Zero = now.
+    double value
+        ///< [IN]
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t resRef = GetHandleResource(handle);
+    if (resRef == NULL)
+    {
+        return;
+    }
+
+    // Create a Data Sample object for this new sample.
+    dataSample_Ref_t sampleRef = dataSample_CreateNumeric(timestamp, value);
+
+    // Push the sample to the Resource.
+    resTree_Push(resRef, IO_DATA_TYPE_NUMERIC, sampleRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a string type data sample through a resource handle.
+ */
+//--------------------------------------------------------------------------------------------------
+void io_PushStringH
+(
+    io_ResourceHandleRef_t handle,
+        ///< [IN] Handle obtained using io_GetResourceHandle().
+    double timestamp,
+        ///< [IN] Timestamp in seconds since the Epoch 1970-01-01 00:00:00 +0000 (UTC).
+        ///< Zero = now.
+    const char* value
+        ///< [IN]
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t resRef = GetHandleResource(handle);
+    if (resRef == NULL)
+    {
+        return;
+    }
+
+    // Create a Data Sample object for this new sample.
+    dataSample_Ref_t sampleRef = dataSample_CreateString(timestamp, value);
+
+    // Push the sample to the Resource.
+    resTree_Push(resRef, IO_DATA_TYPE_STRING, sampleRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a JSON data sample through a resource handle.
+ */
+//--------------------------------------------------------------------------------------------------
+void io_PushJsonH
+(
+    io_ResourceHandleRef_t handle,
+        ///< [IN] Handle obtained using io_GetResourceHandle().
+    double timestamp,
+        ///< [IN] Timestamp in seconds since the Epoch 1970-01-01 00:00:00 +0000 (UTC).
+        ///< Zero = now.
+    const char* value
+        ///< [IN]
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t resRef = GetHandleResource(handle);
+    if (resRef == NULL)
+    {
+        return;
+    }
+
+    if (json_IsValid(value))
+    {
+        // Create a Data Sample object for this new sample.
+        dataSample_Ref_t sampleRef = dataSample_CreateJson(timestamp, value);
+
+        // Push the sample to the Resource.
+        resTree_Push(resRef, IO_DATA_TYPE_JSON, sampleRef);
+    }
+    else
+    {
+        LE_WARN("Rejecting invalid JSON string '%s'.", value);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Add a handler function to be called when a value is pushed to (and accepted by) an Input
@@ -1196,6 +1528,36 @@ static void CallUpdateStartEndHandlers
 }
 
 
+#ifndef UNIT_TEST
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the resource handles still held by a client when its session closes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SessionCloseHandler
+(
+    le_msg_SessionRef_t sessionRef,
+    void* contextPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&ResourceHandleList);
+
+    while (linkPtr != NULL)
+    {
+        ResourceHandle_t* handlePtr = CONTAINER_OF(linkPtr, ResourceHandle_t, link);
+
+        linkPtr = le_dls_PeekNext(&ResourceHandleList, linkPtr);
+
+        if (handlePtr->sessionRef == sessionRef)
+        {
+            DeleteResourceHandle(handlePtr);
+        }
+    }
+}
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initializes the module.  Must be called before any other functions in the module are called.
@@ -1209,6 +1571,14 @@ void ioService_Init
 {
     UpdateStartEndHandlerPool = le_mem_CreatePool("UpdateStartEndHandlers",
                                                   sizeof(UpdateStartEndHandler_t));
+
+    ResourceHandlePool = le_mem_CreatePool("Resource Handle", sizeof(ResourceHandle_t));
+
+    ResourceHandleRefMap = le_ref_CreateMap("Resource Handle", 7);
+
+#ifndef UNIT_TEST
+    le_msg_AddServiceCloseHandler(io_GetServiceRef(), SessionCloseHandler, NULL);
+#endif
 }
 
 
@@ -4,28 +4,76 @@
  *
  * Implementation of Observations.
  *
+ * Each Observation's data sample buffer is a ring of BufferSlot_t records held in a single array
+ * that is sized by obs_SetBufferMaxCount().  Numeric, Boolean and trigger samples are stored
+ * inline in their slots (timestamp and value), so they don't need a Data Sample object each.
+ * String and JSON slots hold a reference to a Data Sample object containing the value.
+ *
+ * If buffer compression is enabled, numeric samples are instead buffered in a list of fixed-size
+ * blocks of encoded samples (see gorilla.c), and the oldest samples are discarded a whole block
+ * at a time.
+ *
+ * If buffer persistence is enabled, trigger, Boolean and numeric samples are instead buffered in a
+ * ring file under BACKUP_DIR (named like the backup file, but with RING_SUFFIX), which is mapped
+ * into memory and used as the buffer in place (see ringFile.c).  Ring files are synced by the
+ * Backup Thread, at most once per the Observation's sync period.  When persistence is enabled for
+ * an empty buffer, the ring file left by a previous run is used in place, without reading it into
+ * memory.
+ *
+ * An Observation can also keep rollup tiers of numerical history alongside its buffer.  Each tier
+ * is a ring of buckets summarizing (count, mean, sum of squares, min and max) the values received
+ * during consecutive fixed-length periods, such as 1 minute or 1 hour.  Tiers let long-range
+ * buffer statistics queries be answered without buffering every sample for the whole range.
+ *
+ * An Observation can also keep a quantile sketch of the numerical values in its buffer (see
+ * quantile.c), so that percentile queries don't have to sort the buffer.  Segments of the sketch
+ * are dropped as their values leave the buffer.  The sketch isn't backed up; it is rebuilt from
+ * the buffer when needed.
+ *
+ * An Observation can also keep a histogram of the numerical values it receives, counted in
+ * buckets with fixed boundaries (see histogram.c).  The histogram doesn't depend on the buffer:
+ * each value is counted as it arrives, and can't be removed again, so the histogram covers every
+ * value received since the boundaries were set.  Like the sketch, the histogram isn't backed up.
+ *
  * Data sample buffer backup files are kept under BACKUP_DIR.  Their file system paths relative
  * to BACKUP_DIR are the same as their resource paths relative to the /obs/ namespace in the
  * resource tree.
+ * Backup files that no Observation with backups enabled is using are deleted at the end of each
+ * administrative update.  They are tracked in a list that is built by walking BACKUP_DIR once at
+ * start-up, and then kept up to date as Observations' backup periods change, so that clean-ups
+ * don't have to walk the directory tree again.  Ring files are tracked the same way, and kept
+ * for as long as an Observation has buffer persistence enabled.
+ *
+ * Rather than rewriting the whole buffer every backup period, a backup normally just appends the
+ * samples added since the last backup to a journal file kept next to the backup file (with
+ * JOURNAL_SUFFIX appended to its name).  Once the journal holds more samples than the buffer, or
+ * something other than new samples has changed (such as the buffer size or data type), the next
+ * backup writes a new snapshot of the whole buffer and starts a new, empty journal.  Restoring
+ * replays the journal on top of the snapshot.
+ *
+ * Backups are scheduled by a single timer shared by all the Observations.  An Observation waiting
+ * for its backup period to pass is kept in a list sorted by due time, and when the timer expires
+ * all the backups that are due are written together, followed by a single sync of the backup file
+ * system to make the journal appends durable.
  *
- * The data sample buffer backup file format looks like this (little-endian byte order):
- *
- * - file format version byte = 0
- * - data type byte containing one of the following ASCII characters:
- *       t = trigger
- *       b = Boolean
- *       n = numeric
- *       s = string
- *       j = JSON
- * - number of records = 4-byte unsigned integer
- * - array of records, sorted oldest-first, each containing:
- *       - timestamp (8-byte IEEE double-precision floating point value)
- *       - value, depending on data type, as follows:
- *             t -> no value
- *             b -> 1 byte, 0 = false, 1 = true
- *             n -> 8-byte IEEE double-precision floating point value
- *             s -> 4-byte unsigned integer length, followed by string content (no null-terminator)
- *             j -> 4-byte unsigned integer length, followed by JSON string content (no term char)
+ * Backup files are written (and deleted) by the Backup Thread (see backupThread.c), so that the
+ * main thread can keep routing data samples while a backup is being serialized and committed.
+ * Each backup job holds its own copy of everything it writes (buffered string and JSON values are
+ * shared by holding a reference on their Data Samples), so the Observation can keep changing
+ * meanwhile.  The Backup Thread does the jobs in the order they were queued, and then passes each
+ * one back to the main thread to update the Observation's backup state.  An Observation only has
+ * one backup in progress at a time.  When the main thread needs to use a file that jobs are still
+ * queued on, it waits for those jobs only.
+ *
+ * Restoring a backup when an Observation is created only reads the newest sample, which is pushed
+ * to the Observation to become its current value.  The rest of the buffer is loaded from the
+ * backup file the first time the buffer is needed, or by a background timer that loads one
+ * Observation's buffer each time it expires, whichever comes first.  Until then, no backup of the
+ * Observation is written, because the backup file holds more than the buffer.  The timer passes
+ * over Observations whose backup files the Backup Thread still has jobs queued on, rather than
+ * waiting for it.
+ *
+ * The formats of the backup files and backup journals are described in backupFile.c.
  *
  * Copyright (C) Sierra Wireless Inc.
  */
@@ -40,7 +88,14 @@
 #include "resTree.h"
 #include "json.h"
 #include "obs.h"
+#include "gorilla.h"
+#include "quantile.h"
+#include "histogram.h"
+#include "ringFile.h"
+#include "backupFile.h"
+#include "backupThread.h"
 #include <ftw.h>
+#include <sys/mman.h>
 
 #ifdef LEGATO_EMBEDDED
  #define BACKUP_DIR "/home/root/dataHubBackup/"
@@ -50,15 +105,125 @@
 #define BACKUP_DIR_PATH_LEN (sizeof(BACKUP_DIR) - 1)
 #define BACKUP_SUFFIX ".bak"
 #define BACKUP_SUFFIX_LEN (sizeof(BACKUP_SUFFIX) - 1)
+#define JOURNAL_SUFFIX ".log"
+#define JOURNAL_SUFFIX_LEN (sizeof(JOURNAL_SUFFIX) - 1)
+#define RING_SUFFIX ".ring"
+#define RING_SUFFIX_LEN (sizeof(RING_SUFFIX) - 1)
 
 #define MAX_BACKUP_FILE_PATH_BYTES (  BACKUP_DIR_PATH_LEN \
                                     + IO_MAX_RESOURCE_PATH_LEN \
                                     + BACKUP_SUFFIX_LEN \
+                                    + JOURNAL_SUFFIX_LEN \
                                     + 1 /* for null terminator */ )
 
+/// Interval at which the buffers of Observations restored lazily are loaded in the background (ms).
+#define BACKGROUND_RESTORE_INTERVAL 100
+
+/// Interval at which ring files are checked for changes that are due to be synced (ms).
+#define RING_SYNC_CHECK_INTERVAL 1000
+
 /// Number of seconds in 30 years.
 #define THIRTY_YEARS 946684800.0
 
+/// Magic number at the start of a binary buffer read ("DHBR" in little-endian byte order).
+#define BINARY_READ_MAGIC 0x52424844
+
+/// Binary buffer read format version written by this implementation.
+#define BINARY_READ_FORMAT_VERSION 0
+
+/// Slot in an Observation's data sample buffer ring.  The type of value held is determined by
+/// the Observation's bufferedType.  String and JSON slots hold a reference on a Data Sample object.
+typedef struct
+{
+    double timestamp;   ///< Timestamp of the sample.
+    union
+    {
+        bool boolean;               ///< Value of a Boolean sample.
+        double numeric;             ///< Value of a numeric sample.
+        dataSample_Ref_t sampleRef; ///< Data Sample holding a string or JSON value.
+    } value;
+}
+BufferSlot_t;
+
+
+/// Position of a sample in an Observation's data sample buffer, however the buffer is stored.
+typedef struct
+{
+    uint64_t seq;           ///< Sequence number of the sample.
+    BufferSlot_t slot;      ///< Copy of the sample (holding no reference on string/JSON values).
+    gorilla_Cursor_t block; ///< Position of the sample in a compressed buffer.
+}
+BufferCursor_t;
+
+
+/// Double-ended queue of value sequence numbers, used to keep track of the minimum or maximum
+/// value covered by a set of running stats.  Stored as a ring of the same size as the running
+/// stats' ring of values.
+typedef struct
+{
+    uint64_t* seqPtr;   ///< Ring of value sequence numbers (oldest at the front).
+    size_t head;        ///< Index into seqPtr of the front of the queue.
+    size_t len;         ///< Number of sequence numbers in the queue.
+}
+SeqDeque_t;
+
+
+/// Value covered by a set of running stats.
+typedef struct
+{
+    double timestamp;   ///< Timestamp of the sample the value came from.
+    double value;       ///< The (non-NAN) value.
+}
+StatsEntry_t;
+
+
+/// Aggregates of a sliding window of numerical values, updated as values enter and leave the window
+/// so that transforms don't have to scan all the values.  For the whole-buffer transforms the
+/// window is the Observation's buffer; for the moving window transforms it is set by the
+/// transform's parameters.  Allocated from the Running Stats Pool, only while such a transform is
+/// applied to the Observation.
+typedef struct
+{
+    StatsEntry_t* entryPtr; ///< Ring of the values in the window (NULL if capacity is 0).
+    size_t capacity;    ///< Number of entries in the ring (and in each queue's ring).
+    size_t head;        ///< Index into entryPtr of the oldest value.
+    size_t count;       ///< Number of values in the window.
+    uint64_t headSeq;   ///< Sequence number of the oldest value.
+    double mean;        ///< Mean of the values.
+    double sumSquares;  ///< Sum of the squared differences from the mean (Welford's method).
+    size_t removals;    ///< Number of values removed since the sums were last recomputed.
+    SeqDeque_t minQueue; ///< Values that could become the minimum (ascending values).
+    SeqDeque_t maxQueue; ///< Values that could become the maximum (descending values).
+}
+RunningStats_t;
+
+
+/// Summary of the numerical values received by an Observation during one rollup tier period.
+typedef struct
+{
+    double start;       ///< Start of the period (seconds since the Epoch).
+    uint32_t count;     ///< Number of values.
+    double mean;        ///< Mean of the values.
+    double sumSquares;  ///< Sum of the squared differences from the mean.
+    double min;         ///< Smallest value.
+    double max;         ///< Largest value.
+}
+RollupBucket_t;
+
+
+/// Rollup tier of downsampled numerical history, kept alongside an Observation's buffer.
+/// Stored as a ring of buckets, oldest first.  The newest bucket is still being filled.
+typedef struct
+{
+    double period;      ///< Length of each bucket's period (seconds).
+    size_t maxCount;    ///< Number of buckets in the ring.
+    size_t count;       ///< Number of buckets in use.
+    size_t oldestIndex; ///< Index into bucketPtr of the oldest bucket.
+    RollupBucket_t* bucketPtr; ///< Ring of buckets.
+}
+RollupTier_t;
+
+
 /// Observation Resource.  Allocated from the Observation Pool.
 typedef struct
 {
@@ -72,6 +237,11 @@ typedef struct
     uint32_t lastPushTime; ///< Time at which last push was accepted (ms, relative clock).
 
     obs_TransformType_t transformType; ///< Buffer transform type
+    double windowPeriod;    ///< Moving window length (seconds); 0 = not limited by time.
+    size_t windowCount;     ///< Moving window size (samples); 0 = not limited by count.
+    double ewmaAlpha;       ///< Weight of the newest value in an exponentially weighted average.
+    double prevValue;       ///< Last EWMA output, or last input value for rate of change.
+    double prevTimestamp;   ///< Timestamp of the last input value for rate of change.
 
     size_t maxCount;  ///< Maximum number of entries to buffer.
     size_t count;     ///< Current number of entries in the buffer.
@@ -80,26 +250,58 @@ typedef struct
 
     uint32_t backupPeriod; ///< Min time (in seconds) between non-volatile backups of the buffer.
     uint32_t lastBackupTime; ///< Time at which last push was accepted (seconds, relative clock).
-    le_timer_Ref_t backupTimer; ///< Reference to the timer used to trigger the next backup.
+    le_dls_Link_t backupLink; ///< Link in the Pending Backup List (while a backup is pending).
+    bool isBackupPending; ///< true if waiting in the Pending Backup List for its next backup.
+    uint32_t backupDueTime; ///< When the pending backup is due (seconds, relative clock).
+    bool canJournal;    ///< true if the next backup can be appended to the backup journal.
+    uint64_t backupSeq; ///< Sequence number of the first sample not backed up yet.
+    size_t journalCount; ///< Number of samples in the backup journal.
+    struct BackupJob* backupJobPtr; ///< Backup being done by the Backup Thread (NULL if none).
+    le_dls_Link_t restoreLink; ///< Link in the Pending Restore List (while a restore is pending).
+    bool isRestorePending; ///< true if the buffer still has to be loaded from the backup file.
 
-    le_sls_List_t sampleList; ///< Queue of buffered data samples (oldest first, newest last).
+    bool compressBuffer; ///< true if numeric samples should be buffered compressed.
+    gorilla_Buffer_t* compressedPtr; ///< Compressed numeric buffer (NULL if not compressed).
 
-    le_dls_List_t readOpList; ///< List of ongoing Read Operations on the buffered samples.
+    bool persistBuffer; ///< true if the buffer should be kept in a ring file (if its type allows).
+    uint32_t ringSyncPeriod; ///< Min time (in seconds) between syncs of the ring file; 0 = none.
+    ringFile_Header_t* ringPtr; ///< Ring file mapped into memory (NULL if the buffer isn't in one).
+    bool isRingDirty; ///< true if the ring file has changed since it was last synced.
+    uint32_t lastRingSyncTime; ///< When the ring file was last synced (seconds, relative clock).
+    le_dls_Link_t ringSyncLink; ///< Link in the Synced Ring List (while it is in that list).
 
-    char jsonExtraction[ADMIN_MAX_JSON_EXTRACTOR_LEN + 1]; ///< JSON extraction specifier (or "").
-}
-Observation_t;
+    BufferSlot_t* bufferPtr; ///< Ring of buffered data samples (NULL if none, compressed or
+                             ///  in a ring file).
+    size_t oldestIndex; ///< Index into the ring of the oldest buffered sample.
+    uint64_t oldestSeq; ///< Sequence number of the oldest buffered sample.
 
+    RunningStats_t* statsPtr; ///< Aggregates for the transform (NULL if not needed).
 
+    RollupTier_t tiers[ADMIN_MAX_ROLLUP_TIERS]; ///< Rollup tiers, finest first.
+    size_t tierCount; ///< Number of rollup tiers in use.
 
-/// Object used to link a Data Sample into an Observation's buffer.
-/// Holds a reference on the Data Sample object.
-typedef struct
-{
-    le_sls_Link_t link;  ///< Used to link into a Observation's sampleList.
-    dataSample_Ref_t sampleRef; ///< Reference to the Data Sample object.
+    quantile_SketchRef_t sketchRef; ///< Quantile sketch of the buffer (NULL if not kept).
+
+    histogram_Ref_t histogramRef; ///< Histogram of the values received (NULL if not kept).
+
+    le_dls_List_t readOpList; ///< List of ongoing Read Operations on the buffered samples.
+    le_dls_List_t readCursorList; ///< List of Read Cursors open on the buffered samples.
+
+    obs_AggregationType_t aggregationType; ///< Tumbling window aggregation type.
+    double aggregationPeriod; ///< Length of the aggregation windows (seconds).
+    double windowEnd;   ///< When the current aggregation window ends (seconds since the Epoch).
+    size_t aggCount;    ///< Number of samples received in the current aggregation window.
+    size_t aggNumCount; ///< Number of those samples that had a (non-NAN) numerical value.
+    double aggSum;      ///< Sum of the numerical values received in the current window.
+    double aggMin;      ///< Smallest numerical value received in the current window.
+    double aggMax;      ///< Largest numerical value received in the current window.
+    io_DataType_t aggLastType;  ///< Data type of aggLastSample.
+    dataSample_Ref_t aggLastSample; ///< Last sample received in the current window (or NULL).
+    le_dls_Link_t aggregationLink; ///< Link in the Aggregating Observation List.
+
+    atom_Ref_t jsonExtraction;  ///< JSON extraction specifier (interned), or NULL if none.
 }
-BufferEntry_t;
+Observation_t;
 
 
 /// Each data sample in a read operation looks like the following:
@@ -110,6 +312,11 @@ BufferEntry_t;
 /// but in this case they typically won't be more than 6 decimal places.
 #define READ_OP_BUFF_BYTES (IO_MAX_STRING_VALUE_LEN + 48)
 
+/// Samples are loaded into a read operation's write buffer in batches, to be written with as few
+/// write() calls as possible.  The buffer must have room for the largest sample, plus a comma
+/// before it and a '[' or ']' around it.
+#define READ_OP_BATCH_BYTES (64 * 1024)
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -122,9 +329,13 @@ typedef struct
     Observation_t* obsPtr;  ///< Ptr to Observation whose buffer is being read.
     le_fdMonitor_Ref_t fdMonitor; ///< Used to get notification when the FD is clear to write.
     int fd; ///< fd to write to.
-    BufferEntry_t* nextEntryPtr; ///< Buff entry to load into write buff next (ref counted).
-    enum { START, SAMPLE, COMMA, END } state; ///< What are we supposed to write next?
-    char writeBuffer[READ_OP_BUFF_BYTES];  ///< Buffer currently being written.
+    uint64_t nextSeq; ///< Sequence number of the buffered sample to load into write buff next.
+    BufferCursor_t cursor; ///< Position of the buffered sample after the last one loaded.
+    bool cursorValid;   ///< true if the cursor can be used.
+    bool isBinary;  ///< true = packed binary format, false = JSON.
+    io_DataType_t dataType; ///< Data type given in the header of the binary format.
+    enum { START, FIRST_SAMPLE, MORE_SAMPLES, END } state; ///< What are we to load next?
+    char writeBuffer[READ_OP_BATCH_BYTES];  ///< Buffer currently being written.
     size_t writeLen; ///< Number of characters (excl. null terminator) in the writeBuffer.
     size_t writeOffset;   ///< Offset into the writeBuffer to write from next.
     query_ReadCompletionFunc_t handlerPtr; ///< Completion callback.
@@ -133,15 +344,145 @@ typedef struct
 ReadOperation_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cursor opened by a client on an Observation's buffer, to read the buffered samples a batch at a
+ * time.  Like a read operation, it keeps its position as a sequence number, so it simply carries
+ * on from the oldest sample if the samples it hadn't read yet have been discarded.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct obs_ReadCursor
+{
+    le_dls_Link_t link; ///< Used to link into the Observation's list of open read cursors.
+    Observation_t* obsPtr;  ///< Ptr to Observation whose buffer is being read (NULL if deleted).
+    uint64_t nextSeq; ///< Sequence number of the buffered sample to be read next.
+    BufferCursor_t cursor; ///< Position of the buffered sample to be read next.
+    bool cursorValid;   ///< true if the cursor can be used.
+}
+ReadCursor_t;
+
+
+/// Kinds of backup job done by the Backup Thread.
+typedef enum
+{
+    BACKUP_JOB_SNAPSHOT,    ///< Write a new backup file and start a new, empty journal.
+    BACKUP_JOB_APPEND,      ///< Append new samples to the backup journal.
+    BACKUP_JOB_DELETE,      ///< Delete the backup file and the backup journal.
+}
+BackupJobType_t;
+
+
+/// Copy of a rollup tier's buckets, taken for a backup.
+typedef struct
+{
+    double period;      ///< Length of each bucket's period (seconds).
+    size_t count;       ///< Number of buckets.
+    RollupBucket_t* bucketPtr; ///< Copies of the buckets, oldest first (NULL if count is 0).
+}
+RollupTierCopy_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Job passed to the Backup Thread.  Holds a copy of everything the Backup Thread needs, so the
+ * Observation can keep changing (or be deleted) while the job is in progress.  The fields marked
+ * "main thread only" must not be accessed by the Backup Thread.  Allocated from the Backup Job
+ * Pool.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct BackupJob
+{
+    BackupJobType_t type;       ///< What to do.
+    Observation_t* obsPtr;      ///< Observation backed up (NULL if none).  Main thread only.
+    bool keepJournal;   ///< false if the journal can't be appended to any more.  Main thread only.
+    bool backupAgain;   ///< true if another backup is due when this is done.  Main thread only.
+    bool ok;            ///< Set by the Backup Thread: true if the job succeeded.
+    bool journalStarted; ///< Set by the Backup Thread: true if a new journal was started.
+    char path[MAX_BACKUP_FILE_PATH_BYTES];          ///< Backup file path.
+    char journalPath[MAX_BACKUP_FILE_PATH_BYTES];   ///< Backup journal file path.
+    io_DataType_t dataType;     ///< Data type of the Observation.
+    io_DataType_t bufferedType; ///< Data type of the samples.
+    uint32_t maxCount;          ///< Buffer size.
+    uint32_t bufferCount;       ///< Number of samples in the buffer.
+    double newestTimestamp;     ///< Timestamp of the newest sample in the buffer (NAN if none).
+    uint64_t endSeq;    ///< Sequence number of the sample after the newest one backed up.
+    size_t count;       ///< Number of samples in slotPtr.
+    BufferSlot_t* slotPtr;  ///< Copies of the samples (holding references on string/JSON values).
+    bool isCompressed;      ///< true if the samples are in blockPtr instead of slotPtr.
+    size_t blockCount;      ///< Number of blocks in blockPtr.
+    uint16_t skipCount;     ///< Number of samples already discarded from the oldest block.
+    gorilla_Block_t* blockPtr;  ///< Copies of the compressed buffer's blocks, oldest first.
+    size_t tierCount;       ///< Number of rollup tiers in tiers.
+    RollupTierCopy_t tiers[ADMIN_MAX_ROLLUP_TIERS]; ///< Copies of the rollup tiers, finest first.
+    backupThread_Job_t threadJob;   ///< The job as queued to the Backup Thread.
+}
+BackupJob_t;
+
+
+/// File found in the backup directory that no Observation with backups enabled is using.
+typedef struct
+{
+    le_dls_Link_t link; ///< Link in the Unused Backup File List.
+    char backupPath[MAX_BACKUP_FILE_PATH_BYTES];    ///< Path of the backup file it goes with.
+    char path[MAX_BACKUP_FILE_PATH_BYTES];          ///< Path of the file itself.
+}
+UnusedBackupFile_t;
+
+
 /// Pool of Observation objects.
 static le_mem_PoolRef_t ObservationPool = NULL;
 
-/// Pool of Buffer Entry objects.
-static le_mem_PoolRef_t BufferEntryPool = NULL;
+/// Pool of Running Stats objects.
+static le_mem_PoolRef_t RunningStatsPool = NULL;
+
+/// Initial number of values in a moving window that is only limited by time.  Grows as needed.
+#define MIN_WINDOW_CAPACITY 16
+
+/// List of Observations that have an aggregation type set.
+static le_dls_List_t AggregatingObsList = LE_DLS_LIST_INIT;
+
+/// Timer shared by all the aggregating Observations.  Expires at the end of the earliest
+/// aggregation window.
+static le_timer_Ref_t AggregationTimer = NULL;
+
+/// List of Observations waiting for a backup of their buffer, sorted by the time the backup is due.
+static le_dls_List_t PendingBackupList = LE_DLS_LIST_INIT;
+
+/// Timer shared by all the Observations waiting for a backup.  Expires when the earliest backup is
+/// due, and then does all the backups that are due together.
+static le_timer_Ref_t BackupTimer = NULL;
+
+/// List of Observations whose buffers haven't been loaded from their backups yet.
+static le_dls_List_t PendingRestoreList = LE_DLS_LIST_INIT;
+
+/// Timer that loads the buffers of the Observations in the Pending Restore List in the background,
+/// one each time it expires.
+static le_timer_Ref_t RestoreTimer = NULL;
+
+/// List of Observations whose buffers are in ring files that are synced periodically.
+static le_dls_List_t SyncedRingList = LE_DLS_LIST_INIT;
+
+/// Timer that syncs the ring files of the Observations in the Synced Ring List that are due.
+/// Only runs while that list isn't empty.
+static le_timer_Ref_t RingSyncTimer = NULL;
 
 /// Pool to allocate ReadOperation_t object from.
 static le_mem_PoolRef_t ReadOperationPool = NULL;
 
+/// Pool to allocate ReadCursor_t objects from.
+static le_mem_PoolRef_t ReadCursorPool = NULL;
+
+/// Pool to allocate BackupJob_t objects from.
+static le_mem_PoolRef_t BackupJobPool = NULL;
+
+/// Pool to allocate UnusedBackupFile_t objects from.
+static le_mem_PoolRef_t UnusedBackupFilePool = NULL;
+
+/// Files in the backup directory that will be deleted by the next clean-up, unless an Observation
+/// enables backups and starts using them first.  Built from the backup directory once at start-up,
+/// and kept up to date as Observations' backup periods change after that.
+static le_dls_List_t UnusedBackupFileList = LE_DLS_LIST_INIT;
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -208,1636 +549,7258 @@ static le_result_t GetBackupFilePath
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Delete the observation's buffer backup file, if it exists.
+ * Get the file system path to use for the backup journal file for a given Observation's data sample
+ * buffer.
+ *
+ * @return LE_OK if successful.
  */
 //--------------------------------------------------------------------------------------------------
-static void DeleteBackup
+static le_result_t GetJournalFilePath
 (
+    char* pathBuffPtr,  ///< [OUT] Ptr to where the path will be written.
+    size_t pathBuffSize,    ///< Size of the buffer in bytes.
     Observation_t* obsPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    char path[IO_MAX_RESOURCE_PATH_LEN];
-    le_result_t result = GetBackupFilePath(path, sizeof(path), obsPtr);
-    if (result == LE_OK)
+    le_result_t result = GetBackupFilePath(pathBuffPtr, pathBuffSize, obsPtr);
+    if (result != LE_OK)
     {
-        unlink(path);
+        return result;
     }
+
+    return le_utf8_Append(pathBuffPtr, JOURNAL_SUFFIX, pathBuffSize, NULL);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Buffer Entry destructor.
+ * Get the file system path to use for the ring file holding a given Observation's persistent data
+ * sample buffer.
+ *
+ * @return LE_OK if successful.
  */
 //--------------------------------------------------------------------------------------------------
-static void BufferEntryDestructor
+static le_result_t GetRingFilePath
 (
-    void* objectPtr
+    char* pathBuffPtr,  ///< [OUT] Ptr to where the path will be written.
+    size_t pathBuffSize,    ///< Size of the buffer in bytes.
+    Observation_t* obsPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    BufferEntry_t* buffEntryPtr = objectPtr;
+    le_result_t result = GetBackupFilePath(pathBuffPtr, pathBuffSize, obsPtr);
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    // The ring file suffix takes the place of the backup file suffix.
+    pathBuffPtr[strlen(pathBuffPtr) - BACKUP_SUFFIX_LEN] = '\0';
 
-    le_mem_Release(buffEntryPtr->sampleRef);
+    return le_utf8_Append(pathBuffPtr, RING_SUFFIX, pathBuffSize, NULL);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Terminate a read operation.
+ * Stop appending backups of a given Observation's buffer to its backup journal, because something
+ * other than new samples has changed.  The next backup writes a new backup file instead.
  */
 //--------------------------------------------------------------------------------------------------
-static void EndRead
+static void StopJournal
 (
-    ReadOperation_t* opPtr,
-    le_result_t result
+    Observation_t* obsPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (opPtr->nextEntryPtr != NULL)
+    obsPtr->canJournal = false;
+
+    // A backup file still being written by the Backup Thread mustn't restart the journal either.
+    if (obsPtr->backupJobPtr != NULL)
     {
-        le_mem_Release(opPtr->nextEntryPtr);
-        opPtr->nextEntryPtr = NULL;
+        obsPtr->backupJobPtr->keepJournal = false;
     }
-
-    le_fdMonitor_Delete(opPtr->fdMonitor);
-
-    close(opPtr->fd);
-
-    opPtr->handlerPtr(result, opPtr->contextPtr);
-
-    le_dls_Remove(&opPtr->obsPtr->readOpList, &opPtr->link);
-
-    le_mem_Release(opPtr);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Observation destructor.
+ * Get the index in an Observation's buffer ring (of slots, or of ring file records) of the sample
+ * at a given position.
+ *
+ * @return The index.
  */
 //--------------------------------------------------------------------------------------------------
-static void ObservationDestructor
+static inline size_t GetRingIndex
 (
-    void* objectPtr
+    Observation_t* obsPtr,
+    size_t offset   ///< Position of the sample relative to the oldest sample (0 = oldest).
 )
 //--------------------------------------------------------------------------------------------------
 {
-    Observation_t* obsPtr = objectPtr;
+    size_t index = obsPtr->oldestIndex + offset;
 
-    // Delete all the buffered data samples.
-    le_sls_Link_t* linkPtr;
-    while (NULL != (linkPtr = le_sls_Pop(&obsPtr->sampleList)))
+    // Both the oldest index and the offset are less than the ring size, so a single subtraction
+    // is enough to wrap around (and is cheaper than a modulo).
+    if (index >= obsPtr->maxCount)
     {
-        BufferEntry_t* buffEntryPtr = CONTAINER_OF(linkPtr, BufferEntry_t, link);
-
-        le_mem_Release(buffEntryPtr);
-    }
-
-    obsPtr->count = 0;
-    obsPtr->maxCount = 0;
-
-    // If the observation had backups enabled, delete the backup file.
-    if (obsPtr->backupPeriod > 0)
-    {
-        DeleteBackup(obsPtr);
-    }
-
-    // If there are read operations in progress, end them.
-    while (le_dls_IsEmpty(&obsPtr->readOpList) == false)
-    {
-        EndRead(CONTAINER_OF(le_dls_Peek(&obsPtr->readOpList), ReadOperation_t, link),
-                LE_COMM_ERROR);
+        index -= obsPtr->maxCount;
     }
 
-    res_Destruct(&obsPtr->resource);
+    return index;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the first (oldest) buffer entry in an Observation's data sample buffer.
+ * Get a pointer to a slot in an Observation's data sample buffer ring.  The buffer must be a ring
+ * of slots (not compressed, or in a ring file).
  *
- * @return Pointer to the buffer entry or NULL if the buffer is empty.
+ * @return Pointer to the slot.
  */
 //--------------------------------------------------------------------------------------------------
-static BufferEntry_t* GetOldestBufferEntry
+static inline BufferSlot_t* GetSlot
 (
-    Observation_t* obsPtr
+    Observation_t* obsPtr,
+    size_t offset   ///< Position of the slot relative to the oldest sample (0 = oldest).
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_sls_Link_t* linkPtr = le_sls_Peek(&obsPtr->sampleList);
-
-    if (linkPtr != NULL)
-    {
-        return CONTAINER_OF(linkPtr, BufferEntry_t, link);
-    }
-    else
-    {
-        return NULL;
-    }
+    return &obsPtr->bufferPtr[GetRingIndex(obsPtr, offset)];
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the next (newer) buffer entry in an Observation's data sample buffer.
+ * Get a pointer to a record in the ring file holding an Observation's buffer.  The buffer must be
+ * in a ring file.
  *
- * @return A pointer to the buffer entry, or NULL if there are no newer samples in the buffer.
+ * @return Pointer to the record.
  */
 //--------------------------------------------------------------------------------------------------
-static BufferEntry_t* GetNextBufferEntry
+static inline ringFile_Record_t* GetRingRecord
 (
     Observation_t* obsPtr,
-    BufferEntry_t* buffEntryPtr
+    size_t offset   ///< Position of the record relative to the oldest sample (0 = oldest).
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_sls_Link_t* linkPtr = le_sls_PeekNext(&obsPtr->sampleList, &buffEntryPtr->link);
-
-    if (linkPtr != NULL)
-    {
-        return CONTAINER_OF(linkPtr, BufferEntry_t, link);
-    }
-    else
-    {
-        return NULL;
-    }
+    return &ringFile_GetRecords(obsPtr->ringPtr)[GetRingIndex(obsPtr, offset)];
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Load the write buffer with a JSON representation of the next sample to be read.
- *
- * @return true if successful, false if there are no more samples.
+ * Fill in a ring file record with a sample held in a slot.
  */
 //--------------------------------------------------------------------------------------------------
-static bool LoadReadOpBuffer
+static inline void SetRingRecord
 (
-    ReadOperation_t* opPtr
+    ringFile_Record_t* recordPtr,
+    const BufferSlot_t* slotPtr,
+    io_DataType_t dataType, ///< Trigger, Boolean or numeric.
+    uint64_t seq            ///< Sequence number of the sample.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    opPtr->writeLen = 0;
-    opPtr->writeOffset = 0;
-    opPtr->writeBuffer[0] = '\0';
-
-    do
+    recordPtr->timestamp = slotPtr->timestamp;
+    switch (dataType)
     {
-        if (opPtr->nextEntryPtr == NULL)
-        {
-            return false;
-        }
-
-        // If the buffer entry's ref count should be 2.  If it is only 1, then we know it has
-        // fallen off the end of the observation's buffer, which means that all entries in the
-        // observation's buffer are now newer than this one.
-        if (le_mem_GetRefCount(opPtr->nextEntryPtr) == 1)
-        {
-            le_mem_Release(opPtr->nextEntryPtr);
-            opPtr->nextEntryPtr = GetOldestBufferEntry(opPtr->obsPtr);
-            if (opPtr->nextEntryPtr != NULL)
-            {
-                le_mem_AddRef(opPtr->nextEntryPtr);
-            }
-            else
-            {
-                return false;
-            }
-        }
-
-        int len = snprintf(opPtr->writeBuffer,
-                           sizeof(opPtr->writeBuffer),
-                           "{\"t\":%lf,\"v\":",
-                           dataSample_GetTimestamp(opPtr->nextEntryPtr->sampleRef));
-        if (len >= sizeof(opPtr->writeBuffer))
-        {
-            LE_CRIT("Buffer overflow. Skipping entry.");
-            // Leave the writeLen 0 so we'll loop around and try the next sample.
-        }
-        else
-        {
-            // Copy the JSON version of the contents of the current buffer entry's data into
-            // the write buffer, if there's space (leaving room for an additional '}' at the end).
-            le_result_t result = dataSample_ConvertToJson(opPtr->nextEntryPtr->sampleRef,
-                                                          res_GetDataType(&(opPtr->obsPtr->resource)),
-                                                          opPtr->writeBuffer + len,
-                                                          sizeof(opPtr->writeBuffer) - len - 1);
-            if (result != LE_OK)
-            {
-                LE_ERROR("JSON value doesn't fit in write buffer. Skipping.");
-                // Leave the writeLen 0 so we'll loop around and try the next sample.
-            }
-            else
-            {
-                len += strlen(opPtr->writeBuffer + len);
-
-                opPtr->writeBuffer[len] = '}';
-                opPtr->writeBuffer[len + 1] = '\0';
+        case IO_DATA_TYPE_BOOLEAN:
 
-                opPtr->writeLen = len + 1;
-            }
-        }
+            recordPtr->value = (slotPtr->value.boolean ? 1 : 0);
+            break;
 
-        // Advance the nextEntryPtr to the next entry in the Observation's data sample list.
-        BufferEntry_t* nextEntryPtr = GetNextBufferEntry(opPtr->obsPtr, opPtr->nextEntryPtr);
-        le_mem_Release(opPtr->nextEntryPtr);
+        case IO_DATA_TYPE_NUMERIC:
 
-        if (nextEntryPtr != NULL)
-        {
-            opPtr->nextEntryPtr = nextEntryPtr;
-            le_mem_AddRef(nextEntryPtr);
-        }
-        else
-        {
-            opPtr->nextEntryPtr = NULL;
-        }
+            recordPtr->value = slotPtr->value.numeric;
+            break;
 
-    } while (opPtr->writeLen == 0); // Loop if the write buffer is still empty.
+        default:
 
-    return true;
+            recordPtr->value = 0;
+            break;
+    }
+    recordPtr->seq = seq;
+    recordPtr->reserved = 0;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Write to an unbuffered file descriptor.
- *
- * @return The number of bytes written.  -1 on error (errno is set).
+ * Copy the sample at a given position in an Observation's buffer into a slot.  The buffer must be
+ * a ring of slots or in a ring file (not compressed).
  */
 //--------------------------------------------------------------------------------------------------
-static ssize_t WriteToFd
+static inline void ReadSlot
 (
-    int fd,
-    const void* buffPtr,
-    size_t byteCount
+    Observation_t* obsPtr,
+    size_t offset,          ///< Position of the sample relative to the oldest sample (0 = oldest).
+    BufferSlot_t* slotPtr   ///< [OUT] Copy of the sample.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    ssize_t result;
-
-    LE_ASSERT(buffPtr != NULL);
-
-    do
+    if (obsPtr->ringPtr == NULL)
     {
-        result = write(fd, buffPtr, byteCount);
+        *slotPtr = *GetSlot(obsPtr, offset);
+        return;
+    }
 
-    } while ((result == -1) && (errno == EINTR));
+    const ringFile_Record_t* recordPtr = GetRingRecord(obsPtr, offset);
 
-    return result;
+    slotPtr->timestamp = recordPtr->timestamp;
+    if (obsPtr->bufferedType == IO_DATA_TYPE_BOOLEAN)
+    {
+        slotPtr->value.boolean = (recordPtr->value != 0);
+    }
+    else
+    {
+        slotPtr->value.numeric = recordPtr->value;
+    }
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Continue a read operation.
+ * Get the timestamp of the sample at a given position in an Observation's buffer.  The buffer must
+ * be a ring of slots or in a ring file (not compressed).
+ *
+ * @return The timestamp.
  */
 //--------------------------------------------------------------------------------------------------
-static void ContinueReadOp
+static inline double GetSlotTimestamp
 (
-    ReadOperation_t* opPtr
+    Observation_t* obsPtr,
+    size_t offset   ///< Position of the sample relative to the oldest sample (0 = oldest).
 )
 //--------------------------------------------------------------------------------------------------
 {
-    ssize_t result;
-    for (;;)
+    if (obsPtr->ringPtr != NULL)
     {
-        const char* writeBuffPtr = NULL;
-        size_t writeLen = 0;
+        return GetRingRecord(obsPtr, offset)->timestamp;
+    }
 
-        // Figure out what to write based on the state.
-        switch (opPtr->state)
-        {
-            case START:
-
-                writeBuffPtr = "[";
-                writeLen = 1;
-
-                break;
-
-            case SAMPLE:
-
-                writeBuffPtr = opPtr->writeBuffer + opPtr->writeOffset;
-                writeLen = opPtr->writeLen - opPtr->writeOffset;
-
-                break;
-
-            case COMMA:
-
-                writeBuffPtr = ",";
-                writeLen = 1;
-
-                break;
-
-            case END:
-
-                writeBuffPtr = "]";
-                writeLen = 1;
-
-                break;
-        }
-
-        // Write and check for errors.
-        result = WriteToFd(opPtr->fd, writeBuffPtr, writeLen);
-        if (result == -1)
-        {
-            if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
-            {
-                // Return and wait for this function to be called again by the FD Monitor.
-                return;
-            }
-
-            LE_ERROR("Error writing (%m).");
-            EndRead(opPtr, LE_COMM_ERROR);
-
-            return;
-        }
-
-        // Advance to the next state.
-        switch (opPtr->state)
-        {
-            case START:
-
-                // If there's a sample in the write buffer,
-                if (opPtr->writeLen > 0)
-                {
-                    opPtr->state = SAMPLE;
-                }
-                else
-                {
-                    opPtr->state = END;
-                }
-                break;
-
-            case SAMPLE:
-
-                // Update the write offset.
-                opPtr->writeOffset += result;
-
-                // If the write buffer has been written entirely,
-                if (opPtr->writeOffset == opPtr->writeLen)
-                {
-                    // Try to load the next sample into the write buffer.
-                    if (LoadReadOpBuffer(opPtr))
-                    {
-                        opPtr->state = COMMA;
-                    }
-                    else
-                    {
-                        opPtr->state = END;
-                    }
-                }
-                // Note: If the write buffer has not been written entirely, stay in the SAMPLE
-                // state and loop back around to write more.
-                break;
-
-            case COMMA:
-
-                opPtr->state = SAMPLE;
-                break;
-
-            case END:
-
-                EndRead(opPtr, LE_OK);
-
-                return;
-        }
-    }
+    return GetSlot(obsPtr, offset)->timestamp;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Event handler call-back for events on a read operation's write file descriptor.
+ * Get buffer slot numerical value.  This works for numeric or Boolean types only.
+ *
+ * @return The value.
  */
 //--------------------------------------------------------------------------------------------------
-static void ReadOpFdEventHandler
+static double GetBufferedNumber
 (
-    int fd,
-    short events
+    BufferSlot_t* slotPtr,
+    io_DataType_t dataType
 )
 //--------------------------------------------------------------------------------------------------
 {
-    ReadOperation_t* opPtr = le_fdMonitor_GetContextPtr();
-
-    // Check for error or hang-up.
-    if ((events & POLLERR) || (events & POLLHUP) || (events & POLLRDHUP))
+    if (dataType == IO_DATA_TYPE_NUMERIC)
     {
-        LE_ERROR("Error or hang-up on output stream.");
-        EndRead(opPtr, LE_COMM_ERROR);
+        return slotPtr->value.numeric;
+    }
+    else if (dataType == IO_DATA_TYPE_BOOLEAN)
+    {
+        if (slotPtr->value.boolean)
+        {
+            return 1.0;
+        }
+        else
+        {
+            return 0.0;
+        }
     }
-    // Note: The only other reason for this function to be called is POLLOUT (writeable).
     else
     {
-        ContinueReadOp(opPtr);
+        LE_CRIT("Non-numerical data type %d.", dataType);
+        return NAN;
     }
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Start a read operation on a given Observation's buffer.
+ * Check whether a transform type operates on all the values in an Observation's buffer.
+ *
+ * @return true if it does.
  */
 //--------------------------------------------------------------------------------------------------
-static void StartRead
+static bool IsBufferTransform
 (
-    Observation_t* obsPtr,
-    BufferEntry_t* startPtr, ///< Ptr to buffer entry to start at, or NULL if read data set empty.
-    int outputFile, ///< File descriptor to write the data to.
-    query_ReadCompletionFunc_t handlerPtr, ///< Completion callback.
-    void* contextPtr    ///< Value to be passed to completion callback.
+    obs_TransformType_t transformType
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Set the fd non-blocking
-    if (0 != fcntl(outputFile, F_SETFL, O_NONBLOCK))
-    {
-        LE_ERROR("Failed to activate non-blocking mode (%m).");
-        handlerPtr(LE_COMM_ERROR, contextPtr);
-        return;
-    }
-
-    ReadOperation_t* opPtr = le_mem_ForceAlloc(ReadOperationPool);
-
-    opPtr->link = LE_DLS_LINK_INIT;
-    le_dls_Queue(&obsPtr->readOpList, &opPtr->link);
-
-    opPtr->obsPtr = obsPtr;
-
-    opPtr->fdMonitor = le_fdMonitor_Create("Read", outputFile, ReadOpFdEventHandler, POLLOUT);
-    le_fdMonitor_SetContextPtr(opPtr->fdMonitor, opPtr);
-    opPtr->fd = outputFile;
-    opPtr->nextEntryPtr = startPtr;
-    // We hold a ref count on the buffer entry to prevent it from being released.
-    if (startPtr != NULL)
-    {
-        le_mem_AddRef(startPtr);
-    }
-    opPtr->handlerPtr = handlerPtr;
-    opPtr->contextPtr = contextPtr;
+    return (   (transformType == OBS_TRANSFORM_TYPE_MEAN)
+            || (transformType == OBS_TRANSFORM_TYPE_STDDEV)
+            || (transformType == OBS_TRANSFORM_TYPE_MAX)
+            || (transformType == OBS_TRANSFORM_TYPE_MIN)  );
+}
 
-    opPtr->state = START;
-    (void)LoadReadOpBuffer(opPtr);
 
-    ContinueReadOp(opPtr);
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a transform type operates on a moving window of values set by its parameters.
+ *
+ * @return true if it does.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsWindowTransform
+(
+    obs_TransformType_t transformType
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (   (transformType == OBS_TRANSFORM_TYPE_MOVING_MEAN)
+            || (transformType == OBS_TRANSFORM_TYPE_MOVING_STDDEV)
+            || (transformType == OBS_TRANSFORM_TYPE_MOVING_MAX)
+            || (transformType == OBS_TRANSFORM_TYPE_MOVING_MIN)  );
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Adds a given data sample to the buffer of a given Observation.
+ * Get a pointer to an entry in a set of running stats.
+ *
+ * @return Pointer to the entry.
  */
 //--------------------------------------------------------------------------------------------------
-static void AddToBuffer
+static inline StatsEntry_t* GetStatsEntry
 (
-    Observation_t* obsPtr,
-    dataSample_Ref_t sampleRef
+    RunningStats_t* statsPtr,
+    size_t offset   ///< Position of the entry relative to the oldest value (0 = oldest).
 )
 //--------------------------------------------------------------------------------------------------
 {
-    BufferEntry_t* buffEntryPtr;
+    size_t index = statsPtr->head + offset;
 
-    // If the new sample is timestamped older than the newest sample already in the buffer,
-    // then we have a serious problem, because buffer traversal operations could get stuck in loops.
-    le_sls_Link_t* linkPtr = le_sls_PeekTail(&obsPtr->sampleList);
-    if (linkPtr != NULL)
+    if (index >= statsPtr->capacity)
     {
-        buffEntryPtr = CONTAINER_OF(linkPtr, BufferEntry_t, link);
-
-        double oldEntryTimestamp = dataSample_GetTimestamp(buffEntryPtr->sampleRef);
-        double newEntryTimestamp = dataSample_GetTimestamp(sampleRef);
-
-        if (oldEntryTimestamp > newEntryTimestamp)
-        {
-            LE_ERROR("New sample has older timestamp than (older) sample already in the buffer!");
-            LE_ERROR("Dropping new sample timestamped %lf (< %lf in buffer)!",
-                     newEntryTimestamp,
-                     oldEntryTimestamp);
-            return;
-        }
+        index -= statsPtr->capacity;
     }
 
-    buffEntryPtr = le_mem_ForceAlloc(BufferEntryPool);
+    return &statsPtr->entryPtr[index];
+}
 
-    le_mem_AddRef(sampleRef);
-    buffEntryPtr->sampleRef = sampleRef;
-    buffEntryPtr->link = LE_SLS_LINK_INIT;
-    le_sls_Queue(&obsPtr->sampleList, &buffEntryPtr->link);
 
-    (obsPtr->count)++;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the value with a given sequence number from a set of running stats.  The value must still
+ * be in the window.
+ *
+ * @return The value.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline double GetStatsValue
+(
+    RunningStats_t* statsPtr,
+    uint64_t seq
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return GetStatsEntry(statsPtr, seq - statsPtr->headSeq)->value;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * If the number of entries in a given Observation's buffer is larger than the number given,
- * discard enough of the oldest entries to correct that condition.
+ * Get the sequence number at the back (newest end) of a sequence number queue.
+ *
+ * @return The sequence number.  The queue must not be empty.
  */
 //--------------------------------------------------------------------------------------------------
-static void TruncateBuffer
+static inline uint64_t GetQueueBack
 (
-    Observation_t* obsPtr,
-    size_t count
+    SeqDeque_t* queuePtr,
+    size_t capacity     ///< Number of slots in the queue's ring.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    while (obsPtr->count > count)
-    {
-        le_sls_Link_t* linkPtr = le_sls_Pop(&obsPtr->sampleList);
+    size_t index = queuePtr->head + queuePtr->len - 1;
 
-        le_mem_Release(CONTAINER_OF(linkPtr, BufferEntry_t, link));
-
-        (obsPtr->count)--;
+    if (index >= capacity)
+    {
+        index -= capacity;
     }
+
+    return queuePtr->seqPtr[index];
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Update the value of a data sample by replacing it, if necessary
+ * Add a value to the back of a min or max queue, first dropping the values that can no longer
+ * become the minimum (or maximum) because the new value is smaller (or larger) and will stay
+ * in the window longer than they will.
  */
 //--------------------------------------------------------------------------------------------------
-static dataSample_Ref_t UpdateSample
+static void PushToQueue
 (
-    dataSample_Ref_t sampleRef,
-    io_DataType_t dataType,
-    void *valuePtr
+    RunningStats_t* statsPtr,
+    SeqDeque_t* queuePtr,
+    uint64_t seq,   ///< Sequence number of the new value.
+    double value,   ///< The new value.
+    bool isMax      ///< true if this is the max queue, false if it is the min queue.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    dataSample_Ref_t sample = sampleRef;
-    double timestamp = dataSample_GetTimestamp(sampleRef);
+    size_t capacity = statsPtr->capacity;
 
-
-    switch (dataType)
+    while (queuePtr->len > 0)
     {
-        case IO_DATA_TYPE_BOOLEAN:
-        {
-            bool value = *((double *)valuePtr) > 0.0 ? true : false;
-            if (dataSample_GetBoolean(sampleRef) != value)
-            {
-                sample = dataSample_CreateBoolean(timestamp, value);
-            }
-            break;
-        }
+        double backValue = GetStatsValue(statsPtr, GetQueueBack(queuePtr, capacity));
 
-        case IO_DATA_TYPE_NUMERIC:
+        if (isMax ? (backValue > value) : (backValue < value))
         {
-            double value = *((double *)valuePtr);
-            if (dataSample_GetNumeric(sampleRef) != value)
-            {
-                sample = dataSample_CreateNumeric(timestamp, value);
-            }
+            break;
         }
 
-        default:
-            break;
+        (queuePtr->len)--;
     }
 
-    if (sample != sampleRef)
+    size_t index = queuePtr->head + queuePtr->len;
+    if (index >= capacity)
     {
-        le_mem_Release(sampleRef);
+        index -= capacity;
     }
 
-    return sample;
+    queuePtr->seqPtr[index] = seq;
+    (queuePtr->len)++;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Writes a buffer load of data to a buffered file stream.
- *
- * On error, logs an error message and closes the file.
- *
- * @return true if successful, false if failed.
+ * Remove a value from the front of a min or max queue, if it is there.
  */
 //--------------------------------------------------------------------------------------------------
-static bool WriteToStream
+static void PopFromQueue
 (
-    FILE* file,
-    const void* buffPtr,
-    size_t buffSize
+    RunningStats_t* statsPtr,
+    SeqDeque_t* queuePtr,
+    uint64_t seq    ///< Sequence number of the value leaving the window.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    size_t recordsWritten = fwrite(buffPtr, buffSize, 1, file);
-    if (recordsWritten != 1)
+    if ((queuePtr->len > 0) && (queuePtr->seqPtr[queuePtr->head] == seq))
     {
-        LE_CRIT("Failed to write (%m).");
-        le_atomFile_CancelStream(file);
-        return false;
+        (queuePtr->head)++;
+        if (queuePtr->head >= statsPtr->capacity)
+        {
+            queuePtr->head = 0;
+        }
+
+        (queuePtr->len)--;
     }
-    return true;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Reads a buffer load of data from a backup file.
- *
- * On error, logs an error message and closes the file.
- *
- * @return LE_OK if successful, LE_UNDERFLOW if the end of file was reached, LE_FAULT if failed.
+ * Move the contents of a min or max queue into a new ring.  Frees the old ring.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t ReadFromFile
+static void MoveQueue
 (
-    void* buffPtr,
-    size_t buffSize,
-    FILE* file
+    SeqDeque_t* queuePtr,
+    size_t oldCapacity,
+    uint64_t* newSeqPtr     ///< New ring (must be large enough to hold the queue's contents).
 )
 //--------------------------------------------------------------------------------------------------
 {
-    size_t bytesRead = fread(buffPtr, 1, buffSize, file);
-
-    le_result_t result = LE_OK;
-
-    if (bytesRead < buffSize)
+    size_t i;
+    for (i = 0; i < queuePtr->len; i++)
     {
-        if (feof(file))
-        {
-            result = LE_UNDERFLOW;
-        }
-        else
+        size_t index = queuePtr->head + i;
+        if (index >= oldCapacity)
         {
-            LE_CRIT("Failed to read (%m).");
-            result = LE_FAULT;
+            index -= oldCapacity;
         }
 
-        le_atomFile_CancelStream(file);
+        newSeqPtr[i] = queuePtr->seqPtr[index];
     }
 
-    return result;
+    free(queuePtr->seqPtr);
+
+    queuePtr->seqPtr = newSeqPtr;
+    queuePtr->head = 0;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Gets the data type code byte to be written into a backup file.
- *
- * @return the data type code byte.
+ * Recompute the mean and sum of squares of a set of running stats from the values in its window.
+ * This is done once in a while to stop rounding errors from building up as values are removed
+ * from the sums.
  */
 //--------------------------------------------------------------------------------------------------
-static uint8_t GetDataTypeCode
+static void RecomputeRunningSums
 (
-    Observation_t* obsPtr
+    RunningStats_t* statsPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    switch (res_GetDataType(&obsPtr->resource))
+    statsPtr->mean = 0;
+    statsPtr->sumSquares = 0;
+    statsPtr->removals = 0;
+
+    size_t i;
+    for (i = 0; i < statsPtr->count; i++)
     {
-        case IO_DATA_TYPE_TRIGGER:  return 't';
-        case IO_DATA_TYPE_BOOLEAN:  return 'b';
-        case IO_DATA_TYPE_NUMERIC:  return 'n';
-        case IO_DATA_TYPE_STRING:   return 's';
-        case IO_DATA_TYPE_JSON:     return 'j';
+        double value = GetStatsEntry(statsPtr, i)->value;
+        double delta = value - statsPtr->mean;
+
+        statsPtr->mean += delta / (i + 1);
+        statsPtr->sumSquares += delta * (value - statsPtr->mean);
     }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a value to the newest end of a set of running stats' window.  There must be room for it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddStat
+(
+    RunningStats_t* statsPtr,
+    double timestamp,
+    double value    ///< Value to add (not NAN).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(statsPtr->count < statsPtr->capacity);
+
+    uint64_t seq = statsPtr->headSeq + statsPtr->count;
+
+    StatsEntry_t* entryPtr = GetStatsEntry(statsPtr, statsPtr->count);
+    entryPtr->timestamp = timestamp;
+    entryPtr->value = value;
+
+    (statsPtr->count)++;
+
+    double delta = value - statsPtr->mean;
+    statsPtr->mean += delta / statsPtr->count;
+    statsPtr->sumSquares += delta * (value - statsPtr->mean);
 
-    LE_FATAL("Invalid data type %d.", res_GetDataType(&obsPtr->resource));
+    PushToQueue(statsPtr, &statsPtr->minQueue, seq, value, false);
+    PushToQueue(statsPtr, &statsPtr->maxQueue, seq, value, true);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Gets the data type represented by the code byte read from a backup file.
- *
- * @return true if successful, false on error.
+ * Remove the oldest value from a set of running stats' window.  The window must not be empty.
  */
 //--------------------------------------------------------------------------------------------------
-static bool GetDataTypeFromCode
+static void RemoveOldestStat
 (
-    io_DataType_t* dataTypePtr, ///< [OUT] Ptr to where the result will be put on success.
-    uint8_t code
+    RunningStats_t* statsPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    switch (code)
+    double value = GetStatsEntry(statsPtr, 0)->value;
+
+    PopFromQueue(statsPtr, &statsPtr->minQueue, statsPtr->headSeq);
+    PopFromQueue(statsPtr, &statsPtr->maxQueue, statsPtr->headSeq);
+
+    (statsPtr->head)++;
+    if (statsPtr->head >= statsPtr->capacity)
     {
-        case 't': *dataTypePtr = IO_DATA_TYPE_TRIGGER; return true;
-        case 'b': *dataTypePtr = IO_DATA_TYPE_BOOLEAN; return true;
-        case 'n': *dataTypePtr = IO_DATA_TYPE_NUMERIC; return true;
-        case 's': *dataTypePtr = IO_DATA_TYPE_STRING;  return true;
-        case 'j': *dataTypePtr = IO_DATA_TYPE_JSON;    return true;
+        statsPtr->head = 0;
     }
+    (statsPtr->headSeq)++;
+    (statsPtr->count)--;
 
-    LE_CRIT("Invalid data type code %d.", (int)code);
+    if (statsPtr->count == 0)
+    {
+        statsPtr->mean = 0;
+        statsPtr->sumSquares = 0;
+        statsPtr->removals = 0;
+        return;
+    }
 
-    return false;
+    double oldMean = statsPtr->mean;
+    statsPtr->mean -= (value - oldMean) / statsPtr->count;
+    statsPtr->sumSquares -= (value - oldMean) * (value - statsPtr->mean);
+    if (statsPtr->sumSquares < 0)
+    {
+        statsPtr->sumSquares = 0;
+    }
+
+    // Recompute the sums once per window length worth of removals.  This keeps the average cost
+    // per value constant.
+    (statsPtr->removals)++;
+    if (statsPtr->removals >= statsPtr->capacity)
+    {
+        RecomputeRunningSums(statsPtr);
+    }
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Writes all the data samples for a given Observation to a given backup file.
+ * Change the number of values a set of running stats' window can hold.  If the window holds more
+ * values than the new capacity, the oldest ones are removed.
  *
- * On error, logs an error message and closes the file.
- *
- * @return true if successful, false if failed.
+ * @return LE_OK if successful, LE_NO_MEMORY if the new rings could not be allocated (in which case
+ *         the stats are unchanged).
  */
 //--------------------------------------------------------------------------------------------------
-static bool WriteSamplesToFile
+static le_result_t ResizeRunningStats
 (
-    FILE* file,
-    Observation_t* obsPtr
+    RunningStats_t* statsPtr,
+    size_t capacity
 )
 //--------------------------------------------------------------------------------------------------
 {
-    io_DataType_t dataType = obsPtr->bufferedType;
+    StatsEntry_t* newEntryPtr = NULL;
+    uint64_t* newMinQueuePtr = NULL;
+    uint64_t* newMaxQueuePtr = NULL;
 
-    BufferEntry_t* buffEntryPtr = GetOldestBufferEntry(obsPtr);
-
-    while (buffEntryPtr != NULL)
+    if (capacity > 0)
     {
-        // Write the timestamp.
-        double timestamp = dataSample_GetTimestamp(buffEntryPtr->sampleRef);
-        if (!WriteToStream(file, &timestamp, sizeof(timestamp)))
-        {
-            return false;
-        }
+        newEntryPtr = calloc(capacity, sizeof(StatsEntry_t));
+        newMinQueuePtr = calloc(capacity, sizeof(uint64_t));
+        newMaxQueuePtr = calloc(capacity, sizeof(uint64_t));
 
-        switch (dataType)
+        if ((newEntryPtr == NULL) || (newMinQueuePtr == NULL) || (newMaxQueuePtr == NULL))
         {
-            case IO_DATA_TYPE_TRIGGER:
+            LE_CRIT("Failed to allocate running stats for %zu values.", capacity);
+            free(newEntryPtr);
+            free(newMinQueuePtr);
+            free(newMaxQueuePtr);
+            return LE_NO_MEMORY;
+        }
+    }
 
-                // No Value.
-                break;
+    while (statsPtr->count > capacity)
+    {
+        RemoveOldestStat(statsPtr);
+    }
 
-            case IO_DATA_TYPE_BOOLEAN:
-            {
-                bool value = dataSample_GetBoolean(buffEntryPtr->sampleRef);
-                if (!WriteToStream(file, &value, sizeof(value)))
-                {
-                    return false;
-                }
-                break;
-            }
-            case IO_DATA_TYPE_NUMERIC:
-            {
-                double value = dataSample_GetNumeric(buffEntryPtr->sampleRef);
-                if (!WriteToStream(file, &value, sizeof(value)))
-                {
-                    return false;
-                }
-                break;
-            }
-            case IO_DATA_TYPE_STRING:
-            {
-                const char* valuePtr = dataSample_GetString(buffEntryPtr->sampleRef);
-                uint32_t stringLen = strlen(valuePtr);
-                if (!WriteToStream(file, &stringLen, 4))
-                {
-                    return false;
-                }
-                if (!WriteToStream(file, valuePtr, stringLen))
-                {
-                    return false;
-                }
-                break;
-            }
-            case IO_DATA_TYPE_JSON:
-            {
-                const char* valuePtr = dataSample_GetJson(buffEntryPtr->sampleRef);
-                uint32_t stringLen = strlen(valuePtr);
-                if (!WriteToStream(file, &stringLen, 4))
-                {
-                    return false;
-                }
-                if (!WriteToStream(file, valuePtr, stringLen))
-                {
-                    return false;
-                }
-                break;
-            }
-        }
-
-        buffEntryPtr = GetNextBufferEntry(obsPtr, buffEntryPtr);
+    size_t i;
+    for (i = 0; i < statsPtr->count; i++)
+    {
+        newEntryPtr[i] = *GetStatsEntry(statsPtr, i);
     }
 
-    return true;
+    MoveQueue(&statsPtr->minQueue, statsPtr->capacity, newMinQueuePtr);
+    MoveQueue(&statsPtr->maxQueue, statsPtr->capacity, newMaxQueuePtr);
+
+    free(statsPtr->entryPtr);
+
+    statsPtr->entryPtr = newEntryPtr;
+    statsPtr->capacity = capacity;
+    statsPtr->head = 0;
+
+    return LE_OK;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Reads all the data samples from a given backup file and adds them to a given Observation's
- * data sample buffer.  Closes the file when done.
+ * Create an empty set of running stats.
+ *
+ * @return Pointer to the stats, or NULL if their rings could not be allocated.
  */
 //--------------------------------------------------------------------------------------------------
-static void ReadSamplesFromFile
+static RunningStats_t* CreateRunningStats
 (
-    Observation_t* obsPtr,
-    FILE* file,
-    size_t count    ///< The expected number of samples to read.
+    size_t capacity     ///< Number of values the window can hold.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (count == 0)
+    RunningStats_t* statsPtr = le_mem_ForceAlloc(RunningStatsPool);
+    memset(statsPtr, 0, sizeof(*statsPtr));
+
+    if (ResizeRunningStats(statsPtr, capacity) != LE_OK)
     {
-        return;
+        le_mem_Release(statsPtr);
+        return NULL;
     }
 
-    io_DataType_t dataType = obsPtr->bufferedType;
+    return statsPtr;
+}
 
-    dataSample_Ref_t dataSample = NULL;
 
-    for (;;)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop keeping running stats for an Observation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteRunningStats
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    RunningStats_t* statsPtr = obsPtr->statsPtr;
+
+    if (statsPtr != NULL)
     {
-        // Read the timestamp.
-        double timestamp;
-        le_result_t result = ReadFromFile(&timestamp, sizeof(timestamp), file);
-        if (result != LE_OK)
-        {
-            if (result == LE_UNDERFLOW)
-            {
-                // End of file reached, check that we've received all we should.
-                if (count == 0)
-                {
-                    // The file contained exactly the number of samples we expected.
-                    // The last data sample read from the file (which is the newest)
-                    // should be pushed to the Observation so it becomes the current value.
-                    res_Push(&obsPtr->resource, dataType, "", dataSample);
-                    return;
-                }
-                else
-                {
-                    LE_CRIT("Backup file was truncated. Expected %zu more samples.", count);
-                }
-            }
+        free(statsPtr->entryPtr);
+        free(statsPtr->minQueue.seqPtr);
+        free(statsPtr->maxQueue.seqPtr);
+        le_mem_Release(statsPtr);
 
-            goto error;
-        }
+        obsPtr->statsPtr = NULL;
+    }
+}
 
-        // We succeeded in reading another timestamp, so we had better be expecting more samples.
-        if (count == 0)
-        {
-            LE_CRIT("Backup file contains extra samples.");
-            le_atomFile_CancelStream(file);
-            goto error;
-        }
 
-        count--;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the value of a running statistic that a transform reports.
+ *
+ * @return The value, or NAN if the window is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetRunningStat
+(
+    RunningStats_t* statsPtr,
+    obs_TransformType_t transformType
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if ((statsPtr == NULL) || (statsPtr->count == 0))
+    {
+        return NAN;
+    }
 
-        switch (dataType)
-        {
-            case IO_DATA_TYPE_TRIGGER:
+    switch (transformType)
+    {
+        case OBS_TRANSFORM_TYPE_MEAN:
+        case OBS_TRANSFORM_TYPE_MOVING_MEAN:
 
-                // No Value.
-                dataSample = dataSample_CreateTrigger(timestamp);
-                break;
+            return statsPtr->mean;
 
-            case IO_DATA_TYPE_BOOLEAN:
-            {
-                bool value;
-                if (ReadFromFile(&value, sizeof(value), file) != LE_OK)
-                {
-                    LE_CRIT("Failed to read boolean value.");
-                    goto error;
-                }
-                dataSample = dataSample_CreateBoolean(timestamp, value);
-                break;
-            }
-            case IO_DATA_TYPE_NUMERIC:
-            {
-                double value;
-                if (ReadFromFile(&value, sizeof(value), file) != LE_OK)
-                {
-                    LE_CRIT("Failed to read numeric value.");
-                    goto error;
-                }
-                dataSample = dataSample_CreateNumeric(timestamp, value);
-                break;
-            }
-            case IO_DATA_TYPE_STRING:
-            {
-                char value[IO_MAX_STRING_VALUE_LEN + 1];
+        case OBS_TRANSFORM_TYPE_STDDEV:
+        case OBS_TRANSFORM_TYPE_MOVING_STDDEV:
 
-                uint32_t stringLen;
-                if (ReadFromFile(&stringLen, 4, file) != LE_OK)
-                {
-                    LE_CRIT("Failed to read string length.");
-                    goto error;
-                }
-                if (stringLen > (sizeof(value) - 1))
-                {
-                    LE_CRIT("String length (%zu) is larger than permitted (%zu).",
-                            (size_t)stringLen,
-                            sizeof(value) - 1);
-                    le_atomFile_CancelStream(file);
-                    goto error;
-                }
-                if (ReadFromFile(value, stringLen, file) != LE_OK)
-                {
-                    LE_CRIT("Failed to read string value of length %zu.", (size_t)stringLen);
-                    goto error;
-                }
-                value[stringLen] = '\0';
-                dataSample = dataSample_CreateString(timestamp, value);
-                break;
-            }
-            case IO_DATA_TYPE_JSON:
-            {
-                char value[IO_MAX_STRING_VALUE_LEN + 1];
+            return sqrt(statsPtr->sumSquares / statsPtr->count);
 
-                uint32_t stringLen;
-                if (ReadFromFile(&stringLen, 4, file) != LE_OK)
-                {
-                    LE_CRIT("Failed to read JSON object length.");
-                    goto error;
-                }
-                if (stringLen > (sizeof(value) - 1))
-                {
-                    LE_CRIT("JSON string length (%zu) is larger than permitted (%zu).",
-                            (size_t)stringLen,
-                            sizeof(value) - 1);
-                    le_atomFile_CancelStream(file);
-                    goto error;
-                }
-                if (ReadFromFile(value, stringLen, file) != LE_OK)
-                {
-                    LE_CRIT("Failed to read JSON value of length %zu.", (size_t)stringLen);
-                    goto error;
-                }
-                value[stringLen] = '\0';
-                dataSample = dataSample_CreateJson(timestamp, value);
-                break;
-            }
-        }
+        case OBS_TRANSFORM_TYPE_MAX:
+        case OBS_TRANSFORM_TYPE_MOVING_MAX:
 
-        // Add the sample to the buffer, unless this is the last (newest) sample, in which case
-        // we will push it to the Observation later when we confirm that the file doesn't have
-        // more than expected in it (which would mean that all these samples are probably corrupt
-        // and need to be discarded).
-        if (count != 0)
-        {
-            AddToBuffer(obsPtr, dataSample);
-        }
-    }
+            return GetStatsValue(statsPtr, statsPtr->maxQueue.seqPtr[statsPtr->maxQueue.head]);
 
-error:
+        case OBS_TRANSFORM_TYPE_MIN:
+        case OBS_TRANSFORM_TYPE_MOVING_MIN:
 
-    // On error, dump the buffer contents in case we read some corrupted samples from the file.
-    TruncateBuffer(obsPtr, 0);
+            return GetStatsValue(statsPtr, statsPtr->minQueue.seqPtr[statsPtr->minQueue.head]);
+
+        default:
+
+            return NAN;
+    }
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Perform a backup to non-volatile storage of an observation's data sample buffer.
+ * Add a value to a moving window transform's running stats, first removing the values that the
+ * new one pushes out of the window.
  */
 //--------------------------------------------------------------------------------------------------
-static void Backup
+static void AddToWindow
 (
-    Observation_t* obsPtr
+    Observation_t* obsPtr,
+    double timestamp,
+    double value    ///< Value to add (not NAN).
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // If the backup timer exists, delete it.
-    if (obsPtr->backupTimer != NULL)
-    {
-        le_timer_Delete(obsPtr->backupTimer);
-        obsPtr->backupTimer = NULL;
-    }
-
-    // Update the time of last backup.
-    le_clk_Time_t now = le_clk_GetRelativeTime();
-    obsPtr->lastBackupTime = now.sec;
-
-    // Get the backup file path.
-    char path[MAX_BACKUP_FILE_PATH_BYTES];
-    if (GetBackupFilePath(path, sizeof(path), obsPtr) != LE_OK)
-    {
-        return;
-    }
+    RunningStats_t* statsPtr = obsPtr->statsPtr;
 
-    LE_DEBUG("Backing up to '%s'...", path);
-
-    // Create the backup directory, if it doesn't exist already.
-    struct stat st = {0};
-    if (stat(BACKUP_DIR, &st) == -1)
+    // Drop values that are older than the window period.
+    if (obsPtr->windowPeriod > 0)
     {
-        LE_DEBUG("Creating directory '" BACKUP_DIR "'.");
+        double windowStart = timestamp - obsPtr->windowPeriod;
 
-        if (mkdir(BACKUP_DIR, 0700) == -1)
+        while ((statsPtr->count > 0) && (GetStatsEntry(statsPtr, 0)->timestamp <= windowStart))
         {
-            LE_CRIT("Unable to create directory '" BACKUP_DIR "' (%m).");
-            return;
+            RemoveOldestStat(statsPtr);
         }
     }
 
-    // Open the file for writing, truncating it to zero length to start.
-    le_result_t result;
-    FILE* file = le_atomFile_CreateStream(path,
-                                          LE_FLOCK_WRITE,
-                                          LE_FLOCK_REPLACE_IF_EXIST,
-                                          0600,
-                                          &result);
-    if (result != LE_OK)
-    {
-        LE_CRIT("Unable to open file '%s' for writing (%s).", path, LE_RESULT_TXT(result));
-        return;
-    }
-
-    // Write in the version byte.
-    uint8_t byte = 0;
-    if (!WriteToStream(file, &byte, 1))
-    {
-        return;
-    }
-
-    // Write the data type code.
-    byte = GetDataTypeCode(obsPtr);
-    if (byte == 0)
-    {
-        le_atomFile_CancelStream(file);
-        return;
-    }
-    if (!WriteToStream(file, &byte, 1))
+    if (statsPtr->count == statsPtr->capacity)
     {
-        return;
+        // If the window is limited by count, it's full.  Otherwise, it's only limited by time,
+        // so grow it (or drop the oldest value if there's no memory for that).
+        if (   (obsPtr->windowCount > 0)
+            || (ResizeRunningStats(statsPtr, statsPtr->capacity * 2) != LE_OK))
+        {
+            RemoveOldestStat(statsPtr);
+        }
     }
 
-    // Write in the number of samples.
-    uint32_t count = obsPtr->count;
-    if (!WriteToStream(file, &count, 4))
-    {
-        return;
-    }
+    AddStat(statsPtr, timestamp, value);
+}
 
-    // Write all the data samples to the file.
-    if (!WriteSamplesToFile(file, obsPtr))
-    {
-        return;
-    }
 
-    // Commit the file.
-    result = le_atomFile_CloseStream(file);
-    if (result != LE_OK)
-    {
-        LE_CRIT("Failed to save '%s' (%s).", path, LE_RESULT_TXT(result));
-    }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the oldest block of an Observation's compressed buffer, along with the samples still
+ * buffered in it, and move on to the oldest sample in the next block.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseOldestBlock
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t count = gorilla_ReleaseOldestBlock(obsPtr->compressedPtr);
 
-    LE_DEBUG("Backup complete.");
+    obsPtr->count -= count;
+    obsPtr->oldestSeq += count;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Disable backups of a given Observation's data sample buffer.
+ * Release an Observation's compressed buffer (and all its blocks), if it has one.
  */
 //--------------------------------------------------------------------------------------------------
-static void DisableBackups
+static void DeleteCompressedBuffer
 (
     Observation_t* obsPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (obsPtr->backupTimer != NULL)
+    if (obsPtr->compressedPtr != NULL)
     {
-        le_timer_Stop(obsPtr->backupTimer);
-        le_timer_Delete(obsPtr->backupTimer);
-        obsPtr->backupTimer = NULL;
+        gorilla_DeleteBuffer(obsPtr->compressedPtr);
+        obsPtr->compressedPtr = NULL;
     }
-
-    obsPtr->lastBackupTime = 0;
-
-    DeleteBackup(obsPtr);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Timer expiry handler function for Observation data sample buffer backup timers.
+ * Check whether an Observation's buffer should be compressed if it had a given size.
  *
- * Saves the contents of an Observation's data sample buffer to non-volatile storage.
- *
- * @note The timer should only be running if a data sample arrived in the buffer before the
- *       backup period had elapsed since the previous backup.
+ * @return true if it should.
  */
 //--------------------------------------------------------------------------------------------------
-static void BackupTimerExpired
+static bool ShouldCompress
 (
-    le_timer_Ref_t timer
+    Observation_t* obsPtr,
+    size_t maxCount
 )
 //--------------------------------------------------------------------------------------------------
 {
-    Observation_t* obsPtr = le_timer_GetContextPtr(timer);
-
-    Backup(obsPtr);
+    // A persistent buffer is kept in a ring file instead.
+    return (   obsPtr->compressBuffer
+            && (!obsPtr->persistBuffer)
+            && (obsPtr->bufferedType == IO_DATA_TYPE_NUMERIC)
+            && (maxCount > 0)  );
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Initialize the Observation module.
- *
- * @warning This must be called before any other function in this module is called.
+ * Copy the sample a block cursor is positioned on into a buffer cursor's slot.
  */
 //--------------------------------------------------------------------------------------------------
-void obs_Init
+static inline void LoadDecodedSlot
 (
-    void
+    BufferCursor_t* cursorPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    ObservationPool = le_mem_CreatePool("Observation", sizeof(Observation_t));
-    le_mem_SetDestructor(ObservationPool, ObservationDestructor);
-
-    BufferEntryPool = le_mem_CreatePool("Buffer Entry", sizeof(BufferEntry_t));
-    le_mem_SetDestructor(BufferEntryPool, BufferEntryDestructor);
-
-    ReadOperationPool = le_mem_CreatePool("Read Op", sizeof(ReadOperation_t));
+    cursorPtr->slot.timestamp = cursorPtr->block.state.timestamp;
+    cursorPtr->slot.value.numeric = gorilla_GetValue(&cursorPtr->block.state);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Create an Observation object.  This allocates the object and initializes the class members,
- * but not the parent class members.
+ * Position a cursor on a sample in an Observation's buffer.
  *
- * @return Pointer to the new object.
+ * @return true if successful, false if the buffer doesn't hold that many samples.
  */
 //--------------------------------------------------------------------------------------------------
-res_Resource_t* obs_Create
+static bool SeekBuffer
 (
-    resTree_EntryRef_t entryRef ///< The resource tree entry to attach this Resource to.
+    Observation_t* obsPtr,
+    BufferCursor_t* cursorPtr,  ///< [OUT] The cursor.
+    size_t offset   ///< Position of the sample relative to the oldest (0 = oldest).
 )
 //--------------------------------------------------------------------------------------------------
 {
-    Observation_t* obsPtr = le_mem_ForceAlloc(ObservationPool);
+    if (offset >= obsPtr->count)
+    {
+        return false;
+    }
 
-    res_Construct(&obsPtr->resource, entryRef);
+    cursorPtr->seq = obsPtr->oldestSeq + offset;
 
-    obsPtr->lowLimit = NAN;
-    obsPtr->highLimit = NAN;
-    obsPtr->changeBy = NAN;
-    obsPtr->minPeriod = NAN;
+    if (obsPtr->compressedPtr == NULL)
+    {
+        ReadSlot(obsPtr, offset, &cursorPtr->slot);
+        return true;
+    }
 
-    obsPtr->maxCount = 0;
-    obsPtr->count = 0;
+    gorilla_Buffer_t* bufPtr = obsPtr->compressedPtr;
+    gorilla_Cursor_t* blockCursorPtr = &cursorPtr->block;
 
-    obsPtr->transformType = OBS_TRANSFORM_TYPE_NONE;
+    *blockCursorPtr = bufPtr->oldest;
 
-    obsPtr->bufferedType = IO_DATA_TYPE_TRIGGER;
+    // Skip whole blocks until reaching the one holding the sample, then decode up to it.
+    size_t rest = blockCursorPtr->blockPtr->count - blockCursorPtr->nextIndex;
+    while (offset > rest)
+    {
+        offset -= rest + 1;
 
-    obsPtr->backupPeriod = 0;
-    obsPtr->lastBackupTime = 0;
-    obsPtr->backupTimer = NULL;
+        le_sls_Link_t* linkPtr = le_sls_PeekNext(&bufPtr->blockList,
+                                                 &blockCursorPtr->blockPtr->link);
+        LE_ASSERT(linkPtr != NULL);
+        LE_ASSERT(gorilla_StartCursor(blockCursorPtr,
+                                      CONTAINER_OF(linkPtr, gorilla_Block_t, link)));
 
-    obsPtr->sampleList = LE_SLS_LIST_INIT;
+        rest = blockCursorPtr->blockPtr->count - blockCursorPtr->nextIndex;
+    }
 
-    obsPtr->readOpList = LE_DLS_LIST_INIT;
+    while (offset > 0)
+    {
+        LE_ASSERT(gorilla_DecodeNext(blockCursorPtr));
+        offset--;
+    }
 
-    obsPtr->jsonExtraction[0] = '\0';
+    LoadDecodedSlot(cursorPtr);
 
-    return &obsPtr->resource;
+    return true;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Restore an Observation's data buffer from non-volatile backup, if one exists.
+ * Move a cursor on to the next sample in an Observation's buffer.  The sample the cursor is
+ * positioned on must still be in the buffer.
+ *
+ * @return true if successful, false if there are no more samples.
  */
 //--------------------------------------------------------------------------------------------------
-void obs_RestoreBackup
+static bool NextInBuffer
 (
-    res_Resource_t* resPtr
+    Observation_t* obsPtr,
+    BufferCursor_t* cursorPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+    size_t offset = cursorPtr->seq + 1 - obsPtr->oldestSeq;
 
-    // If there's no backup directory yet, then we know there are no backups, so don't
-    // try opening one (which would result in an error message in the logs because the lock file
-    // can't be created).
-    struct stat st = {0};
-    if (stat(BACKUP_DIR, &st) == -1)
+    if (offset >= obsPtr->count)
     {
-        LE_DEBUG("Backup directory '" BACKUP_DIR "' not found. (%m)");
-        return;
+        return false;
     }
 
-    char path[MAX_BACKUP_FILE_PATH_BYTES];
-    if (GetBackupFilePath(path, sizeof(path), obsPtr) != LE_OK)
+    (cursorPtr->seq)++;
+
+    if (obsPtr->compressedPtr == NULL)
     {
-        return;
+        ReadSlot(obsPtr, offset, &cursorPtr->slot);
+        return true;
     }
 
-    LE_INFO("Loading observation buffer from file '%s'.", path);
-
-    // Open the file for reading.
-    le_result_t result;
-    FILE* file = le_atomFile_OpenStream(path, LE_FLOCK_READ, &result);
-    if (result != LE_OK)
+    if (!gorilla_AdvanceCursor(obsPtr->compressedPtr, &cursorPtr->block))
+    {
+        return false;
+    }
+
+    LoadDecodedSlot(cursorPtr);
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the timestamp of the oldest sample in an Observation's buffer.  The buffer must not be empty.
+ *
+ * @return The timestamp.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetOldestTimestamp
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (obsPtr->compressedPtr != NULL)
+    {
+        return obsPtr->compressedPtr->oldest.state.timestamp;
+    }
+
+    return GetSlotTimestamp(obsPtr, 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the timestamp of the newest sample in an Observation's buffer.  The buffer must not be empty.
+ *
+ * @return The timestamp.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetNewestTimestamp
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (obsPtr->compressedPtr != NULL)
+    {
+        return obsPtr->compressedPtr->newest.timestamp;
+    }
+
+    return GetSlotTimestamp(obsPtr, obsPtr->count - 1);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop keeping a quantile sketch for an Observation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteQuantileSketch
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (obsPtr->sketchRef != NULL)
+    {
+        quantile_DeleteSketch(obsPtr->sketchRef);
+        obsPtr->sketchRef = NULL;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bring an Observation's quantile sketch up to date with its buffer, up to a given sequence
+ * number.  Drops the segments whose values have all left the buffer, and adds any samples that
+ * got into the buffer without the sketch seeing them (such as when restoring a backup).
+ */
+//--------------------------------------------------------------------------------------------------
+static void SyncQuantileSketch
+(
+    Observation_t* obsPtr,
+    uint64_t endSeq     ///< Sequence number to stop at (the next one the sketch will see).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    quantile_SketchRef_t sketchRef = obsPtr->sketchRef;
+
+    if (quantile_GetNextSeq(sketchRef) > endSeq)
+    {
+        quantile_ResetSketch(sketchRef);
+    }
+
+    quantile_DropBefore(sketchRef, obsPtr->oldestSeq);
+
+    uint64_t nextSeq = quantile_GetNextSeq(sketchRef);
+    if (nextSeq < obsPtr->oldestSeq)
+    {
+        nextSeq = obsPtr->oldestSeq;
+    }
+
+    if (   (nextSeq < endSeq)
+        && (   (obsPtr->bufferedType == IO_DATA_TYPE_NUMERIC)
+            || (obsPtr->bufferedType == IO_DATA_TYPE_BOOLEAN)  )  )
+    {
+        BufferCursor_t cursor;
+        bool found;
+        for (found = SeekBuffer(obsPtr, &cursor, nextSeq - obsPtr->oldestSeq);
+             found && (cursor.seq < endSeq);
+             found = NextInBuffer(obsPtr, &cursor))
+        {
+            double value = GetBufferedNumber(&cursor.slot, obsPtr->bufferedType);
+
+            if (!isnan(value))
+            {
+                quantile_Add(sketchRef,
+                             obsPtr->maxCount,
+                             cursor.seq,
+                             cursor.slot.timestamp,
+                             value);
+            }
+        }
+    }
+
+    quantile_SetNextSeq(sketchRef, endSeq);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the Backup Thread still has jobs queued on a given Observation's backup file or
+ * backup journal.
+ *
+ * @return true if the Observation's backup files are still in use by the Backup Thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsBackupBusy
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char path[MAX_BACKUP_FILE_PATH_BYTES];
+    char journalPath[MAX_BACKUP_FILE_PATH_BYTES];
+    if (   (GetBackupFilePath(path, sizeof(path), obsPtr) != LE_OK)
+        || (GetJournalFilePath(journalPath, sizeof(journalPath), obsPtr) != LE_OK)  )
+    {
+        return false;
+    }
+
+    return (backupThread_IsFileBusy(path) || backupThread_IsFileBusy(journalPath));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the backup directory, if it doesn't exist already.
+ *
+ * @return true if successful.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool MakeBackupDir
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    struct stat st = {0};
+    if (stat(BACKUP_DIR, &st) == -1)
+    {
+        LE_DEBUG("Creating directory '" BACKUP_DIR "'.");
+
+        if (mkdir(BACKUP_DIR, 0700) == -1)
+        {
+            LE_CRIT("Unable to create directory '" BACKUP_DIR "' (%m).");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether an Observation's buffer should be kept in a ring file if it had a given size.
+ *
+ * @return true if it should.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ShouldMap
+(
+    Observation_t* obsPtr,
+    size_t maxCount
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // String and JSON slots hold references to Data Samples, which can't outlive the Data Hub.
+    return (   obsPtr->persistBuffer
+            && (maxCount > 0)
+            && (   (obsPtr->bufferedType == IO_DATA_TYPE_TRIGGER)
+                || (obsPtr->bufferedType == IO_DATA_TYPE_BOOLEAN)
+                || (obsPtr->bufferedType == IO_DATA_TYPE_NUMERIC)  )  );
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy an Observation's buffer state into the header of its ring file, if its buffer is in one.
+ * Must be called after the slots have been updated.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void UpdateRingHeader
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ringFile_Header_t* ringPtr = obsPtr->ringPtr;
+    if (ringPtr == NULL)
+    {
+        return;
+    }
+
+    // Writes to the mapping survive a crash of the Data Hub in the page cache, so as long as the
+    // compiler doesn't move the slot writes after the header writes, the header never counts a
+    // slot that hasn't been written.
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+
+    ringPtr->dataType = obsPtr->bufferedType;
+    ringPtr->oldestIndex = obsPtr->oldestIndex;
+    ringPtr->count = obsPtr->count;
+    ringPtr->oldestSeq = obsPtr->oldestSeq;
+
+    obsPtr->isRingDirty = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an Observation to the Synced Ring List, if its buffer is in a ring file that should be
+ * synced periodically.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartRingSync
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if ((obsPtr->ringPtr == NULL) || (obsPtr->ringSyncPeriod == 0))
+    {
+        return;
+    }
+
+    obsPtr->lastRingSyncTime = le_clk_GetRelativeTime().sec;
+    le_dls_Queue(&SyncedRingList, &obsPtr->ringSyncLink);
+
+    if (!le_timer_IsRunning(RingSyncTimer))
+    {
+        LE_ASSERT(le_timer_Start(RingSyncTimer) == LE_OK);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove an Observation from the Synced Ring List, if it is in it.  Must be called before the
+ * Observation's ring file or sync period changes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopRingSync
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if ((obsPtr->ringPtr == NULL) || (obsPtr->ringSyncPeriod == 0))
+    {
+        return;
+    }
+
+    le_dls_Remove(&SyncedRingList, &obsPtr->ringSyncLink);
+
+    if (le_dls_IsEmpty(&SyncedRingList))
+    {
+        le_timer_Stop(RingSyncTimer);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ring sync timer expiry handler.  Queues syncs of the ring files that have changed and whose sync
+ * periods have passed to the Backup Thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RingSyncTimerExpired
+(
+    le_timer_Ref_t timer
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_UNUSED(timer);
+
+    uint32_t now = le_clk_GetRelativeTime().sec;
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&SyncedRingList);
+    while (linkPtr != NULL)
+    {
+        Observation_t* obsPtr = CONTAINER_OF(linkPtr, Observation_t, ringSyncLink);
+
+        if (obsPtr->isRingDirty && ((now - obsPtr->lastRingSyncTime) >= obsPtr->ringSyncPeriod))
+        {
+            obsPtr->isRingDirty = false;
+            obsPtr->lastRingSyncTime = now;
+
+            // The mapping isn't removed until the Backup Thread has done the jobs queued before.
+            backupThread_QueueFunction(ringFile_Sync, obsPtr->ringPtr, NULL);
+        }
+
+        linkPtr = le_dls_PeekNext(&SyncedRingList, linkPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unmap an Observation's ring file from memory.  Its buffer must be in one.  The file is left as
+ * it is.  The mapping is removed by the Backup Thread, once it is done with any syncs of it, but
+ * must not be used any more from now on.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UnmapRingFile
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    StopRingSync(obsPtr);
+
+    // Syncs of the file still queued to the Backup Thread need the mapping.
+    backupThread_QueueFunction(ringFile_Unmap, obsPtr->ringPtr, NULL);
+
+    obsPtr->ringPtr = NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete an Observation's ring file, if it has one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteRingFile
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char path[MAX_BACKUP_FILE_PATH_BYTES];
+    if (GetRingFilePath(path, sizeof(path), obsPtr) != LE_OK)
     {
-        LE_DEBUG("Unable to open '%s' for reading (%s).", path, LE_RESULT_TXT(result));
         return;
     }
 
-    // Read the version byte.
-    uint8_t byte;
-    if (ReadFromFile(&byte, 1, file) != LE_OK)
+    if ((unlink(path) != 0) && (errno != ENOENT))
+    {
+        LE_CRIT("Failed to delete ring file '%s' (%m).", path);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a new ring file for an Observation's buffer, with a given number of slots, and map it
+ * into memory.  See ringFile_Create().
+ *
+ * @return Pointer to the header at the start of the mapping (with the buffer state still to be
+ *         filled in), or NULL if failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static ringFile_Header_t* CreateRingFile
+(
+    Observation_t* obsPtr,
+    size_t maxCount,    ///< Number of slots.
+    int* fdPtr          ///< [OUT] File descriptor to commit the file with.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char path[MAX_BACKUP_FILE_PATH_BYTES];
+    if ((GetRingFilePath(path, sizeof(path), obsPtr) != LE_OK) || !MakeBackupDir())
+    {
+        return NULL;
+    }
+
+    // A clean-up may still be deleting a ring file left at the same path by a previous run.
+    backupThread_WaitForFile(path);
+
+    return ringFile_Create(path, maxCount, fdPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take over the ring file left by a previous run as an Observation's buffer, if there is a valid
+ * one.  The buffer must be empty.  The file is used in place, at the size it was created with.
+ *
+ * If power was lost before all of the file's pages were written to non-volatile storage, its
+ * header may count slots that hold older samples, so only the samples up to the first one out of
+ * order are kept.
+ *
+ * @return true if the file was taken over.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool AdoptRingFile
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char path[MAX_BACKUP_FILE_PATH_BYTES];
+    if (GetRingFilePath(path, sizeof(path), obsPtr) != LE_OK)
+    {
+        return false;
+    }
+
+    // A clean-up may still be deleting the file.
+    backupThread_WaitForFile(path);
+
+    ringFile_Header_t* ringPtr = ringFile_Open(path);
+    if (ringPtr == NULL)
+    {
+        return false;
+    }
+
+    io_DataType_t dataType = ringPtr->dataType;
+
+    // The running stats of a whole-buffer transform must be able to hold the whole buffer.
+    bool hasStats = ((obsPtr->statsPtr != NULL) && IsBufferTransform(obsPtr->transformType));
+    if (hasStats && (ResizeRunningStats(obsPtr->statsPtr, ringPtr->maxCount) != LE_OK))
+    {
+        ringFile_Unmap(ringPtr, NULL);
+        return false;
+    }
+
+    // The file's ring replaces the empty one.
+    DeleteCompressedBuffer(obsPtr);
+    free(obsPtr->bufferPtr);
+
+    obsPtr->ringPtr = ringPtr;
+    obsPtr->bufferPtr = NULL;
+    obsPtr->maxCount = ringPtr->maxCount;
+    obsPtr->oldestIndex = ringPtr->oldestIndex;
+    obsPtr->oldestSeq = ringPtr->oldestSeq;
+    obsPtr->bufferedType = dataType;
+
+    // The file's sequence numbers have nothing to do with the ones the quantile sketch has seen.
+    if (obsPtr->sketchRef != NULL)
+    {
+        quantile_ResetSketch(obsPtr->sketchRef);
+    }
+
+    // A record that doesn't hold the sample the header says it should (because its page didn't
+    // reach non-volatile storage) ends the buffer.
+    obsPtr->count = ringFile_CheckRecords(ringPtr, path);
+
+    if (hasStats && (dataType != IO_DATA_TYPE_TRIGGER))
+    {
+        size_t i;
+        for (i = 0; i < obsPtr->count; i++)
+        {
+            BufferSlot_t slot;
+            ReadSlot(obsPtr, i, &slot);
+
+            double value = GetBufferedNumber(&slot, dataType);
+
+            if (!isnan(value))
+            {
+                AddStat(obsPtr->statsPtr, slot.timestamp, value);
+            }
+        }
+    }
+
+    UpdateRingHeader(obsPtr);
+    StartRingSync(obsPtr);
+
+    LE_DEBUG("Buffer of %zu samples taken over from '%s'.", obsPtr->count, path);
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Discard the oldest data sample in an Observation's buffer.  The buffer must not be empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DiscardOldest
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    BufferSlot_t decodedSlot;
+    BufferSlot_t* slotPtr;
+
+    if (obsPtr->compressedPtr != NULL)
+    {
+        decodedSlot.timestamp = obsPtr->compressedPtr->oldest.state.timestamp;
+        decodedSlot.value.numeric = gorilla_GetValue(&obsPtr->compressedPtr->oldest.state);
+        slotPtr = &decodedSlot;
+    }
+    else if (obsPtr->ringPtr != NULL)
+    {
+        ReadSlot(obsPtr, 0, &decodedSlot);
+        slotPtr = &decodedSlot;
+    }
+    else
+    {
+        slotPtr = GetSlot(obsPtr, 0);
+    }
+
+    // If a whole-buffer transform is keeping running stats, the oldest value in their window is
+    // this sample's (unless this sample has no numerical value).
+    if ((obsPtr->statsPtr != NULL) && IsBufferTransform(obsPtr->transformType))
+    {
+        if (   (   (obsPtr->bufferedType == IO_DATA_TYPE_NUMERIC)
+                || (obsPtr->bufferedType == IO_DATA_TYPE_BOOLEAN)  )
+            && (!isnan(GetBufferedNumber(slotPtr, obsPtr->bufferedType)))  )
+        {
+            RemoveOldestStat(obsPtr->statsPtr);
+        }
+    }
+
+    if (obsPtr->compressedPtr != NULL)
+    {
+        gorilla_Cursor_t* oldestPtr = &obsPtr->compressedPtr->oldest;
+
+        // Once the last sample in the oldest block is discarded, the block goes with it.
+        if (oldestPtr->nextIndex >= oldestPtr->blockPtr->count)
+        {
+            ReleaseOldestBlock(obsPtr);
+            return;
+        }
+
+        LE_ASSERT(gorilla_DecodeNext(oldestPtr));
+    }
+    else
+    {
+        if (   (obsPtr->bufferedType == IO_DATA_TYPE_STRING)
+            || (obsPtr->bufferedType == IO_DATA_TYPE_JSON)  )
+        {
+            le_mem_Release(slotPtr->value.sampleRef);
+            slotPtr->value.sampleRef = NULL;
+        }
+
+        (obsPtr->oldestIndex)++;
+        if (obsPtr->oldestIndex >= obsPtr->maxCount)
+        {
+            obsPtr->oldestIndex = 0;
+        }
+    }
+
+    (obsPtr->count)--;
+    (obsPtr->oldestSeq)++;
+
+    UpdateRingHeader(obsPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * If the number of entries in a given Observation's buffer is larger than the number given,
+ * discard enough of the oldest entries to correct that condition.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TruncateBuffer
+(
+    Observation_t* obsPtr,
+    size_t count
+)
+//--------------------------------------------------------------------------------------------------
+{
+    while (obsPtr->count > count)
+    {
+        // Compressed samples can be dropped a whole block at a time, unless a whole-buffer
+        // transform's running stats need to see each value leave.
+        if (   (obsPtr->compressedPtr != NULL)
+            && ((obsPtr->statsPtr == NULL) || (!IsBufferTransform(obsPtr->transformType)))  )
+        {
+            gorilla_Cursor_t* oldestPtr = &obsPtr->compressedPtr->oldest;
+
+            if ((obsPtr->count - count) > (oldestPtr->blockPtr->count - oldestPtr->nextIndex))
+            {
+                ReleaseOldestBlock(obsPtr);
+                continue;
+            }
+        }
+
+        DiscardOldest(obsPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make the read operations in progress and read cursors open on an Observation's buffer find
+ * their place again, because the buffer's ring has been replaced.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InvalidateReadCursors
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&obsPtr->readOpList);
+    while (linkPtr != NULL)
+    {
+        CONTAINER_OF(linkPtr, ReadOperation_t, link)->cursorValid = false;
+
+        linkPtr = le_dls_PeekNext(&obsPtr->readOpList, linkPtr);
+    }
+
+    linkPtr = le_dls_Peek(&obsPtr->readCursorList);
+    while (linkPtr != NULL)
+    {
+        CONTAINER_OF(linkPtr, ReadCursor_t, link)->cursorValid = false;
+
+        linkPtr = le_dls_PeekNext(&obsPtr->readCursorList, linkPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Change the number of samples an Observation's data sample buffer can hold.  If the buffer holds
+ * more samples than the new size, the oldest ones are discarded.
+ *
+ * Also moves the samples between a ring of slots, a ring file and a compressed buffer, if the
+ * compression or persistence setting or data type calls for it.  If a ring file can't be created,
+ * the buffer is kept in memory instead.
+ *
+ * @return LE_OK if successful, LE_NO_MEMORY if the new ring could not be allocated (in which case
+ *         the buffer keeps its previous size).
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ResizeBuffer
+(
+    Observation_t* obsPtr,
+    size_t maxCount ///< New maximum number of samples to buffer (0 = no buffer).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    bool compress = ShouldCompress(obsPtr, maxCount);
+    bool map = ShouldMap(obsPtr, maxCount);
+
+    // An empty buffer that starts persisting takes over the ring file left by a previous run, if
+    // there is one.  If that is the right size already, there's nothing more to do.
+    if (   map
+        && (obsPtr->ringPtr == NULL)
+        && (obsPtr->count == 0)
+        && AdoptRingFile(obsPtr)
+        && (obsPtr->maxCount == maxCount)  )
+    {
+        StopJournal(obsPtr);
+        InvalidateReadCursors(obsPtr);
+        return LE_OK;
+    }
+
+    BufferSlot_t* newBufferPtr = NULL;
+    ringFile_Header_t* newRingPtr = NULL;
+    int ringFd = -1;
+
+    if (map)
+    {
+        newRingPtr = CreateRingFile(obsPtr, maxCount, &ringFd);
+    }
+
+    if ((maxCount > 0) && (!compress) && (newRingPtr == NULL))
+    {
+        // The ring size is chosen at run-time, so it can't come from a fixed-size memory pool.
+        newBufferPtr = calloc(maxCount, sizeof(BufferSlot_t));
+        if (newBufferPtr == NULL)
+        {
+            LE_CRIT("Failed to allocate buffer of %zu samples.", maxCount);
+            return LE_NO_MEMORY;
+        }
+    }
+
+    // The running stats of a whole-buffer transform must be able to hold the whole buffer.  Grow
+    // them before any samples are discarded, so that a failure leaves the buffer as it was.
+    bool hasStats = ((obsPtr->statsPtr != NULL) && IsBufferTransform(obsPtr->transformType));
+    if (   hasStats
+        && (obsPtr->statsPtr->capacity < maxCount)
+        && (ResizeRunningStats(obsPtr->statsPtr, maxCount) != LE_OK)  )
+    {
+        if (newRingPtr != NULL)
+        {
+            ringFile_Unmap(newRingPtr, NULL);
+            le_atomFile_Cancel(ringFd);
+        }
+        else
+        {
+            free(newBufferPtr);
+        }
+        return LE_NO_MEMORY;
+    }
+
+    TruncateBuffer(obsPtr, maxCount);
+
+    // Once the discarded samples have left the stats, they can shrink to fit.  If that fails,
+    // they just keep their spare capacity.
+    if (hasStats && (obsPtr->statsPtr->capacity > maxCount))
+    {
+        (void)ResizeRunningStats(obsPtr->statsPtr, maxCount);
+    }
+
+    if (compress)
+    {
+        // Encode the samples held in the ring (if any) into a new compressed buffer.
+        if (obsPtr->compressedPtr == NULL)
+        {
+            gorilla_Buffer_t* bufPtr = gorilla_CreateBuffer();
+
+            size_t i;
+            for (i = 0; i < obsPtr->count; i++)
+            {
+                BufferSlot_t slot;
+                ReadSlot(obsPtr, i, &slot);
+
+                gorilla_Append(bufPtr, slot.timestamp, slot.value.numeric);
+            }
+
+            if (obsPtr->count > 0)
+            {
+                (void)gorilla_StartCursor(&bufPtr->oldest,
+                                          CONTAINER_OF(le_sls_Peek(&bufPtr->blockList),
+                                                       gorilla_Block_t,
+                                                       link));
+            }
+
+            obsPtr->compressedPtr = bufPtr;
+        }
+    }
+    else
+    {
+        // Move the remaining samples into the new ring, oldest first.
+        BufferCursor_t cursor;
+        bool found;
+        size_t i = 0;
+        for (found = SeekBuffer(obsPtr, &cursor, 0);
+             found;
+             found = NextInBuffer(obsPtr, &cursor))
+        {
+            if (newRingPtr != NULL)
+            {
+                SetRingRecord(&ringFile_GetRecords(newRingPtr)[i],
+                              &cursor.slot,
+                              obsPtr->bufferedType,
+                              cursor.seq);
+            }
+            else
+            {
+                newBufferPtr[i] = cursor.slot;
+            }
+            i++;
+        }
+
+        DeleteCompressedBuffer(obsPtr);
+    }
+
+    bool wasMapped = (obsPtr->ringPtr != NULL);
+    if (wasMapped)
+    {
+        UnmapRingFile(obsPtr);
+    }
+    else
+    {
+        free(obsPtr->bufferPtr);
+    }
+
+    obsPtr->bufferPtr = newBufferPtr;
+    obsPtr->maxCount = maxCount;
+    obsPtr->oldestIndex = 0;
+    obsPtr->ringPtr = newRingPtr;
+
+    if (newRingPtr != NULL)
+    {
+        // The new ring file replaces the old one now that it holds the samples.  If it can't be
+        // saved, the mapping still works as a buffer, but won't survive a restart.
+        UpdateRingHeader(obsPtr);
+        le_result_t result = le_atomFile_Close(ringFd);
+        if (result != LE_OK)
+        {
+            LE_CRIT("Failed to save ring file (%s).", LE_RESULT_TXT(result));
+        }
+        StartRingSync(obsPtr);
+    }
+    else if (wasMapped)
+    {
+        DeleteRingFile(obsPtr);
+    }
+
+    // The backup journal records the buffer size, so the next backup can't just append to it.
+    StopJournal(obsPtr);
+
+    // Read operations in progress will have to find their place again.
+    InvalidateReadCursors(obsPtr);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move an Observation's buffered samples between a ring of slots, a ring file and a compressed
+ * buffer, if its compression or persistence setting or data type has changed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateBufferEncoding
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (   (ShouldCompress(obsPtr, obsPtr->maxCount) == (obsPtr->compressedPtr != NULL))
+        && (ShouldMap(obsPtr, obsPtr->maxCount) == (obsPtr->ringPtr != NULL))  )
+    {
+        return;
+    }
+
+    if (   (ResizeBuffer(obsPtr, obsPtr->maxCount) != LE_OK)
+        && (obsPtr->compressedPtr != NULL)
+        && (obsPtr->bufferedType != IO_DATA_TYPE_NUMERIC)  )
+    {
+        // A compressed buffer can only hold numbers, so the buffer has to go.
+        LE_CRIT("Unable to buffer non-numeric samples.");
+        (void)ResizeBuffer(obsPtr, 0);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether an Observation keeps any history (a buffer or rollup tiers) of the samples it
+ * receives.
+ *
+ * @return true if it does.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool HasHistory
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return ((obsPtr->maxCount > 0) || (obsPtr->tierCount > 0));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a pointer to a bucket in a rollup tier.
+ *
+ * @return Pointer to the bucket.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline RollupBucket_t* GetBucket
+(
+    RollupTier_t* tierPtr,
+    size_t offset   ///< Position of the bucket relative to the oldest (0 = oldest).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t index = tierPtr->oldestIndex + offset;
+
+    if (index >= tierPtr->maxCount)
+    {
+        index -= tierPtr->maxCount;
+    }
+
+    return &tierPtr->bucketPtr[index];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Change the number of buckets in a rollup tier's ring.  If the tier holds more buckets than the
+ * new size, the oldest ones are discarded.
+ *
+ * @return LE_OK if successful, LE_NO_MEMORY if the new ring could not be allocated (in which case
+ *         the tier keeps its previous size).
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ResizeRollupTier
+(
+    RollupTier_t* tierPtr,
+    size_t maxCount
+)
+//--------------------------------------------------------------------------------------------------
+{
+    RollupBucket_t* newBucketPtr = NULL;
+
+    if (maxCount > 0)
+    {
+        newBucketPtr = calloc(maxCount, sizeof(RollupBucket_t));
+        if (newBucketPtr == NULL)
+        {
+            LE_CRIT("Failed to allocate rollup tier of %zu buckets.", maxCount);
+            return LE_NO_MEMORY;
+        }
+    }
+
+    size_t skip = 0;
+    if (tierPtr->count > maxCount)
+    {
+        skip = tierPtr->count - maxCount;
+    }
+
+    size_t i;
+    for (i = skip; i < tierPtr->count; i++)
+    {
+        newBucketPtr[i - skip] = *GetBucket(tierPtr, i);
+    }
+
+    free(tierPtr->bucketPtr);
+
+    tierPtr->bucketPtr = newBucketPtr;
+    tierPtr->maxCount = maxCount;
+    tierPtr->count -= skip;
+    tierPtr->oldestIndex = 0;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove all the rollup tiers of an Observation from a given tier onwards.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteRollupTiers
+(
+    Observation_t* obsPtr,
+    size_t firstTier    ///< Index of the finest tier to remove.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    while (obsPtr->tierCount > firstTier)
+    {
+        (obsPtr->tierCount)--;
+
+        RollupTier_t* tierPtr = &obsPtr->tiers[obsPtr->tierCount];
+
+        free(tierPtr->bucketPtr);
+        memset(tierPtr, 0, sizeof(*tierPtr));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Empty all of an Observation's rollup tiers (keeping their settings).
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClearRollupTiers
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t i;
+    for (i = 0; i < obsPtr->tierCount; i++)
+    {
+        obsPtr->tiers[i].count = 0;
+        obsPtr->tiers[i].oldestIndex = 0;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a numerical value to the bucket for its period in each of an Observation's rollup tiers.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddToRollupTiers
+(
+    Observation_t* obsPtr,
+    double timestamp,
+    double value    ///< The value (not NAN).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t i;
+    for (i = 0; i < obsPtr->tierCount; i++)
+    {
+        RollupTier_t* tierPtr = &obsPtr->tiers[i];
+
+        // Periods are aligned to multiples of the period length since the Epoch.
+        double start = floor(timestamp / tierPtr->period) * tierPtr->period;
+
+        RollupBucket_t* bucketPtr = NULL;
+
+        if (tierPtr->count > 0)
+        {
+            bucketPtr = GetBucket(tierPtr, tierPtr->count - 1);
+
+            // Like the buffer, the tiers must be sorted by time.
+            if (bucketPtr->start > start)
+            {
+                LE_ERROR("Dropping value timestamped %lf from rollup tier (older than %lf).",
+                         timestamp,
+                         bucketPtr->start);
+                continue;
+            }
+
+            if (bucketPtr->start < start)
+            {
+                bucketPtr = NULL;
+            }
+        }
+
+        // If the value starts a new period, use a new bucket (discarding the oldest if full).
+        if (bucketPtr == NULL)
+        {
+            if (tierPtr->count == tierPtr->maxCount)
+            {
+                (tierPtr->oldestIndex)++;
+                if (tierPtr->oldestIndex >= tierPtr->maxCount)
+                {
+                    tierPtr->oldestIndex = 0;
+                }
+                (tierPtr->count)--;
+            }
+
+            bucketPtr = GetBucket(tierPtr, tierPtr->count);
+            (tierPtr->count)++;
+
+            bucketPtr->start = start;
+            bucketPtr->count = 0;
+            bucketPtr->mean = 0;
+            bucketPtr->sumSquares = 0;
+            bucketPtr->min = value;
+            bucketPtr->max = value;
+        }
+
+        (bucketPtr->count)++;
+
+        double delta = value - bucketPtr->mean;
+        bucketPtr->mean += delta / bucketPtr->count;
+        bucketPtr->sumSquares += delta * (value - bucketPtr->mean);
+
+        if (value < bucketPtr->min)
+        {
+            bucketPtr->min = value;
+        }
+        if (value > bucketPtr->max)
+        {
+            bucketPtr->max = value;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert a query start time to an absolute time.
+ *
+ * @return Seconds since the Epoch (or NAN if startTime is NAN).
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetAbsoluteStartTime
+(
+    double startTime   ///< NAN for oldest; if < 30 years, count back from now; else absolute time.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // If the start time is less than or equal to 30 years, then convert to an
+    // absolute timestamp by subtracting it from the current time.
+    if (startTime <= THIRTY_YEARS)
+    {
+        le_clk_Time_t now = le_clk_GetAbsoluteTime();
+        startTime = ((((double)(now.usec)) / 1000000) + now.sec) - startTime;
+    }
+
+    return startTime;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Choose the rollup tier to use to answer a buffer statistics query, if any.
+ *
+ * The buffer is used if it holds everything received since the start time.  Otherwise, the finest
+ * tier that does is used.  If none of them do, the one that goes back the furthest is used.
+ *
+ * @return Pointer to the tier, or NULL if the buffer should be used.
+ */
+//--------------------------------------------------------------------------------------------------
+static RollupTier_t* FindRollupTier
+(
+    Observation_t* obsPtr,
+    double startTime    ///< Seconds since the Epoch (NAN = the whole buffer).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (isnan(startTime) || (obsPtr->tierCount == 0))
+    {
+        return NULL;
+    }
+
+    // The buffer covers the time span if it hasn't dropped anything newer than the start time.
+    double oldest = INFINITY;
+    if (obsPtr->count > 0)
+    {
+        oldest = GetOldestTimestamp(obsPtr);
+
+        if ((obsPtr->count < obsPtr->maxCount) || (oldest <= startTime))
+        {
+            return NULL;
+        }
+    }
+
+    RollupTier_t* bestPtr = NULL;
+
+    size_t i;
+    for (i = 0; i < obsPtr->tierCount; i++)
+    {
+        RollupTier_t* tierPtr = &obsPtr->tiers[i];
+
+        if (tierPtr->count == 0)
+        {
+            continue;
+        }
+
+        double tierOldest = GetBucket(tierPtr, 0)->start;
+
+        if ((tierPtr->count < tierPtr->maxCount) || (tierOldest <= startTime))
+        {
+            return tierPtr;
+        }
+
+        if (tierOldest < oldest)
+        {
+            oldest = tierOldest;
+            bestPtr = tierPtr;
+        }
+    }
+
+    return bestPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Combine the buckets of a rollup tier whose periods end after a given start time into a single
+ * summary.
+ *
+ * @return The number of values summarized.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t SummarizeRollupTier
+(
+    RollupTier_t* tierPtr,
+    double startTime,   ///< Seconds since the Epoch.
+    RollupBucket_t* summaryPtr  ///< [OUT] Summary (only valid if the return value is non-zero).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Binary search for the oldest bucket whose period ends after the start time.
+    size_t first = 0;
+    size_t end = tierPtr->count;
+    while (first < end)
+    {
+        size_t middle = first + ((end - first) / 2);
+
+        if ((GetBucket(tierPtr, middle)->start + tierPtr->period) <= startTime)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            end = middle;
+        }
+    }
+
+    if (first < tierPtr->count)
+    {
+        summaryPtr->start = GetBucket(tierPtr, first)->start;
+    }
+    summaryPtr->count = 0;
+    summaryPtr->mean = 0;
+    summaryPtr->sumSquares = 0;
+
+    // Combine the means and mins/maxes, then the sums of squares (Chan et al's parallel method).
+    size_t i;
+    for (i = first; i < tierPtr->count; i++)
+    {
+        RollupBucket_t* bucketPtr = GetBucket(tierPtr, i);
+
+        if ((summaryPtr->count == 0) || (bucketPtr->min < summaryPtr->min))
+        {
+            summaryPtr->min = bucketPtr->min;
+        }
+        if ((summaryPtr->count == 0) || (bucketPtr->max > summaryPtr->max))
+        {
+            summaryPtr->max = bucketPtr->max;
+        }
+
+        summaryPtr->count += bucketPtr->count;
+        summaryPtr->mean += (bucketPtr->mean - summaryPtr->mean) * bucketPtr->count
+                            / summaryPtr->count;
+    }
+
+    for (i = first; i < tierPtr->count; i++)
+    {
+        RollupBucket_t* bucketPtr = GetBucket(tierPtr, i);
+        double delta = bucketPtr->mean - summaryPtr->mean;
+
+        summaryPtr->sumSquares += bucketPtr->sumSquares + (delta * delta * bucketPtr->count);
+    }
+
+    return summaryPtr->count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Summarize the numerical values an Observation has received since a given start time using its
+ * rollup tiers, if its buffer doesn't go back far enough.
+ *
+ * @return true if a rollup tier was used (summaryPtr->count is 0 if there were no values),
+ *         false if the buffer should be used.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool QueryRollupTiers
+(
+    Observation_t* obsPtr,
+    double startTime,   ///< If < 30 years then seconds before now; else seconds since the Epoch.
+    RollupBucket_t* summaryPtr  ///< [OUT] Summary of the values.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (obsPtr->tierCount == 0)
+    {
+        return false;
+    }
+
+    if (!isnan(startTime))
+    {
+        startTime = GetAbsoluteStartTime(startTime);
+    }
+
+    RollupTier_t* tierPtr = FindRollupTier(obsPtr, startTime);
+    if (tierPtr == NULL)
+    {
+        return false;
+    }
+
+    SummarizeRollupTier(tierPtr, startTime, summaryPtr);
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Terminate a read operation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndRead
+(
+    ReadOperation_t* opPtr,
+    le_result_t result
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_fdMonitor_Delete(opPtr->fdMonitor);
+
+    close(opPtr->fd);
+
+    opPtr->handlerPtr(result, opPtr->contextPtr);
+
+    le_dls_Remove(&opPtr->obsPtr->readOpList, &opPtr->link);
+
+    le_mem_Release(opPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current time.
+ *
+ * @return Seconds since the Epoch.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetAbsoluteTimeSec
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_clk_Time_t now = le_clk_GetAbsoluteTime();
+
+    return ((((double)(now.usec)) / 1000000) + now.sec);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop keeping an Observation's histogram (if it keeps one).
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteHistogram
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (obsPtr->histogramRef != NULL)
+    {
+        histogram_Delete(obsPtr->histogramRef);
+        obsPtr->histogramRef = NULL;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a new (empty) aggregation window for an Observation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResetAggregation
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    obsPtr->aggCount = 0;
+    obsPtr->aggNumCount = 0;
+    obsPtr->aggSum = 0;
+    obsPtr->aggMin = NAN;
+    obsPtr->aggMax = NAN;
+
+    if (obsPtr->histogramRef != NULL)
+    {
+        histogram_ResetWindow(obsPtr->histogramRef);
+    }
+
+    if (obsPtr->aggLastSample != NULL)
+    {
+        le_mem_Release(obsPtr->aggLastSample);
+        obsPtr->aggLastSample = NULL;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the end of the aggregation window that a given time falls into.  Windows are aligned
+ * to multiples of the aggregation period since the Epoch, so Observations with the same period
+ * all end their windows at the same time.
+ *
+ * @return The end of the window (seconds since the Epoch).
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetWindowEnd
+(
+    Observation_t* obsPtr,
+    double now  ///< Seconds since the Epoch.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (floor(now / obsPtr->aggregationPeriod) + 1) * obsPtr->aggregationPeriod;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * (Re)start the shared aggregation timer so that it expires at the end of the earliest
+ * aggregation window, or stop it if no Observations are aggregating.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RestartAggregationTimer
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (le_timer_IsRunning(AggregationTimer))
+    {
+        le_timer_Stop(AggregationTimer);
+    }
+
+    double earliestEnd = INFINITY;
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&AggregatingObsList);
+    while (linkPtr != NULL)
+    {
+        Observation_t* obsPtr = CONTAINER_OF(linkPtr, Observation_t, aggregationLink);
+
+        if (obsPtr->windowEnd < earliestEnd)
+        {
+            earliestEnd = obsPtr->windowEnd;
+        }
+
+        linkPtr = le_dls_PeekNext(&AggregatingObsList, linkPtr);
+    }
+
+    if (isinf(earliestEnd))
+    {
+        return;
+    }
+
+    // Round up so the timer doesn't expire just before the end of the window.  If the window is
+    // further away than the timer can count, the timer will just be restarted when it expires.
+    double interval = ceil((earliestEnd - GetAbsoluteTimeSec()) * 1000);
+    if (interval < 1)
+    {
+        interval = 1;
+    }
+    else if (interval > UINT32_MAX)
+    {
+        interval = UINT32_MAX;
+    }
+
+    LE_ASSERT(le_timer_SetMsInterval(AggregationTimer, (uint32_t)interval) == LE_OK);
+    LE_ASSERT(le_timer_Start(AggregationTimer) == LE_OK);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End an Observation's current aggregation window.  Pushes the aggregate of the samples received
+ * during the window (if any were) and starts the next window.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndAggregationWindow
+(
+    Observation_t* obsPtr,
+    double now  ///< Seconds since the Epoch.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    double timestamp = obsPtr->windowEnd;
+    io_DataType_t dataType = IO_DATA_TYPE_NUMERIC;
+    dataSample_Ref_t sample = NULL;
+
+    switch (obsPtr->aggregationType)
+    {
+        case OBS_AGGREGATION_TYPE_MEAN:
+
+            if (obsPtr->aggNumCount > 0)
+            {
+                sample = dataSample_CreateNumeric(timestamp,
+                                                  obsPtr->aggSum / obsPtr->aggNumCount);
+            }
+            break;
+
+        case OBS_AGGREGATION_TYPE_MIN:
+
+            if (obsPtr->aggNumCount > 0)
+            {
+                sample = dataSample_CreateNumeric(timestamp, obsPtr->aggMin);
+            }
+            break;
+
+        case OBS_AGGREGATION_TYPE_MAX:
+
+            if (obsPtr->aggNumCount > 0)
+            {
+                sample = dataSample_CreateNumeric(timestamp, obsPtr->aggMax);
+            }
+            break;
+
+        case OBS_AGGREGATION_TYPE_COUNT:
+
+            if (obsPtr->aggCount > 0)
+            {
+                sample = dataSample_CreateNumeric(timestamp, obsPtr->aggCount);
+            }
+            break;
+
+        case OBS_AGGREGATION_TYPE_LAST:
+
+            if (obsPtr->aggLastSample != NULL)
+            {
+                dataType = obsPtr->aggLastType;
+                sample = dataSample_Copy(dataType, obsPtr->aggLastSample);
+                dataSample_SetTimestamp(sample, timestamp);
+            }
+            break;
+
+        case OBS_AGGREGATION_TYPE_HISTOGRAM:
+
+            if ((obsPtr->histogramRef != NULL) && (obsPtr->aggNumCount > 0))
+            {
+                dataType = IO_DATA_TYPE_JSON;
+                sample = histogram_CreateWindowSample(obsPtr->histogramRef, timestamp);
+            }
+            break;
+
+        default:
+
+            LE_FATAL("Invalid aggregation type %d", obsPtr->aggregationType);
+            break;
+    }
+
+    ResetAggregation(obsPtr);
+
+    // If the timer expired late (e.g., the system was suspended), skip the windows that were
+    // missed rather than pushing empty ones.
+    obsPtr->windowEnd = GetWindowEnd(obsPtr, now);
+
+    if (sample != NULL)
+    {
+        res_PushAggregate(&obsPtr->resource, dataType, sample);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Shared aggregation timer expiry handler.  Ends the aggregation windows that are due.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AggregationTimerExpired
+(
+    le_timer_Ref_t timer
+)
+//--------------------------------------------------------------------------------------------------
+{
+    double now = GetAbsoluteTimeSec();
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&AggregatingObsList);
+    while (linkPtr != NULL)
+    {
+        Observation_t* obsPtr = CONTAINER_OF(linkPtr, Observation_t, aggregationLink);
+
+        // Get the next link first, in case pushing the aggregate changes the list.
+        linkPtr = le_dls_PeekNext(&AggregatingObsList, linkPtr);
+
+        if (obsPtr->windowEnd <= now)
+        {
+            EndAggregationWindow(obsPtr, now);
+        }
+    }
+
+    RestartAggregationTimer();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * (Re)start the shared backup timer so that it expires when the earliest pending backup is due,
+ * or stop it if no backups are pending.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RestartBackupTimer
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (le_timer_IsRunning(BackupTimer))
+    {
+        le_timer_Stop(BackupTimer);
+    }
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&PendingBackupList);
+    if (linkPtr == NULL)
+    {
+        return;
+    }
+
+    uint32_t dueTime = CONTAINER_OF(linkPtr, Observation_t, backupLink)->backupDueTime;
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    // If the backup is further away than the timer can count, the timer will just be restarted
+    // when it expires.
+    uint64_t interval = 1;
+    if (dueTime > now.sec)
+    {
+        interval = (uint64_t)(dueTime - now.sec) * 1000;
+        if (interval > UINT32_MAX)
+        {
+            interval = UINT32_MAX;
+        }
+    }
+
+    LE_ASSERT(le_timer_SetMsInterval(BackupTimer, (uint32_t)interval) == LE_OK);
+    LE_ASSERT(le_timer_Start(BackupTimer) == LE_OK);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a given Observation from the Pending Backup List, if it's in it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CancelBackup
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (!obsPtr->isBackupPending)
+    {
+        return;
+    }
+
+    bool wasFirst = (le_dls_Peek(&PendingBackupList) == &obsPtr->backupLink);
+
+    le_dls_Remove(&PendingBackupList, &obsPtr->backupLink);
+    obsPtr->isBackupPending = false;
+
+    if (wasFirst)
+    {
+        RestartBackupTimer();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Schedule a backup of a given Observation's buffer for when its backup period will have passed
+ * since its last backup, or as soon as possible if it already has.  If a backup is already
+ * pending, it is rescheduled.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ScheduleBackup
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    CancelBackup(obsPtr);
+
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    uint64_t dueTime = (uint64_t)obsPtr->lastBackupTime + obsPtr->backupPeriod;
+    if (dueTime < now.sec)
+    {
+        dueTime = now.sec;
+    }
+    else if (dueTime > UINT32_MAX)
+    {
+        dueTime = UINT32_MAX;
+    }
+    obsPtr->backupDueTime = dueTime;
+
+    // Keep the list sorted by due time.  Backups being scheduled are usually due after the ones
+    // already pending, so search from the tail.
+    le_dls_Link_t* linkPtr = le_dls_PeekTail(&PendingBackupList);
+    while (   (linkPtr != NULL)
+           && (CONTAINER_OF(linkPtr, Observation_t, backupLink)->backupDueTime > dueTime))
+    {
+        linkPtr = le_dls_PeekPrev(&PendingBackupList, linkPtr);
+    }
+
+    if (linkPtr == NULL)
+    {
+        le_dls_Stack(&PendingBackupList, &obsPtr->backupLink);
+
+        // The earliest backup is now due sooner, so the timer has to expire sooner.
+        RestartBackupTimer();
+    }
+    else
+    {
+        le_dls_AddAfter(&PendingBackupList, linkPtr, &obsPtr->backupLink);
+    }
+
+    obsPtr->isBackupPending = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the JSON representation of the value held in a buffer slot into a given buffer.
+ *
+ * @return
+ *  - LE_OK if successful,
+ *  - LE_OVERFLOW if the buffer provided is too small to hold the value.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ConvertSlotToJson
+(
+    Observation_t* obsPtr,
+    BufferSlot_t* slotPtr,
+    char* valueBuffPtr,     ///< [OUT] Ptr to buffer where value will be stored.
+    size_t valueBuffSize    ///< [IN] Size of value buffer, in bytes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    switch (obsPtr->bufferedType)
+    {
+        case IO_DATA_TYPE_TRIGGER:
+
+            return le_utf8_Copy(valueBuffPtr, "null", valueBuffSize, NULL);
+
+        case IO_DATA_TYPE_BOOLEAN:
+
+            return le_utf8_Copy(valueBuffPtr,
+                                slotPtr->value.boolean ? "true" : "false",
+                                valueBuffSize,
+                                NULL);
+
+        case IO_DATA_TYPE_NUMERIC:
+
+            if (valueBuffSize <= snprintf(valueBuffPtr,
+                                          valueBuffSize,
+                                          "%lf",
+                                          slotPtr->value.numeric))
+            {
+                return LE_OVERFLOW;
+            }
+            return LE_OK;
+
+        case IO_DATA_TYPE_STRING:
+        case IO_DATA_TYPE_JSON:
+
+            return dataSample_ConvertToJson(slotPtr->value.sampleRef,
+                                            obsPtr->bufferedType,
+                                            valueBuffPtr,
+                                            valueBuffSize);
+    }
+
+    LE_ERROR("Invalid data type %d.", obsPtr->bufferedType);
+    return LE_BAD_PARAMETER;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format a JSON representation of a buffered sample, e.g., {"t":1537483647.125,"v":true}.
+ *
+ * @return true if successful, false if it doesn't fit in the buffer (with its null terminator).
+ */
+//--------------------------------------------------------------------------------------------------
+static bool FormatJsonSample
+(
+    Observation_t* obsPtr,
+    BufferSlot_t* slotPtr,
+    char* buffPtr,      ///< [OUT] Ptr to buffer where the JSON will be stored.
+    size_t buffSize,    ///< [IN] Size of the buffer, in bytes.
+    size_t* lenPtr      ///< [OUT] Length of the JSON (excluding the null terminator).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int len = snprintf(buffPtr, buffSize, "{\"t\":%lf,\"v\":", slotPtr->timestamp);
+    if ((len < 0) || ((len + 2) > buffSize))
+    {
+        return false;
+    }
+
+    // Copy the JSON version of the contents of the buffer slot into the buffer, if there's space
+    // (leaving room for an additional '}' at the end).
+    if (ConvertSlotToJson(obsPtr, slotPtr, buffPtr + len, buffSize - len - 1) != LE_OK)
+    {
+        return false;
+    }
+
+    len += strlen(buffPtr + len);
+
+    buffPtr[len] = '}';
+    buffPtr[len + 1] = '\0';
+
+    *lenPtr = len + 1;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a JSON representation of the sample under a read operation's cursor to the write buffer,
+ * preceded by a comma if it isn't the first sample, leaving room for the closing ']'.
+ *
+ * @return true if successful, false if there isn't enough room left in the write buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool AppendJsonSample
+(
+    ReadOperation_t* opPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    BufferSlot_t* slotPtr = &opPtr->cursor.slot;
+
+    char* buffPtr = opPtr->writeBuffer + opPtr->writeLen;
+    size_t buffSize = sizeof(opPtr->writeBuffer) - opPtr->writeLen - 1;
+
+    if (opPtr->state == MORE_SAMPLES)
+    {
+        *buffPtr = ',';
+        buffPtr++;
+        buffSize--;
+    }
+
+    size_t len;
+    if (!FormatJsonSample(opPtr->obsPtr, slotPtr, buffPtr, buffSize, &len))
+    {
+        return false;
+    }
+
+    opPtr->writeLen = (buffPtr + len) - opPtr->writeBuffer;
+    opPtr->state = MORE_SAMPLES;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a packed binary record of the sample under a read operation's cursor to the write buffer.
+ * See query_ReadBufferBinary() for the format.
+ *
+ * @return true if successful, false if there isn't enough room left in the write buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool AppendBinarySample
+(
+    ReadOperation_t* opPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    BufferSlot_t* slotPtr = &opPtr->cursor.slot;
+
+    const void* valuePtr = NULL;
+    size_t valueSize = 0;
+    uint32_t stringLen = 0;
+    size_t lengthSize = 0;  // Strings are prefixed with their length.
+
+    switch (opPtr->dataType)
+    {
+        case IO_DATA_TYPE_TRIGGER:
+
+            break;
+
+        case IO_DATA_TYPE_BOOLEAN:
+
+            valuePtr = &slotPtr->value.boolean;
+            valueSize = sizeof(slotPtr->value.boolean);
+            break;
+
+        case IO_DATA_TYPE_NUMERIC:
+
+            valuePtr = &slotPtr->value.numeric;
+            valueSize = sizeof(slotPtr->value.numeric);
+            break;
+
+        case IO_DATA_TYPE_STRING:
+        case IO_DATA_TYPE_JSON:
+
+            if (opPtr->dataType == IO_DATA_TYPE_STRING)
+            {
+                valuePtr = dataSample_GetString(slotPtr->value.sampleRef);
+            }
+            else
+            {
+                valuePtr = dataSample_GetJson(slotPtr->value.sampleRef);
+            }
+            stringLen = strlen(valuePtr);
+            lengthSize = sizeof(stringLen);
+            valueSize = stringLen;
+            break;
+    }
+
+    size_t recordSize = sizeof(slotPtr->timestamp) + lengthSize + valueSize;
+    if (recordSize > (sizeof(opPtr->writeBuffer) - opPtr->writeLen))
+    {
+        return false;
+    }
+
+    uint8_t* buffPtr = (uint8_t*)opPtr->writeBuffer + opPtr->writeLen;
+
+    memcpy(buffPtr, &slotPtr->timestamp, sizeof(slotPtr->timestamp));
+    buffPtr += sizeof(slotPtr->timestamp);
+
+    memcpy(buffPtr, &stringLen, lengthSize);
+    buffPtr += lengthSize;
+
+    if (valueSize > 0)
+    {
+        memcpy(buffPtr, valuePtr, valueSize);
+    }
+
+    opPtr->writeLen += recordSize;
+    opPtr->state = MORE_SAMPLES;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the write buffer with as much of the read operation's output as will fit: the opening '['
+ * or binary header (if nothing has been loaded yet), as many of the following samples as there is
+ * room for, and the closing ']' (in JSON) if that leaves no more samples to be read.
+ *
+ * This lets a whole batch of samples be written with a single write() call, rather than making
+ * one call per sample and another per comma.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LoadReadOpBuffer
+(
+    ReadOperation_t* opPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = opPtr->obsPtr;
+
+    opPtr->writeLen = 0;
+    opPtr->writeOffset = 0;
+    opPtr->writeBuffer[0] = '\0';
+
+    if (opPtr->state == START)
+    {
+        if (opPtr->isBinary)
+        {
+            uint32_t magic = BINARY_READ_MAGIC;
+            memcpy(opPtr->writeBuffer, &magic, sizeof(magic));
+            opPtr->writeBuffer[4] = BINARY_READ_FORMAT_VERSION;
+            opPtr->writeBuffer[5] = opPtr->dataType;
+            opPtr->writeBuffer[6] = 0;
+            opPtr->writeBuffer[7] = 0;
+            opPtr->writeLen = 8;
+        }
+        else
+        {
+            opPtr->writeBuffer[opPtr->writeLen++] = '[';
+        }
+        opPtr->state = FIRST_SAMPLE;
+    }
+
+    size_t emptyLen = opPtr->writeLen;
+
+    for (;;)
+    {
+        // If the next sample has fallen off the end of the observation's buffer, then all
+        // samples in the observation's buffer are now newer than it, so start from the oldest.
+        if (opPtr->nextSeq < obsPtr->oldestSeq)
+        {
+            opPtr->nextSeq = obsPtr->oldestSeq;
+        }
+
+        // A binary read ends early if the data type changes, as that flushes the samples of the
+        // type given in the header from the buffer.
+        if (   (opPtr->nextSeq >= (obsPtr->oldestSeq + obsPtr->count))
+            || (opPtr->isBinary && (obsPtr->bufferedType != opPtr->dataType)))
+        {
+            if (!opPtr->isBinary)
+            {
+                opPtr->writeBuffer[opPtr->writeLen++] = ']';
+                opPtr->writeBuffer[opPtr->writeLen] = '\0';
+            }
+            opPtr->state = END;
+
+            return;
+        }
+
+        // Carry on from the cursor if it's still on the next sample, rather than finding it again
+        // (which, in a compressed buffer, means decoding from the start of its block).
+        if ((!opPtr->cursorValid) || (opPtr->cursor.seq != opPtr->nextSeq))
+        {
+            opPtr->cursorValid = SeekBuffer(obsPtr,
+                                            &opPtr->cursor,
+                                            opPtr->nextSeq - obsPtr->oldestSeq);
+        }
+
+        bool appended = (opPtr->isBinary ? AppendBinarySample(opPtr) : AppendJsonSample(opPtr));
+        if (!appended)
+        {
+            // If the write buffer is full, leave this sample to be loaded into the next batch.
+            // An empty write buffer is always big enough for a sample, so if it didn't fit
+            // into one of those, it never will.
+            if (opPtr->writeLen > emptyLen)
+            {
+                return;
+            }
+
+            LE_ERROR("Sample doesn't fit in write buffer. Skipping.");
+        }
+
+        // Advance to the next sample in the Observation's buffer.
+        (opPtr->nextSeq)++;
+        opPtr->cursorValid = NextInBuffer(obsPtr, &opPtr->cursor);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write to an unbuffered file descriptor.
+ *
+ * @return The number of bytes written.  -1 on error (errno is set).
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t WriteToFd
+(
+    int fd,
+    const void* buffPtr,
+    size_t byteCount
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ssize_t result;
+
+    LE_ASSERT(buffPtr != NULL);
+
+    do
+    {
+        result = write(fd, buffPtr, byteCount);
+
+    } while ((result == -1) && (errno == EINTR));
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Continue a read operation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ContinueReadOp
+(
+    ReadOperation_t* opPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    for (;;)
+    {
+        // If the write buffer has been written entirely, either we're finished or it's time to
+        // load the next batch.
+        if (opPtr->writeOffset == opPtr->writeLen)
+        {
+            if (opPtr->state == END)
+            {
+                EndRead(opPtr, LE_OK);
+
+                return;
+            }
+
+            LoadReadOpBuffer(opPtr);
+
+            continue;
+        }
+
+        // Write and check for errors.
+        ssize_t result = WriteToFd(opPtr->fd,
+                                   opPtr->writeBuffer + opPtr->writeOffset,
+                                   opPtr->writeLen - opPtr->writeOffset);
+        if (result == -1)
+        {
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+            {
+                // Return and wait for this function to be called again by the FD Monitor.
+                return;
+            }
+
+            LE_ERROR("Error writing (%m).");
+            EndRead(opPtr, LE_COMM_ERROR);
+
+            return;
+        }
+
+        // Note: If the write buffer has not been written entirely, loop back around to write more.
+        opPtr->writeOffset += result;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event handler call-back for events on a read operation's write file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReadOpFdEventHandler
+(
+    int fd,
+    short events
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ReadOperation_t* opPtr = le_fdMonitor_GetContextPtr();
+
+    // Check for error or hang-up.
+    if ((events & POLLERR) || (events & POLLHUP) || (events & POLLRDHUP))
+    {
+        LE_ERROR("Error or hang-up on output stream.");
+        EndRead(opPtr, LE_COMM_ERROR);
+    }
+    // Note: The only other reason for this function to be called is POLLOUT (writeable).
+    else
+    {
+        ContinueReadOp(opPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a read operation on a given Observation's buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartRead
+(
+    Observation_t* obsPtr,
+    size_t startOffset, ///< Position in the buffer to start at (count if read data set empty).
+    bool isBinary,  ///< true = packed binary format, false = JSON.
+    int outputFile, ///< File descriptor to write the data to.
+    query_ReadCompletionFunc_t handlerPtr, ///< Completion callback.
+    void* contextPtr    ///< Value to be passed to completion callback.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Set the fd non-blocking
+    if (0 != fcntl(outputFile, F_SETFL, O_NONBLOCK))
+    {
+        LE_ERROR("Failed to activate non-blocking mode (%m).");
+        handlerPtr(LE_COMM_ERROR, contextPtr);
+        return;
+    }
+
+    ReadOperation_t* opPtr = le_mem_ForceAlloc(ReadOperationPool);
+
+    opPtr->link = LE_DLS_LINK_INIT;
+    le_dls_Queue(&obsPtr->readOpList, &opPtr->link);
+
+    opPtr->obsPtr = obsPtr;
+
+    opPtr->fdMonitor = le_fdMonitor_Create("Read", outputFile, ReadOpFdEventHandler, POLLOUT);
+    le_fdMonitor_SetContextPtr(opPtr->fdMonitor, opPtr);
+    opPtr->fd = outputFile;
+    opPtr->nextSeq = obsPtr->oldestSeq + startOffset;
+    opPtr->cursorValid = false;
+    opPtr->isBinary = isBinary;
+    opPtr->dataType = obsPtr->bufferedType;
+    opPtr->handlerPtr = handlerPtr;
+    opPtr->contextPtr = contextPtr;
+
+    opPtr->state = START;
+    opPtr->writeLen = 0;
+    opPtr->writeOffset = 0;
+
+    ContinueReadOp(opPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a given data sample to the buffer of a given Observation.  If the buffer is full, the
+ * oldest sample is discarded to make room.
+ *
+ * @note Numeric, Boolean and trigger values are copied into the buffer.  For string and JSON
+ *       samples, the buffer takes its own reference on the Data Sample.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddToBuffer
+(
+    Observation_t* obsPtr,
+    dataSample_Ref_t sampleRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (obsPtr->maxCount == 0)
+    {
+        return;
+    }
+
+    double newEntryTimestamp = dataSample_GetTimestamp(sampleRef);
+
+    // If the new sample is timestamped older than the newest sample already in the buffer,
+    // then we have a serious problem, because buffer traversal operations rely on the buffer
+    // being sorted by timestamp.
+    if (obsPtr->count > 0)
+    {
+        double oldEntryTimestamp = GetNewestTimestamp(obsPtr);
+
+        if (oldEntryTimestamp > newEntryTimestamp)
+        {
+            LE_ERROR("New sample has older timestamp than (older) sample already in the buffer!");
+            LE_ERROR("Dropping new sample timestamped %lf (< %lf in buffer)!",
+                     newEntryTimestamp,
+                     oldEntryTimestamp);
+            return;
+        }
+    }
+
+    if (obsPtr->count == obsPtr->maxCount)
+    {
+        DiscardOldest(obsPtr);
+    }
+
+    // Compressed samples (and samples going into a ring file) are put together in a slot first,
+    // then encoded.
+    BufferSlot_t newSlot;
+    BufferSlot_t* slotPtr = &newSlot;
+
+    if ((obsPtr->compressedPtr == NULL) && (obsPtr->ringPtr == NULL))
+    {
+        slotPtr = GetSlot(obsPtr, obsPtr->count);
+    }
+
+    slotPtr->timestamp = newEntryTimestamp;
+
+    switch (obsPtr->bufferedType)
+    {
+        case IO_DATA_TYPE_TRIGGER:
+
+            // No value.
+            break;
+
+        case IO_DATA_TYPE_BOOLEAN:
+
+            slotPtr->value.boolean = dataSample_GetBoolean(sampleRef);
+            break;
+
+        case IO_DATA_TYPE_NUMERIC:
+
+            slotPtr->value.numeric = dataSample_GetNumeric(sampleRef);
+            break;
+
+        case IO_DATA_TYPE_STRING:
+        case IO_DATA_TYPE_JSON:
+
+            le_mem_AddRef(sampleRef);
+            slotPtr->value.sampleRef = sampleRef;
+            break;
+    }
+
+    if (obsPtr->compressedPtr != NULL)
+    {
+        gorilla_Buffer_t* bufPtr = obsPtr->compressedPtr;
+
+        gorilla_Append(bufPtr, slotPtr->timestamp, slotPtr->value.numeric);
+
+        // If the buffer was empty, the new sample is the oldest (and the first in its block).
+        if (obsPtr->count == 0)
+        {
+            (void)gorilla_StartCursor(&bufPtr->oldest,
+                                      CONTAINER_OF(le_sls_Peek(&bufPtr->blockList),
+                                                   gorilla_Block_t,
+                                                   link));
+        }
+    }
+    else if (obsPtr->ringPtr != NULL)
+    {
+        SetRingRecord(GetRingRecord(obsPtr, obsPtr->count),
+                      slotPtr,
+                      obsPtr->bufferedType,
+                      obsPtr->oldestSeq + obsPtr->count);
+    }
+
+    (obsPtr->count)++;
+
+    UpdateRingHeader(obsPtr);
+
+    // Keep the running stats of a whole-buffer transform up to date.
+    if ((obsPtr->statsPtr != NULL) && IsBufferTransform(obsPtr->transformType))
+    {
+        if (   (obsPtr->bufferedType == IO_DATA_TYPE_NUMERIC)
+            || (obsPtr->bufferedType == IO_DATA_TYPE_BOOLEAN)  )
+        {
+            double value = GetBufferedNumber(slotPtr, obsPtr->bufferedType);
+
+            if (!isnan(value))
+            {
+                AddStat(obsPtr->statsPtr, slotPtr->timestamp, value);
+            }
+        }
+    }
+
+    // Keep the quantile sketch up to date.
+    if (obsPtr->sketchRef != NULL)
+    {
+        uint64_t seq = obsPtr->oldestSeq + obsPtr->count - 1;
+
+        SyncQuantileSketch(obsPtr, seq);
+
+        if (   (obsPtr->bufferedType == IO_DATA_TYPE_NUMERIC)
+            || (obsPtr->bufferedType == IO_DATA_TYPE_BOOLEAN)  )
+        {
+            double value = GetBufferedNumber(slotPtr, obsPtr->bufferedType);
+
+            if (!isnan(value))
+            {
+                quantile_Add(obsPtr->sketchRef, obsPtr->maxCount, seq, slotPtr->timestamp, value);
+            }
+        }
+
+        quantile_SetNextSeq(obsPtr->sketchRef, seq + 1);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the value of a data sample by replacing it, if necessary
+ */
+//--------------------------------------------------------------------------------------------------
+static dataSample_Ref_t UpdateSample
+(
+    dataSample_Ref_t sampleRef,
+    io_DataType_t dataType,
+    void *valuePtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    dataSample_Ref_t sample = sampleRef;
+    double timestamp = dataSample_GetTimestamp(sampleRef);
+
+
+    switch (dataType)
+    {
+        case IO_DATA_TYPE_BOOLEAN:
+        {
+            bool value = *((double *)valuePtr) > 0.0 ? true : false;
+            if (dataSample_GetBoolean(sampleRef) != value)
+            {
+                sample = dataSample_CreateBoolean(timestamp, value);
+            }
+            break;
+        }
+
+        case IO_DATA_TYPE_NUMERIC:
+        {
+            double value = *((double *)valuePtr);
+            if (dataSample_GetNumeric(sampleRef) != value)
+            {
+                sample = dataSample_CreateNumeric(timestamp, value);
+            }
+        }
+
+        default:
+            break;
+    }
+
+    if (sample != sampleRef)
+    {
+        le_mem_Release(sampleRef);
+    }
+
+    return sample;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a data sample record to a backup journal file.  Doesn't close the file on error.
+ *
+ * @return true if successful, false if failed (errno is set).
+ */
+//--------------------------------------------------------------------------------------------------
+static bool WriteRecord
+(
+    FILE* file,
+    io_DataType_t dataType,
+    const BufferSlot_t* slotPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Write the timestamp.
+    if (fwrite(&slotPtr->timestamp, sizeof(slotPtr->timestamp), 1, file) != 1)
+    {
+        return false;
+    }
+
+    switch (dataType)
+    {
+        case IO_DATA_TYPE_TRIGGER:
+
+            // No Value.
+            return true;
+
+        case IO_DATA_TYPE_BOOLEAN:
+
+            return (fwrite(&slotPtr->value.boolean, sizeof(slotPtr->value.boolean), 1, file) == 1);
+
+        case IO_DATA_TYPE_NUMERIC:
+
+            return (fwrite(&slotPtr->value.numeric, sizeof(slotPtr->value.numeric), 1, file) == 1);
+
+        case IO_DATA_TYPE_STRING:
+        case IO_DATA_TYPE_JSON:
+        {
+            const char* valuePtr;
+            if (dataType == IO_DATA_TYPE_STRING)
+            {
+                valuePtr = dataSample_GetString(slotPtr->value.sampleRef);
+            }
+            else
+            {
+                valuePtr = dataSample_GetJson(slotPtr->value.sampleRef);
+            }
+
+            uint32_t stringLen = strlen(valuePtr);
+
+            return (   (fwrite(&stringLen, 4, 1, file) == 1)
+                    && ((stringLen == 0) || (fwrite(valuePtr, stringLen, 1, file) == 1))  );
+        }
+    }
+
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the string or JSON value held by a buffer slot.
+ *
+ * @return Pointer to the null-terminated value.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline const char* GetSlotString
+(
+    const BufferSlot_t* slotPtr,
+    io_DataType_t dataType      ///< IO_DATA_TYPE_STRING or IO_DATA_TYPE_JSON.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (dataType == IO_DATA_TYPE_STRING)
+    {
+        return dataSample_GetString(slotPtr->value.sampleRef);
+    }
+
+    return dataSample_GetJson(slotPtr->value.sampleRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lays out the whole backup file for the copy of an Observation's buffer and rollup tiers held by
+ * a given backup job in a newly allocated staging buffer, so that it can be written in one go.
+ *
+ * @return Pointer to the staging buffer (which the caller must free), or NULL if out of memory.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* BuildBackupImage
+(
+    const BackupJob_t* jobPtr,
+    size_t* imageBytesPtr   ///< [OUT] Size of the backup file.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    bool hasStrings = (   (jobPtr->bufferedType == IO_DATA_TYPE_STRING)
+                       || (jobPtr->bufferedType == IO_DATA_TYPE_JSON)  );
+    size_t i;
+    size_t j;
+
+    // Size up the sections.
+    size_t dataBytes = 0;
+    size_t heapBytes = 0;
+    if (jobPtr->isCompressed)
+    {
+        dataBytes = 4 + 2;
+        for (i = 0; i < jobPtr->blockCount; i++)
+        {
+            dataBytes += 2 + 2 + (jobPtr->blockPtr[i].bitCount + 7) / 8;
+        }
+    }
+    else
+    {
+        dataBytes = jobPtr->count * BACKUP_RECORD_BYTES;
+        for (i = 0; hasStrings && (i < jobPtr->count); i++)
+        {
+            heapBytes += strlen(GetSlotString(&jobPtr->slotPtr[i], jobPtr->bufferedType)) + 1;
+        }
+    }
+
+    size_t imageBytes = BACKUP_HEADER_BYTES + dataBytes + heapBytes;
+    for (i = 0; i < jobPtr->tierCount; i++)
+    {
+        imageBytes += 8 + 4 + (jobPtr->tiers[i].count * BACKUP_BUCKET_BYTES);
+    }
+
+    uint8_t* imagePtr = calloc(1, imageBytes);
+    if (imagePtr == NULL)
+    {
+        LE_CRIT("Failed to allocate %zu bytes for backup.", imageBytes);
+        return NULL;
+    }
+
+    // Header.
+    backupFile_Header_t header;
+    header.dataType = jobPtr->dataType;
+    header.isCompressed = jobPtr->isCompressed;
+    header.count = jobPtr->bufferCount;
+    uint8_t* posPtr = backupFile_WriteHeader(imagePtr,
+                                             &header,
+                                             jobPtr->tierCount,
+                                             dataBytes,
+                                             heapBytes);
+    uint32_t size;
+
+    // Compressed blocks or record table, followed by the string heap.
+    if (jobPtr->isCompressed)
+    {
+        size = jobPtr->blockCount;
+        posPtr = backupFile_CopyToImage(posPtr, &size, 4);
+        posPtr = backupFile_CopyToImage(posPtr, &jobPtr->skipCount, 2);
+
+        for (i = 0; i < jobPtr->blockCount; i++)
+        {
+            const gorilla_Block_t* blockPtr = &jobPtr->blockPtr[i];
+
+            posPtr = backupFile_CopyToImage(posPtr, &blockPtr->count, 2);
+            posPtr = backupFile_CopyToImage(posPtr, &blockPtr->bitCount, 2);
+            posPtr = backupFile_CopyToImage(posPtr, blockPtr->data, (blockPtr->bitCount + 7) / 8);
+        }
+    }
+    else
+    {
+        char* heapPtr = (char*)posPtr + dataBytes;
+        uint32_t heapOffset = 0;
+
+        for (i = 0; i < jobPtr->count; i++)
+        {
+            const BufferSlot_t* slotPtr = &jobPtr->slotPtr[i];
+            uint8_t* valuePtr = backupFile_CopyToImage(posPtr, &slotPtr->timestamp, 8);
+
+            switch (jobPtr->bufferedType)
+            {
+                case IO_DATA_TYPE_TRIGGER:
+
+                    break;
+
+                case IO_DATA_TYPE_BOOLEAN:
+
+                    *valuePtr = slotPtr->value.boolean;
+                    break;
+
+                case IO_DATA_TYPE_NUMERIC:
+
+                    backupFile_CopyToImage(valuePtr, &slotPtr->value.numeric, 8);
+                    break;
+
+                case IO_DATA_TYPE_STRING:
+                case IO_DATA_TYPE_JSON:
+                {
+                    const char* stringPtr = GetSlotString(slotPtr, jobPtr->bufferedType);
+                    uint32_t stringLen = strlen(stringPtr);
+
+                    valuePtr = backupFile_CopyToImage(valuePtr, &heapOffset, 4);
+                    backupFile_CopyToImage(valuePtr, &stringLen, 4);
+
+                    memcpy(heapPtr + heapOffset, stringPtr, stringLen + 1);
+                    heapOffset += stringLen + 1;
+                    break;
+                }
+            }
+
+            posPtr += BACKUP_RECORD_BYTES;
+        }
+
+        posPtr += heapBytes;
+    }
+
+    // Rollup tiers.
+    for (i = 0; i < jobPtr->tierCount; i++)
+    {
+        const RollupTierCopy_t* tierPtr = &jobPtr->tiers[i];
+
+        size = tierPtr->count;
+        posPtr = backupFile_CopyToImage(posPtr, &tierPtr->period, 8);
+        posPtr = backupFile_CopyToImage(posPtr, &size, 4);
+
+        for (j = 0; j < tierPtr->count; j++)
+        {
+            const RollupBucket_t* bucketPtr = &tierPtr->bucketPtr[j];
+
+            posPtr = backupFile_CopyToImage(posPtr, &bucketPtr->start, 8);
+            posPtr = backupFile_CopyToImage(posPtr, &bucketPtr->count, 4);
+            posPtr = backupFile_CopyToImage(posPtr, &bucketPtr->mean, 8);
+            posPtr = backupFile_CopyToImage(posPtr, &bucketPtr->sumSquares, 8);
+            posPtr = backupFile_CopyToImage(posPtr, &bucketPtr->min, 8);
+            posPtr = backupFile_CopyToImage(posPtr, &bucketPtr->max, 8);
+        }
+    }
+
+    LE_ASSERT(posPtr == (imagePtr + imageBytes));
+
+    *imageBytesPtr = imageBytes;
+
+    return imagePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a given number of data samples from a given backup file and adds all but the newest one
+ * to a given Observation's data sample buffer.
+ *
+ * On error, logs an error message and closes the file.
+ *
+ * @return The newest data sample (which the caller must release), or NULL if there were no
+ *         samples to read or an error occurred (check errorPtr).
+ */
+//--------------------------------------------------------------------------------------------------
+static dataSample_Ref_t ReadSamplesFromFile
+(
+    Observation_t* obsPtr,
+    FILE* file,
+    size_t count,   ///< The number of samples to read.
+    bool* errorPtr  ///< [OUT] Set to true if an error occurred.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    dataSample_Ref_t dataSample = NULL;
+
+    *errorPtr = false;
+
+    while (count > 0)
+    {
+        le_result_t result = backupFile_ReadRecord(file, obsPtr->bufferedType, &dataSample);
+        if (result != LE_OK)
+        {
+            if (result == LE_UNDERFLOW)
+            {
+                LE_CRIT("Backup file was truncated. Expected %zu more samples.", count);
+            }
+
+            goto error;
+        }
+
+        count--;
+
+        // Add the sample to the buffer, unless this is the last (newest) sample, in which case
+        // the caller will push it to the Observation once it has confirmed that the rest of the
+        // file is intact (otherwise all these samples are probably corrupt and need to be
+        // discarded).
+        if (count != 0)
+        {
+            AddToBuffer(obsPtr, dataSample);
+            le_mem_Release(dataSample);
+            dataSample = NULL;
+        }
+    }
+
+    return dataSample;
+
+error:
+
+    // On error, dump the buffer contents in case we read some corrupted samples from the file.
+    TruncateBuffer(obsPtr, 0);
+    *errorPtr = true;
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decodes the samples in a compressed block read from a backup file and adds all but the newest
+ * one decoded so far to a given Observation's data sample buffer.
+ *
+ * @return true if successful, false if the block is corrupt or holds more samples than expected.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool AddBlockToBuffer
+(
+    Observation_t* obsPtr,
+    gorilla_Block_t* blockPtr,
+    uint16_t* skipCountPtr,     ///< [INOUT] Number of samples still to be skipped.
+    size_t* countPtr,           ///< [INOUT] Number of samples still expected.
+    dataSample_Ref_t* newestPtr ///< [INOUT] Newest sample decoded so far (or NULL).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    gorilla_Cursor_t cursor;
+
+    bool ok = gorilla_StartCursor(&cursor, blockPtr);
+    while (ok)
+    {
+        if (*skipCountPtr > 0)
+        {
+            (*skipCountPtr)--;
+        }
+        else
+        {
+            if (*countPtr == 0)
+            {
+                LE_CRIT("Backup file contains extra samples.");
+                return false;
+            }
+            (*countPtr)--;
+
+            // All but the newest sample go in the buffer.  See ReadSamplesFromFile().
+            if (*newestPtr != NULL)
+            {
+                AddToBuffer(obsPtr, *newestPtr);
+                le_mem_Release(*newestPtr);
+            }
+            *newestPtr = dataSample_CreateNumeric(cursor.state.timestamp,
+                                                  gorilla_GetValue(&cursor.state));
+        }
+
+        if (cursor.nextIndex >= blockPtr->count)
+        {
+            return true;
+        }
+
+        ok = gorilla_DecodeNext(&cursor);
+    }
+
+    LE_CRIT("Corrupt compressed block in backup file.");
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a given number of data samples in compressed blocks from a given backup file and adds all
+ * but the newest one to a given Observation's data sample buffer.
+ *
+ * On error, logs an error message and closes the file.
+ *
+ * @return The newest data sample (which the caller must release), or NULL if there were no
+ *         samples to read or an error occurred (check errorPtr).
+ */
+//--------------------------------------------------------------------------------------------------
+static dataSample_Ref_t ReadBlocksFromFile
+(
+    Observation_t* obsPtr,
+    FILE* file,
+    size_t count,   ///< The number of samples to read.
+    bool* errorPtr  ///< [OUT] Set to true if an error occurred.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    dataSample_Ref_t dataSample = NULL;
+
+    *errorPtr = false;
+
+    uint32_t blockCount;
+    uint16_t skipCount;
+    if (   (backupFile_Read(&blockCount, 4, file) != LE_OK)
+        || (backupFile_Read(&skipCount, 2, file) != LE_OK)  )
+    {
+        LE_CRIT("Failed to read compressed block header.");
+        goto error;
+    }
+
+    // The blocks are decoded one at a time and their samples added to the buffer, which
+    // compresses them again if its compression is enabled.
+    gorilla_Block_t block;
+
+    while (blockCount > 0)
+    {
+        blockCount--;
+
+        if (   (backupFile_Read(&block.count, 2, file) != LE_OK)
+            || (backupFile_Read(&block.bitCount, 2, file) != LE_OK)  )
+        {
+            LE_CRIT("Failed to read compressed block size.");
+            goto error;
+        }
+        if (block.bitCount > GORILLA_BLOCK_BITS)
+        {
+            LE_CRIT("Compressed block size (%u bits) is larger than permitted (%u).",
+                    (unsigned int)block.bitCount,
+                    GORILLA_BLOCK_BITS);
+            le_atomFile_CancelStream(file);
+            goto error;
+        }
+        if (backupFile_Read(block.data, (block.bitCount + 7) / 8, file) != LE_OK)
+        {
+            LE_CRIT("Failed to read compressed block of %u bits.", (unsigned int)block.bitCount);
+            goto error;
+        }
+
+        if (!AddBlockToBuffer(obsPtr, &block, &skipCount, &count, &dataSample))
+        {
+            le_atomFile_CancelStream(file);
+            goto error;
+        }
+    }
+
+    if (count > 0)
+    {
+        LE_CRIT("Backup file was truncated. Expected %zu more samples.", count);
+        le_atomFile_CancelStream(file);
+        goto error;
+    }
+
+    return dataSample;
+
+error:
+
+    // On error, dump the buffer contents in case we read some corrupted samples from the file.
+    if (dataSample != NULL)
+    {
+        le_mem_Release(dataSample);
+    }
+    TruncateBuffer(obsPtr, 0);
+    *errorPtr = true;
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens the backup journal file of a given Observation for reading, if there is one that follows
+ * on from the backup file just read, and reads its header.
+ *
+ * @return The journal file, positioned at its first record, or NULL if there is no usable journal.
+ */
+//--------------------------------------------------------------------------------------------------
+static FILE* OpenJournal
+(
+    Observation_t* obsPtr,
+    uint32_t count,                 ///< Number of samples read from the backup file.
+    dataSample_Ref_t newestSample,  ///< Newest sample read from the backup file (or NULL).
+    uint32_t* maxCountPtr           ///< [OUT] Buffer size when the journal was written.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char path[MAX_BACKUP_FILE_PATH_BYTES];
+    if (GetJournalFilePath(path, sizeof(path), obsPtr) != LE_OK)
+    {
+        return NULL;
+    }
+
+    backupFile_JournalHeader_t header;
+    FILE* file = backupFile_OpenJournal(path, &header);
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    // The journal must follow on from this backup file, not one that was replaced since
+    // (because the Data Hub was interrupted between writing a backup file and starting a new
+    // journal).
+    double newestTimestamp = (newestSample == NULL) ? NAN : dataSample_GetTimestamp(newestSample);
+    if (   (header.dataType != obsPtr->bufferedType)
+        || (header.count != count)
+        || (   (header.newestTimestamp != newestTimestamp)
+            && !(isnan(header.newestTimestamp) && isnan(newestTimestamp)))  )
+    {
+        LE_WARN("Ignoring backup journal '%s' that doesn't match the backup file.", path);
+        le_atomFile_CancelStream(file);
+        return NULL;
+    }
+
+    *maxCountPtr = header.maxCount;
+
+    return file;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the data samples from a given backup journal file and adds them to a given Observation's
+ * data sample buffer (if doBuffer is true), after the newest sample read from the backup file,
+ * keeping the journal's newest sample back instead.  Closes the file.
+ *
+ * An incomplete last record (left if the Data Hub was interrupted while appending to the journal)
+ * is ignored.
+ *
+ * @return The number of samples read from the journal.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t ReplayJournal
+(
+    Observation_t* obsPtr,
+    FILE* file,
+    dataSample_Ref_t* newestSamplePtr,  ///< [IN/OUT] Newest sample (which the caller must release).
+    bool doBuffer                       ///< false to just find the newest sample.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t count = 0;
+
+    for (;;)
+    {
+        dataSample_Ref_t dataSample;
+        le_result_t result = backupFile_ReadRecord(file, obsPtr->bufferedType, &dataSample);
+        if (result != LE_OK)
+        {
+            if (result != LE_UNDERFLOW)
+            {
+                LE_WARN("Ignoring incomplete sample at end of backup journal.");
+            }
+
+            return count;
+        }
+
+        count++;
+
+        if (*newestSamplePtr != NULL)
+        {
+            if (doBuffer)
+            {
+                AddToBuffer(obsPtr, *newestSamplePtr);
+            }
+            le_mem_Release(*newestSamplePtr);
+        }
+        *newestSamplePtr = dataSample;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the rollup tiers from a given backup file into a given array of tiers.
+ *
+ * On error, logs an error message and closes the file.
+ *
+ * @return true if successful, false if failed (in which case the tiers must still be freed).
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReadRollupTiersFromFile
+(
+    FILE* file,
+    RollupTier_t* tiers,    ///< [OUT] Array of ADMIN_MAX_ROLLUP_TIERS zeroed tiers to read into.
+    size_t* tierCountPtr    ///< [OUT] Number of tiers read.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint8_t tierCount;
+    if (backupFile_Read(&tierCount, 1, file) != LE_OK)
+    {
+        LE_CRIT("Failed to read number of rollup tiers.");
+        return false;
+    }
+    if (tierCount > ADMIN_MAX_ROLLUP_TIERS)
+    {
+        LE_CRIT("Too many rollup tiers (%d).", (int)tierCount);
+        le_atomFile_CancelStream(file);
+        return false;
+    }
+
+    *tierCountPtr = 0;
+
+    while (*tierCountPtr < tierCount)
+    {
+        RollupTier_t* tierPtr = &tiers[*tierCountPtr];
+        (*tierCountPtr)++;
+
+        uint32_t count;
+        if (   (backupFile_Read(&tierPtr->period, sizeof(tierPtr->period), file) != LE_OK)
+            || (backupFile_Read(&count, 4, file) != LE_OK)  )
+        {
+            LE_CRIT("Failed to read rollup tier header.");
+            return false;
+        }
+        if (   (!(tierPtr->period > 0)) || isinf(tierPtr->period)
+            || ((*tierCountPtr > 1) && (tierPtr->period <= tiers[*tierCountPtr - 2].period))  )
+        {
+            LE_CRIT("Invalid rollup tier period (%lf).", tierPtr->period);
+            le_atomFile_CancelStream(file);
+            return false;
+        }
+
+        if (ResizeRollupTier(tierPtr, count) != LE_OK)
+        {
+            le_atomFile_CancelStream(file);
+            return false;
+        }
+
+        for (tierPtr->count = 0; tierPtr->count < count; (tierPtr->count)++)
+        {
+            RollupBucket_t* bucketPtr = GetBucket(tierPtr, tierPtr->count);
+
+            if (   (backupFile_Read(&bucketPtr->start, sizeof(bucketPtr->start), file) != LE_OK)
+                || (backupFile_Read(&bucketPtr->count, 4, file) != LE_OK)
+                || (backupFile_Read(&bucketPtr->mean, sizeof(bucketPtr->mean), file) != LE_OK)
+                || (backupFile_Read(&bucketPtr->sumSquares,
+                                 sizeof(bucketPtr->sumSquares),
+                                 file) != LE_OK)
+                || (backupFile_Read(&bucketPtr->min, sizeof(bucketPtr->min), file) != LE_OK)
+                || (backupFile_Read(&bucketPtr->max, sizeof(bucketPtr->max), file) != LE_OK)  )
+            {
+                LE_CRIT("Failed to read rollup tier bucket.");
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the record table of a backup file image and adds all but the newest sample to a given
+ * Observation's data sample buffer.
+ *
+ * @return true if successful, false if the record table is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReadRecordsFromImage
+(
+    Observation_t* obsPtr,
+    const uint8_t* dataPtr,     ///< Start of the record table.
+    size_t dataBytes,           ///< Size of the record table.
+    const char* heapPtr,        ///< Start of the string heap.
+    size_t heapBytes,           ///< Size of the string heap.
+    size_t count,               ///< Number of samples expected.
+    dataSample_Ref_t* newestPtr ///< [OUT] Newest sample (which the caller must release), or NULL.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (((dataBytes % BACKUP_RECORD_BYTES) != 0) || ((dataBytes / BACKUP_RECORD_BYTES) != count))
+    {
+        LE_CRIT("Record table size (%zu) doesn't match number of samples (%zu).", dataBytes, count);
+        return false;
+    }
+
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        const uint8_t* recordPtr = dataPtr + (i * BACKUP_RECORD_BYTES);
+        dataSample_Ref_t sampleRef = backupFile_CreateSampleFromRecord(recordPtr,
+                                                                       obsPtr->bufferedType,
+                                                                       heapPtr,
+                                                                       heapBytes);
+        if (sampleRef == NULL)
+        {
+            return false;
+        }
+
+        // All but the newest sample go in the buffer.  See ReadSamplesFromFile().
+        if (*newestPtr != NULL)
+        {
+            AddToBuffer(obsPtr, *newestPtr);
+            le_mem_Release(*newestPtr);
+        }
+        *newestPtr = sampleRef;
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the compressed blocks of a backup file image and adds all but the newest sample to a
+ * given Observation's data sample buffer.
+ *
+ * @return true if successful, false if the blocks are invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReadBlocksFromImage
+(
+    Observation_t* obsPtr,
+    const uint8_t* dataPtr,     ///< Start of the compressed blocks section.
+    size_t dataBytes,           ///< Size of the compressed blocks section.
+    size_t count,               ///< Number of samples expected.
+    dataSample_Ref_t* newestPtr ///< [OUT] Newest sample (which the caller must release), or NULL.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const uint8_t* endPtr = dataPtr + dataBytes;
+
+    uint32_t blockCount;
+    uint16_t skipCount;
+    if (dataBytes < (4 + 2))
+    {
+        LE_CRIT("Compressed block header is truncated.");
+        return false;
+    }
+    dataPtr = backupFile_CopyFromImage(&blockCount, dataPtr, 4);
+    dataPtr = backupFile_CopyFromImage(&skipCount, dataPtr, 2);
+
+    // The blocks are decoded one at a time and their samples added to the buffer, which
+    // compresses them again if its compression is enabled.
+    gorilla_Block_t block;
+
+    while (blockCount > 0)
+    {
+        blockCount--;
+
+        if ((endPtr - dataPtr) < (2 + 2))
+        {
+            LE_CRIT("Compressed block size is truncated.");
+            return false;
+        }
+        dataPtr = backupFile_CopyFromImage(&block.count, dataPtr, 2);
+        dataPtr = backupFile_CopyFromImage(&block.bitCount, dataPtr, 2);
+
+        size_t blockBytes = (block.bitCount + 7) / 8;
+        if (block.bitCount > GORILLA_BLOCK_BITS)
+        {
+            LE_CRIT("Compressed block size (%u bits) is larger than permitted (%u).",
+                    (unsigned int)block.bitCount,
+                    GORILLA_BLOCK_BITS);
+            return false;
+        }
+        if ((size_t)(endPtr - dataPtr) < blockBytes)
+        {
+            LE_CRIT("Compressed block of %u bits is truncated.", (unsigned int)block.bitCount);
+            return false;
+        }
+        dataPtr = backupFile_CopyFromImage(block.data, dataPtr, blockBytes);
+
+        if (!AddBlockToBuffer(obsPtr, &block, &skipCount, &count, newestPtr))
+        {
+            return false;
+        }
+    }
+
+    if (dataPtr != endPtr)
+    {
+        LE_CRIT("Compressed blocks section contains extra data.");
+        return false;
+    }
+    if (count > 0)
+    {
+        LE_CRIT("Backup file was truncated. Expected %zu more samples.", count);
+        return false;
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the rollup tiers section of a backup file image, which runs to the end of the image.
+ *
+ * @return true if successful, false if the section is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReadRollupTiersFromImage
+(
+    const uint8_t* posPtr,  ///< Start of the rollup tiers section.
+    const uint8_t* endPtr,  ///< End of the image.
+    size_t tierCount,       ///< Number of tiers in the section.
+    RollupTier_t* tiers,    ///< [OUT] Array of ADMIN_MAX_ROLLUP_TIERS zeroed tiers to read into.
+    size_t* tierCountPtr    ///< [OUT] Number of tiers read.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    *tierCountPtr = 0;
+
+    while (*tierCountPtr < tierCount)
+    {
+        RollupTier_t* tierPtr = &tiers[*tierCountPtr];
+        (*tierCountPtr)++;
+
+        uint32_t count;
+        if ((endPtr - posPtr) < (8 + 4))
+        {
+            LE_CRIT("Rollup tier header is truncated.");
+            return false;
+        }
+        posPtr = backupFile_CopyFromImage(&tierPtr->period, posPtr, 8);
+        posPtr = backupFile_CopyFromImage(&count, posPtr, 4);
+        if (   (!(tierPtr->period > 0)) || isinf(tierPtr->period)
+            || ((*tierCountPtr > 1) && (tierPtr->period <= tiers[*tierCountPtr - 2].period))  )
+        {
+            LE_CRIT("Invalid rollup tier period (%lf).", tierPtr->period);
+            return false;
+        }
+        if (((size_t)(endPtr - posPtr) / BACKUP_BUCKET_BYTES) < count)
+        {
+            LE_CRIT("Rollup tier of %u buckets is truncated.", (unsigned int)count);
+            return false;
+        }
+
+        if (ResizeRollupTier(tierPtr, count) != LE_OK)
+        {
+            return false;
+        }
+
+        for (tierPtr->count = 0; tierPtr->count < count; (tierPtr->count)++)
+        {
+            RollupBucket_t* bucketPtr = GetBucket(tierPtr, tierPtr->count);
+
+            posPtr = backupFile_CopyFromImage(&bucketPtr->start, posPtr, 8);
+            posPtr = backupFile_CopyFromImage(&bucketPtr->count, posPtr, 4);
+            posPtr = backupFile_CopyFromImage(&bucketPtr->mean, posPtr, 8);
+            posPtr = backupFile_CopyFromImage(&bucketPtr->sumSquares, posPtr, 8);
+            posPtr = backupFile_CopyFromImage(&bucketPtr->min, posPtr, 8);
+            posPtr = backupFile_CopyFromImage(&bucketPtr->max, posPtr, 8);
+        }
+    }
+
+    if (posPtr != endPtr)
+    {
+        LE_CRIT("Backup file contains extra data.");
+        return false;
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the rest of a backup file (in the current format) whose header has been read up to the
+ * number of records, by mapping the whole file into memory.  Adds all but the newest sample to a
+ * given Observation's data sample buffer.
+ *
+ * Closes the file.
+ *
+ * @return The newest data sample (which the caller must release), or NULL if there were no
+ *         samples to read or an error occurred (check errorPtr).
+ */
+//--------------------------------------------------------------------------------------------------
+static dataSample_Ref_t ReadBackupImage
+(
+    Observation_t* obsPtr,
+    FILE* file,
+    size_t count,           ///< The number of samples to read.
+    bool isCompressed,      ///< true if the samples are in compressed blocks.
+    RollupTier_t* tiers,    ///< [OUT] Array of ADMIN_MAX_ROLLUP_TIERS zeroed tiers to read into.
+    size_t* tierCountPtr,   ///< [OUT] Number of tiers read.
+    bool* errorPtr          ///< [OUT] Set to true if an error occurred.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    dataSample_Ref_t dataSample = NULL;
+
+    *tierCountPtr = 0;
+    *errorPtr = false;
+
+    backupFile_Image_t image;
+    if (!backupFile_MapImage(file, &image))
+    {
+        le_atomFile_CancelStream(file);
+        goto error;
+    }
+
+    bool ok;
+    if (isCompressed)
+    {
+        ok = ReadBlocksFromImage(obsPtr, image.dataPtr, image.dataBytes, count, &dataSample);
+    }
+    else
+    {
+        ok = ReadRecordsFromImage(obsPtr,
+                                  image.dataPtr,
+                                  image.dataBytes,
+                                  image.heapPtr,
+                                  image.heapBytes,
+                                  count,
+                                  &dataSample);
+    }
+
+    ok = ok && ReadRollupTiersFromImage((const uint8_t*)image.heapPtr + image.heapBytes,
+                                        image.basePtr + image.size,
+                                        image.tierCount,
+                                        tiers,
+                                        tierCountPtr);
+
+    backupFile_UnmapImage(&image);
+    le_atomFile_CancelStream(file);
+
+    if (ok)
+    {
+        return dataSample;
+    }
+
+error:
+
+    // On error, dump the buffer contents in case we read some corrupted samples from the file.
+    if (dataSample != NULL)
+    {
+        le_mem_Release(dataSample);
+    }
+    size_t i;
+    for (i = 0; i < *tierCountPtr; i++)
+    {
+        free(tiers[i].bucketPtr);
+        tiers[i].bucketPtr = NULL;
+    }
+    *tierCountPtr = 0;
+    TruncateBuffer(obsPtr, 0);
+    *errorPtr = true;
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads just the newest data sample from a backup file image, without adding anything to the
+ * Observation's buffer.  The rest of the image is only checked when the whole backup is loaded.
+ *
+ * @return The newest data sample (which the caller must release), or NULL if there are no
+ *         samples or an error occurred (check errorPtr).
+ */
+//--------------------------------------------------------------------------------------------------
+static dataSample_Ref_t ReadNewestFromImage
+(
+    const backupFile_Image_t* imagePtr,
+    const backupFile_Header_t* headerPtr,
+    bool* errorPtr  ///< [OUT] Set to true if an error occurred.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    *errorPtr = false;
+
+    if (headerPtr->count == 0)
+    {
+        return NULL;
+    }
+
+    dataSample_Ref_t dataSample = NULL;
+
+    if (!headerPtr->isCompressed)
+    {
+        if (   ((imagePtr->dataBytes % BACKUP_RECORD_BYTES) != 0)
+            || ((imagePtr->dataBytes / BACKUP_RECORD_BYTES) != headerPtr->count)  )
+        {
+            LE_CRIT("Record table size (%zu) doesn't match number of samples (%u).",
+                    imagePtr->dataBytes,
+                    (unsigned int)headerPtr->count);
+        }
+        else
+        {
+            const uint8_t* recordPtr = imagePtr->dataPtr
+                                       + ((headerPtr->count - 1) * BACKUP_RECORD_BYTES);
+            dataSample = backupFile_CreateSampleFromRecord(recordPtr,
+                                                           headerPtr->dataType,
+                                                           imagePtr->heapPtr,
+                                                           imagePtr->heapBytes);
+        }
+
+        *errorPtr = (dataSample == NULL);
+        return dataSample;
+    }
+
+    // Skip to the last compressed block, which holds the newest sample.
+    const uint8_t* posPtr = imagePtr->dataPtr;
+    const uint8_t* endPtr = posPtr + imagePtr->dataBytes;
+    const uint8_t* lastBlockPtr = NULL;
+    uint32_t blockCount = 0;
+    gorilla_Block_t block;
+
+    if (imagePtr->dataBytes >= (4 + 2))
+    {
+        // The skip count only matters to the oldest block.
+        posPtr = backupFile_CopyFromImage(&blockCount, posPtr, 4) + 2;
+    }
+    while (blockCount > 0)
+    {
+        blockCount--;
+
+        if ((endPtr - posPtr) < (2 + 2))
+        {
+            break;
+        }
+        lastBlockPtr = posPtr;
+        posPtr = backupFile_CopyFromImage(&block.count, posPtr, 2);
+        posPtr = backupFile_CopyFromImage(&block.bitCount, posPtr, 2);
+        if (   (block.bitCount > GORILLA_BLOCK_BITS)
+            || ((size_t)(endPtr - posPtr) < ((block.bitCount + 7) / 8))  )
+        {
+            break;
+        }
+        posPtr += (block.bitCount + 7) / 8;
+    }
+
+    if ((lastBlockPtr != NULL) && (blockCount == 0))
+    {
+        posPtr = backupFile_CopyFromImage(&block.count, lastBlockPtr, 2);
+        posPtr = backupFile_CopyFromImage(&block.bitCount, posPtr, 2);
+        backupFile_CopyFromImage(block.data, posPtr, (block.bitCount + 7) / 8);
+
+        gorilla_Cursor_t cursor;
+        bool ok = gorilla_StartCursor(&cursor, &block);
+        while (ok && (cursor.nextIndex < block.count))
+        {
+            ok = gorilla_DecodeNext(&cursor);
+        }
+        if (ok)
+        {
+            dataSample = dataSample_CreateNumeric(cursor.state.timestamp,
+                                                  gorilla_GetValue(&cursor.state));
+        }
+    }
+
+    if (dataSample == NULL)
+    {
+        LE_CRIT("Corrupt compressed blocks in backup file.");
+        *errorPtr = true;
+    }
+
+    return dataSample;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Install rollup tiers read from a backup file into an Observation.  Tiers that match the
+ * Observation's own tier settings (by period) replace the Observation's tiers' contents (keeping
+ * the newest buckets if the Observation's tier is smaller).  If the Observation has no tiers, it
+ * takes on the backed-up tiers as they are.  Other backed-up tiers are dropped.
+ *
+ * Frees the backed-up tiers.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InstallRollupTiers
+(
+    Observation_t* obsPtr,
+    RollupTier_t* tiers,    ///< Array of backed-up tiers.
+    size_t tierCount        ///< Number of backed-up tiers.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    bool adopt = (obsPtr->tierCount == 0);
+
+    size_t i;
+    for (i = 0; i < tierCount; i++)
+    {
+        RollupTier_t* tierPtr = &tiers[i];
+
+        if (adopt)
+        {
+            // The restored tier must have room for at least one bucket to be usable.
+            if ((tierPtr->maxCount > 0) || (ResizeRollupTier(tierPtr, 1) == LE_OK))
+            {
+                obsPtr->tiers[obsPtr->tierCount] = *tierPtr;
+                (obsPtr->tierCount)++;
+                continue;
+            }
+        }
+        else
+        {
+            size_t j;
+            for (j = 0; j < obsPtr->tierCount; j++)
+            {
+                RollupTier_t* ownTierPtr = &obsPtr->tiers[j];
+
+                if (   (ownTierPtr->period == tierPtr->period)
+                    && (ResizeRollupTier(tierPtr, ownTierPtr->maxCount) == LE_OK)  )
+                {
+                    free(ownTierPtr->bucketPtr);
+                    *ownTierPtr = *tierPtr;
+                    tierPtr->bucketPtr = NULL;
+                    break;
+                }
+            }
+        }
+
+        free(tierPtr->bucketPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a new backup file from the copy of an Observation's buffer and rollup tiers held by a
+ * given backup job, and start a new, empty journal after it.  Runs in the Backup Thread.
+ *
+ * @return true if the backup file was written.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool WriteBackupFile
+(
+    BackupJob_t* jobPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* path = jobPtr->path;
+
+    LE_DEBUG("Backing up to '%s'...", path);
+
+    if (!MakeBackupDir())
+    {
+        return false;
+    }
+
+    // Lay out the whole file in memory first, so it can be written with a single system call.
+    size_t imageBytes;
+    uint8_t* imagePtr = BuildBackupImage(jobPtr, &imageBytes);
+    if (imagePtr == NULL)
+    {
+        return false;
+    }
+
+    // Open the file for writing, truncating it to zero length to start.
+    int fd = le_atomFile_Create(path, LE_FLOCK_WRITE, LE_FLOCK_REPLACE_IF_EXIST, 0600);
+    if (fd < 0)
+    {
+        LE_CRIT("Unable to open file '%s' for writing (%s).", path, LE_RESULT_TXT(fd));
+        free(imagePtr);
+        return false;
+    }
+
+    // Write the image, looping only if the write is cut short.
+    size_t offset = 0;
+    while (offset < imageBytes)
+    {
+        ssize_t bytesWritten = WriteToFd(fd, imagePtr + offset, imageBytes - offset);
+        if (bytesWritten < 0)
+        {
+            LE_CRIT("Failed to write (%m).");
+            le_atomFile_Cancel(fd);
+            free(imagePtr);
+            return false;
+        }
+        offset += bytesWritten;
+    }
+
+    free(imagePtr);
+
+    // Commit the file.
+    le_result_t result = le_atomFile_Close(fd);
+    if (result != LE_OK)
+    {
+        LE_CRIT("Failed to save '%s' (%s).", path, LE_RESULT_TXT(result));
+        return false;
+    }
+
+    // Start a new journal for the samples that arrive after this backup (unless there's no buffer
+    // to journal them from).
+    if (jobPtr->maxCount > 0)
+    {
+        backupFile_JournalHeader_t header;
+        header.dataType = jobPtr->dataType;
+        header.maxCount = jobPtr->maxCount;
+        header.count = jobPtr->bufferCount;
+        header.newestTimestamp = jobPtr->newestTimestamp;
+        jobPtr->journalStarted = backupFile_StartJournal(jobPtr->journalPath, &header);
+    }
+
+    LE_DEBUG("Backup complete.");
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append the samples held by a given backup job to the backup journal.  Runs in the Backup Thread.
+ *
+ * @return true if successful, false if failed (the journal may now end with a partial record).
+ */
+//--------------------------------------------------------------------------------------------------
+static bool WriteToJournal
+(
+    const BackupJob_t* jobPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* path = jobPtr->journalPath;
+
+    LE_DEBUG("Appending %zu samples to '%s'...", jobPtr->count, path);
+
+    le_result_t result;
+    FILE* file = le_flock_CreateStream(path,
+                                       LE_FLOCK_APPEND,
+                                       LE_FLOCK_OPEN_IF_EXIST,
+                                       0600,
+                                       &result);
+    if (result != LE_OK)
+    {
+        LE_CRIT("Unable to open file '%s' for appending (%s).", path, LE_RESULT_TXT(result));
+        return false;
+    }
+
+    bool ok = true;
+
+    size_t i;
+    for (i = 0; (i < jobPtr->count) && ok; i++)
+    {
+        ok = WriteRecord(file, jobPtr->bufferedType, &jobPtr->slotPtr[i]);
+    }
+
+    // Don't sync here.  SyncBackups() syncs all the backups written together.
+    ok = ok && (fflush(file) == 0);
+    if (!ok)
+    {
+        LE_CRIT("Failed to append to '%s' (%m).", path);
+    }
+
+    le_flock_CloseStream(file);
+
+    if (ok)
+    {
+        LE_DEBUG("Backup complete.");
+    }
+
+    return ok;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a backup job, along with its copies of the samples and rollup tiers.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseBackupJob
+(
+    BackupJob_t* jobPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (   (jobPtr->bufferedType == IO_DATA_TYPE_STRING)
+        || (jobPtr->bufferedType == IO_DATA_TYPE_JSON)  )
+    {
+        size_t i;
+        for (i = 0; i < jobPtr->count; i++)
+        {
+            le_mem_Release(jobPtr->slotPtr[i].value.sampleRef);
+        }
+    }
+    free(jobPtr->slotPtr);
+    free(jobPtr->blockPtr);
+
+    size_t i;
+    for (i = 0; i < jobPtr->tierCount; i++)
+    {
+        free(jobPtr->tiers[i].bucketPtr);
+    }
+
+    le_mem_Release(jobPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish a backup job passed back by the Backup Thread, updating the backup state of the
+ * Observation it backed up.  Runs in the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompleteBackupJob
+(
+    backupThread_Job_t* jobPtr  ///< The backup job, as queued to the Backup Thread.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    BackupJob_t* backupJobPtr = CONTAINER_OF(jobPtr, BackupJob_t, threadJob);
+    Observation_t* obsPtr = backupJobPtr->obsPtr;
+
+    // If the Observation has been deleted since, there's nothing to update.
+    if (obsPtr != NULL)
+    {
+        obsPtr->backupJobPtr = NULL;
+
+        if (backupJobPtr->type == BACKUP_JOB_SNAPSHOT)
+        {
+            if (backupJobPtr->ok && backupJobPtr->journalStarted && backupJobPtr->keepJournal)
+            {
+                obsPtr->canJournal = true;
+                obsPtr->backupSeq = backupJobPtr->endSeq;
+                obsPtr->journalCount = 0;
+            }
+        }
+        else if (!backupJobPtr->ok)
+        {
+            // The journal may now end with a partial record, so don't append to it again.
+            obsPtr->canJournal = false;
+        }
+
+        // If another backup came due while this one was in progress, it's overdue now.
+        if (backupJobPtr->backupAgain && (obsPtr->backupPeriod > 0))
+        {
+            ScheduleBackup(obsPtr);
+        }
+    }
+
+    ReleaseBackupJob(backupJobPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the directories a deleted backup file was in, up to (but not including) the backup
+ * directory, as long as they are empty.  Runs in the Backup Thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveEmptyDirectories
+(
+    const char* path    ///< Path of the deleted file.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char dirPath[MAX_BACKUP_FILE_PATH_BYTES];
+    LE_ASSERT(le_utf8_Copy(dirPath, path, sizeof(dirPath), NULL) == LE_OK);
+
+    char* slashPtr;
+    while (   ((slashPtr = strrchr(dirPath, '/')) != NULL)
+           && (slashPtr > (dirPath + BACKUP_DIR_PATH_LEN - 1))  )
+    {
+        *slashPtr = '\0';
+
+        if (rmdir(dirPath) != 0)
+        {
+            if ((errno != ENOTEMPTY) && (errno != EEXIST) && (errno != ENOENT))
+            {
+                LE_CRIT("Failed to remove directory '%s' (%m).", dirPath);
+            }
+            return;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Do a backup job.  Runs in the Backup Thread, which then passes the job back to the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunBackupJob
+(
+    backupThread_Job_t* jobPtr  ///< The backup job, as queued to the Backup Thread.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    BackupJob_t* backupJobPtr = CONTAINER_OF(jobPtr, BackupJob_t, threadJob);
+
+    switch (backupJobPtr->type)
+    {
+        case BACKUP_JOB_SNAPSHOT:
+
+            backupJobPtr->ok = WriteBackupFile(backupJobPtr);
+            break;
+
+        case BACKUP_JOB_APPEND:
+
+            backupJobPtr->ok = WriteToJournal(backupJobPtr);
+            break;
+
+        case BACKUP_JOB_DELETE:
+
+            unlink(backupJobPtr->path);
+            if (backupJobPtr->journalPath[0] != '\0')
+            {
+                unlink(backupJobPtr->journalPath);
+            }
+            RemoveEmptyDirectories(backupJobPtr->path);
+            backupJobPtr->ok = true;
+            break;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a backup job for a given Observation's backup files.  The job doesn't hold any samples
+ * or rollup tiers yet.
+ *
+ * @return Pointer to the job, or NULL if failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static BackupJob_t* CreateBackupJob
+(
+    Observation_t* obsPtr,
+    BackupJobType_t type
+)
+//--------------------------------------------------------------------------------------------------
+{
+    BackupJob_t* jobPtr = le_mem_ForceAlloc(BackupJobPool);
+    memset(jobPtr, 0, sizeof(*jobPtr));
+
+    // The journal path is the backup file path with the journal suffix appended.
+    if (   (GetBackupFilePath(jobPtr->path, sizeof(jobPtr->path), obsPtr) != LE_OK)
+        || (le_utf8_Copy(jobPtr->journalPath, jobPtr->path, sizeof(jobPtr->journalPath), NULL)
+            != LE_OK)
+        || (le_utf8_Append(jobPtr->journalPath, JOURNAL_SUFFIX, sizeof(jobPtr->journalPath), NULL)
+            != LE_OK)  )
+    {
+        le_mem_Release(jobPtr);
+        return NULL;
+    }
+
+    jobPtr->type = type;
+    jobPtr->keepJournal = true;
+    jobPtr->dataType = res_GetDataType(&obsPtr->resource);
+    jobPtr->bufferedType = obsPtr->bufferedType;
+    jobPtr->maxCount = obsPtr->maxCount;
+    jobPtr->bufferCount = obsPtr->count;
+    jobPtr->newestTimestamp = (obsPtr->count == 0) ? NAN : GetNewestTimestamp(obsPtr);
+    jobPtr->endSeq = obsPtr->oldestSeq + obsPtr->count;
+
+    return jobPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy the samples in a given Observation's buffer, from a given sequence number to the newest,
+ * into a backup job.  String and JSON values are shared with the buffer by holding a reference on
+ * their Data Samples.
+ *
+ * @return true if successful, false if out of memory.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CopySamplesToJob
+(
+    BackupJob_t* jobPtr,
+    Observation_t* obsPtr,
+    uint64_t startSeq   ///< Sequence number of the first sample to copy.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t count = jobPtr->endSeq - startSeq;
+    if (count == 0)
+    {
+        return true;
+    }
+
+    jobPtr->slotPtr = calloc(count, sizeof(BufferSlot_t));
+    if (jobPtr->slotPtr == NULL)
+    {
+        LE_CRIT("Failed to allocate backup of %zu samples.", count);
+        return false;
+    }
+
+    bool holdsRef = (   (obsPtr->bufferedType == IO_DATA_TYPE_STRING)
+                     || (obsPtr->bufferedType == IO_DATA_TYPE_JSON)  );
+
+    BufferCursor_t cursor;
+    bool found;
+    for (found = SeekBuffer(obsPtr, &cursor, startSeq - obsPtr->oldestSeq);
+         found;
+         found = NextInBuffer(obsPtr, &cursor))
+    {
+        BufferSlot_t* slotPtr = &jobPtr->slotPtr[jobPtr->count++];
+
+        *slotPtr = cursor.slot;
+        if (holdsRef)
+        {
+            le_mem_AddRef(slotPtr->value.sampleRef);
+        }
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy the blocks of a given Observation's compressed buffer into a backup job.
+ *
+ * @return true if successful, false if out of memory.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CopyBlocksToJob
+(
+    BackupJob_t* jobPtr,
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    gorilla_Buffer_t* bufPtr = obsPtr->compressedPtr;
+
+    jobPtr->isCompressed = true;
+
+    le_sls_Link_t* linkPtr = le_sls_Peek(&bufPtr->blockList);
+    if (linkPtr == NULL)
+    {
+        return true;
+    }
+
+    // Samples already discarded from the oldest block are still encoded in it.
+    jobPtr->skipCount = bufPtr->oldest.nextIndex - 1;
+
+    size_t blockCount = 0;
+    while (linkPtr != NULL)
+    {
+        blockCount++;
+        linkPtr = le_sls_PeekNext(&bufPtr->blockList, linkPtr);
+    }
+
+    jobPtr->blockPtr = calloc(blockCount, sizeof(gorilla_Block_t));
+    if (jobPtr->blockPtr == NULL)
+    {
+        LE_CRIT("Failed to allocate backup of %zu blocks.", blockCount);
+        return false;
+    }
+
+    for (linkPtr = le_sls_Peek(&bufPtr->blockList);
+         linkPtr != NULL;
+         linkPtr = le_sls_PeekNext(&bufPtr->blockList, linkPtr))
+    {
+        jobPtr->blockPtr[jobPtr->blockCount++] = *CONTAINER_OF(linkPtr, gorilla_Block_t, link);
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy the rollup tiers of a given Observation into a backup job.
+ *
+ * @return true if successful, false if out of memory.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CopyRollupTiersToJob
+(
+    BackupJob_t* jobPtr,
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t i;
+    for (i = 0; i < obsPtr->tierCount; i++)
+    {
+        RollupTier_t* tierPtr = &obsPtr->tiers[i];
+        RollupTierCopy_t* copyPtr = &jobPtr->tiers[jobPtr->tierCount++];
+
+        copyPtr->period = tierPtr->period;
+
+        if (tierPtr->count > 0)
+        {
+            copyPtr->bucketPtr = calloc(tierPtr->count, sizeof(RollupBucket_t));
+            if (copyPtr->bucketPtr == NULL)
+            {
+                LE_CRIT("Failed to allocate backup of %zu buckets.", tierPtr->count);
+                return false;
+            }
+
+            size_t j;
+            for (j = 0; j < tierPtr->count; j++)
+            {
+                copyPtr->bucketPtr[j] = *GetBucket(tierPtr, j);
+            }
+            copyPtr->count = tierPtr->count;
+        }
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a backup job to the Backup Thread.  If the job backs up an Observation, it becomes that
+ * Observation's backup in progress until the Backup Thread passes it back.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueBackupJob
+(
+    BackupJob_t* jobPtr,
+    Observation_t* obsPtr   ///< Observation backed up, or NULL if the job doesn't back one up.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    jobPtr->obsPtr = obsPtr;
+    if (obsPtr != NULL)
+    {
+        obsPtr->backupJobPtr = jobPtr;
+    }
+
+    jobPtr->threadJob.pathPtr = jobPtr->path;
+    jobPtr->threadJob.otherPathPtr = (jobPtr->journalPath[0] == '\0') ? NULL : jobPtr->journalPath;
+
+    backupThread_QueueJob(&jobPtr->threadJob, RunBackupJob, CompleteBackupJob);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the observation's buffer backup file and backup journal file, if they exist.  The files
+ * are deleted by the Backup Thread after any backups of them still in progress.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteBackup
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    StopJournal(obsPtr);
+
+    BackupJob_t* jobPtr = CreateBackupJob(obsPtr, BACKUP_JOB_DELETE);
+    if (jobPtr != NULL)
+    {
+        QueueBackupJob(jobPtr, NULL);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a file to the Unused Backup File List.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddUnusedBackupFile
+(
+    const char* backupPath, ///< Path of the backup file it goes with.
+    const char* path        ///< Path of the file itself.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    UnusedBackupFile_t* filePtr = le_mem_ForceAlloc(UnusedBackupFilePool);
+
+    filePtr->link = LE_DLS_LINK_INIT;
+    if (   (le_utf8_Copy(filePtr->backupPath, backupPath, sizeof(filePtr->backupPath), NULL)
+            != LE_OK)
+        || (le_utf8_Copy(filePtr->path, path, sizeof(filePtr->path), NULL) != LE_OK)  )
+    {
+        LE_ERROR("Backup file path too long. Skipping '%s'.", path);
+        le_mem_Release(filePtr);
+        return;
+    }
+
+    le_dls_Queue(&UnusedBackupFileList, &filePtr->link);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record that an Observation has stopped using its backup files, without deleting them, so the
+ * next clean-up will delete them (unless the Observation starts using them again first).
+ */
+//--------------------------------------------------------------------------------------------------
+static void MarkBackupUnused
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char path[MAX_BACKUP_FILE_PATH_BYTES];
+    char journalPath[MAX_BACKUP_FILE_PATH_BYTES];
+
+    if (   (GetBackupFilePath(path, sizeof(path), obsPtr) == LE_OK)
+        && (GetJournalFilePath(journalPath, sizeof(journalPath), obsPtr) == LE_OK)  )
+    {
+        AddUnusedBackupFile(path, path);
+        AddUnusedBackupFile(path, journalPath);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the files that go with a given backup (or ring) file from the Unused Backup File List, so
+ * clean-ups won't delete them.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClaimUnusedBackupFiles
+(
+    const char* backupPath  ///< Path of the backup (or ring) file.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&UnusedBackupFileList);
+    while (linkPtr != NULL)
+    {
+        UnusedBackupFile_t* filePtr = CONTAINER_OF(linkPtr, UnusedBackupFile_t, link);
+
+        linkPtr = le_dls_PeekNext(&UnusedBackupFileList, linkPtr);
+
+        if (strcmp(filePtr->backupPath, backupPath) == 0)
+        {
+            le_dls_Remove(&UnusedBackupFileList, &filePtr->link);
+            le_mem_Release(filePtr);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record that an Observation has started using its backup files, so clean-ups won't delete them.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MarkBackupInUse
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (le_dls_IsEmpty(&UnusedBackupFileList))
+    {
+        return;
+    }
+
+    char path[MAX_BACKUP_FILE_PATH_BYTES];
+    if (GetBackupFilePath(path, sizeof(path), obsPtr) == LE_OK)
+    {
+        ClaimUnusedBackupFiles(path);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function that gets called for each file system object (file, directory, symlink, etc.) found
+ * under the backup directory when it is indexed at start-up.
+ *
+ * @return 0 to continue the file system tree walk, non-zero to stop.
+ */
+//--------------------------------------------------------------------------------------------------
+static int BackupDirTreeWalkCallback
+(
+    const char *fpath,      ///< File system path of the object.
+    const struct stat *sb,  ///< Ptr to the stat() info for the object.
+    int typeflag,           ///< What type of file system object we're looking at.
+    struct FTW *ftwbuf      ///< Ptr to buffer containing the basename and the nesting level.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    switch (typeflag)
+    {
+        case FTW_F:  // regular file
+        {
+            // Find the backup file that this file goes with (the file itself, if it isn't a
+            // backup journal).  Ring files go with themselves.
+            const char* relPath = fpath + BACKUP_DIR_PATH_LEN;
+            const char* suffixPtr = strstr(relPath, BACKUP_SUFFIX);
+            size_t suffixLen = BACKUP_SUFFIX_LEN;
+            const char* ringSuffixPtr = strstr(relPath, RING_SUFFIX);
+            if ((ringSuffixPtr != NULL) && ((suffixPtr == NULL) || (ringSuffixPtr > suffixPtr)))
+            {
+                suffixPtr = ringSuffixPtr;
+                suffixLen = RING_SUFFIX_LEN;
+            }
+            if (suffixPtr == NULL)
+            {
+                LE_WARN("Unexpected file in backup directory. Skipping '%s'.", fpath);
+                return 0;
+            }
+            size_t backupPathBytes = (suffixPtr + suffixLen - fpath) + 1;
+            char backupPath[MAX_BACKUP_FILE_PATH_BYTES];
+            if (backupPathBytes > sizeof(backupPath))
+            {
+                LE_ERROR("Length of path too long. Skipping '%s'.", fpath);
+                return 0;
+            }
+            (void)snprintf(backupPath, backupPathBytes, "%s", fpath);
+
+            // No Observation has enabled backups (or persistence) yet.
+            AddUnusedBackupFile(backupPath, fpath);
+
+            return 0;
+        }
+        case FTW_D:  // directory and FTW_DEPTH was NOT specified
+
+            // This should never happen, because we specified FTW_DEPTH.
+            LE_CRIT("Received FTW_D flag for '%s'!", fpath);
+            return 0;
+
+        case FTW_DNR:   // directory that can't be read
+
+            LE_ERROR("Can't read directory '%s'", fpath);
+            return 0;
+
+        case FTW_DP:    // directory and FTW_DEPTH was specified
+        {
+            // If the directory is empty, delete it.
+            int result = rmdir(fpath);
+            if ((result == -1) && (errno != ENOTEMPTY) && (errno != EEXIST))
+            {
+                LE_CRIT("Failed to remove directory '%s' (%m).", fpath);
+            }
+            return 0;
+        }
+        case FTW_NS:     // stat() call failed on fpath
+
+            LE_CRIT("Failed to stat '%s'", fpath);
+            return 0;
+
+        case FTW_SL:     // symbolic link and FTW_PHYS specified
+
+            // This should never happen, because we didn't specify FTW_PHYS.
+            LE_CRIT("Received FTW_SL flag for '%s'!", fpath);
+            return 0;
+
+        case FTW_SLN:    // symbolic link pointing to a nonexistent file
+
+            LE_CRIT("Broken symlink found at '%s'", fpath);
+            return 0;
+    }
+
+    LE_CRIT("Unexpected type flag %d.", typeflag);
+
+    return -1;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build the Unused Backup File List from the files in the backup directory.  Empty directories
+ * found under it are removed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void IndexBackupFiles
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Walk the directory tree under the backup directory, depth-first so that directories can
+    // be removed after examining all the files in them.
+    // Note: The number of file descriptors allowed to be used is selected to prevent
+    // running into the app's open file descriptor limit, while avoiding a lot of opening
+    // and closing of directories.  Normally we don't expect a lot of depth in the Observation
+    // resource naming heirarchy, so there shouldn't be a lot of depth in the backup directory.
+    int result = nftw(BACKUP_DIR,
+                      BackupDirTreeWalkCallback,
+                      4 /* max fds */,
+                      FTW_DEPTH /* depth-first traversal */);
+    if (result != 0)
+    {
+        if (errno == ENOENT)
+        {
+            LE_DEBUG("No backup directory.");
+        }
+        else
+        {
+            LE_CRIT("Failed to traverse backup directory '%s' (%m)", BACKUP_DIR);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Back up the samples added to a given Observation's buffer since its last backup by appending
+ * them to its backup journal, if the journal can be used for that.
+ *
+ * @return true if the backup is done (or queued), false if a new backup file has to be written
+ *         instead.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool AppendToJournal
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (!obsPtr->canJournal)
+    {
+        return false;
+    }
+
+    // Samples that have already left the buffer can't be journalled.  That doesn't matter to the
+    // buffer, but would leave them out of the rollup tiers when the journal is replayed.
+    uint64_t startSeq = obsPtr->backupSeq;
+    if (startSeq < obsPtr->oldestSeq)
+    {
+        if (obsPtr->tierCount > 0)
+        {
+            return false;
+        }
+        startSeq = obsPtr->oldestSeq;
+    }
+
+    uint64_t endSeq = obsPtr->oldestSeq + obsPtr->count;
+    size_t newCount = endSeq - startSeq;
+    if (newCount == 0)
+    {
+        return true;
+    }
+
+    // Compact the journal into a new backup file once it would hold more samples than the buffer.
+    if ((obsPtr->journalCount + newCount) > obsPtr->maxCount)
+    {
+        return false;
+    }
+
+    BackupJob_t* jobPtr = CreateBackupJob(obsPtr, BACKUP_JOB_APPEND);
+    if (jobPtr == NULL)
+    {
+        return false;
+    }
+
+    if (!CopySamplesToJob(jobPtr, obsPtr, startSeq))
+    {
+        ReleaseBackupJob(jobPtr);
+        return false;
+    }
+
+    // Assume the append will succeed.  If it doesn't, the journal won't be used again anyway.
+    obsPtr->journalCount += newCount;
+    obsPtr->backupSeq = endSeq;
+
+    QueueBackupJob(jobPtr, obsPtr);
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Perform a backup to non-volatile storage of an observation's data sample buffer.  The backup
+ * file I/O is done by the Backup Thread.
+ *
+ * @return true if a backup job was queued to the Backup Thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool Backup
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Until the buffer has been loaded from the backup file, the backup file is more complete.
+    if (obsPtr->isRestorePending)
+    {
+        return false;
+    }
+
+    // If the previous backup is still in progress, do this one when it's done.
+    if (obsPtr->backupJobPtr != NULL)
+    {
+        obsPtr->backupJobPtr->backupAgain = true;
+        return false;
+    }
+
+    // Update the time of last backup.
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    obsPtr->lastBackupTime = now.sec;
+
+    // If only new samples need backing up, the journal is enough.
+    if (AppendToJournal(obsPtr))
+    {
+        return (obsPtr->backupJobPtr != NULL);
+    }
+    obsPtr->canJournal = false;
+
+    BackupJob_t* jobPtr = CreateBackupJob(obsPtr, BACKUP_JOB_SNAPSHOT);
+    if (jobPtr == NULL)
+    {
+        return false;
+    }
+
+    bool ok;
+    if (obsPtr->compressedPtr != NULL)
+    {
+        ok = CopyBlocksToJob(jobPtr, obsPtr);
+    }
+    else
+    {
+        ok = CopySamplesToJob(jobPtr, obsPtr, obsPtr->oldestSeq);
+    }
+    ok = ok && CopyRollupTiersToJob(jobPtr, obsPtr);
+
+    if (!ok)
+    {
+        ReleaseBackupJob(jobPtr);
+        return false;
+    }
+
+    QueueBackupJob(jobPtr, obsPtr);
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Disable backups of a given Observation's data sample buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DisableBackups
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    CancelBackup(obsPtr);
+
+    obsPtr->lastBackupTime = 0;
+
+    DeleteBackup(obsPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Flush everything written to the backup file system to non-volatile storage.  Runs in the Backup
+ * Thread, once after a batch of backup jobs, instead of syncing each journal as it is written.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SyncBackups
+(
+    void* unused1,  ///< [IN] Unused parameter.
+    void* unused2   ///< [IN] Unused parameter.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_UNUSED(unused1);
+    LE_UNUSED(unused2);
+
+    int fd = open(BACKUP_DIR, O_RDONLY | O_DIRECTORY);
+    if (fd == -1)
+    {
+        LE_CRIT("Unable to open directory '" BACKUP_DIR "' (%m).");
+        return;
+    }
+
+    if (syncfs(fd) != 0)
+    {
+        LE_CRIT("Failed to sync '" BACKUP_DIR "' (%m).");
+    }
+
+    close(fd);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Shared backup timer expiry handler.  Queues backups of the data sample buffers of all the
+ * Observations whose backups are due to the Backup Thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BackupTimerExpired
+(
+    le_timer_Ref_t timer
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    size_t backupCount = 0;
+
+    // The list is sorted by due time, so stop at the first backup that isn't due yet.
+    le_dls_Link_t* linkPtr;
+    while ((linkPtr = le_dls_Peek(&PendingBackupList)) != NULL)
+    {
+        Observation_t* obsPtr = CONTAINER_OF(linkPtr, Observation_t, backupLink);
+
+        if (obsPtr->backupDueTime > now.sec)
+        {
+            break;
+        }
+
+        le_dls_Remove(&PendingBackupList, linkPtr);
+        obsPtr->isBackupPending = false;
+
+        if (Backup(obsPtr))
+        {
+            backupCount++;
+        }
+    }
+
+    // The Backup Thread does jobs in order, so this sync follows all the backups just queued.
+    if (backupCount > 0)
+    {
+        LE_DEBUG("Queued %zu backups.", backupCount);
+        backupThread_QueueFunction(SyncBackups, NULL, NULL);
+    }
+
+    RestartBackupTimer();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens an Observation's backup file for reading, if there is one, and reads its header up to the
+ * number of records.
+ *
+ * @return The backup file, positioned after the number of records, or NULL if there is no backup
+ *         file or its header couldn't be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static FILE* OpenBackupFile
+(
+    Observation_t* obsPtr,
+    backupFile_Header_t* headerPtr   ///< [OUT] The header.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // If there's no backup directory yet, then we know there are no backups, so don't
+    // try opening one (which would result in an error message in the logs because the lock file
+    // can't be created).
+    struct stat st = {0};
+    if (stat(BACKUP_DIR, &st) == -1)
+    {
+        LE_DEBUG("Backup directory '" BACKUP_DIR "' not found. (%m)");
+        return NULL;
+    }
+
+    char path[MAX_BACKUP_FILE_PATH_BYTES];
+    char journalPath[MAX_BACKUP_FILE_PATH_BYTES];
+    if (   (GetBackupFilePath(path, sizeof(path), obsPtr) != LE_OK)
+        || (GetJournalFilePath(journalPath, sizeof(journalPath), obsPtr) != LE_OK)  )
+    {
+        return NULL;
+    }
+
+    // A backup file (or journal) being written or deleted by the Backup Thread can't be read yet.
+    backupThread_WaitForFile(path);
+    backupThread_WaitForFile(journalPath);
+
+    LE_INFO("Loading observation buffer from file '%s'.", path);
+
+    return backupFile_Open(path, headerPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Empties an Observation's buffer and rollup tiers, ready for restoring a backup file with a given
+ * header into them.
+ *
+ * @return true if successful, false if the buffer couldn't be made big enough.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ResetForRestore
+(
+    Observation_t* obsPtr,
+    const backupFile_Header_t* headerPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    TruncateBuffer(obsPtr, 0);
+    ClearRollupTiers(obsPtr);
+    obsPtr->bufferedType = headerPtr->dataType;
+
+    // A buffer that was backed up compressed stays compressed, so restoring it doesn't take
+    // more memory than it did before.
+    if (headerPtr->isCompressed)
+    {
+        obsPtr->compressBuffer = true;
+    }
+    UpdateBufferEncoding(obsPtr);
+
+    // The maximum count must be at least the number of samples in the backup.
+    // NOTE: Don't enable backups, though, because we don't know the frequency to choose
+    //       and flash wear can permanently damage a device.
+    return ((obsPtr->maxCount > 0) || (ResizeBuffer(obsPtr, headerPtr->count) == LE_OK));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loads an Observation's buffer and rollup tiers from its backup file (and journal), if it has one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LoadBackup
+(
+    Observation_t* obsPtr,
+    bool isNewestPushed ///< true if the newest sample has already been pushed to the Observation.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    backupFile_Header_t header;
+    FILE* file = OpenBackupFile(obsPtr, &header);
+    if (file == NULL)
+    {
+        return;
+    }
+
+    bool isAutoSized = (obsPtr->maxCount == 0);
+    if (!ResetForRestore(obsPtr, &header))
+    {
+        le_atomFile_CancelStream(file);
+        return;
+    }
+
+    RollupTier_t tiers[ADMIN_MAX_ROLLUP_TIERS];
+    size_t tierCount = 0;
+    size_t i;
+    memset(tiers, 0, sizeof(tiers));
+
+    // Read all the data samples (and rollup tiers) from the file.  Files in the current format
+    // are mapped into memory and parsed in place, which also closes them.
+    bool error;
+    dataSample_Ref_t newestSample;
+    if (header.version >= 3)
+    {
+        newestSample = ReadBackupImage(obsPtr,
+                                       file,
+                                       header.count,
+                                       header.isCompressed,
+                                       tiers,
+                                       &tierCount,
+                                       &error);
+    }
+    else if (header.isCompressed)
+    {
+        newestSample = ReadBlocksFromFile(obsPtr, file, header.count, &error);
+    }
+    else
+    {
+        newestSample = ReadSamplesFromFile(obsPtr, file, header.count, &error);
+    }
+    if (error)
+    {
+        return;
+    }
+
+    if (header.version < 3)
+    {
+        // Read the rollup tiers (if the file has them).
+        if ((header.version > 0) && (!ReadRollupTiersFromFile(file, tiers, &tierCount)))
+        {
+            goto error;
+        }
+
+        // Make sure the file doesn't have more in it than expected, which would mean that its
+        // contents are probably corrupt.
+        uint8_t byte;
+        le_result_t result = backupFile_Read(&byte, 1, file);
+        if (result != LE_UNDERFLOW)
+        {
+            if (result == LE_OK)
+            {
+                LE_CRIT("Backup file contains extra data.");
+                le_atomFile_CancelStream(file);
+            }
+            goto error;
+        }
+    }
+
+    // Add the samples from the backup journal, if there is one that follows on from this backup.
+    uint32_t journalMaxCount;
+    uint64_t journalSeq = obsPtr->oldestSeq + obsPtr->count + (newestSample != NULL);
+    size_t journalCount = 0;
+    FILE* journal = OpenJournal(obsPtr, header.count, newestSample, &journalMaxCount);
+    if (journal != NULL)
+    {
+        // The buffer must be able to hold as many samples as it did when they were journalled.
+        if (   isAutoSized
+            && (journalMaxCount > obsPtr->maxCount)
+            && (ResizeBuffer(obsPtr, journalMaxCount) != LE_OK)  )
+        {
+            le_atomFile_CancelStream(journal);
+        }
+        else
+        {
+            journalCount = ReplayJournal(obsPtr, journal, &newestSample, true);
+        }
+    }
+
+    // The newest sample should be pushed to the Observation so it becomes the current value,
+    // unless that was done when the backup was restored lazily.
+    if (newestSample != NULL)
+    {
+        if (isNewestPushed)
+        {
+            AddToBuffer(obsPtr, newestSample);
+            le_mem_Release(newestSample);
+        }
+        else
+        {
+            res_Push(&obsPtr->resource, header.dataType, NULL, newestSample);
+        }
+    }
+
+    // The backed-up tiers already include the newest sample from the backup file, so they replace
+    // what the push added to the tiers.
+    ClearRollupTiers(obsPtr);
+    InstallRollupTiers(obsPtr, tiers, tierCount);
+
+    // But they don't include the journalled samples, which are now the newest in the buffer.
+    if ((journalCount > 0) && (obsPtr->tierCount > 0))
+    {
+        BufferCursor_t cursor;
+        bool found;
+        if (journalSeq < obsPtr->oldestSeq)
+        {
+            journalSeq = obsPtr->oldestSeq;
+        }
+        for (found = SeekBuffer(obsPtr, &cursor, journalSeq - obsPtr->oldestSeq);
+             found;
+             found = NextInBuffer(obsPtr, &cursor))
+        {
+            double value = GetBufferedNumber(&cursor.slot, obsPtr->bufferedType);
+
+            if (!isnan(value))
+            {
+                AddToRollupTiers(obsPtr, cursor.slot.timestamp, value);
+            }
+        }
+    }
+    return;
+
+error:
+
+    for (i = 0; i < tierCount; i++)
+    {
+        free(tiers[i].bucketPtr);
+    }
+    if (newestSample != NULL)
+    {
+        le_mem_Release(newestSample);
+    }
+    TruncateBuffer(obsPtr, 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Takes an Observation off the Pending Restore List, if it's on it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CancelRestore
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (obsPtr->isRestorePending)
+    {
+        le_dls_Remove(&PendingRestoreList, &obsPtr->restoreLink);
+        obsPtr->isRestorePending = false;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loads an Observation's buffer from its backup file now, if that was put off when the backup was
+ * restored.  Must be called before the buffer (or the rollup tiers) is accessed or changed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompleteRestore
+(
+    Observation_t* obsPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (obsPtr->isRestorePending)
+    {
+        CancelRestore(obsPtr);
+        LoadBackup(obsPtr, true);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Background restore timer expiry handler.  Loads the buffer of the Observation at the head of
+ * the Pending Restore List, so that restoring lots of big backups at start-up doesn't hold up
+ * everything else.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RestoreTimerExpired
+(
+    le_timer_Ref_t timer
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Restore the first Observation whose backup files aren't busy.  The others are tried again
+    // next time.
+    le_dls_Link_t* linkPtr = le_dls_Peek(&PendingRestoreList);
+    while (linkPtr != NULL)
+    {
+        Observation_t* obsPtr = CONTAINER_OF(linkPtr, Observation_t, restoreLink);
+
+        if (!IsBackupBusy(obsPtr))
+        {
+            CompleteRestore(obsPtr);
+            break;
+        }
+
+        linkPtr = le_dls_PeekNext(&PendingRestoreList, linkPtr);
+    }
+
+    if (le_dls_IsEmpty(&PendingRestoreList))
+    {
+        le_timer_Stop(timer);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Observation destructor.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ObservationDestructor
+(
+    void* objectPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = objectPtr;
+
+    // Delete all the buffered data samples and the buffer itself.
+    TruncateBuffer(obsPtr, 0);
+    DeleteRunningStats(obsPtr);
+    DeleteCompressedBuffer(obsPtr);
+    if (obsPtr->ringPtr != NULL)
+    {
+        UnmapRingFile(obsPtr);
+    }
+    else
+    {
+        free(obsPtr->bufferPtr);
+    }
+    obsPtr->bufferPtr = NULL;
+    obsPtr->maxCount = 0;
+    DeleteRollupTiers(obsPtr, 0);
+    DeleteQuantileSketch(obsPtr);
+    DeleteHistogram(obsPtr);
+    if (obsPtr->jsonExtraction != NULL)
+    {
+        le_mem_Release(obsPtr->jsonExtraction);
+        obsPtr->jsonExtraction = NULL;
+    }
+
+    // A persistent buffer's ring file goes with the Observation.
+    if (obsPtr->persistBuffer)
+    {
+        DeleteRingFile(obsPtr);
+    }
+
+    // If the observation had backups enabled, delete the backup file.
+    CancelRestore(obsPtr);
+    CancelBackup(obsPtr);
+    if (obsPtr->backupPeriod > 0)
+    {
+        DeleteBackup(obsPtr);
+    }
+
+    // If a backup is still in progress, it will finish without the Observation.
+    if (obsPtr->backupJobPtr != NULL)
+    {
+        obsPtr->backupJobPtr->obsPtr = NULL;
+    }
+
+    // If there are read operations in progress, end them.
+    while (le_dls_IsEmpty(&obsPtr->readOpList) == false)
+    {
+        EndRead(CONTAINER_OF(le_dls_Peek(&obsPtr->readOpList), ReadOperation_t, link),
+                LE_COMM_ERROR);
+    }
+
+    // Any read cursors still open are left detached, for their clients to find out when they next
+    // try to read through them.
+    le_dls_Link_t* linkPtr;
+    while ((linkPtr = le_dls_Pop(&obsPtr->readCursorList)) != NULL)
+    {
+        CONTAINER_OF(linkPtr, ReadCursor_t, link)->obsPtr = NULL;
+    }
+
+    // Stop aggregating.  The shared timer will ignore the Observation's absence when it expires.
+    if (obsPtr->aggregationType != OBS_AGGREGATION_TYPE_NONE)
+    {
+        le_dls_Remove(&AggregatingObsList, &obsPtr->aggregationLink);
+        ResetAggregation(obsPtr);
+    }
+
+    res_Destruct(&obsPtr->resource);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Observation module.
+ *
+ * @warning This must be called before any other function in this module is called.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ObservationPool = le_mem_CreatePool("Observation", sizeof(Observation_t));
+    le_mem_SetDestructor(ObservationPool, ObservationDestructor);
+
+    RunningStatsPool = le_mem_CreatePool("Running Stats", sizeof(RunningStats_t));
+
+    ReadOperationPool = le_mem_CreatePool("Read Op", sizeof(ReadOperation_t));
+    ReadCursorPool = le_mem_CreatePool("Read Cursor", sizeof(ReadCursor_t));
+
+    AggregationTimer = le_timer_Create("aggregation");
+    LE_ASSERT(le_timer_SetHandler(AggregationTimer, AggregationTimerExpired) == LE_OK);
+
+    BackupJobPool = le_mem_CreatePool("Backup Job", sizeof(BackupJob_t));
+
+    UnusedBackupFilePool = le_mem_CreatePool("Unused Backup File", sizeof(UnusedBackupFile_t));
+    IndexBackupFiles();
+
+    BackupTimer = le_timer_Create("backup");
+    LE_ASSERT(le_timer_SetHandler(BackupTimer, BackupTimerExpired) == LE_OK);
+
+    RestoreTimer = le_timer_Create("restore");
+    LE_ASSERT(le_timer_SetHandler(RestoreTimer, RestoreTimerExpired) == LE_OK);
+    LE_ASSERT(le_timer_SetMsInterval(RestoreTimer, BACKGROUND_RESTORE_INTERVAL) == LE_OK);
+    LE_ASSERT(le_timer_SetRepeat(RestoreTimer, 0) == LE_OK);
+
+    RingSyncTimer = le_timer_Create("ring sync");
+    LE_ASSERT(le_timer_SetHandler(RingSyncTimer, RingSyncTimerExpired) == LE_OK);
+    LE_ASSERT(le_timer_SetMsInterval(RingSyncTimer, RING_SYNC_CHECK_INTERVAL) == LE_OK);
+    LE_ASSERT(le_timer_SetRepeat(RingSyncTimer, 0) == LE_OK);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an Observation object.  This allocates the object and initializes the class members,
+ * but not the parent class members.
+ *
+ * @return Pointer to the new object.
+ */
+//--------------------------------------------------------------------------------------------------
+res_Resource_t* obs_Create
+(
+    resTree_EntryRef_t entryRef ///< The resource tree entry to attach this Resource to.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = le_mem_ForceAlloc(ObservationPool);
+
+    res_Construct(&obsPtr->resource, entryRef);
+
+    obsPtr->lowLimit = NAN;
+    obsPtr->highLimit = NAN;
+    obsPtr->changeBy = NAN;
+    obsPtr->minPeriod = NAN;
+
+    obsPtr->maxCount = 0;
+    obsPtr->count = 0;
+
+    obsPtr->transformType = OBS_TRANSFORM_TYPE_NONE;
+    obsPtr->windowPeriod = 0;
+    obsPtr->windowCount = 0;
+    obsPtr->ewmaAlpha = 0;
+    obsPtr->prevValue = NAN;
+    obsPtr->prevTimestamp = NAN;
+
+    obsPtr->bufferedType = IO_DATA_TYPE_TRIGGER;
+
+    obsPtr->backupPeriod = 0;
+    obsPtr->lastBackupTime = 0;
+    obsPtr->backupLink = LE_DLS_LINK_INIT;
+    obsPtr->isBackupPending = false;
+    obsPtr->backupDueTime = 0;
+    obsPtr->canJournal = false;
+    obsPtr->backupSeq = 0;
+    obsPtr->journalCount = 0;
+    obsPtr->backupJobPtr = NULL;
+    obsPtr->restoreLink = LE_DLS_LINK_INIT;
+    obsPtr->isRestorePending = false;
+
+    obsPtr->compressBuffer = false;
+    obsPtr->compressedPtr = NULL;
+
+    obsPtr->persistBuffer = false;
+    obsPtr->ringSyncPeriod = 0;
+    obsPtr->ringPtr = NULL;
+    obsPtr->isRingDirty = false;
+    obsPtr->lastRingSyncTime = 0;
+    obsPtr->ringSyncLink = LE_DLS_LINK_INIT;
+
+    obsPtr->bufferPtr = NULL;
+    obsPtr->oldestIndex = 0;
+    obsPtr->oldestSeq = 0;
+
+    obsPtr->statsPtr = NULL;
+
+    memset(obsPtr->tiers, 0, sizeof(obsPtr->tiers));
+    obsPtr->tierCount = 0;
+
+    obsPtr->sketchRef = NULL;
+    obsPtr->histogramRef = NULL;
+
+    obsPtr->readOpList = LE_DLS_LIST_INIT;
+    obsPtr->readCursorList = LE_DLS_LIST_INIT;
+
+    obsPtr->aggregationType = OBS_AGGREGATION_TYPE_NONE;
+    obsPtr->aggregationPeriod = 0;
+    obsPtr->windowEnd = 0;
+    obsPtr->aggLastSample = NULL;
+    ResetAggregation(obsPtr);
+    obsPtr->aggregationLink = LE_DLS_LINK_INIT;
+
+    obsPtr->jsonExtraction = NULL;
+
+    return &obsPtr->resource;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Restore an Observation's data buffer from non-volatile backup, if one exists.
+ *
+ * Only the newest sample is read right away, to become the Observation's current value.  The rest
+ * of the buffer is loaded when it is first needed, or in the background before that.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_RestoreBackup
+(
+    res_Resource_t* resPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    CancelRestore(obsPtr);
+
+    backupFile_Header_t header;
+    FILE* file = OpenBackupFile(obsPtr, &header);
+    if (file == NULL)
+    {
+        return;
+    }
+
+    // Older backup files have to be read in full to find the newest sample.  And a buffer
+    // transform needs the whole buffer to transform the newest sample.
+    if ((header.version < 3) || IsBufferTransform(obsPtr->transformType))
+    {
+        le_atomFile_CancelStream(file);
+        LoadBackup(obsPtr, false);
+        return;
+    }
+
+    backupFile_Image_t image;
+    if (!backupFile_MapImage(file, &image))
+    {
+        le_atomFile_CancelStream(file);
+        return;
+    }
+    bool error;
+    dataSample_Ref_t newestSample = ReadNewestFromImage(&image, &header, &error);
+    backupFile_UnmapImage(&image);
+    le_atomFile_CancelStream(file);
+    if (error)
+    {
+        return;
+    }
+
+    // Only size the buffer for the backup once its header has been checked against the file.
+    bool isAutoSized = (obsPtr->maxCount == 0);
+    if (!ResetForRestore(obsPtr, &header))
+    {
+        if (newestSample != NULL)
+        {
+            le_mem_Release(newestSample);
+        }
+        return;
+    }
+
+    // The newest sample may be in the backup journal.
+    uint32_t journalMaxCount;
+    FILE* journal = OpenJournal(obsPtr, header.count, newestSample, &journalMaxCount);
+    if (journal != NULL)
+    {
+        // The buffer must be able to hold as many samples as it did when they were journalled.
+        if (   isAutoSized
+            && (journalMaxCount > obsPtr->maxCount)
+            && (ResizeBuffer(obsPtr, journalMaxCount) != LE_OK)  )
+        {
+            LE_CRIT("Unable to resize buffer to %u samples.", (unsigned int)journalMaxCount);
+            le_atomFile_CancelStream(journal);
+        }
+        else
+        {
+            ReplayJournal(obsPtr, journal, &newestSample, false);
+        }
+    }
+
+    // Push the newest sample before the restore is marked pending, so it doesn't trigger the load.
+    if (newestSample != NULL)
+    {
+        res_Push(&obsPtr->resource, header.dataType, NULL, newestSample);
+    }
+
+    obsPtr->isRestorePending = true;
+    le_dls_Queue(&PendingRestoreList, &obsPtr->restoreLink);
+    if (!le_timer_IsRunning(RestoreTimer))
+    {
+        LE_ASSERT(le_timer_Start(RestoreTimer) == LE_OK);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Perform JSON extraction.  If the data type is not JSON, does nothing.
+ *
+ * @return LE_OK if successful.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t obs_DoJsonExtraction
+(
+    res_Resource_t* resPtr,
+    io_DataType_t* dataTypePtr,     ///< [INOUT] the data type, may be changed by JSON extraction
+    dataSample_Ref_t* valueRefPtr   ///< [INOUT] the data sample, may be replaced by JSON extraction
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    // If JSON extraction is enabled,
+    if (obsPtr->jsonExtraction != NULL)
+    {
+        if (*dataTypePtr != IO_DATA_TYPE_JSON)
+        {
+            LE_WARN("Ignoring non-JSON value pushed to observation configured to extract JSON.");
+            return LE_FAULT;
+        }
+
+        // Extract the appropriate JSON data element from the value.
+        const char* extractionSpec = atom_GetString(obsPtr->jsonExtraction);
+        io_DataType_t extractedType;
+        dataSample_Ref_t extractedValue = dataSample_ExtractJson(*valueRefPtr,
+                                                                 extractionSpec,
+                                                                 &extractedType);
+        if (extractedValue == NULL)
+        {
+            // Extraction failed.
+            return LE_FAULT;
+        }
+
+        // Extraction succeeded, so replace value data sample with extracted one.
+        le_mem_Release(*valueRefPtr);
+        *valueRefPtr = extractedValue;
+        *dataTypePtr = extractedType;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Determine whether the value should be accepted by a given Observation.
+ *
+ * @warning JSON extraction should be performed first if the data type is JSON.
+ *
+ * @return true if the value should be accepted.
+ */
+//--------------------------------------------------------------------------------------------------
+bool obs_ShouldAccept
+(
+    res_Resource_t* resPtr,
+    io_DataType_t dataType,     ///< [IN] the data type
+    dataSample_Ref_t valueRef   ///< [IN] the data sample
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    // Check the high limit and low limit before other limits.
+    if (dataType == IO_DATA_TYPE_NUMERIC)
+    {
+        double numericValue = dataSample_GetNumeric(valueRef);
+
+        // If both limits are enabled and the low limit is higher than the high limit, then
+        // this is the "deadband" case. ( - <------HxxxxxxxxxL------> + )
+        if (   (!isnan(obsPtr->highLimit))
+            && (!isnan(obsPtr->lowLimit))
+            && (obsPtr->lowLimit > obsPtr->highLimit)  )
+        {
+            if ((numericValue < obsPtr->lowLimit) && (numericValue > obsPtr->highLimit))
+            {
+                return false;
+            }
+        }
+        // In all other cases, reject if lower than non-NAN low limit or higher than non-NAN high.
+        else
+        {
+            if ((!isnan(obsPtr->lowLimit)) && (numericValue < obsPtr->lowLimit))
+            {
+                return false;
+            }
+
+            if ((!isnan(obsPtr->highLimit)) && (numericValue > obsPtr->highLimit))
+            {
+                return false;
+            }
+        }
+    }
+
+    // The current time in ms since some unspecified start time.
+    uint32_t now = 0;
+
+    // If we have received a push before (giving us something to compare against),
+    // Check the minPeriod and changeBy,
+    dataSample_Ref_t previousValue = res_GetCurrentValue(resPtr);
+    if (previousValue != NULL)
+    {
+        // If there is a changedBy filter in effect,
+        if ((obsPtr->changeBy != 0) && (!isnan(obsPtr->changeBy)))
+        {
+            // If overridden, reject everything because the value won't change.
+            if (res_IsOverridden(resPtr))
+            {
+                return false;
+            }
+
+            // If the data type has changed, we can't do a comparison, so only check the changeBy
+            // filter if the new data sample's type is the same as the previous current value's
+            // type.
+            if (dataType == res_GetDataType(resPtr))
+            {
+                // If this is a numeric value and the last value was numeric too,
+                if (dataType == IO_DATA_TYPE_NUMERIC)
+                {
+                    // Reject changes in the current value smaller than the changeBy setting.
+                    double previousNumber = dataSample_GetNumeric(previousValue);
+                    if (  fabs(dataSample_GetNumeric(valueRef) - previousNumber)
+                        < obsPtr->changeBy)
+                    {
+                        return false;
+                    }
+                }
+                // For Boolean, a non-zero changeBy means filter out if unchanged.
+                else if (dataType == IO_DATA_TYPE_BOOLEAN)
+                {
+                    if (dataSample_GetBoolean(valueRef) == dataSample_GetBoolean(previousValue))
+                    {
+                        return false;
+                    }
+                }
+                // For string or JSON, a non-zero changeBy means filter out if unchanged.
+                else if (   (dataType == IO_DATA_TYPE_STRING)
+                         || (dataType == IO_DATA_TYPE_JSON))
+                {
+                    if (0 == strcmp(dataSample_GetString(valueRef),
+                                    dataSample_GetString(previousValue)))
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+
+        // All of the above can be done without a system call, so that's why we do the
+        // minPeriod check last.
+        if ((obsPtr->minPeriod != 0) && (!isnan(obsPtr->minPeriod)))
+        {
+            now = GetRelativeTimeMs();  // system call
+
+            if ((now - obsPtr->lastPushTime) < (obsPtr->minPeriod * 1000))
+            {
+                return false;
+            }
+        }
+    }
+
+    // Update the time of last update.
+    if (now == 0)
+    {
+        now = GetRelativeTimeMs(); // system call
+    }
+    obsPtr->lastPushTime = now;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Perform processing of an accepted pushed data sample that is specific to an Observation
+ * resource.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_ProcessAccepted
+(
+    res_Resource_t* resPtr,
+    io_DataType_t dataType,     ///< Data type of the data sample.
+    dataSample_Ref_t sampleRef  ///< Data sample.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    CompleteRestore(obsPtr);
+
+    double value = NAN;
+    if (dataType == IO_DATA_TYPE_NUMERIC)
+    {
+        value = dataSample_GetNumeric(sampleRef);
+    }
+    else if (dataType == IO_DATA_TYPE_BOOLEAN)
+    {
+        value = (dataSample_GetBoolean(sampleRef) ? 1.0 : 0.0);
+    }
+
+    // The histogram is counted whether or not the samples are buffered.
+    if ((obsPtr->histogramRef != NULL) && !isnan(value))
+    {
+        histogram_Add(obsPtr->histogramRef, value);
+    }
+
+    if (HasHistory(obsPtr))
+    {
+        // If the data type has changed, we have to dump the current set of buffered samples.
+        if (obsPtr->bufferedType != dataType)
+        {
+            TruncateBuffer(obsPtr, 0);
+            ClearRollupTiers(obsPtr);
+
+            obsPtr->bufferedType = dataType;
+
+            // Only numeric samples can be compressed.
+            UpdateBufferEncoding(obsPtr);
+
+            // The backup journal can't record the flush.
+            StopJournal(obsPtr);
+        }
+
+        AddToBuffer(obsPtr, sampleRef);
+
+        if ((obsPtr->tierCount > 0) && !isnan(value))
+        {
+            AddToRollupTiers(obsPtr, dataSample_GetTimestamp(sampleRef), value);
+        }
+
+        // If the buffer backup period is non-zero, then back-ups are enabled.  If a backup isn't
+        // already pending, schedule one for when the backup period has passed since the last one.
+        // Even an overdue backup waits for the shared backup timer, so that a burst of pushes to
+        // different Observations gets backed up together.
+        if ((obsPtr->backupPeriod > 0) && !obsPtr->isBackupPending)
+        {
+            ScheduleBackup(obsPtr);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Perform any post-filtering on a given Observation.
+ */
+//--------------------------------------------------------------------------------------------------
+dataSample_Ref_t obs_ApplyTransform
+(
+    res_Resource_t* resPtr,
+    io_DataType_t dataType,     ///< Data type of the data sample.
+    dataSample_Ref_t sampleRef  ///< Data sample.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+    dataSample_Ref_t sample = sampleRef;
+    double transformVal = NAN;
+
+    if (OBS_TRANSFORM_TYPE_NONE == obsPtr->transformType)
+    {
+        return sample;
+    }
+
+    // Get the numerical value of the new sample, for the transforms that don't work from the
+    // buffer.
+    double timestamp = dataSample_GetTimestamp(sampleRef);
+    double value = NAN;
+    if (dataType == IO_DATA_TYPE_NUMERIC)
+    {
+        value = dataSample_GetNumeric(sampleRef);
+    }
+    else if (dataType == IO_DATA_TYPE_BOOLEAN)
+    {
+        value = (dataSample_GetBoolean(sampleRef) ? 1.0 : 0.0);
+    }
+
+    switch (obsPtr->transformType)
+    {
+        case OBS_TRANSFORM_TYPE_MEAN:
+        case OBS_TRANSFORM_TYPE_STDDEV:
+        case OBS_TRANSFORM_TYPE_MAX:
+        case OBS_TRANSFORM_TYPE_MIN:
+
+            // The running stats already cover the whole buffer, including the new sample,
+            // so each of these takes constant time.
+            transformVal = GetRunningStat(obsPtr->statsPtr, obsPtr->transformType);
+            break;
+
+        case OBS_TRANSFORM_TYPE_MOVING_MEAN:
+        case OBS_TRANSFORM_TYPE_MOVING_STDDEV:
+        case OBS_TRANSFORM_TYPE_MOVING_MAX:
+        case OBS_TRANSFORM_TYPE_MOVING_MIN:
+
+            if ((obsPtr->statsPtr != NULL) && (!isnan(value)))
+            {
+                AddToWindow(obsPtr, timestamp, value);
+            }
+            transformVal = GetRunningStat(obsPtr->statsPtr, obsPtr->transformType);
+            break;
+
+        case OBS_TRANSFORM_TYPE_EWMA:
+
+            if (!isnan(value))
+            {
+                if (isnan(obsPtr->prevValue))
+                {
+                    obsPtr->prevValue = value;
+                }
+                else
+                {
+                    obsPtr->prevValue += obsPtr->ewmaAlpha * (value - obsPtr->prevValue);
+                }
+            }
+            transformVal = obsPtr->prevValue;
+            break;
+
+        case OBS_TRANSFORM_TYPE_RATE:
+
+            // Rate of change (per second) since the previous value.  Undefined for the first
+            // value, or if the timestamp hasn't advanced.
+            if (!isnan(value))
+            {
+                if ((!isnan(obsPtr->prevValue)) && (timestamp > obsPtr->prevTimestamp))
+                {
+                    transformVal =   (value - obsPtr->prevValue)
+                                   / (timestamp - obsPtr->prevTimestamp);
+                }
+                obsPtr->prevValue = value;
+                obsPtr->prevTimestamp = timestamp;
+            }
+            break;
+
+        default:
+            LE_FATAL("Invalid transform type %d", obsPtr->transformType);
+            break;
+    }
+
+    // If transformed value differs from the input sample, update the sample
+    sample = UpdateSample(sampleRef, dataType, (void *)&transformVal);
+
+    return sample;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the minimum period between data samples accepted by a given Observation.
+ *
+ * This is used to throttle the rate of data passing into and through an Observation.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_SetMinPeriod
+(
+    res_Resource_t* resPtr,
+    double minPeriod
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    obsPtr->minPeriod = minPeriod;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the minimum period between data samples accepted by a given Observation.
+ *
+ * @return The value, or 0 if not set.
+ */
+//--------------------------------------------------------------------------------------------------
+double obs_GetMinPeriod
+(
+    res_Resource_t* resPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    return obsPtr->minPeriod;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the highest value in a range that will be accepted by a given Observation.
+ *
+ * Ignored for all non-numeric types except Boolean for which non-zero = true and zero = false.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_SetHighLimit
+(
+    res_Resource_t* resPtr,
+    double highLimit
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    obsPtr->highLimit = highLimit;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the highest value in a range that will be accepted by a given Observation.
+ *
+ * @return The value, or NAN (not a number) if not set.
+ */
+//--------------------------------------------------------------------------------------------------
+double obs_GetHighLimit
+(
+    res_Resource_t* resPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    return obsPtr->highLimit;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the lowest value in a range that will be accepted by a given Observation.
+ *
+ * Ignored for all non-numeric types except Boolean for which non-zero = true and zero = false.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_SetLowLimit
+(
+    res_Resource_t* resPtr,
+    double lowLimit
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    obsPtr->lowLimit = lowLimit;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the lowest value in a range that will be accepted by a given Observation.
+ *
+ * @return The value, or NAN (not a number) if not set.
+ */
+//--------------------------------------------------------------------------------------------------
+double obs_GetLowLimit
+(
+    res_Resource_t* resPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    return obsPtr->lowLimit;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the magnitude that a new value must vary from the current value to be accepted by
+ * a given Observation.
+ *
+ * Ignored for trigger types.
+ *
+ * For all other types, any non-zero value means accept any change, but drop if the same as current.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_SetChangeBy
+(
+    res_Resource_t* resPtr,
+    double change
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    obsPtr->changeBy = change;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the magnitude that a new value must vary from the current value to be accepted by
+ * a given Observation.
+ *
+ * @return The value, or 0 if not set.
+ */
+//--------------------------------------------------------------------------------------------------
+double obs_GetChangeBy
+(
+    res_Resource_t* resPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    return obsPtr->changeBy;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Perform a transform on buffered data. Value of the observation will be the output of the
+ * transform
+ *
+ * Ignored for all non-numeric types except Boolean for which non-zero = true and zero = false.
+ *
+ * Parameters (missing ones are taken as 0):
+ *  - Moving window transforms: params[0] = window period (seconds, 0 = not limited by time),
+ *                              params[1] = window size (samples, 0 = not limited by count).
+ *                              At least one of them must be non-zero.
+ *  - Exponentially weighted moving average: params[0] = weight of the newest value (0 < w <= 1).
+ *  - Other transforms take no parameters.
+ *
+ * Invalid settings are logged and ignored.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_SetTransform
+(
+    res_Resource_t* resPtr,
+    obs_TransformType_t transformType,
+    const double* paramsPtr,
+    size_t paramsSize
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    CompleteRestore(obsPtr);
+
+    double params[ADMIN_MAX_TRANSFORM_PARAMETERS] = { 0 };
+    size_t i;
+    for (i = 0; (i < paramsSize) && (i < ADMIN_MAX_TRANSFORM_PARAMETERS); i++)
+    {
+        params[i] = paramsPtr[i];
+    }
+
+    // Validate the transform settings before changing anything.
+    switch (transformType)
+    {
+        case OBS_TRANSFORM_TYPE_NONE:
+        case OBS_TRANSFORM_TYPE_MEAN:
+        case OBS_TRANSFORM_TYPE_STDDEV:
+        case OBS_TRANSFORM_TYPE_MAX:
+        case OBS_TRANSFORM_TYPE_MIN:
+        case OBS_TRANSFORM_TYPE_RATE:
+            break;
+
+        case OBS_TRANSFORM_TYPE_MOVING_MEAN:
+        case OBS_TRANSFORM_TYPE_MOVING_STDDEV:
+        case OBS_TRANSFORM_TYPE_MOVING_MAX:
+        case OBS_TRANSFORM_TYPE_MOVING_MIN:
+
+            if (   (!(params[0] >= 0))
+                || (!(params[1] >= 0))
+                || (params[1] != floor(params[1]))
+                || (params[1] > UINT32_MAX)
+                || ((params[0] == 0) && (params[1] == 0))  )
+            {
+                LE_ERROR("Invalid moving window (period %lf s, count %lf).", params[0], params[1]);
+                return;
+            }
+            break;
+
+        case OBS_TRANSFORM_TYPE_EWMA:
+
+            if (!((params[0] > 0) && (params[0] <= 1)))
+            {
+                LE_ERROR("Invalid moving average weight %lf (must be > 0 and <= 1).", params[0]);
+                return;
+            }
+            break;
+
+        default:
+
+            LE_ERROR("Invalid transform type %d.", transformType);
+            return;
+    }
+
+    // The running stats will be restarted along with the buffer.
+    DeleteRunningStats(obsPtr);
+
+    obsPtr->transformType = transformType;
+    obsPtr->windowPeriod = 0;
+    obsPtr->windowCount = 0;
+    obsPtr->ewmaAlpha = 0;
+    obsPtr->prevValue = NAN;
+    obsPtr->prevTimestamp = NAN;
+
+    // If the transform works on the buffer, ensure there is at least one data sample buffered in
+    // order to allow transforms to behave properly
+    if (   IsBufferTransform(obsPtr->transformType)
+        && (0 == obsPtr->maxCount)
+        && (ResizeBuffer(obsPtr, 1) != LE_OK)  )
+    {
+        LE_CRIT("Unable to allocate buffer for transform.");
+    }
+
+    // Clear the buffer and current value of the observation.  Do this even if the same transform
+    // is being re-applied.  This allows any cumulative behavior to be cleared
+    TruncateBuffer(obsPtr, 0);
+    if (resPtr->pushedValue != NULL)
+    {
+        le_mem_Release(resPtr->pushedValue);
+        resPtr->pushedValue = NULL;
+    }
+
+    if (IsBufferTransform(obsPtr->transformType))
+    {
+        obsPtr->statsPtr = CreateRunningStats(obsPtr->maxCount);
+    }
+    else if (IsWindowTransform(obsPtr->transformType))
+    {
+        obsPtr->windowPeriod = params[0];
+        obsPtr->windowCount = (size_t)params[1];
+
+        obsPtr->statsPtr = CreateRunningStats((obsPtr->windowCount > 0) ? obsPtr->windowCount
+                                                                         : MIN_WINDOW_CAPACITY);
+    }
+    else if (obsPtr->transformType == OBS_TRANSFORM_TYPE_EWMA)
+    {
+        obsPtr->ewmaAlpha = params[0];
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the type of transform currently applied to an Observation.
+ *
+ * @return The TransformType
+ */
+//--------------------------------------------------------------------------------------------------
+obs_TransformType_t obs_GetTransform
+(
+    res_Resource_t* resPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    return obsPtr->transformType;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set an Observation to aggregate the samples it accepts over fixed-length (tumbling) windows
+ * of wall-clock time.  Instead of updating its value for each accepted sample, the Observation
+ * updates it once at the end of each window, with an aggregate of the samples accepted during
+ * the window.  Nothing is pushed for a window in which no samples were accepted.
+ *
+ * The mean, minimum, maximum and histogram only include numeric and Boolean (0 or 1) values.
+ * The count includes samples of any type.  The histogram uses the Observation's histogram
+ * buckets (see obs_SetHistogram()); nothing is pushed while it doesn't keep a histogram.
+ *
+ * Invalid settings are logged and ignored.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_SetAggregation
+(
+    res_Resource_t* resPtr,
+    obs_AggregationType_t aggregationType,
+    double period   ///< Length of the aggregation windows (seconds).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    switch (aggregationType)
     {
-        LE_ERROR("Failed to read version byte.");
-        return;
+        case OBS_AGGREGATION_TYPE_NONE:
+            break;
+
+        case OBS_AGGREGATION_TYPE_MEAN:
+        case OBS_AGGREGATION_TYPE_MIN:
+        case OBS_AGGREGATION_TYPE_MAX:
+        case OBS_AGGREGATION_TYPE_COUNT:
+        case OBS_AGGREGATION_TYPE_LAST:
+        case OBS_AGGREGATION_TYPE_HISTOGRAM:
+
+            if (!((period > 0) && isfinite(period)))
+            {
+                LE_ERROR("Invalid aggregation period %lf.", period);
+                return;
+            }
+            break;
+
+        default:
+
+            LE_ERROR("Invalid aggregation type %d.", aggregationType);
+            return;
     }
-    if (byte != 0)
+
+    // Restart aggregation, even if the settings haven't changed.
+    if (obsPtr->aggregationType != OBS_AGGREGATION_TYPE_NONE)
     {
-        LE_CRIT("Backup file format version %d unrecognized.", (int)byte);
-        le_atomFile_CancelStream(file);
-        return;
+        le_dls_Remove(&AggregatingObsList, &obsPtr->aggregationLink);
     }
+    ResetAggregation(obsPtr);
+
+    obsPtr->aggregationType = aggregationType;
 
-    // Read the data type code.
-    if (ReadFromFile(&byte, 1, file) != LE_OK)
+    if (aggregationType == OBS_AGGREGATION_TYPE_NONE)
     {
-        LE_ERROR("Failed to read data type code.");
-        return;
+        obsPtr->aggregationPeriod = 0;
     }
-    io_DataType_t dataType;
-    if (!GetDataTypeFromCode(&dataType, byte))
+    else
     {
-        le_atomFile_CancelStream(file);
-        return;
+        obsPtr->aggregationPeriod = period;
+        obsPtr->windowEnd = GetWindowEnd(obsPtr, GetAbsoluteTimeSec());
+        le_dls_Queue(&AggregatingObsList, &obsPtr->aggregationLink);
     }
-    obsPtr->bufferedType = dataType;
 
-    // Read the number of samples.
-    uint32_t count;
-    if (ReadFromFile(&count, 4, file) != LE_OK)
-    {
-        LE_ERROR("Failed to read number of samples.");
-        return;
-    }
+    RestartAggregationTimer();
+}
 
-    // The maximum count must be at least the number we read.
-    if (obsPtr->maxCount == 0)
-    {
-        obsPtr->maxCount = count;
-    }
-    // NOTE: Don't enable backups, though, because we don't know the frequency to choose
-    //       and flash wear can permanently damage a device.
 
-    // Read all the data samples from the file.
-    ReadSamplesFromFile(obsPtr, file, count);
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the type of aggregation currently applied to an Observation.
+ *
+ * @return The aggregation type.
+ */
+//--------------------------------------------------------------------------------------------------
+obs_AggregationType_t obs_GetAggregation
+(
+    res_Resource_t* resPtr,
+    double* periodPtr   ///< [OUT] Length of the aggregation windows (seconds, 0 if none).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    *periodPtr = obsPtr->aggregationPeriod;
+
+    return obsPtr->aggregationType;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Perform JSON extraction.  If the data type is not JSON, does nothing.
+ * Add an accepted sample to an Observation's current aggregation window, if it is aggregating.
  *
- * @return LE_OK if successful.
+ * @return true if the sample was added to the window (and so must not update the Observation's
+ *         value), false if the Observation isn't aggregating.
+ *
+ * @note Does not take ownership of the sample reference.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t obs_DoJsonExtraction
+bool obs_Aggregate
 (
     res_Resource_t* resPtr,
-    io_DataType_t* dataTypePtr,     ///< [INOUT] the data type, may be changed by JSON extraction
-    dataSample_Ref_t* valueRefPtr   ///< [INOUT] the data sample, may be replaced by JSON extraction
+    io_DataType_t dataType,
+    dataSample_Ref_t sampleRef
 )
 //--------------------------------------------------------------------------------------------------
 {
     Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
-    // If JSON extraction is enabled,
-    if (obsPtr->jsonExtraction[0] != '\0')
+    if (obsPtr->aggregationType == OBS_AGGREGATION_TYPE_NONE)
     {
-        if (*dataTypePtr != IO_DATA_TYPE_JSON)
+        return false;
+    }
+
+    (obsPtr->aggCount)++;
+
+    double value = NAN;
+    if (dataType == IO_DATA_TYPE_NUMERIC)
+    {
+        value = dataSample_GetNumeric(sampleRef);
+    }
+    else if (dataType == IO_DATA_TYPE_BOOLEAN)
+    {
+        value = (dataSample_GetBoolean(sampleRef) ? 1.0 : 0.0);
+    }
+
+    if (!isnan(value))
+    {
+        (obsPtr->aggNumCount)++;
+        obsPtr->aggSum += value;
+
+        if (isnan(obsPtr->aggMin) || (value < obsPtr->aggMin))
         {
-            LE_WARN("Ignoring non-JSON value pushed to observation configured to extract JSON.");
-            return LE_FAULT;
+            obsPtr->aggMin = value;
+        }
+        if (isnan(obsPtr->aggMax) || (value > obsPtr->aggMax))
+        {
+            obsPtr->aggMax = value;
         }
 
-        // Extract the appropriate JSON data element from the value.
-        io_DataType_t extractedType;
-        dataSample_Ref_t extractedValue = dataSample_ExtractJson(*valueRefPtr,
-                                                                 obsPtr->jsonExtraction,
-                                                                 &extractedType);
-        if (extractedValue == NULL)
+        if (   (obsPtr->aggregationType == OBS_AGGREGATION_TYPE_HISTOGRAM)
+            && (obsPtr->histogramRef != NULL)  )
         {
-            // Extraction failed.
-            return LE_FAULT;
+            histogram_AddToWindow(obsPtr->histogramRef, value);
         }
+    }
 
-        // Extraction succeeded, so replace value data sample with extracted one.
-        le_mem_Release(*valueRefPtr);
-        *valueRefPtr = extractedValue;
-        *dataTypePtr = extractedType;
+    if (obsPtr->aggregationType == OBS_AGGREGATION_TYPE_LAST)
+    {
+        le_mem_AddRef(sampleRef);
+        if (obsPtr->aggLastSample != NULL)
+        {
+            le_mem_Release(obsPtr->aggLastSample);
+        }
+        obsPtr->aggLastSample = sampleRef;
+        obsPtr->aggLastType = dataType;
     }
 
-    return LE_OK;
+    return true;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Determine whether the value should be accepted by a given Observation.
- *
- * @warning JSON extraction should be performed first if the data type is JSON.
- *
- * @return true if the value should be accepted.
+ * Set the maximum number of data samples to buffer in a given Observation.  Buffers are FIFO
+ * circular buffers. When full, the buffer drops the oldest value to make room for a new addition.
  */
 //--------------------------------------------------------------------------------------------------
-bool obs_ShouldAccept
+void obs_SetBufferMaxCount
 (
     res_Resource_t* resPtr,
-    io_DataType_t dataType,     ///< [IN] the data type
-    dataSample_Ref_t valueRef   ///< [IN] the data sample
+    uint32_t count
 )
 //--------------------------------------------------------------------------------------------------
 {
     Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
-    // Check the high limit and low limit before other limits.
-    if (dataType == IO_DATA_TYPE_NUMERIC)
-    {
-        double numericValue = dataSample_GetNumeric(valueRef);
+    CompleteRestore(obsPtr);
 
-        // If both limits are enabled and the low limit is higher than the high limit, then
-        // this is the "deadband" case. ( - <------HxxxxxxxxxL------> + )
-        if (   (!isnan(obsPtr->highLimit))
-            && (!isnan(obsPtr->lowLimit))
-            && (obsPtr->lowLimit > obsPtr->highLimit)  )
+    // If the buffer size is being changed,
+    if (obsPtr->maxCount != count)
+    {
+        // If the size is now zero, there are no rollup tiers, and backups were enabled,
+        // disable backups.
+        if ((count == 0) && (obsPtr->tierCount == 0) && (obsPtr->backupPeriod > 0))
         {
-            if ((numericValue < obsPtr->lowLimit) && (numericValue > obsPtr->highLimit))
-            {
-                return false;
-            }
+            DisableBackups(obsPtr);
         }
-        // In all other cases, reject if lower than non-NAN low limit or higher than non-NAN high.
-        else
-        {
-            if ((!isnan(obsPtr->lowLimit)) && (numericValue < obsPtr->lowLimit))
-            {
-                return false;
-            }
 
-            if ((!isnan(obsPtr->highLimit)) && (numericValue > obsPtr->highLimit))
-            {
-                return false;
-            }
+        // Reallocate the buffer, discarding extra samples if the size has shrunk.
+        if (ResizeBuffer(obsPtr, count) != LE_OK)
+        {
+            LE_CRIT("Unable to resize buffer to %u samples.", (unsigned int)count);
         }
     }
+}
 
-    // The current time in ms since some unspecified start time.
-    uint32_t now = 0;
 
-    // If we have received a push before (giving us something to compare against),
-    // Check the minPeriod and changeBy,
-    dataSample_Ref_t previousValue = res_GetCurrentValue(resPtr);
-    if (previousValue != NULL)
-    {
-        // If there is a changedBy filter in effect,
-        if ((obsPtr->changeBy != 0) && (!isnan(obsPtr->changeBy)))
-        {
-            // If overridden, reject everything because the value won't change.
-            if (res_IsOverridden(resPtr))
-            {
-                return false;
-            }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the buffer size setting for a given Observation.
+ *
+ * @return The buffer size (in number of samples) or 0 if not set.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t obs_GetBufferMaxCount
+(
+    res_Resource_t* resPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
-            // If the data type has changed, we can't do a comparison, so only check the changeBy
-            // filter if the new data sample's type is the same as the previous current value's
-            // type.
-            if (dataType == res_GetDataType(resPtr))
-            {
-                // If this is a numeric value and the last value was numeric too,
-                if (dataType == IO_DATA_TYPE_NUMERIC)
-                {
-                    // Reject changes in the current value smaller than the changeBy setting.
-                    double previousNumber = dataSample_GetNumeric(previousValue);
-                    if (  fabs(dataSample_GetNumeric(valueRef) - previousNumber)
-                        < obsPtr->changeBy)
-                    {
-                        return false;
-                    }
-                }
-                // For Boolean, a non-zero changeBy means filter out if unchanged.
-                else if (dataType == IO_DATA_TYPE_BOOLEAN)
-                {
-                    if (dataSample_GetBoolean(valueRef) == dataSample_GetBoolean(previousValue))
-                    {
-                        return false;
-                    }
-                }
-                // For string or JSON, a non-zero changeBy means filter out if unchanged.
-                else if (   (dataType == IO_DATA_TYPE_STRING)
-                         || (dataType == IO_DATA_TYPE_JSON))
-                {
-                    if (0 == strcmp(dataSample_GetString(valueRef),
-                                    dataSample_GetString(previousValue)))
-                    {
-                        return false;
-                    }
-                }
-            }
-        }
+    return obsPtr->maxCount;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set whether a given Observation's numeric data samples should be buffered compressed.
+ * Compressed samples take much less memory (often only a few bits each), but reading or querying
+ * the buffer means decoding them.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_SetBufferCompression
+(
+    res_Resource_t* resPtr,
+    bool compress
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    CompleteRestore(obsPtr);
+
+    obsPtr->compressBuffer = compress;
+
+    UpdateBufferEncoding(obsPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a given Observation's numeric data samples are set to be buffered compressed.
+ * See admin_SetBufferCompression() for more information.
+ *
+ * @return true if they are.
+ */
+//--------------------------------------------------------------------------------------------------
+bool obs_GetBufferCompression
+(
+    res_Resource_t* resPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    return obsPtr->compressBuffer;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set whether a given Observation's trigger, Boolean and numeric data samples should be buffered in
+ * a memory-mapped file.  See admin_SetBufferPersistence() for more information.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_SetBufferPersistence
+(
+    res_Resource_t* resPtr,
+    bool persist,
+    uint32_t syncPeriod ///< Minimum number of seconds between syncs (0 = leave it to the OS).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
-        // All of the above can be done without a system call, so that's why we do the
-        // minPeriod check last.
-        if ((obsPtr->minPeriod != 0) && (!isnan(obsPtr->minPeriod)))
-        {
-            now = GetRelativeTimeMs();  // system call
+    CompleteRestore(obsPtr);
 
-            if ((now - obsPtr->lastPushTime) < (obsPtr->minPeriod * 1000))
-            {
-                return false;
-            }
+    char path[MAX_BACKUP_FILE_PATH_BYTES];
+    if (   (persist != obsPtr->persistBuffer)
+        && (GetRingFilePath(path, sizeof(path), obsPtr) == LE_OK)  )
+    {
+        // Any ring file left from before is this Observation's to use now.
+        if (persist)
+        {
+            ClaimUnusedBackupFiles(path);
+        }
+        // If the buffer isn't in its ring file (which would be deleted when it moves out of it),
+        // there may be one left from before for the next clean-up to delete.
+        else if (obsPtr->ringPtr == NULL)
+        {
+            AddUnusedBackupFile(path, path);
         }
     }
 
-    // Update the time of last update.
-    if (now == 0)
-    {
-        now = GetRelativeTimeMs(); // system call
-    }
-    obsPtr->lastPushTime = now;
+    StopRingSync(obsPtr);
+    obsPtr->ringSyncPeriod = syncPeriod;
+    StartRingSync(obsPtr);
 
-    return true;
+    obsPtr->persistBuffer = persist;
+
+    UpdateBufferEncoding(obsPtr);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Perform processing of an accepted pushed data sample that is specific to an Observation
- * resource.
+ * Check whether a given Observation's buffer is set to be kept in a memory-mapped file.
+ * See admin_SetBufferPersistence() for more information.
+ *
+ * @return true if it is.
  */
 //--------------------------------------------------------------------------------------------------
-void obs_ProcessAccepted
+bool obs_GetBufferPersistence
 (
     res_Resource_t* resPtr,
-    io_DataType_t dataType,     ///< Data type of the data sample.
-    dataSample_Ref_t sampleRef  ///< Data sample.
+    uint32_t* syncPeriodPtr ///< [OUT] Minimum number of seconds between syncs.
 )
 //--------------------------------------------------------------------------------------------------
 {
     Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
-    if (obsPtr->maxCount > 0)
-    {
-        // If the data type has changed, we have to dump the current set of buffered samples.
-        if (obsPtr->bufferedType != dataType)
-        {
-            TruncateBuffer(obsPtr, 0);
+    *syncPeriodPtr = obsPtr->ringSyncPeriod;
 
-            obsPtr->bufferedType = dataType;
-        }
+    return obsPtr->persistBuffer;
+}
 
-        AddToBuffer(obsPtr, sampleRef);
 
-        TruncateBuffer(obsPtr, obsPtr->maxCount);
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the minimum time between backups of an Observation's buffer to non-volatile storage.
+ * If the buffer's size is non-zero and the backup period is non-zero, then the buffer will be
+ * backed-up to non-volatile storage when it changes, but never more often than this period setting
+ * specifies.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_SetBufferBackupPeriod
+(
+    res_Resource_t* resPtr,
+    uint32_t seconds
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    CompleteRestore(obsPtr);
+
+    uint32_t oldPeriod = obsPtr->backupPeriod;
+
+    // If the period is being changed,
+    if (oldPeriod != seconds)
+    {
+        obsPtr->backupPeriod = seconds;
+
+        // Any backup files left from before are this Observation's to use now.
+        if (oldPeriod == 0)
+        {
+            MarkBackupInUse(obsPtr);
+        }
 
-        // If the buffer backup period is non-zero, then back-ups are enabled.
-        if (obsPtr->backupPeriod > 0)
+        // If there's no buffer or rollup tiers, then backups aren't done, so we can skip the rest.
+        if (HasHistory(obsPtr))
         {
-            // If more than the backup period has passed since the time of last backup, do a backup.
-            uint32_t nextBackupTime = obsPtr->lastBackupTime + obsPtr->backupPeriod;
-            le_clk_Time_t now = le_clk_GetRelativeTime();
-            if (nextBackupTime <= now.sec)
+            // If the period is now zero, disable backups.
+            if (seconds == 0)
             {
-                Backup(obsPtr);
+                DisableBackups(obsPtr);
             }
-            // If the backup period hasn't passed yet, and there isn't already a timer running,
-            // then start a timer to expire when it's time to do a backup.
-            else if (obsPtr->backupTimer == NULL)
+            // If there's nothing in the buffer or tiers, we can skip the rest and just wait for
+            // something to be added.
+            else if ((obsPtr->count > 0) || (obsPtr->tierCount > 0))
             {
-                uint32_t timerInterval = (nextBackupTime - now.sec) * 1000;
-
-                obsPtr->backupTimer = le_timer_Create("backup");
-                LE_ASSERT(le_timer_SetMsInterval(obsPtr->backupTimer, timerInterval) == LE_OK);
-                LE_ASSERT(le_timer_SetHandler(obsPtr->backupTimer, BackupTimerExpired) == LE_OK);
-                LE_ASSERT(le_timer_SetContextPtr(obsPtr->backupTimer, obsPtr) == LE_OK);
-                LE_ASSERT(le_timer_Start(obsPtr->backupTimer) == LE_OK);
+                // If backups were already enabled and the period has just changed,
+                if (oldPeriod != 0)
+                {
+                    // If a backup is pending, then we know there's something waiting to be
+                    // backed up, so reschedule it to be due after the new period.  Otherwise, we
+                    // wait for something to be added to the buffer.
+                    if (obsPtr->isBackupPending)
+                    {
+                        ScheduleBackup(obsPtr);
+                    }
+                }
             }
         }
+        // Otherwise, backups weren't being done, but there may be backup files left from before
+        // for the next clean-up to delete.
+        else if (seconds == 0)
+        {
+            MarkBackupUnused(obsPtr);
+        }
     }
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Perform any post-filtering on a given Observation.
+ * Get the minimum time between backups of an Observation's buffer to non-volatile storage.
+ * See admin_SetBufferBackupPeriod() for more information.
+ *
+ * @return The buffer backup period (in seconds) or 0 if backups are disabled or the Observation
+ *         does not exist.
  */
 //--------------------------------------------------------------------------------------------------
-dataSample_Ref_t obs_ApplyTransform
+uint32_t obs_GetBufferBackupPeriod
+(
+    res_Resource_t* resPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    return obsPtr->backupPeriod;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set up a rollup tier of an Observation.  See admin_SetRollupTier() for more information.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_SetRollupTier
 (
     res_Resource_t* resPtr,
-    io_DataType_t dataType,     ///< Data type of the data sample.
-    dataSample_Ref_t sampleRef  ///< Data sample.
+    uint32_t tier,      ///< Tier number (0 = finest).
+    double period,      ///< Length of each bucket's period (seconds).
+    uint32_t maxCount   ///< Number of buckets to keep (0 = remove this tier and all coarser ones).
 )
 //--------------------------------------------------------------------------------------------------
 {
     Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
-    dataSample_Ref_t sample = sampleRef;
-    double transformVal;
 
+    CompleteRestore(obsPtr);
 
-    switch (obsPtr->transformType)
+    // Once the tiers change, the tiers in the backup file can't just be brought up to date by
+    // replaying the backup journal.
+    StopJournal(obsPtr);
+
+    if (maxCount == 0)
     {
-        case OBS_TRANSFORM_TYPE_NONE:
-            break;
+        DeleteRollupTiers(obsPtr, tier);
 
-        case OBS_TRANSFORM_TYPE_MEAN:
-            transformVal = obs_QueryMean(resPtr, NAN);
-            break;
+        // If nothing is kept anymore, there's nothing to back up.
+        if ((!HasHistory(obsPtr)) && (obsPtr->backupPeriod > 0))
+        {
+            DisableBackups(obsPtr);
+        }
 
-        case OBS_TRANSFORM_TYPE_STDDEV:
-            transformVal = obs_QueryStdDev(resPtr, NAN);
-            break;
+        return;
+    }
 
-        case OBS_TRANSFORM_TYPE_MAX:
-            transformVal = obs_QueryMax(resPtr, NAN);
-            break;
+    if (tier >= ADMIN_MAX_ROLLUP_TIERS)
+    {
+        LE_ERROR("Rollup tier %u out of range (max %d).",
+                 tier,
+                 ADMIN_MAX_ROLLUP_TIERS - 1);
+        return;
+    }
+    if (tier > obsPtr->tierCount)
+    {
+        LE_ERROR("Rollup tier %u can't be set before tier %zu.", tier, obsPtr->tierCount);
+        return;
+    }
+    if ((!(period > 0)) || isinf(period))
+    {
+        LE_ERROR("Invalid rollup tier period %lf.", period);
+        return;
+    }
+    if (   ((tier > 0) && (period <= obsPtr->tiers[tier - 1].period))
+        || ((tier + 1 < obsPtr->tierCount) && (period >= obsPtr->tiers[tier + 1].period))  )
+    {
+        LE_ERROR("Rollup tier %u period %lf must lie between its neighbours' periods.",
+                 tier,
+                 period);
+        return;
+    }
 
-        case OBS_TRANSFORM_TYPE_MIN:
-            transformVal = obs_QueryMin(resPtr, NAN);
-            break;
+    RollupTier_t* tierPtr = &obsPtr->tiers[tier];
 
-        default:
-            LE_FATAL("Invalid transform type %d", obsPtr->transformType);
-            break;
+    if (ResizeRollupTier(tierPtr, maxCount) != LE_OK)
+    {
+        return;
     }
 
-    // If transformed value differs from the input sample, update the sample
-    if (OBS_TRANSFORM_TYPE_NONE != obsPtr->transformType)
+    // Buckets of a different length can't be reused.
+    if (tierPtr->period != period)
     {
-        sample = UpdateSample(sampleRef, dataType, (void *)&transformVal);
+        tierPtr->period = period;
+        tierPtr->count = 0;
+        tierPtr->oldestIndex = 0;
     }
 
-    return sample;
+    if (tier == obsPtr->tierCount)
+    {
+        (obsPtr->tierCount)++;
+    }
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the minimum period between data samples accepted by a given Observation.
+ * Get the settings of a rollup tier of an Observation.
  *
- * This is used to throttle the rate of data passing into and through an Observation.
+ * @return The number of buckets kept in the tier, or 0 if the tier is not set.
  */
 //--------------------------------------------------------------------------------------------------
-void obs_SetMinPeriod
+uint32_t obs_GetRollupTier
 (
     res_Resource_t* resPtr,
-    double minPeriod
+    uint32_t tier,      ///< Tier number (0 = finest).
+    double* periodPtr   ///< [OUT] Length of each bucket's period (seconds), or NAN if not set.
 )
 //--------------------------------------------------------------------------------------------------
 {
     Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
-    obsPtr->minPeriod = minPeriod;
-}
+    CompleteRestore(obsPtr);
 
+    if (tier >= obsPtr->tierCount)
+    {
+        *periodPtr = NAN;
+        return 0;
+    }
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Get the minimum period between data samples accepted by a given Observation.
- *
- * @return The value, or 0 if not set.
- */
-//--------------------------------------------------------------------------------------------------
-double obs_GetMinPeriod
-(
-    res_Resource_t* resPtr
-)
-//--------------------------------------------------------------------------------------------------
-{
-    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+    *periodPtr = obsPtr->tiers[tier].period;
 
-    return obsPtr->minPeriod;
+    return obsPtr->tiers[tier].maxCount;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the highest value in a range that will be accepted by a given Observation.
- *
- * Ignored for all non-numeric types except Boolean for which non-zero = true and zero = false.
+ * Set the size of an Observation's quantile sketch.  See admin_SetQuantileSketch() for more
+ * information.
  */
 //--------------------------------------------------------------------------------------------------
-void obs_SetHighLimit
+void obs_SetQuantileSketch
 (
     res_Resource_t* resPtr,
-    double highLimit
+    uint32_t size       ///< Number of centroids per segment (0 = don't keep a sketch).
 )
 //--------------------------------------------------------------------------------------------------
 {
     Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
-    obsPtr->highLimit = highLimit;
+    if (size > ADMIN_MAX_SKETCH_SIZE)
+    {
+        LE_ERROR("Quantile sketch size %u out of range (max %d).", size, ADMIN_MAX_SKETCH_SIZE);
+        return;
+    }
+
+    if ((obsPtr->sketchRef != NULL) && (quantile_GetSize(obsPtr->sketchRef) == size))
+    {
+        return;
+    }
+
+    // A sketch of a different size starts again from the buffered samples.
+    DeleteQuantileSketch(obsPtr);
+
+    if (size > 0)
+    {
+        obsPtr->sketchRef = quantile_CreateSketch(size);
+    }
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the highest value in a range that will be accepted by a given Observation.
+ * Get the size of an Observation's quantile sketch.
  *
- * @return The value, or NAN (not a number) if not set.
+ * @return The number of centroids each segment of the sketch is compressed down to, or 0 if no
+ *         sketch is kept.
  */
 //--------------------------------------------------------------------------------------------------
-double obs_GetHighLimit
+uint32_t obs_GetQuantileSketch
 (
     res_Resource_t* resPtr
 )
@@ -1845,517 +7808,604 @@ double obs_GetHighLimit
 {
     Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
-    return obsPtr->highLimit;
+    if (obsPtr->sketchRef == NULL)
+    {
+        return 0;
+    }
+
+    return quantile_GetSize(obsPtr->sketchRef);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the lowest value in a range that will be accepted by a given Observation.
+ * Set the bucket boundaries of an Observation's histogram.  See admin_SetHistogram() for more
+ * information.
  *
- * Ignored for all non-numeric types except Boolean for which non-zero = true and zero = false.
+ * Invalid boundaries are logged and ignored.
  */
 //--------------------------------------------------------------------------------------------------
-void obs_SetLowLimit
+void obs_SetHistogram
 (
     res_Resource_t* resPtr,
-    double lowLimit
+    const double* boundsPtr,    ///< Bucket boundaries, in increasing order.
+    size_t boundsSize           ///< Number of boundaries (0 = don't keep a histogram).
 )
 //--------------------------------------------------------------------------------------------------
 {
     Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
-    obsPtr->lowLimit = lowLimit;
+    if (boundsSize > (IO_MAX_HISTOGRAM_BUCKETS - 1))
+    {
+        LE_ERROR("Too many histogram bucket boundaries (%zu, max %d).",
+                 boundsSize,
+                 IO_MAX_HISTOGRAM_BUCKETS - 1);
+        return;
+    }
+
+    size_t i;
+    for (i = 0; i < boundsSize; i++)
+    {
+        if (!isfinite(boundsPtr[i]) || ((i > 0) && !(boundsPtr[i] > boundsPtr[i - 1])))
+        {
+            LE_ERROR("Histogram bucket boundary %zu (%lf) is not finite and increasing.",
+                     i,
+                     boundsPtr[i]);
+            return;
+        }
+    }
+
+    // Counts don't carry over from the old buckets, even if the boundaries haven't changed.
+    DeleteHistogram(obsPtr);
+
+    if (boundsSize > 0)
+    {
+        obsPtr->histogramRef = histogram_Create(boundsPtr, boundsSize);
+    }
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the lowest value in a range that will be accepted by a given Observation.
- *
- * @return The value, or NAN (not a number) if not set.
+ * Get the bucket boundaries of an Observation's histogram.
  */
 //--------------------------------------------------------------------------------------------------
-double obs_GetLowLimit
+void obs_GetHistogram
 (
-    res_Resource_t* resPtr
+    res_Resource_t* resPtr,
+    double* boundsPtr,      ///< [OUT] Bucket boundaries, in increasing order.
+    size_t* boundsSizePtr   ///< [INOUT] Room in the array, then number of boundaries (0 if none).
 )
 //--------------------------------------------------------------------------------------------------
 {
     Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
-    return obsPtr->lowLimit;
+    if (obsPtr->histogramRef == NULL)
+    {
+        *boundsSizePtr = 0;
+        return;
+    }
+
+    histogram_GetBounds(obsPtr->histogramRef, boundsPtr, boundsSizePtr);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the magnitude that a new value must vary from the current value to be accepted by
- * a given Observation.
- *
- * Ignored for trigger types.
- *
- * For all other types, any non-zero value means accept any change, but drop if the same as current.
+ * Delete buffer backup files that aren't being used.
  */
 //--------------------------------------------------------------------------------------------------
-void obs_SetChangeBy
+void obs_DeleteUnusedBackupFiles
 (
-    res_Resource_t* resPtr,
-    double change
+    void
 )
 //--------------------------------------------------------------------------------------------------
 {
-    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+    LE_DEBUG("Cleaning up unused buffer backup files.");
 
-    obsPtr->changeBy = change;
+    // The files are deleted by the Backup Thread, after any backups still being written to them.
+    le_dls_Link_t* linkPtr;
+    while ((linkPtr = le_dls_Pop(&UnusedBackupFileList)) != NULL)
+    {
+        UnusedBackupFile_t* filePtr = CONTAINER_OF(linkPtr, UnusedBackupFile_t, link);
+
+        BackupJob_t* jobPtr = le_mem_ForceAlloc(BackupJobPool);
+        memset(jobPtr, 0, sizeof(*jobPtr));
+        jobPtr->type = BACKUP_JOB_DELETE;
+        LE_ASSERT(le_utf8_Copy(jobPtr->path, filePtr->path, sizeof(jobPtr->path), NULL) == LE_OK);
+        QueueBackupJob(jobPtr, NULL);
+
+        le_mem_Release(filePtr);
+    }
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the magnitude that a new value must vary from the current value to be accepted by
- * a given Observation.
+ * Find the data sample at or after a given timestamp in a given Observation's compressed buffer.
  *
- * @return The value, or 0 if not set.
+ * @return the position of the sample in the buffer (0 = oldest), or the buffer's count if there
+ *         is no such sample.
  */
 //--------------------------------------------------------------------------------------------------
-double obs_GetChangeBy
+static size_t FindCompressedIndex
 (
-    res_Resource_t* resPtr
+    Observation_t* obsPtr,
+    double startTime    ///< Seconds since the Epoch.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+    gorilla_Buffer_t* bufPtr = obsPtr->compressedPtr;
+    gorilla_Cursor_t cursor = bufPtr->oldest;
+    size_t i = 0;
+
+    // Skip the blocks that are followed by a block starting before the start time, without
+    // decoding them.
+    for (;;)
+    {
+        le_sls_Link_t* linkPtr = le_sls_PeekNext(&bufPtr->blockList, &cursor.blockPtr->link);
+
+        if (   (linkPtr == NULL)
+            || (CONTAINER_OF(linkPtr, gorilla_Block_t, link)->firstTimestamp >= startTime)  )
+        {
+            break;
+        }
+
+        i += cursor.blockPtr->count - cursor.nextIndex + 1;
+
+        LE_ASSERT(gorilla_StartCursor(&cursor, CONTAINER_OF(linkPtr, gorilla_Block_t, link)));
+    }
 
-    return obsPtr->changeBy;
+    // Then decode up to the first sample that is the same age or newer than the start time.
+    while (cursor.state.timestamp < startTime)
+    {
+        i++;
+
+        if (!gorilla_AdvanceCursor(bufPtr, &cursor))
+        {
+            break;
+        }
+    }
+
+    return i;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Perform a transform on buffered data. Value of the observation will be the output of the
- * transform
+ * Find the data sample at or after a given timestamp in a given Observation's buffer.
  *
- * Ignored for all non-numeric types except Boolean for which non-zero = true and zero = false.
+ * @return the position of the sample in the buffer (0 = oldest), or the buffer's count if there
+ *         is no such sample.
  */
 //--------------------------------------------------------------------------------------------------
-void obs_SetTransform
+static size_t FindBufferIndex
 (
-    res_Resource_t* resPtr,
-    obs_TransformType_t transformType,
-    const double* paramsPtr,
-    size_t paramsSize
+    Observation_t* obsPtr,
+    double startTime   ///< NAN for oldest; if < 30 years, count back from now; else absolute time.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
-
-    obsPtr->transformType = transformType;
+    // Default to the oldest entry.
+    size_t i = 0;
 
-    // If the transform is being set to anything other than NONE, ensure there is at least one
-    // data sample buffered in order to allow transforms to behave properly
-    if (   (OBS_TRANSFORM_TYPE_NONE != obsPtr->transformType)
-        && (0 == obsPtr->maxCount))
+    // If the buffer isn't empty and the startTime was specified,
+    if ((obsPtr->count > 0) && (!isnan(startTime)))
     {
-        obsPtr->maxCount = 1;
-    }
+        startTime = GetAbsoluteStartTime(startTime);
 
-    // Clear the buffer and current value of the observation.  Do this even if the same transform
-    // is being re-applied.  This allows any cumulative behavior to be cleared
-    TruncateBuffer(obsPtr, 0);
-    if (resPtr->pushedValue != NULL)
-    {
-        le_mem_Release(resPtr->pushedValue);
-        resPtr->pushedValue = NULL;
+        if (obsPtr->compressedPtr != NULL)
+        {
+            return FindCompressedIndex(obsPtr, startTime);
+        }
+
+        // The buffer is sorted by timestamp (AddToBuffer rejects out-of-order samples), so
+        // binary search for the oldest entry that is the same age or newer than the
+        // specified start time.
+        size_t end = obsPtr->count;
+        while (i < end)
+        {
+            size_t middle = i + ((end - i) / 2);
+
+            if (GetSlotTimestamp(obsPtr, middle) < startTime)
+            {
+                i = middle + 1;
+            }
+            else
+            {
+                end = middle;
+            }
+        }
     }
 
-    (void)paramsPtr;
-    (void)paramsSize;
+    return i;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the type of transform currently applied to an Observation.
+ * Find the position in a given Observation's buffer at which a read operation should start.
  *
- * @return The TransformType
+ * @return Index of the oldest sample newer than startAfter (count if there isn't one).
  */
 //--------------------------------------------------------------------------------------------------
-obs_TransformType_t obs_GetTransform
+static size_t FindReadStart
 (
-    res_Resource_t* resPtr
+    Observation_t* obsPtr,
+    double startAfter   ///< Start after this many seconds ago, or after an absolute number of
+                        ///< seconds since the Epoch (if startafter > 30 years).
+                        ///< Use NAN (not a number) to read the whole buffer.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+    CompleteRestore(obsPtr);
 
-    return obsPtr->transformType;
+    size_t start = FindBufferIndex(obsPtr, startAfter);
+
+    // If the data sample found is an exact match for the startAfter time, then skip to the
+    // sample after that.
+    BufferCursor_t cursor;
+    if (SeekBuffer(obsPtr, &cursor, start) && (cursor.slot.timestamp == startAfter))
+    {
+        start++;
+    }
+
+    return start;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the maximum number of data samples to buffer in a given Observation.  Buffers are FIFO
- * circular buffers. When full, the buffer drops the oldest value to make room for a new addition.
+ * Read data out of a buffer.  Data is written to a given file descriptor in JSON-encoded format
+ * as an array of objects containing a timestamp and a value (or just a timestamp for triggers).
+ * E.g.,
+ *
+ * @code
+ * [{"t":1537483647.125,"v":true},{"t":1537483657.128,"v":true}]
+ * @endcode
  */
 //--------------------------------------------------------------------------------------------------
-void obs_SetBufferMaxCount
+void obs_ReadBufferJson
 (
-    res_Resource_t* resPtr,
-    uint32_t count
+    res_Resource_t* resPtr, ///< Ptr to the resource object for the Observation.
+    double startAfter,  ///< Start after this many seconds ago, or after an absolute number of
+                        ///< seconds since the Epoch (if startafter > 30 years).
+                        ///< Use NAN (not a number) to read the whole buffer.
+    int outputFile, ///< File descriptor to write the data to.
+    query_ReadCompletionFunc_t handlerPtr, ///< Completion callback.
+    void* contextPtr    ///< Value to be passed to completion callback.
 )
 //--------------------------------------------------------------------------------------------------
 {
     Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
-    // If the buffer size is being changed,
-    if (obsPtr->maxCount != count)
-    {
-        // If the size is now zero and backups were enabled, disable backups.
-        if ((count == 0) && (obsPtr->backupPeriod > 0))
-        {
-            DisableBackups(obsPtr);
-        }
+    size_t start = FindReadStart(obsPtr, startAfter);
 
-        // Update the size.
-        obsPtr->maxCount = count;
-
-        // Discard extra samples if the size has shrunk.
-        TruncateBuffer(obsPtr, count);
-    }
+    StartRead(obsPtr, start, false, outputFile, handlerPtr, contextPtr);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the buffer size setting for a given Observation.
- *
- * @return The buffer size (in number of samples) or 0 if not set.
+ * Read data out of a buffer.  Data is written to a given file descriptor in a packed binary format:
+ * a header giving the data type, followed by a record for each sample.
+ * See query_ReadBufferBinary() for details.
  */
 //--------------------------------------------------------------------------------------------------
-uint32_t obs_GetBufferMaxCount
+void obs_ReadBufferBinary
 (
-    res_Resource_t* resPtr
+    res_Resource_t* resPtr, ///< Ptr to the resource object for the Observation.
+    double startAfter,  ///< Start after this many seconds ago, or after an absolute number of
+                        ///< seconds since the Epoch (if startafter > 30 years).
+                        ///< Use NAN (not a number) to read the whole buffer.
+    int outputFile, ///< File descriptor to write the data to.
+    query_ReadCompletionFunc_t handlerPtr, ///< Completion callback.
+    void* contextPtr    ///< Value to be passed to completion callback.
 )
 //--------------------------------------------------------------------------------------------------
 {
     Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
-    return obsPtr->maxCount;
+    size_t start = FindReadStart(obsPtr, startAfter);
+
+    StartRead(obsPtr, start, true, outputFile, handlerPtr, contextPtr);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the minimum time between backups of an Observation's buffer to non-volatile storage.
- * If the buffer's size is non-zero and the backup period is non-zero, then the buffer will be
- * backed-up to non-volatile storage when it changes, but never more often than this period setting
- * specifies.
+ * Find the buffered sample that a read cursor is to read next.
+ *
+ * @return Ptr to the sample's slot (which is only valid until the buffer next changes), or NULL if
+ *         the cursor has read all of the buffered samples.
  */
 //--------------------------------------------------------------------------------------------------
-void obs_SetBufferBackupPeriod
+static BufferSlot_t* PeekReadCursor
 (
-    res_Resource_t* resPtr,
-    uint32_t seconds
+    ReadCursor_t* cursorPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+    Observation_t* obsPtr = cursorPtr->obsPtr;
 
-    uint32_t oldPeriod = obsPtr->backupPeriod;
+    // If the next sample has fallen off the end of the observation's buffer, then all
+    // samples in the observation's buffer are now newer than it, so start from the oldest.
+    if (cursorPtr->nextSeq < obsPtr->oldestSeq)
+    {
+        cursorPtr->nextSeq = obsPtr->oldestSeq;
+    }
 
-    // If the period is being changed,
-    if (oldPeriod != seconds)
+    if (cursorPtr->nextSeq >= (obsPtr->oldestSeq + obsPtr->count))
     {
-        obsPtr->backupPeriod = seconds;
+        return NULL;
+    }
 
-        // If the buffer size is zero, then backups aren't done, so we can skip the rest.
-        if (obsPtr->maxCount > 0)
-        {
-            // If the period is now zero, disable backups.
-            if (seconds == 0)
-            {
-                DisableBackups(obsPtr);
-            }
-            // If there's nothing in the buffer, we can skip the rest and just wait for something
-            // to be added to the buffer.
-            else if (!le_sls_IsEmpty(&obsPtr->sampleList))
-            {
-                // If backups were already enabled and the period has just changed,
-                if (oldPeriod != 0)
-                {
-                    // If the timer is running, then we know there's something waiting to be
-                    // backed up.  Otherwise, we wait for something to be added to the buffer.
-                    if (obsPtr->backupTimer != NULL)
-                    {
-                        // Stop the old timer, because we know it has the wrong interval.
-                        le_timer_Stop(obsPtr->backupTimer);
-
-                        // If the backup period has passed since the last backup,
-                        // release the timer and do a backup now.
-                        uint32_t nextBackupTime = obsPtr->lastBackupTime + seconds;
-                        le_clk_Time_t now = le_clk_GetRelativeTime();
-                        if (nextBackupTime < now.sec)
-                        {
-                            le_timer_Delete(obsPtr->backupTimer);
-                            obsPtr->backupTimer = NULL;
-
-                            Backup(obsPtr);
-                        }
-                        else // If the backup period has not yet passed, correct the timer's
-                             // interval and restart it.
-                        {
-                            uint32_t timerInterval = (nextBackupTime - now.sec) * 1000;
-                            LE_ASSERT(le_timer_SetMsInterval(obsPtr->backupTimer, timerInterval)
-                                      == LE_OK);
-                            LE_ASSERT(le_timer_Start(obsPtr->backupTimer) == LE_OK);
-                        }
-                    }
-                }
-            }
-        }
+    if ((!cursorPtr->cursorValid) || (cursorPtr->cursor.seq != cursorPtr->nextSeq))
+    {
+        cursorPtr->cursorValid = SeekBuffer(obsPtr,
+                                            &cursorPtr->cursor,
+                                            cursorPtr->nextSeq - obsPtr->oldestSeq);
     }
+
+    return &cursorPtr->cursor.slot;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the minimum time between backups of an Observation's buffer to non-volatile storage.
- * See admin_SetBufferBackupPeriod() for more information.
- *
- * @return The buffer backup period (in seconds) or 0 if backups are disabled or the Observation
- *         does not exist.
+ * Move a read cursor on to the next buffered sample.
  */
 //--------------------------------------------------------------------------------------------------
-uint32_t obs_GetBufferBackupPeriod
+static void AdvanceReadCursor
 (
-    res_Resource_t* resPtr
+    ReadCursor_t* cursorPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
-
-    return obsPtr->backupPeriod;
+    (cursorPtr->nextSeq)++;
+    cursorPtr->cursorValid = NextInBuffer(cursorPtr->obsPtr, &cursorPtr->cursor);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Function that gets called for each file system object (file, directory, symlink, etc.) found
- * under the backup directory.
+ * Read the next batch of Boolean or numeric samples through a read cursor.
  *
- * @return 0 to continue the file system tree walk, non-zero to stop.
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).
+ *  - LE_FORMAT_ERROR if the buffered samples aren't of the given data type.
+ *  - LE_CLOSED if the Observation has been deleted.
  */
 //--------------------------------------------------------------------------------------------------
-static int BackupDirTreeWalkCallback
+static le_result_t ReadCursorSamples
 (
-    const char *fpath,      ///< File system path of the object.
-    const struct stat *sb,  ///< Ptr to the stat() info for the object.
-    int typeflag,           ///< What type of file system object we're looking at.
-    struct FTW *ftwbuf      ///< Ptr to buffer containing the basename and the nesting level.
+    ReadCursor_t* cursorPtr,
+    io_DataType_t dataType, ///< IO_DATA_TYPE_BOOLEAN or IO_DATA_TYPE_NUMERIC.
+    double* timestampsPtr,  ///< [OUT] Array to store the timestamps in.
+    void* valuesPtr,        ///< [OUT] Array to store the values in (bool or double).
+    size_t* countPtr        ///< [INOUT] Size of the arrays / number of samples read.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    switch (typeflag)
-    {
-        case FTW_F:  // regular file
-        {
-            // Compute the resource tree entry path of the associated Observation.
-            const char* relPath = fpath + BACKUP_DIR_PATH_LEN;
-            const char* suffixPtr = strstr(relPath, BACKUP_SUFFIX);
-            if (suffixPtr == NULL)
-            {
-                LE_WARN("Unexpected file in backup directory. Skipping '%s'.", fpath);
-                return 0;
-            }
-            // Copy all but the suffix into the observation path.
-            size_t obsPathBytes = (suffixPtr - relPath) + sizeof("/obs/");
-            char obsPath[HUB_MAX_RESOURCE_PATH_BYTES];
-            if (obsPathBytes >= sizeof(obsPath))
-            {
-                LE_ERROR("Length of path too long. Skipping '%s'.", fpath);
-                return 0;
-            }
-            (void)snprintf(obsPath, obsPathBytes, "/obs/%s", relPath);
+    size_t maxCount = *countPtr;
 
-            // If that Observation doesn't exist, or its backup period is 0, delete the file.
-            resTree_EntryRef_t entryRef = resTree_FindEntry(resTree_GetRoot(), obsPath);
-            if (   (entryRef == NULL)
-                || (resTree_GetEntryType(entryRef) != ADMIN_ENTRY_TYPE_OBSERVATION)
-                || (resTree_GetBufferBackupPeriod(entryRef) == 0)  )
-            {
-                if (unlink(fpath) != 0)
-                {
-                    LE_CRIT("Failed to delete '%s' (%m).", fpath);
-                }
-            }
+    *countPtr = 0;
 
-            return 0;
-        }
-        case FTW_D:  // directory and FTW_DEPTH was NOT specified
+    Observation_t* obsPtr = cursorPtr->obsPtr;
+    if (obsPtr == NULL)
+    {
+        return LE_CLOSED;
+    }
 
-            // This should never happen, because we specified FTW_DEPTH.
-            LE_CRIT("Received FTW_D flag for '%s'!", fpath);
-            return 0;
+    if (PeekReadCursor(cursorPtr) == NULL)
+    {
+        return LE_NOT_FOUND;
+    }
 
-        case FTW_DNR:   // directory that can't be read
+    if (obsPtr->bufferedType != dataType)
+    {
+        return LE_FORMAT_ERROR;
+    }
 
-            LE_ERROR("Can't read directory '%s'", fpath);
-            return 0;
+    BufferSlot_t* slotPtr;
+    size_t count = 0;
 
-        case FTW_DP:    // directory and FTW_DEPTH was specified
+    while ((count < maxCount) && ((slotPtr = PeekReadCursor(cursorPtr)) != NULL))
+    {
+        timestampsPtr[count] = slotPtr->timestamp;
+
+        if (dataType == IO_DATA_TYPE_BOOLEAN)
         {
-            // If the directory is empty, delete it.
-            int result = rmdir(fpath);
-            if ((result == -1) && (errno != ENOTEMPTY) && (errno != EEXIST))
-            {
-                LE_CRIT("Failed to remove directory '%s' (%m).", fpath);
-            }
-            return 0;
+            ((bool*)valuesPtr)[count] = slotPtr->value.boolean;
+        }
+        else
+        {
+            ((double*)valuesPtr)[count] = slotPtr->value.numeric;
         }
-        case FTW_NS:     // stat() call failed on fpath
 
-            LE_CRIT("Failed to stat '%s'", fpath);
-            return 0;
+        count++;
+        AdvanceReadCursor(cursorPtr);
+    }
 
-        case FTW_SL:     // symbolic link and FTW_PHYS specified
+    *countPtr = count;
 
-            // This should never happen, because we didn't specify FTW_PHYS.
-            LE_CRIT("Received FTW_SL flag for '%s'!", fpath);
-            return 0;
+    return LE_OK;
+}
 
-        case FTW_SLN:    // symbolic link pointing to a nonexistent file
 
-            LE_CRIT("Broken symlink found at '%s'", fpath);
-            return 0;
-    }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a read cursor on an Observation's buffer, so the buffered samples newer than a given time
+ * can be read a batch at a time, with each batch carrying on from where the last one left off.
+ *
+ * @return Reference to the cursor.  Must be closed using obs_CloseReadCursor().
+ */
+//--------------------------------------------------------------------------------------------------
+obs_ReadCursorRef_t obs_OpenReadCursor
+(
+    res_Resource_t* resPtr, ///< Ptr to the resource object for the Observation.
+    double startAfter   ///< Start after this many seconds ago, or after an absolute number of
+                        ///< seconds since the Epoch (if startafter > 30 years).
+                        ///< Use NAN (not a number) to read the whole buffer.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
-    LE_CRIT("Unexpected type flag %d.", typeflag);
+    size_t start = FindReadStart(obsPtr, startAfter);
 
-    return -1;
+    ReadCursor_t* cursorPtr = le_mem_ForceAlloc(ReadCursorPool);
+
+    cursorPtr->link = LE_DLS_LINK_INIT;
+    le_dls_Queue(&obsPtr->readCursorList, &cursorPtr->link);
+
+    cursorPtr->obsPtr = obsPtr;
+    cursorPtr->nextSeq = obsPtr->oldestSeq + start;
+    cursorPtr->cursorValid = false;
+
+    return cursorPtr;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Delete buffer backup files that aren't being used.
+ * Close a read cursor.
  */
 //--------------------------------------------------------------------------------------------------
-void obs_DeleteUnusedBackupFiles
+void obs_CloseReadCursor
 (
-    void
+    obs_ReadCursorRef_t cursorRef
 )
 //--------------------------------------------------------------------------------------------------
 {
-    LE_DEBUG("Cleaning up unused buffer backup files.");
-
-    // Walk the directory tree under the backup directory.
-    // For each file, compute the resource tree entry path of the associated Observation.
-    // If that Observation doesn't exist, delete the file.
-    // If the directory is empty (after examining all files in it), delete the directory.
-    // Note: The number of file descriptors allowed to be used is selected to prevent
-    // running into the app's open file descriptor limit, while avoiding a lot of opening
-    // and closing of directories.  Normally we don't expect a lot of depth in the Observation
-    // resource naming heirarchy, so there shouldn't be a lot of depth in the backup directory.
-    int result = nftw(BACKUP_DIR,
-                      BackupDirTreeWalkCallback,
-                      4 /* max fds */,
-                      FTW_DEPTH /* depth-first traversal */);
-    if (result != 0)
+    if (cursorRef->obsPtr != NULL)
     {
-        if (errno == ENOENT)
-        {
-            LE_DEBUG("No backup directory. Skipping backup file clean-up.");
-        }
-        else
-        {
-            LE_CRIT("Failed to traverse backup directory '%s' (%m)", BACKUP_DIR);
-        }
+        le_dls_Remove(&cursorRef->obsPtr->readCursorList, &cursorRef->link);
     }
+
+    le_mem_Release(cursorRef);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Find the data sample at or after a given timestamp in a given Observation's buffer.
+ * Read the next batch of Boolean samples through a read cursor.
  *
- * @return a pointer to the buffer entry, or NULL if not found.
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).
+ *  - LE_FORMAT_ERROR if the buffered samples aren't Boolean.
+ *  - LE_CLOSED if the Observation has been deleted.
  */
 //--------------------------------------------------------------------------------------------------
-static BufferEntry_t* FindBufferEntry
+le_result_t obs_ReadCursorBoolean
 (
-    Observation_t* obsPtr,
-    double startTime   ///< NAN for oldest; if < 30 years, count back from now; else absolute time.
+    obs_ReadCursorRef_t cursorRef,
+    double* timestampsPtr,  ///< [OUT] Array to store the timestamps in.
+    bool* valuesPtr,        ///< [OUT] Array to store the values in.
+    size_t* countPtr        ///< [INOUT] Size of the arrays / number of samples read.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Start at the oldest end and search forward.
-    BufferEntry_t* buffEntryPtr = GetOldestBufferEntry(obsPtr);
-
-    // If the buffer isn't empty and the startTime was specified,
-    if ((buffEntryPtr != NULL) && (!isnan(startTime)))
-    {
-        // If the start time is less than or equal to 30 years, then convert to an
-        // absolute timestamp by subtracting it from the current time.
-        if (startTime <= THIRTY_YEARS)
-        {
-            le_clk_Time_t now = le_clk_GetAbsoluteTime();
-            startTime = ((((double)(now.usec)) / 1000000) + now.sec) - startTime;
-        }
-
-        // Walk up the buffer looking for an entry that is the same age or newer than the
-        // specified start time.
-        do
-        {
-            if (dataSample_GetTimestamp(buffEntryPtr->sampleRef) >= startTime)
-            {
-                break;
-            }
-
-            buffEntryPtr = GetNextBufferEntry(obsPtr, buffEntryPtr);
+    return ReadCursorSamples(cursorRef, IO_DATA_TYPE_BOOLEAN, timestampsPtr, valuesPtr, countPtr);
+}
 
-        } while (buffEntryPtr != NULL);
-    }
 
-    return buffEntryPtr;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of numeric samples through a read cursor.
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).
+ *  - LE_FORMAT_ERROR if the buffered samples aren't numeric.
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t obs_ReadCursorNumeric
+(
+    obs_ReadCursorRef_t cursorRef,
+    double* timestampsPtr,  ///< [OUT] Array to store the timestamps in.
+    double* valuesPtr,      ///< [OUT] Array to store the values in.
+    size_t* countPtr        ///< [INOUT] Size of the arrays / number of samples read.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return ReadCursorSamples(cursorRef, IO_DATA_TYPE_NUMERIC, timestampsPtr, valuesPtr, countPtr);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Read data out of a buffer.  Data is written to a given file descriptor in JSON-encoded format
- * as an array of objects containing a timestamp and a value (or just a timestamp for triggers).
- * E.g.,
+ * Read the next batch of samples (of any data type) through a read cursor, as a JSON array of as
+ * many samples as fit in a given buffer, in the same format as obs_ReadBufferJson().
  *
- * @code
- * [{"t":1537483647.125,"v":true},{"t":1537483657.128,"v":true}]
- * @endcode
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).  The buffer holds an empty array.
+ *  - LE_CLOSED if the Observation has been deleted.
  */
 //--------------------------------------------------------------------------------------------------
-void obs_ReadBufferJson
+le_result_t obs_ReadCursorJson
 (
-    res_Resource_t* resPtr, ///< Ptr to the resource object for the Observation.
-    double startAfter,  ///< Start after this many seconds ago, or after an absolute number of
-                        ///< seconds since the Epoch (if startafter > 30 years).
-                        ///< Use NAN (not a number) to read the whole buffer.
-    int outputFile, ///< File descriptor to write the data to.
-    query_ReadCompletionFunc_t handlerPtr, ///< Completion callback.
-    void* contextPtr    ///< Value to be passed to completion callback.
+    obs_ReadCursorRef_t cursorRef,
+    char* buffPtr,      ///< [OUT] Ptr to buffer where the JSON array will be stored.
+    size_t buffSize     ///< [IN] Size of the buffer, in bytes (at least 3).
 )
 //--------------------------------------------------------------------------------------------------
 {
-    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+    LE_ASSERT(buffSize >= 3);
 
-    BufferEntry_t* startPtr = FindBufferEntry(obsPtr, startAfter);
+    Observation_t* obsPtr = cursorRef->obsPtr;
+    if (obsPtr == NULL)
+    {
+        return LE_CLOSED;
+    }
 
-    // If the data sample found is an exact match for the startAfter time, then skip to the
-    // sample after that.
-    if ((startPtr != NULL) && (dataSample_GetTimestamp(startPtr->sampleRef) == startAfter))
+    size_t len = 0;
+    size_t count = 0;
+    BufferSlot_t* slotPtr;
+
+    buffPtr[len++] = '[';
+
+    while ((slotPtr = PeekReadCursor(cursorRef)) != NULL)
     {
-        startPtr = GetNextBufferEntry(obsPtr, startPtr);
+        // Leave room for the closing ']'.
+        char* samplePtr = buffPtr + len;
+        size_t sampleSize = buffSize - len - 1;
+
+        if (count > 0)
+        {
+            *samplePtr = ',';
+            samplePtr++;
+            sampleSize--;
+        }
+
+        size_t sampleLen;
+        if (FormatJsonSample(obsPtr, slotPtr, samplePtr, sampleSize, &sampleLen))
+        {
+            len = (samplePtr + sampleLen) - buffPtr;
+            count++;
+        }
+        // If the buffer is full, leave this sample to be read next time.  If it doesn't fit
+        // into an empty buffer, though, it never will.
+        else if (count > 0)
+        {
+            break;
+        }
+        else
+        {
+            LE_ERROR("JSON value doesn't fit in buffer. Skipping.");
+        }
+
+        AdvanceReadCursor(cursorRef);
     }
 
-    StartRead(obsPtr, startPtr, outputFile, handlerPtr, contextPtr);
+    buffPtr[len++] = ']';
+    buffPtr[len] = '\0';
+
+    return (count > 0) ? LE_OK : LE_NOT_FOUND;
 }
 
 
@@ -2363,7 +8413,8 @@ void obs_ReadBufferJson
 /**
  * Find the oldest data sample in a given Observation's buffer that is newer than a given timestamp.
  *
- * @return Reference to the sample, or NULL if not found in buffer.
+ * @return Reference to the sample, or NULL if not found in buffer.  The caller is responsible for
+ *         releasing the reference.
  */
 //--------------------------------------------------------------------------------------------------
 dataSample_Ref_t obs_FindBufferedSampleAfter
@@ -2377,18 +8428,42 @@ dataSample_Ref_t obs_FindBufferedSampleAfter
 {
     Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
-    BufferEntry_t* startPtr = FindBufferEntry(obsPtr, startAfter);
+    CompleteRestore(obsPtr);
+
+    BufferCursor_t cursor;
+    if (!SeekBuffer(obsPtr, &cursor, FindBufferIndex(obsPtr, startAfter)))
+    {
+        return NULL;
+    }
 
     // If the data sample found is an exact match for the startAfter time, then skip to the
     // sample after that.
-    if ((startPtr != NULL) && (dataSample_GetTimestamp(startPtr->sampleRef) == startAfter))
+    if ((cursor.slot.timestamp == startAfter) && (!NextInBuffer(obsPtr, &cursor)))
     {
-        startPtr = GetNextBufferEntry(obsPtr, startPtr);
+        return NULL;
     }
 
-    if (startPtr != NULL)
+    BufferSlot_t* slotPtr = &cursor.slot;
+
+    switch (obsPtr->bufferedType)
     {
-        return startPtr->sampleRef;
+        case IO_DATA_TYPE_TRIGGER:
+
+            return dataSample_CreateTrigger(slotPtr->timestamp);
+
+        case IO_DATA_TYPE_BOOLEAN:
+
+            return dataSample_CreateBoolean(slotPtr->timestamp, slotPtr->value.boolean);
+
+        case IO_DATA_TYPE_NUMERIC:
+
+            return dataSample_CreateNumeric(slotPtr->timestamp, slotPtr->value.numeric);
+
+        case IO_DATA_TYPE_STRING:
+        case IO_DATA_TYPE_JSON:
+
+            le_mem_AddRef(slotPtr->value.sampleRef);
+            return slotPtr->value.sampleRef;
     }
 
     return NULL;
@@ -2413,10 +8488,18 @@ void obs_SetJsonExtraction
 {
     Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
-    LE_ASSERT(LE_OK == le_utf8_Copy(obsPtr->jsonExtraction,
-                                    extractionSpec,
-                                    sizeof(obsPtr->jsonExtraction),
-                                    NULL));
+    LE_ASSERT(strlen(extractionSpec) <= ADMIN_MAX_JSON_EXTRACTOR_LEN);
+
+    if (obsPtr->jsonExtraction != NULL)
+    {
+        le_mem_Release(obsPtr->jsonExtraction);
+        obsPtr->jsonExtraction = NULL;
+    }
+
+    if (extractionSpec[0] != '\0')
+    {
+        obsPtr->jsonExtraction = atom_Get(extractionSpec);
+    }
 }
 
 
@@ -2436,44 +8519,12 @@ const char* obs_GetJsonExtraction
 {
     Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
-    return obsPtr->jsonExtraction;
-}
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Get buffer entry numerical value.  This works for numeric or Boolean types only.
- *
- * @return The value.
- */
-//--------------------------------------------------------------------------------------------------
-static double GetBufferedNumber
-(
-    BufferEntry_t* buffEntryPtr,
-    io_DataType_t dataType
-)
-//--------------------------------------------------------------------------------------------------
-{
-    if (dataType == IO_DATA_TYPE_NUMERIC)
-    {
-        return dataSample_GetNumeric(buffEntryPtr->sampleRef);
-    }
-    else if (dataType == IO_DATA_TYPE_BOOLEAN)
-    {
-        if (dataSample_GetBoolean(buffEntryPtr->sampleRef))
-        {
-            return 1.0;
-        }
-        else
-        {
-            return 0.0;
-        }
-    }
-    else
+    if (obsPtr->jsonExtraction == NULL)
     {
-        LE_CRIT("Non-numerical data type %d.", dataType);
-        return NAN;
+        return "";
     }
+
+    return atom_GetString(obsPtr->jsonExtraction);
 }
 
 
@@ -2495,6 +8546,8 @@ double obs_QueryMin
 {
     Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
+    CompleteRestore(obsPtr);
+
     // This only works for numeric or Boolean type data.
     if (   (obsPtr->bufferedType != IO_DATA_TYPE_NUMERIC)
         && (obsPtr->bufferedType != IO_DATA_TYPE_BOOLEAN)  )
@@ -2502,13 +8555,22 @@ double obs_QueryMin
         return NAN;
     }
 
-    BufferEntry_t* buffEntryPtr = FindBufferEntry(obsPtr, startTime);
+    // If the buffer doesn't go back far enough, use the rollup tiers instead.
+    RollupBucket_t summary;
+    if (QueryRollupTiers(obsPtr, startTime, &summary))
+    {
+        return ((summary.count > 0) ? summary.min : NAN);
+    }
 
     double result = NAN;
 
-    while (buffEntryPtr != NULL)
+    BufferCursor_t cursor;
+    bool found;
+    for (found = SeekBuffer(obsPtr, &cursor, FindBufferIndex(obsPtr, startTime));
+         found;
+         found = NextInBuffer(obsPtr, &cursor))
     {
-        double value = GetBufferedNumber(buffEntryPtr, obsPtr->bufferedType);
+        double value = GetBufferedNumber(&cursor.slot, obsPtr->bufferedType);
 
         if (!isnan(value))
         {
@@ -2517,8 +8579,6 @@ double obs_QueryMin
                 result = value;
             }
         }
-
-        buffEntryPtr = GetNextBufferEntry(obsPtr, buffEntryPtr);
     }
 
     return result;
@@ -2543,6 +8603,8 @@ double obs_QueryMax
 {
     Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
+    CompleteRestore(obsPtr);
+
     // This only works for numeric or Boolean type data.
     if (   (obsPtr->bufferedType != IO_DATA_TYPE_NUMERIC)
         && (obsPtr->bufferedType != IO_DATA_TYPE_BOOLEAN)  )
@@ -2550,13 +8612,22 @@ double obs_QueryMax
         return NAN;
     }
 
-    BufferEntry_t* buffEntryPtr = FindBufferEntry(obsPtr, startTime);
+    // If the buffer doesn't go back far enough, use the rollup tiers instead.
+    RollupBucket_t summary;
+    if (QueryRollupTiers(obsPtr, startTime, &summary))
+    {
+        return ((summary.count > 0) ? summary.max : NAN);
+    }
 
     double result = NAN;
 
-    while (buffEntryPtr != NULL)
+    BufferCursor_t cursor;
+    bool found;
+    for (found = SeekBuffer(obsPtr, &cursor, FindBufferIndex(obsPtr, startTime));
+         found;
+         found = NextInBuffer(obsPtr, &cursor))
     {
-        double value = GetBufferedNumber(buffEntryPtr, obsPtr->bufferedType);
+        double value = GetBufferedNumber(&cursor.slot, obsPtr->bufferedType);
 
         if (!isnan(value))
         {
@@ -2565,8 +8636,6 @@ double obs_QueryMax
                 result = value;
             }
         }
-
-        buffEntryPtr = GetNextBufferEntry(obsPtr, buffEntryPtr);
     }
 
     return result;
@@ -2591,6 +8660,8 @@ double obs_QueryMean
 {
     Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
+    CompleteRestore(obsPtr);
+
     // This only works for numeric or Boolean type data.
     if (   (obsPtr->bufferedType != IO_DATA_TYPE_NUMERIC)
         && (obsPtr->bufferedType != IO_DATA_TYPE_BOOLEAN)  )
@@ -2598,22 +8669,29 @@ double obs_QueryMean
         return NAN;
     }
 
-    BufferEntry_t* buffEntryPtr = FindBufferEntry(obsPtr, startTime);
+    // If the buffer doesn't go back far enough, use the rollup tiers instead.
+    RollupBucket_t summary;
+    if (QueryRollupTiers(obsPtr, startTime, &summary))
+    {
+        return ((summary.count > 0) ? summary.mean : NAN);
+    }
 
     double sum = 0;
     size_t count = 0;
 
-    while (buffEntryPtr != NULL)
+    BufferCursor_t cursor;
+    bool found;
+    for (found = SeekBuffer(obsPtr, &cursor, FindBufferIndex(obsPtr, startTime));
+         found;
+         found = NextInBuffer(obsPtr, &cursor))
     {
-        double value = GetBufferedNumber(buffEntryPtr, obsPtr->bufferedType);
+        double value = GetBufferedNumber(&cursor.slot, obsPtr->bufferedType);
 
         if (!isnan(value))
         {
             sum += value;
             count++;
         }
-
-        buffEntryPtr = GetNextBufferEntry(obsPtr, buffEntryPtr);
     }
 
     if (count == 0)
@@ -2644,6 +8722,8 @@ double obs_QueryStdDev
 {
     Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
 
+    CompleteRestore(obsPtr);
+
     // This only works for numeric or Boolean type data.
     if (   (obsPtr->bufferedType != IO_DATA_TYPE_NUMERIC)
         && (obsPtr->bufferedType != IO_DATA_TYPE_BOOLEAN)  )
@@ -2651,28 +8731,35 @@ double obs_QueryStdDev
         return NAN;
     }
 
-    BufferEntry_t* startEntryPtr = FindBufferEntry(obsPtr, startTime);
-
-    if (startEntryPtr == NULL)
+    // If the buffer doesn't go back far enough, use the rollup tiers instead.
+    RollupBucket_t summary;
+    if (QueryRollupTiers(obsPtr, startTime, &summary))
     {
-        return NAN;
+        if (summary.count == 0)
+        {
+            return NAN;
+        }
+
+        return sqrt(summary.sumSquares / summary.count);
     }
 
+    size_t start = FindBufferIndex(obsPtr, startTime);
+
+    BufferCursor_t cursor;
+    bool found;
+
     double sum = 0;
     size_t count = 0;
 
-    BufferEntry_t* buffEntryPtr = startEntryPtr;
-    while (buffEntryPtr != NULL)
+    for (found = SeekBuffer(obsPtr, &cursor, start); found; found = NextInBuffer(obsPtr, &cursor))
     {
-        double value = GetBufferedNumber(buffEntryPtr, obsPtr->bufferedType);
+        double value = GetBufferedNumber(&cursor.slot, obsPtr->bufferedType);
 
         if (!isnan(value))
         {
             sum += value;
             count++;
         }
-
-        buffEntryPtr = GetNextBufferEntry(obsPtr, buffEntryPtr);
     }
 
     if (count == 0)
@@ -2684,19 +8771,247 @@ double obs_QueryStdDev
 
     double sumOfSquaredDifferences = 0;
 
-    buffEntryPtr = startEntryPtr;
-    while (buffEntryPtr != NULL)
+    for (found = SeekBuffer(obsPtr, &cursor, start); found; found = NextInBuffer(obsPtr, &cursor))
     {
-        double value = GetBufferedNumber(buffEntryPtr, obsPtr->bufferedType);
+        double value = GetBufferedNumber(&cursor.slot, obsPtr->bufferedType);
 
         if (!isnan(value))
         {
             double diff = value - mean;
             sumOfSquaredDifferences += (diff * diff);
         }
-
-        buffEntryPtr = GetNextBufferEntry(obsPtr, buffEntryPtr);
     }
 
     return sqrt(sumOfSquaredDifferences / count);
 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the count, minimum, maximum, mean and standard deviation of all values found within a given
+ * time span in an Observation's data set, along with the time span they cover.
+ *
+ * This takes a single pass over the values, or none at all if they are all covered by the running
+ * stats of a whole-buffer transform.  If the buffer doesn't go back far enough, the rollup tiers
+ * are used, in which case the time span is that of the tier periods the values fall into.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_NOT_FOUND if there are no values in the time span.
+ *  - LE_FORMAT_ERROR if the Observation's data set isn't numerical.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t obs_QueryStats
+(
+    res_Resource_t* resPtr,    ///< Ptr to Observation resource.
+    double startTime,   ///< If < 30 years then seconds before now; else seconds since the Epoch.
+    obs_Stats_t* statsPtr   ///< [OUT] The aggregates (count 0 and NANs unless LE_OK).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    statsPtr->count = 0;
+    statsPtr->min = NAN;
+    statsPtr->max = NAN;
+    statsPtr->mean = NAN;
+    statsPtr->stdDev = NAN;
+    statsPtr->firstTimestamp = NAN;
+    statsPtr->lastTimestamp = NAN;
+
+    CompleteRestore(obsPtr);
+
+    // This only works for numeric or Boolean type data.
+    if (   (obsPtr->bufferedType != IO_DATA_TYPE_NUMERIC)
+        && (obsPtr->bufferedType != IO_DATA_TYPE_BOOLEAN)  )
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    // If the buffer doesn't go back far enough, use the rollup tiers instead.
+    double absStartTime = startTime;
+    if (!isnan(startTime))
+    {
+        absStartTime = GetAbsoluteStartTime(startTime);
+    }
+
+    RollupTier_t* tierPtr = FindRollupTier(obsPtr, absStartTime);
+    if (tierPtr != NULL)
+    {
+        RollupBucket_t summary;
+        if (SummarizeRollupTier(tierPtr, absStartTime, &summary) == 0)
+        {
+            return LE_NOT_FOUND;
+        }
+
+        statsPtr->count = summary.count;
+        statsPtr->min = summary.min;
+        statsPtr->max = summary.max;
+        statsPtr->mean = summary.mean;
+        statsPtr->stdDev = sqrt(summary.sumSquares / summary.count);
+        statsPtr->firstTimestamp = summary.start;
+        if (statsPtr->firstTimestamp < absStartTime)
+        {
+            statsPtr->firstTimestamp = absStartTime;
+        }
+        statsPtr->lastTimestamp = GetBucket(tierPtr, tierPtr->count - 1)->start + tierPtr->period;
+
+        return LE_OK;
+    }
+
+    size_t start = FindBufferIndex(obsPtr, startTime);
+
+    // If the time span covers the whole buffer, a whole-buffer transform's running stats already
+    // hold the answer.
+    RunningStats_t* runningPtr = obsPtr->statsPtr;
+    if ((start == 0) && (runningPtr != NULL) && IsBufferTransform(obsPtr->transformType))
+    {
+        if (runningPtr->count == 0)
+        {
+            return LE_NOT_FOUND;
+        }
+
+        statsPtr->count = runningPtr->count;
+        statsPtr->min = GetStatsValue(runningPtr,
+                                      runningPtr->minQueue.seqPtr[runningPtr->minQueue.head]);
+        statsPtr->max = GetStatsValue(runningPtr,
+                                      runningPtr->maxQueue.seqPtr[runningPtr->maxQueue.head]);
+        statsPtr->mean = runningPtr->mean;
+        statsPtr->stdDev = sqrt(runningPtr->sumSquares / runningPtr->count);
+        statsPtr->firstTimestamp = GetStatsEntry(runningPtr, 0)->timestamp;
+        statsPtr->lastTimestamp = GetStatsEntry(runningPtr, runningPtr->count - 1)->timestamp;
+
+        return LE_OK;
+    }
+
+    // Sum the values and their squares after shifting them by the first value, so that the
+    // variance can be had from a single pass without losing precision to large offsets.
+    uint32_t count = 0;
+    double shift = 0;
+    double sum = 0;
+    double sumSquares = 0;
+
+    BufferCursor_t cursor;
+    bool found;
+    for (found = SeekBuffer(obsPtr, &cursor, start); found; found = NextInBuffer(obsPtr, &cursor))
+    {
+        double value = GetBufferedNumber(&cursor.slot, obsPtr->bufferedType);
+
+        if (!isnan(value))
+        {
+            if (count == 0)
+            {
+                shift = value;
+                statsPtr->min = value;
+                statsPtr->max = value;
+                statsPtr->firstTimestamp = cursor.slot.timestamp;
+            }
+            else if (value < statsPtr->min)
+            {
+                statsPtr->min = value;
+            }
+            else if (value > statsPtr->max)
+            {
+                statsPtr->max = value;
+            }
+
+            double diff = value - shift;
+            sum += diff;
+            sumSquares += (diff * diff);
+            count++;
+
+            statsPtr->lastTimestamp = cursor.slot.timestamp;
+        }
+    }
+
+    if (count == 0)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    double variance = (sumSquares - ((sum * sum) / count)) / count;
+
+    statsPtr->count = count;
+    statsPtr->mean = shift + (sum / count);
+    statsPtr->stdDev = ((variance > 0) ? sqrt(variance) : 0);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Estimate a percentile of the values found within a given time span in an Observation's buffer,
+ * using its quantile sketch.  The buffer isn't scanned, but the segments of the sketch are only
+ * included or excluded as a whole, so values received up to one segment before the start time
+ * (and values that have just left the buffer) may be included.
+ *
+ * @return The value, or NAN (not-a-number) if the Observation doesn't keep a quantile sketch or
+ *         there's no numerical data in its buffer within the time span.
+ */
+//--------------------------------------------------------------------------------------------------
+double obs_QueryPercentile
+(
+    res_Resource_t* resPtr,    ///< Ptr to Observation resource.
+    double startTime,   ///< If < 30 years then seconds before now; else seconds since the Epoch.
+    double percentile   ///< Percentile (0 to 100).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    if (obsPtr->sketchRef == NULL)
+    {
+        return NAN;
+    }
+
+    CompleteRestore(obsPtr);
+
+    // This only works for numeric or Boolean type data.
+    if (   (obsPtr->bufferedType != IO_DATA_TYPE_NUMERIC)
+        && (obsPtr->bufferedType != IO_DATA_TYPE_BOOLEAN)  )
+    {
+        return NAN;
+    }
+
+    SyncQuantileSketch(obsPtr, obsPtr->oldestSeq + obsPtr->count);
+
+    if (!isnan(startTime))
+    {
+        startTime = GetAbsoluteStartTime(startTime);
+    }
+
+    return quantile_Estimate(obsPtr->sketchRef, startTime, percentile / 100);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fetch the counts in each bucket of an Observation's histogram.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_NOT_FOUND if the Observation doesn't keep a histogram.
+ *  - LE_OVERFLOW if the array is too small to hold all the counts.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t obs_QueryHistogram
+(
+    res_Resource_t* resPtr,    ///< Ptr to Observation resource.
+    uint64_t* countsPtr,    ///< [OUT] Number of values in each bucket, lowest bucket first.
+    size_t* countsSizePtr   ///< [INOUT] Room in the array, then number of buckets.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Observation_t* obsPtr = CONTAINER_OF(resPtr, Observation_t, resource);
+
+    if (obsPtr->histogramRef == NULL)
+    {
+        *countsSizePtr = 0;
+        return LE_NOT_FOUND;
+    }
+
+    return histogram_GetCounts(obsPtr->histogramRef, countsPtr, countsSizePtr);
+}
+
+
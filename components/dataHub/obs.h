@@ -24,10 +24,34 @@ typedef enum
     OBS_TRANSFORM_TYPE_STDDEV,
     OBS_TRANSFORM_TYPE_MAX,
     OBS_TRANSFORM_TYPE_MIN,
+    OBS_TRANSFORM_TYPE_MOVING_MEAN,
+    OBS_TRANSFORM_TYPE_MOVING_STDDEV,
+    OBS_TRANSFORM_TYPE_MOVING_MAX,
+    OBS_TRANSFORM_TYPE_MOVING_MIN,
+    OBS_TRANSFORM_TYPE_EWMA,
+    OBS_TRANSFORM_TYPE_RATE,
 }
 obs_TransformType_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enumeration of all the supported tumbling window aggregation types for observations.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    OBS_AGGREGATION_TYPE_NONE = 0,
+    OBS_AGGREGATION_TYPE_MEAN,
+    OBS_AGGREGATION_TYPE_MIN,
+    OBS_AGGREGATION_TYPE_MAX,
+    OBS_AGGREGATION_TYPE_COUNT,
+    OBS_AGGREGATION_TYPE_LAST,
+    OBS_AGGREGATION_TYPE_HISTOGRAM,
+}
+obs_AggregationType_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the Observation module.
@@ -245,6 +269,8 @@ double obs_GetChangeBy
  * transform
  *
  * Ignored for all non-numeric types except Boolean for which non-zero = true and zero = false.
+ *
+ * Invalid transform types or parameters are logged and ignored.
  */
 //--------------------------------------------------------------------------------------------------
 void obs_SetTransform
@@ -269,6 +295,54 @@ obs_TransformType_t obs_GetTransform
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set an Observation to aggregate the samples it accepts over fixed-length (tumbling) windows
+ * of wall-clock time.  The Observation's value is only updated at the end of each window.
+ *
+ * Invalid settings are logged and ignored.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_SetAggregation
+(
+    res_Resource_t* resPtr,
+    obs_AggregationType_t aggregationType,
+    double period   ///< Length of the aggregation windows (seconds).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the type of aggregation currently applied to an Observation.
+ *
+ * @return The aggregation type.
+ */
+//--------------------------------------------------------------------------------------------------
+obs_AggregationType_t obs_GetAggregation
+(
+    res_Resource_t* resPtr,
+    double* periodPtr   ///< [OUT] Length of the aggregation windows (seconds, 0 if none).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an accepted sample to an Observation's current aggregation window, if it is aggregating.
+ *
+ * @return true if the sample was added to the window (and so must not update the Observation's
+ *         value), false if the Observation isn't aggregating.
+ *
+ * @note Does not take ownership of the sample reference.
+ */
+//--------------------------------------------------------------------------------------------------
+bool obs_Aggregate
+(
+    res_Resource_t* resPtr,
+    io_DataType_t dataType,
+    dataSample_Ref_t sampleRef
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the maximum number of data samples to buffer in a given Observation.  Buffers are FIFO
@@ -295,6 +369,63 @@ uint32_t obs_GetBufferMaxCount
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set whether a given Observation's numeric data samples should be buffered compressed.
+ * Compressed samples take much less memory (often only a few bits each), but reading or querying
+ * the buffer means decoding them.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_SetBufferCompression
+(
+    res_Resource_t* resPtr,
+    bool compress
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a given Observation's numeric data samples are set to be buffered compressed.
+ * See admin_SetBufferCompression() for more information.
+ *
+ * @return true if they are.
+ */
+//--------------------------------------------------------------------------------------------------
+bool obs_GetBufferCompression
+(
+    res_Resource_t* resPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set whether a given Observation's trigger, Boolean and numeric data samples should be buffered in
+ * a memory-mapped file.  See admin_SetBufferPersistence() for more information.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_SetBufferPersistence
+(
+    res_Resource_t* resPtr,
+    bool persist,
+    uint32_t syncPeriod ///< Minimum number of seconds between syncs (0 = leave it to the OS).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a given Observation's buffer is set to be kept in a memory-mapped file.
+ * See admin_SetBufferPersistence() for more information.
+ *
+ * @return true if it is.
+ */
+//--------------------------------------------------------------------------------------------------
+bool obs_GetBufferPersistence
+(
+    res_Resource_t* resPtr,
+    uint32_t* syncPeriodPtr ///< [OUT] Minimum number of seconds between syncs.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the minimum time between backups of an Observation's buffer to non-volatile storage.
@@ -325,6 +456,89 @@ uint32_t obs_GetBufferBackupPeriod
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set up a rollup tier of an Observation.  See admin_SetRollupTier() for more information.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_SetRollupTier
+(
+    res_Resource_t* resPtr,
+    uint32_t tier,      ///< Tier number (0 = finest).
+    double period,      ///< Length of each bucket's period (seconds).
+    uint32_t maxCount   ///< Number of buckets to keep (0 = remove this tier and all coarser ones).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the settings of a rollup tier of an Observation.
+ *
+ * @return The number of buckets kept in the tier, or 0 if the tier is not set.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t obs_GetRollupTier
+(
+    res_Resource_t* resPtr,
+    uint32_t tier,      ///< Tier number (0 = finest).
+    double* periodPtr   ///< [OUT] Length of each bucket's period (seconds), or NAN if not set.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the size of an Observation's quantile sketch.  See admin_SetQuantileSketch() for more
+ * information.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_SetQuantileSketch
+(
+    res_Resource_t* resPtr,
+    uint32_t size       ///< Number of centroids per segment (0 = don't keep a sketch).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the size of an Observation's quantile sketch.
+ *
+ * @return The number of centroids each segment of the sketch is compressed down to, or 0 if no
+ *         sketch is kept.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t obs_GetQuantileSketch
+(
+    res_Resource_t* resPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the bucket boundaries of an Observation's histogram.  See admin_SetHistogram() for more
+ * information.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_SetHistogram
+(
+    res_Resource_t* resPtr,
+    const double* boundsPtr,    ///< Bucket boundaries, in increasing order.
+    size_t boundsSize           ///< Number of boundaries (0 = don't keep a histogram).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the bucket boundaries of an Observation's histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_GetHistogram
+(
+    res_Resource_t* resPtr,
+    double* boundsPtr,      ///< [OUT] Bucket boundaries, in increasing order.
+    size_t* boundsSizePtr   ///< [INOUT] Room in the array, then number of boundaries (0 if none).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Delete buffer backup files that aren't being used.
@@ -359,11 +573,118 @@ void obs_ReadBufferJson
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read data out of a buffer.  Data is written to a given file descriptor in a packed binary format:
+ * a header giving the data type, followed by a record for each sample.
+ * See query_ReadBufferBinary() for details.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_ReadBufferBinary
+(
+    res_Resource_t* resPtr, ///< Ptr to the resource object for the Observation.
+    double startAfter,  ///< Start after this many seconds ago, or after an absolute number of
+                        ///< seconds since the Epoch (if startafter > 30 years).
+                        ///< Use NAN (not a number) to read the whole buffer.
+    int outputFile, ///< File descriptor to write the data to.
+    query_ReadCompletionFunc_t handlerPtr, ///< Completion callback.
+    void* contextPtr    ///< Value to be passed to completion callback.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a read cursor on an Observation's buffer, so the buffered samples newer than a given time
+ * can be read a batch at a time, with each batch carrying on from where the last one left off.
+ *
+ * @return Reference to the cursor.  Must be closed using obs_CloseReadCursor().
+ */
+//--------------------------------------------------------------------------------------------------
+obs_ReadCursorRef_t obs_OpenReadCursor
+(
+    res_Resource_t* resPtr, ///< Ptr to the resource object for the Observation.
+    double startAfter   ///< Start after this many seconds ago, or after an absolute number of
+                        ///< seconds since the Epoch (if startafter > 30 years).
+                        ///< Use NAN (not a number) to read the whole buffer.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a read cursor.
+ */
+//--------------------------------------------------------------------------------------------------
+void obs_CloseReadCursor
+(
+    obs_ReadCursorRef_t cursorRef
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of Boolean samples through a read cursor.
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).
+ *  - LE_FORMAT_ERROR if the buffered samples aren't Boolean.
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t obs_ReadCursorBoolean
+(
+    obs_ReadCursorRef_t cursorRef,
+    double* timestampsPtr,  ///< [OUT] Array to store the timestamps in.
+    bool* valuesPtr,        ///< [OUT] Array to store the values in.
+    size_t* countPtr        ///< [INOUT] Size of the arrays / number of samples read.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of numeric samples through a read cursor.
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).
+ *  - LE_FORMAT_ERROR if the buffered samples aren't numeric.
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t obs_ReadCursorNumeric
+(
+    obs_ReadCursorRef_t cursorRef,
+    double* timestampsPtr,  ///< [OUT] Array to store the timestamps in.
+    double* valuesPtr,      ///< [OUT] Array to store the values in.
+    size_t* countPtr        ///< [INOUT] Size of the arrays / number of samples read.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of samples (of any data type) through a read cursor, as a JSON array of as
+ * many samples as fit in a given buffer, in the same format as obs_ReadBufferJson().
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).  The buffer holds an empty array.
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t obs_ReadCursorJson
+(
+    obs_ReadCursorRef_t cursorRef,
+    char* buffPtr,      ///< [OUT] Ptr to buffer where the JSON array will be stored.
+    size_t buffSize     ///< [IN] Size of the buffer, in bytes (at least 3).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Find the oldest data sample in a given Observation's buffer that is newer than a given timestamp.
  *
- * @return Reference to the sample, or NULL if not found in buffer.
+ * @return Reference to the sample, or NULL if not found in buffer.  The caller is responsible for
+ *         releasing the reference.
  */
 //--------------------------------------------------------------------------------------------------
 dataSample_Ref_t obs_FindBufferedSampleAfter
@@ -470,4 +791,58 @@ double obs_QueryStdDev
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the count, minimum, maximum, mean and standard deviation of all values found within a given
+ * time span in an Observation's data set, along with the time span they cover.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_NOT_FOUND if there are no values in the time span.
+ *  - LE_FORMAT_ERROR if the Observation's data set isn't numerical.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t obs_QueryStats
+(
+    res_Resource_t* resPtr,    ///< Ptr to Observation resource.
+    double startTime,   ///< If < 30 years then seconds before now; else seconds since the Epoch.
+    obs_Stats_t* statsPtr   ///< [OUT] The aggregates (count 0 and NANs unless LE_OK).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Estimate a percentile of the values found within a given time span in an Observation's buffer,
+ * using its quantile sketch.
+ *
+ * @return The value, or NAN (not-a-number) if the Observation doesn't keep a quantile sketch or
+ *         there's no numerical data in its buffer within the time span.
+ */
+//--------------------------------------------------------------------------------------------------
+double obs_QueryPercentile
+(
+    res_Resource_t* resPtr,    ///< Ptr to Observation resource.
+    double startTime,   ///< If < 30 years then seconds before now; else seconds since the Epoch.
+    double percentile   ///< Percentile (0 to 100).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fetch the counts in each bucket of an Observation's histogram.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_NOT_FOUND if the Observation doesn't keep a histogram.
+ *  - LE_OVERFLOW if the array is too small to hold all the counts.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t obs_QueryHistogram
+(
+    res_Resource_t* resPtr,    ///< Ptr to Observation resource.
+    uint64_t* countsPtr,    ///< [OUT] Number of values in each bucket, lowest bucket first.
+    size_t* countsSizePtr   ///< [INOUT] Room in the array, then number of buckets.
+);
+
+
 #endif // OBS_H_INCLUDE_GUARD
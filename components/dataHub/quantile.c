@@ -0,0 +1,556 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file quantile.c
+ *
+ * Implementation of the Quantile Sketch module.
+ *
+ * A sketch is a simplified merging t-digest: clusters of nearby values (centroids) are merged more
+ * readily in the middle of the distribution than at its tails, so that extreme quantiles stay
+ * accurate.  So that values can leave the sketch again, it is split into a ring of segments, each
+ * covering a fixed run of sequence numbers.  A segment is dropped once all its values are no
+ * longer wanted, and the segments are only merged to answer a query.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "quantile.h"
+
+
+/// Number of segments in a quantile sketch.  The values wanted span all but one of them, so up to
+/// one segment's worth of values that are no longer wanted can still be counted by the sketch.
+#define SEGMENT_COUNT 8
+
+
+/// Centroid of a quantile sketch: a cluster of nearby values, represented by their mean.
+typedef struct
+{
+    double mean;        ///< Mean of the values.
+    double weight;      ///< Number of values.
+}
+Centroid_t;
+
+
+/// Segment of a quantile sketch, covering a run of consecutive sequence numbers.
+typedef struct
+{
+    uint64_t endSeq;    ///< Sequence number of the first value belonging to the next segment.
+    uint64_t lastSeq;   ///< Sequence number of the newest value in the segment.
+    double lastTimestamp; ///< Timestamp of the newest value in the segment.
+    double count;       ///< Number of values.
+    double min;         ///< Smallest value.
+    double max;         ///< Largest value.
+    size_t centroidCount; ///< Number of centroids in use.
+    Centroid_t* centroidPtr; ///< Room for twice the sketch's size in centroids (unsorted).
+}
+Segment_t;
+
+
+/// Quantile sketch.  Allocated from the Sketch Pool.
+typedef struct quantile_Sketch
+{
+    size_t size;        ///< Number of centroids each segment is compressed down to.
+    uint64_t nextSeq;   ///< Sequence number of the next value the sketch expects.
+    size_t oldestIndex; ///< Index into segments of the oldest segment.
+    size_t count;       ///< Number of segments in use.
+    Segment_t segments[SEGMENT_COUNT]; ///< Ring of segments, oldest first.
+    Centroid_t* centroidPtr; ///< Storage for all the segments' centroids.
+    Centroid_t* mergedPtr;   ///< Room to merge all the segments' centroids to answer a query.
+}
+Sketch_t;
+
+
+/// Pool of Quantile Sketch objects.
+static le_mem_PoolRef_t SketchPool = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare two quantile sketch centroids by their means.  For use with qsort().
+ *
+ * @return Negative, zero or positive, like strcmp().
+ */
+//--------------------------------------------------------------------------------------------------
+static int CompareCentroids
+(
+    const void* aPtr,
+    const void* bPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    double a = ((const Centroid_t*)aPtr)->mean;
+    double b = ((const Centroid_t*)bPtr)->mean;
+
+    return ((a > b) - (a < b));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sort a set of centroids and merge neighbouring ones until there are no more than a given number
+ * of them.  Centroids near the tails of the distribution are kept smaller than the ones in the
+ * middle, so that extreme percentiles stay accurate.
+ *
+ * @return The number of centroids left.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t CompressCentroids
+(
+    Centroid_t* centroidPtr,
+    size_t count,       ///< Number of centroids.
+    size_t maxCount     ///< Number of centroids to compress them down to (> 0).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    qsort(centroidPtr, count, sizeof(Centroid_t), CompareCentroids);
+
+    double total = 0;
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        total += centroidPtr[i].weight;
+    }
+
+    // A centroid covering the quantiles around q may hold up to 4 * total * q * (1 - q) / delta
+    // values.  If that leaves too many centroids, go around again with a smaller delta.
+    double delta = maxCount / 2.0;
+    while (count > maxCount)
+    {
+        size_t last = 0;
+        double cumulative = 0;
+
+        for (i = 1; i < count; i++)
+        {
+            double weight = centroidPtr[last].weight + centroidPtr[i].weight;
+            double q = (cumulative + (weight / 2)) / total;
+
+            if (weight <= (4 * total * q * (1 - q) / delta))
+            {
+                centroidPtr[last].mean += (centroidPtr[i].mean - centroidPtr[last].mean)
+                                          * centroidPtr[i].weight / weight;
+                centroidPtr[last].weight = weight;
+            }
+            else
+            {
+                cumulative += centroidPtr[last].weight;
+                last++;
+                centroidPtr[last] = centroidPtr[i];
+            }
+        }
+
+        count = last + 1;
+        delta /= 2;
+    }
+
+    return count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a pointer to a segment of a quantile sketch.
+ *
+ * @return Pointer to the segment.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline Segment_t* GetSegment
+(
+    Sketch_t* sketchPtr,
+    size_t offset   ///< Position of the segment relative to the oldest (0 = oldest).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return &sketchPtr->segments[(sketchPtr->oldestIndex + offset) % SEGMENT_COUNT];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the oldest segment of a quantile sketch.  The sketch must have at least one segment.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DropOldestSegment
+(
+    Sketch_t* sketchPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    sketchPtr->oldestIndex = (sketchPtr->oldestIndex + 1) % SEGMENT_COUNT;
+    (sketchPtr->count)--;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Estimate a quantile from a sorted set of centroids, by interpolating between the centroids'
+ * means (taken to lie at the middle of the ranks they cover) and the extreme values.
+ *
+ * @return The value.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetCentroidQuantile
+(
+    const Centroid_t* centroidPtr,
+    size_t count,       ///< Number of centroids (> 0).
+    double total,       ///< Total weight of the centroids.
+    double min,         ///< Smallest value.
+    double max,         ///< Largest value.
+    double q            ///< Quantile (0 to 1).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    double rank = q * total;
+    double prevRank = 0;
+    double prevValue = min;
+    double cumulative = 0;
+
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        double centre = cumulative + (centroidPtr[i].weight / 2);
+
+        if (rank < centre)
+        {
+            return prevValue + ((centroidPtr[i].mean - prevValue) * (rank - prevRank)
+                                / (centre - prevRank));
+        }
+
+        prevRank = centre;
+        prevValue = centroidPtr[i].mean;
+        cumulative += centroidPtr[i].weight;
+    }
+
+    if (total > prevRank)
+    {
+        return prevValue + ((max - prevValue) * (rank - prevRank) / (total - prevRank));
+    }
+
+    return max;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Quantile Sketch module.
+ *
+ * @warning This function must be called before any others in this module.
+ */
+//--------------------------------------------------------------------------------------------------
+void quantile_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    SketchPool = le_mem_CreatePool("Quantile Sketch", sizeof(Sketch_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an empty quantile sketch.
+ *
+ * @return Reference to the sketch, or NULL if its centroids could not be allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+quantile_SketchRef_t quantile_CreateSketch
+(
+    size_t size     ///< Number of centroids each segment is compressed down to (> 0).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Each segment has room for twice its size, so it is only compressed every size values.
+    size_t segmentCapacity = 2 * size;
+
+    Sketch_t* sketchPtr = le_mem_ForceAlloc(SketchPool);
+    memset(sketchPtr, 0, sizeof(*sketchPtr));
+
+    sketchPtr->size = size;
+    sketchPtr->centroidPtr = calloc(SEGMENT_COUNT * segmentCapacity, sizeof(Centroid_t));
+    sketchPtr->mergedPtr = calloc(SEGMENT_COUNT * segmentCapacity, sizeof(Centroid_t));
+    if ((sketchPtr->centroidPtr == NULL) || (sketchPtr->mergedPtr == NULL))
+    {
+        LE_CRIT("Failed to allocate quantile sketch of size %zu.", size);
+        free(sketchPtr->centroidPtr);
+        free(sketchPtr->mergedPtr);
+        le_mem_Release(sketchPtr);
+        return NULL;
+    }
+
+    size_t i;
+    for (i = 0; i < SEGMENT_COUNT; i++)
+    {
+        sketchPtr->segments[i].centroidPtr = &sketchPtr->centroidPtr[i * segmentCapacity];
+    }
+
+    return sketchPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a quantile sketch.
+ */
+//--------------------------------------------------------------------------------------------------
+void quantile_DeleteSketch
+(
+    quantile_SketchRef_t sketchRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    free(sketchRef->centroidPtr);
+    free(sketchRef->mergedPtr);
+    le_mem_Release(sketchRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the size of a quantile sketch.
+ *
+ * @return The number of centroids each segment of the sketch is compressed down to.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t quantile_GetSize
+(
+    quantile_SketchRef_t sketchRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return sketchRef->size;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Empty a quantile sketch, and set the sequence number of the next value it expects to 0.
+ */
+//--------------------------------------------------------------------------------------------------
+void quantile_ResetSketch
+(
+    quantile_SketchRef_t sketchRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    sketchRef->nextSeq = 0;
+    sketchRef->oldestIndex = 0;
+    sketchRef->count = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the sequence number of the next value a quantile sketch expects.  Values with lower
+ * sequence numbers have already been added to the sketch (or skipped).
+ *
+ * @return The sequence number.
+ */
+//--------------------------------------------------------------------------------------------------
+uint64_t quantile_GetNextSeq
+(
+    quantile_SketchRef_t sketchRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return sketchRef->nextSeq;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the sequence number of the next value a quantile sketch expects.
+ */
+//--------------------------------------------------------------------------------------------------
+void quantile_SetNextSeq
+(
+    quantile_SketchRef_t sketchRef,
+    uint64_t nextSeq
+)
+//--------------------------------------------------------------------------------------------------
+{
+    sketchRef->nextSeq = nextSeq;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the segments of a quantile sketch whose values all have sequence numbers lower than a
+ * given one.
+ */
+//--------------------------------------------------------------------------------------------------
+void quantile_DropBefore
+(
+    quantile_SketchRef_t sketchRef,
+    uint64_t oldestSeq  ///< Sequence number of the oldest value still wanted.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    while ((sketchRef->count > 0) && (GetSegment(sketchRef, 0)->lastSeq < oldestSeq))
+    {
+        DropOldestSegment(sketchRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a value to a quantile sketch.  Values must be added in sequence number order.
+ */
+//--------------------------------------------------------------------------------------------------
+void quantile_Add
+(
+    quantile_SketchRef_t sketchRef,
+    size_t maxCount,    ///< Number of sequence numbers the sketch should span (buffer size).
+    uint64_t seq,       ///< Sequence number of the value.
+    double timestamp,
+    double value        ///< The (non-NAN) value.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Sketch_t* sketchPtr = sketchRef;
+    Segment_t* segPtr = NULL;
+
+    if (sketchPtr->count > 0)
+    {
+        segPtr = GetSegment(sketchPtr, sketchPtr->count - 1);
+
+        if (seq >= segPtr->endSeq)
+        {
+            segPtr = NULL;
+        }
+    }
+
+    if (segPtr == NULL)
+    {
+        // If the span has grown, the segments (sized for the old span) may run out.  Then the
+        // oldest one is merged into the next.
+        if (sketchPtr->count == SEGMENT_COUNT)
+        {
+            Segment_t* oldestPtr = GetSegment(sketchPtr, 0);
+            Segment_t* nextPtr = GetSegment(sketchPtr, 1);
+
+            oldestPtr->centroidCount = CompressCentroids(oldestPtr->centroidPtr,
+                                                         oldestPtr->centroidCount,
+                                                         sketchPtr->size);
+            nextPtr->centroidCount = CompressCentroids(nextPtr->centroidPtr,
+                                                       nextPtr->centroidCount,
+                                                       sketchPtr->size);
+            memcpy(&nextPtr->centroidPtr[nextPtr->centroidCount],
+                   oldestPtr->centroidPtr,
+                   oldestPtr->centroidCount * sizeof(Centroid_t));
+            nextPtr->centroidCount += oldestPtr->centroidCount;
+            nextPtr->count += oldestPtr->count;
+            if (oldestPtr->min < nextPtr->min)
+            {
+                nextPtr->min = oldestPtr->min;
+            }
+            if (oldestPtr->max > nextPtr->max)
+            {
+                nextPtr->max = oldestPtr->max;
+            }
+
+            DropOldestSegment(sketchPtr);
+        }
+
+        // Segments start at multiples of the number of sequence numbers each covers.
+        uint64_t seqsPerSegment = (maxCount + SEGMENT_COUNT - 2) / (SEGMENT_COUNT - 1);
+        if (seqsPerSegment == 0)
+        {
+            seqsPerSegment = 1;
+        }
+
+        segPtr = GetSegment(sketchPtr, sketchPtr->count);
+        (sketchPtr->count)++;
+
+        segPtr->endSeq = ((seq / seqsPerSegment) + 1) * seqsPerSegment;
+        segPtr->count = 0;
+        segPtr->min = value;
+        segPtr->max = value;
+        segPtr->centroidCount = 0;
+    }
+    else if (value < segPtr->min)
+    {
+        segPtr->min = value;
+    }
+    else if (value > segPtr->max)
+    {
+        segPtr->max = value;
+    }
+
+    if (segPtr->centroidCount == (2 * sketchPtr->size))
+    {
+        segPtr->centroidCount = CompressCentroids(segPtr->centroidPtr,
+                                                  segPtr->centroidCount,
+                                                  sketchPtr->size);
+    }
+
+    segPtr->centroidPtr[segPtr->centroidCount].mean = value;
+    segPtr->centroidPtr[segPtr->centroidCount].weight = 1;
+    (segPtr->centroidCount)++;
+    (segPtr->count)++;
+    segPtr->lastSeq = seq;
+    segPtr->lastTimestamp = timestamp;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Estimate a quantile of the values in a quantile sketch that were received no earlier than a
+ * given time.  The segments of the sketch are only included or excluded as a whole, so values
+ * received up to one segment before the start time may be included.
+ *
+ * @return The value, or NAN (not-a-number) if the sketch has no values within the time span.
+ */
+//--------------------------------------------------------------------------------------------------
+double quantile_Estimate
+(
+    quantile_SketchRef_t sketchRef,
+    double startTime,   ///< Seconds since the Epoch (NAN = all values).
+    double q            ///< Quantile (0 to 1).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Sketch_t* sketchPtr = sketchRef;
+
+    // Merge the centroids of the segments that have values newer than the start time.
+    size_t count = 0;
+    double total = 0;
+    double min = NAN;
+    double max = NAN;
+
+    size_t i;
+    for (i = 0; i < sketchPtr->count; i++)
+    {
+        Segment_t* segPtr = GetSegment(sketchPtr, i);
+
+        if (segPtr->lastTimestamp < startTime)
+        {
+            continue;
+        }
+
+        memcpy(&sketchPtr->mergedPtr[count],
+               segPtr->centroidPtr,
+               segPtr->centroidCount * sizeof(Centroid_t));
+        count += segPtr->centroidCount;
+        total += segPtr->count;
+
+        if (isnan(min) || (segPtr->min < min))
+        {
+            min = segPtr->min;
+        }
+        if (isnan(max) || (segPtr->max > max))
+        {
+            max = segPtr->max;
+        }
+    }
+
+    if (count == 0)
+    {
+        return NAN;
+    }
+
+    qsort(sketchPtr->mergedPtr, count, sizeof(Centroid_t), CompareCentroids);
+
+    return GetCentroidQuantile(sketchPtr->mergedPtr, count, total, min, max, q);
+}
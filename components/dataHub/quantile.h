@@ -0,0 +1,159 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file quantile.h
+ *
+ * Interface to the Quantile Sketch module, which estimates quantiles of a stream of numerical
+ * values (such as the values in an Observation's data sample buffer) without keeping them all.
+ *
+ * Values are added to a sketch in sequence number order, and can be dropped again (a segment of
+ * the sketch at a time) once the values with older sequence numbers are no longer wanted.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef QUANTILE_H_INCLUDE_GUARD
+#define QUANTILE_H_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a Quantile Sketch.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct quantile_Sketch* quantile_SketchRef_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Quantile Sketch module.
+ *
+ * @warning This function must be called before any others in this module.
+ */
+//--------------------------------------------------------------------------------------------------
+void quantile_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an empty quantile sketch.
+ *
+ * @return Reference to the sketch, or NULL if its centroids could not be allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+quantile_SketchRef_t quantile_CreateSketch
+(
+    size_t size     ///< Number of centroids each segment is compressed down to (> 0).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a quantile sketch.
+ */
+//--------------------------------------------------------------------------------------------------
+void quantile_DeleteSketch
+(
+    quantile_SketchRef_t sketchRef
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the size of a quantile sketch.
+ *
+ * @return The number of centroids each segment of the sketch is compressed down to.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t quantile_GetSize
+(
+    quantile_SketchRef_t sketchRef
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Empty a quantile sketch, and set the sequence number of the next value it expects to 0.
+ */
+//--------------------------------------------------------------------------------------------------
+void quantile_ResetSketch
+(
+    quantile_SketchRef_t sketchRef
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the sequence number of the next value a quantile sketch expects.  Values with lower
+ * sequence numbers have already been added to the sketch (or skipped).
+ *
+ * @return The sequence number.
+ */
+//--------------------------------------------------------------------------------------------------
+uint64_t quantile_GetNextSeq
+(
+    quantile_SketchRef_t sketchRef
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the sequence number of the next value a quantile sketch expects.
+ */
+//--------------------------------------------------------------------------------------------------
+void quantile_SetNextSeq
+(
+    quantile_SketchRef_t sketchRef,
+    uint64_t nextSeq
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the segments of a quantile sketch whose values all have sequence numbers lower than a
+ * given one.
+ */
+//--------------------------------------------------------------------------------------------------
+void quantile_DropBefore
+(
+    quantile_SketchRef_t sketchRef,
+    uint64_t oldestSeq  ///< Sequence number of the oldest value still wanted.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a value to a quantile sketch.  Values must be added in sequence number order.
+ */
+//--------------------------------------------------------------------------------------------------
+void quantile_Add
+(
+    quantile_SketchRef_t sketchRef,
+    size_t maxCount,    ///< Number of sequence numbers the sketch should span (buffer size).
+    uint64_t seq,       ///< Sequence number of the value.
+    double timestamp,
+    double value        ///< The (non-NAN) value.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Estimate a quantile of the values in a quantile sketch that were received no earlier than a
+ * given time.  The segments of the sketch are only included or excluded as a whole, so values
+ * received up to one segment before the start time may be included.
+ *
+ * @return The value, or NAN (not-a-number) if the sketch has no values within the time span.
+ */
+//--------------------------------------------------------------------------------------------------
+double quantile_Estimate
+(
+    quantile_SketchRef_t sketchRef,
+    double startTime,   ///< Seconds since the Epoch (NAN = all values).
+    double q            ///< Quantile (0 to 1).
+);
+
+
+#endif // QUANTILE_H_INCLUDE_GUARD
@@ -8,6 +8,48 @@
 
 #include "dataHub.h"
 #include "handler.h"
+#include "queryService.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Buffer cursor opened by a client through the Query API.
+ *
+ * These are allocated from the BufferCursorPool.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t link; ///< Used to link into the BufferCursorList.
+    query_BufferCursorRef_t safeRef; ///< Safe reference passed to the client.
+    le_msg_SessionRef_t sessionRef; ///< IPC session of the client that opened the cursor.
+    obs_ReadCursorRef_t readCursorRef; ///< Read cursor on the Observation's buffer.
+}
+BufferCursor_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of open buffer cursors.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t BufferCursorList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of BufferCursor objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t BufferCursorPool = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Safe reference map for BufferCursor objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_ref_MapRef_t BufferCursorRefMap = NULL;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -112,6 +154,66 @@ le_result_t query_ReadBufferJson
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read data out of a buffer in a packed binary format, which is much cheaper to produce and to
+ * parse than JSON.  Data is written to a given file descriptor as an 8-byte header followed by a
+ * record for each sample, all in the native byte order of the Data Hub's host, without padding:
+ *  - header: uint32 magic number 0x52424844 ("DHBR" in little-endian byte order), uint8 format
+ *    version (0), uint8 data type of the samples (io_DataType_t), then two zero bytes.
+ *  - trigger record: double timestamp.
+ *  - Boolean record: double timestamp, then uint8 value (0 or 1).
+ *  - numeric record: double timestamp, then double value.
+ *  - string or JSON record: double timestamp, uint32 length, then that many bytes of the value
+ *    (without a null terminator).
+ *
+ * Timestamps are in seconds since the Epoch, with full precision.  If the data type of the
+ * Observation's samples changes during the read, the read ends early, as the buffered samples of
+ * the type given in the header are discarded.
+ *
+ * @return
+ *  - LE_OK if the read operation started successfully.
+ *  - LE_NOT_FOUND if the Observation doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t query_ReadBufferBinary
+(
+    const char* obsPath,
+        ///< [IN] Observation path. Can be absolute
+        ///< (beginning with a '/') or relative to /obs/.
+    double startAfter,
+        ///< [IN] Start after this many seconds ago,
+        ///< or after an absolute number of seconds since the Epoch
+        ///< (if startafter > 30 years).
+        ///< Use NAN (not a number) to read the whole buffer.
+    int outputFile,
+        ///< [IN] File descriptor to write the data to.
+    query_ReadCompletionFunc_t completionFuncPtr,
+        ///< [IN] Completion callback to be called when operation finishes.
+    void* contextPtr
+        ///< [IN]
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t entryRef = FindObservation(obsPath);
+
+    if (entryRef == NULL)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    if (startAfter < 0)
+    {
+        LE_KILL_CLIENT("Negative startAfter time provided (%lf).", startAfter);
+        return LE_OK;   // Doesn't matter what we return.
+    }
+
+    resTree_ReadBufferBinary(entryRef, startAfter, outputFile, completionFuncPtr, contextPtr);
+
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Read the timestamp of a single sample from a buffer.
@@ -161,6 +263,8 @@ le_result_t query_ReadBufferSampleTimestamp
 
     *timestampPtr = dataSample_GetTimestamp(sample);
 
+    le_mem_Release(sample);
+
     return LE_OK;
 }
 
@@ -222,6 +326,8 @@ le_result_t query_ReadBufferSampleBoolean
     *timestampPtr = dataSample_GetTimestamp(sample);
     *valuePtr = dataSample_GetBoolean(sample);
 
+    le_mem_Release(sample);
+
     return LE_OK;
 }
 
@@ -283,6 +389,8 @@ le_result_t query_ReadBufferSampleNumeric
     *timestampPtr = dataSample_GetTimestamp(sample);
     *valuePtr = dataSample_GetNumeric(sample);
 
+    le_mem_Release(sample);
+
     return LE_OK;
 }
 
@@ -341,7 +449,14 @@ le_result_t query_ReadBufferSampleString
 
     *timestampPtr = dataSample_GetTimestamp(sample);
 
-    return dataSample_ConvertToString(sample, resTree_GetDataType(entryRef), value, valueSize);
+    le_result_t result = dataSample_ConvertToString(sample,
+                                                    resTree_GetDataType(entryRef),
+                                                    value,
+                                                    valueSize);
+
+    le_mem_Release(sample);
+
+    return result;
 }
 
 
@@ -400,7 +515,274 @@ le_result_t query_ReadBufferSampleJson
 
     *timestampPtr = dataSample_GetTimestamp(sample);
 
-    return dataSample_ConvertToJson(sample, resTree_GetDataType(entryRef), value, valueSize);
+    le_result_t result = dataSample_ConvertToJson(sample,
+                                                  resTree_GetDataType(entryRef),
+                                                  value,
+                                                  valueSize);
+
+    le_mem_Release(sample);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a cursor on an Observation's buffer, to read the samples newer than a given time a batch at
+ * a time.
+ *
+ * @return Reference to the cursor, or NULL if the Observation doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+query_BufferCursorRef_t query_OpenBufferCursor
+(
+    const char* obsPath,
+        ///< [IN] Observation path. Can be absolute
+        ///< (beginning with a '/') or relative to /obs/.
+    double startAfter
+        ///< [IN] Start after this many seconds ago,
+        ///< or after an absolute number of seconds since the Epoch
+        ///< (if startafter > 30 years).
+        ///< Use NAN (not a number) to read the whole buffer.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t entryRef = FindObservation(obsPath);
+
+    if (entryRef == NULL)
+    {
+        return NULL;
+    }
+
+    if (startAfter < 0)
+    {
+        LE_KILL_CLIENT("Negative startAfter time provided (%lf).", startAfter);
+        return NULL;
+    }
+
+    BufferCursor_t* cursorPtr = le_mem_ForceAlloc(BufferCursorPool);
+
+    cursorPtr->link = LE_DLS_LINK_INIT;
+    cursorPtr->safeRef = le_ref_CreateRef(BufferCursorRefMap, cursorPtr);
+    cursorPtr->sessionRef = query_GetClientSessionRef();
+    cursorPtr->readCursorRef = resTree_OpenReadCursor(entryRef, startAfter);
+
+    le_dls_Queue(&BufferCursorList, &cursorPtr->link);
+
+    return cursorPtr->safeRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look up a buffer cursor opened by the client.  Kills the client if the reference is invalid.
+ *
+ * @return Ptr to the cursor, or NULL if the reference is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static BufferCursor_t* GetBufferCursor
+(
+    query_BufferCursorRef_t cursorRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    BufferCursor_t* cursorPtr = le_ref_Lookup(BufferCursorRefMap, cursorRef);
+
+    if ((cursorPtr == NULL) || (cursorPtr->sessionRef != query_GetClientSessionRef()))
+    {
+        LE_KILL_CLIENT("Invalid buffer cursor reference %p.", cursorRef);
+        return NULL;
+    }
+
+    return cursorPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a buffer cursor and free it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteBufferCursor
+(
+    BufferCursor_t* cursorPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Remove(&BufferCursorList, &cursorPtr->link);
+
+    resTree_CloseReadCursor(cursorPtr->readCursorRef);
+
+    le_ref_DeleteRef(BufferCursorRefMap, cursorPtr->safeRef);
+
+    le_mem_Release(cursorPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a cursor opened using query_OpenBufferCursor().
+ */
+//--------------------------------------------------------------------------------------------------
+void query_CloseBufferCursor
+(
+    query_BufferCursorRef_t cursor
+        ///< [IN]
+)
+//--------------------------------------------------------------------------------------------------
+{
+    BufferCursor_t* cursorPtr = GetBufferCursor(cursor);
+
+    if (cursorPtr != NULL)
+    {
+        DeleteBufferCursor(cursorPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of Boolean samples through a buffer cursor.
+ *
+ * @warning This can only be used with Boolean type samples.
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).
+ *  - LE_FORMAT_ERROR if the buffered samples aren't Boolean.
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t query_ReadBufferCursorBoolean
+(
+    query_BufferCursorRef_t cursor,
+        ///< [IN]
+    double* timestampPtr,
+        ///< [OUT] Timestamps of the samples read.
+    size_t* timestampSizePtr,
+        ///< [INOUT]
+    bool* valuePtr,
+        ///< [OUT] Values of the samples read.
+    size_t* valueSizePtr
+        ///< [INOUT]
+)
+//--------------------------------------------------------------------------------------------------
+{
+    BufferCursor_t* cursorPtr = GetBufferCursor(cursor);
+
+    if (cursorPtr == NULL)
+    {
+        return LE_CLOSED;   // Doesn't matter what we return.
+    }
+
+    size_t count = *timestampSizePtr;
+    if (*valueSizePtr < count)
+    {
+        count = *valueSizePtr;
+    }
+
+    le_result_t result = resTree_ReadCursorBoolean(cursorPtr->readCursorRef,
+                                                   timestampPtr,
+                                                   valuePtr,
+                                                   &count);
+
+    *timestampSizePtr = count;
+    *valueSizePtr = count;
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of numeric samples through a buffer cursor.
+ *
+ * @warning This can only be used with numeric type samples.
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).
+ *  - LE_FORMAT_ERROR if the buffered samples aren't numeric.
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t query_ReadBufferCursorNumeric
+(
+    query_BufferCursorRef_t cursor,
+        ///< [IN]
+    double* timestampPtr,
+        ///< [OUT] Timestamps of the samples read.
+    size_t* timestampSizePtr,
+        ///< [INOUT]
+    double* valuePtr,
+        ///< [OUT] Values of the samples read.
+    size_t* valueSizePtr
+        ///< [INOUT]
+)
+//--------------------------------------------------------------------------------------------------
+{
+    BufferCursor_t* cursorPtr = GetBufferCursor(cursor);
+
+    if (cursorPtr == NULL)
+    {
+        return LE_CLOSED;   // Doesn't matter what we return.
+    }
+
+    size_t count = *timestampSizePtr;
+    if (*valueSizePtr < count)
+    {
+        count = *valueSizePtr;
+    }
+
+    le_result_t result = resTree_ReadCursorNumeric(cursorPtr->readCursorRef,
+                                                   timestampPtr,
+                                                   valuePtr,
+                                                   &count);
+
+    *timestampSizePtr = count;
+    *valueSizePtr = count;
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of samples through a buffer cursor, as a JSON array of as many samples as
+ * fit in the buffer provided, in the same format as query_ReadBufferJson().
+ *
+ * @note This can be used with any type of sample.
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t query_ReadBufferCursorJson
+(
+    query_BufferCursorRef_t cursor,
+        ///< [IN]
+    char* json,
+        ///< [OUT] JSON array of the samples read.
+    size_t jsonSize
+        ///< [IN]
+)
+//--------------------------------------------------------------------------------------------------
+{
+    BufferCursor_t* cursorPtr = GetBufferCursor(cursor);
+
+    if (cursorPtr == NULL)
+    {
+        return LE_CLOSED;   // Doesn't matter what we return.
+    }
+
+    if (jsonSize < 3)
+    {
+        return LE_OVERFLOW;
+    }
+
+    return resTree_ReadCursorJson(cursorPtr->readCursorRef, json, jsonSize);
 }
 
 
@@ -525,6 +907,155 @@ double query_GetStdDev
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number, minimum, maximum, mean and standard deviation of all values found within a given
+ * time span in an Observation's buffer, along with the timestamps of the oldest and newest values.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_NOT_FOUND if there's no numerical data in the time span (or no such Observation).
+ *  - LE_FORMAT_ERROR if the Observation's buffer contains data of a non-numerical type.
+ *
+ * @note On failure, the count is 0 and the other outputs are NAN (not-a-number).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t query_GetStats
+(
+    const char* obsPath,
+        ///< [IN] Observation path. Can be absolute
+        ///< (beginning with a '/') or relative to /obs/.
+    double startTime,
+        ///< [IN] If < 30 years then seconds before now; else seconds since the Epoch.
+    uint32_t* countPtr,
+        ///< [OUT] Number of values.
+    double* minPtr,
+        ///< [OUT] Smallest value.
+    double* maxPtr,
+        ///< [OUT] Largest value.
+    double* meanPtr,
+        ///< [OUT] Mean of the values.
+    double* stdDevPtr,
+        ///< [OUT] Standard deviation of the values.
+    double* firstTimestampPtr,
+        ///< [OUT] Timestamp of the oldest value (seconds since the Epoch).
+    double* lastTimestampPtr
+        ///< [OUT] Timestamp of the newest value (seconds since the Epoch).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    obs_Stats_t stats;
+    le_result_t result = LE_NOT_FOUND;
+
+    resTree_EntryRef_t entryRef = FindObservation(obsPath);
+
+    if (entryRef == NULL)
+    {
+        stats.count = 0;
+        stats.min = NAN;
+        stats.max = NAN;
+        stats.mean = NAN;
+        stats.stdDev = NAN;
+        stats.firstTimestamp = NAN;
+        stats.lastTimestamp = NAN;
+    }
+    else
+    {
+        result = resTree_QueryStats(entryRef, startTime, &stats);
+    }
+
+    *countPtr = stats.count;
+    *minPtr = stats.min;
+    *maxPtr = stats.max;
+    *meanPtr = stats.mean;
+    *stdDevPtr = stats.stdDev;
+    *firstTimestampPtr = stats.firstTimestamp;
+    *lastTimestampPtr = stats.lastTimestamp;
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Estimate a percentile of the values found within a given time span in an Observation's buffer,
+ * such as the median (50) or the 95th percentile.  The estimate comes from the Observation's
+ * quantile sketch (see admin_SetQuantileSketch()), so the buffer isn't scanned.
+ *
+ * @return The value, or NAN (not-a-number) if the Observation doesn't keep a quantile sketch or
+ *         there's no numerical data in its buffer within the time span.
+ */
+//--------------------------------------------------------------------------------------------------
+double query_GetPercentile
+(
+    const char* obsPath,
+        ///< [IN] Observation path. Can be absolute
+        ///< (beginning with a '/') or relative to /obs/.
+    double startTime,
+        ///< [IN] If < 30 years then seconds before now; else seconds since the Epoch.
+    double percentile
+        ///< [IN] Percentile (0 to 100).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t entryRef = FindObservation(obsPath);
+
+    if (entryRef == NULL)
+    {
+        return NAN;
+    }
+
+    if (!((percentile >= 0) && (percentile <= 100)))
+    {
+        LE_KILL_CLIENT("Percentile %lf out of range (0 to 100).", percentile);
+        return NAN;
+    }
+
+    return resTree_QueryPercentile(entryRef, startTime, percentile);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fetch the counts in each bucket of an Observation's histogram (see admin_SetHistogram()),
+ * lowest bucket first.  The values are counted as they arrive, so the buffer isn't scanned.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_NOT_FOUND if the Observation doesn't exist or doesn't keep a histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t query_GetHistogram
+(
+    const char* obsPath,
+        ///< [IN] Observation path. Can be absolute
+        ///< (beginning with a '/') or relative to /obs/.
+    uint64_t* countsPtr,
+        ///< [OUT] Number of values counted in each bucket.
+    size_t* countsSizePtr
+        ///< [INOUT]
+)
+//--------------------------------------------------------------------------------------------------
+{
+    resTree_EntryRef_t entryRef = FindObservation(obsPath);
+
+    if (entryRef == NULL)
+    {
+        *countsSizePtr = 0;
+        return LE_NOT_FOUND;
+    }
+
+    le_result_t result = resTree_QueryHistogram(entryRef, countsPtr, countsSizePtr);
+
+    if (result == LE_OVERFLOW)
+    {
+        LE_KILL_CLIENT("Histogram counts array too small (%zu).", *countsSizePtr);
+    }
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Find a resource at a given path.  The path can be absolute (beginning with a '/'), or relative
@@ -1217,3 +1748,54 @@ void query_RemoveJsonPushHandler
 {
     handler_Remove((hub_HandlerRef_t)handlerRef);
 }
+
+
+#ifndef UNIT_TEST
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the buffer cursors left open by a client when its session closes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SessionCloseHandler
+(
+    le_msg_SessionRef_t sessionRef,
+    void* contextPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&BufferCursorList);
+
+    while (linkPtr != NULL)
+    {
+        BufferCursor_t* cursorPtr = CONTAINER_OF(linkPtr, BufferCursor_t, link);
+
+        linkPtr = le_dls_PeekNext(&BufferCursorList, linkPtr);
+
+        if (cursorPtr->sessionRef == sessionRef)
+        {
+            DeleteBufferCursor(cursorPtr);
+        }
+    }
+}
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the module.  Must be called before any other functions in the module are called.
+ */
+//--------------------------------------------------------------------------------------------------
+void queryService_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    BufferCursorPool = le_mem_CreatePool("Buffer Cursor", sizeof(BufferCursor_t));
+
+    BufferCursorRefMap = le_ref_CreateMap("Buffer Cursor", 7);
+
+#ifndef UNIT_TEST
+    le_msg_AddServiceCloseHandler(query_GetServiceRef(), SessionCloseHandler, NULL);
+#endif
+}
@@ -25,8 +25,13 @@ typedef struct resTree_Entry
 {
     le_dls_Link_t link;  ///< Used to link into parent's list of children.
     struct resTree_Entry* parentPtr; ///< Ptr to the parent entry (NULL if the root entry).
-    char name[HUB_MAX_ENTRY_NAME_BYTES]; ///< Name of the entry.
+    atom_Ref_t name;     ///< Name of the entry (interned).
     le_dls_List_t childList;  ///< List of child entries.
+    struct resTree_Entry** childIndexPtr; ///< Hash index of the children (NULL if no children).
+    size_t childIndexSize;  ///< Number of slots in the child index (a power of 2, or 0).
+    size_t childCount;      ///< Number of children (including deleted ones not yet released).
+    char* pathPtr;          ///< Cached absolute path (NULL if not built yet).
+    size_t pathLen;         ///< Length of the cached absolute path (excluding null terminator).
     admin_EntryType_t type; ///< The type of entry.
 
     union
@@ -44,6 +49,210 @@ static Entry_t* RootPtr;
 /// Pool of Entry objects.
 static le_mem_PoolRef_t EntryPool = NULL;
 
+/// Pool of cached absolute paths of up to SHORT_PATH_BYTES (including null terminator).
+static le_mem_PoolRef_t ShortPathPool = NULL;
+
+/// Pool of cached absolute paths of up to HUB_MAX_RESOURCE_PATH_BYTES.
+/// @note This is a separate pool so that the majority case of short paths doesn't waste memory.
+static le_mem_PoolRef_t LongPathPool = NULL;
+
+/// The maximum number of bytes in a short path, including the null terminator.
+#define SHORT_PATH_BYTES 64
+
+/// Initial number of slots in an entry's child index.  The index doubles in size whenever it
+/// would become more than half full, so probe sequences stay short.
+#define MIN_CHILD_INDEX_SIZE 8
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Slot in the entry lookup cache, holding the result of a successful path lookup.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t generation;    ///< TreeGeneration when the slot was filled (0 = empty).
+    uint32_t hash;          ///< Hash of the base entry and path (see HashLookup()).
+    Entry_t* baseEntryPtr;  ///< Entry the path is relative to.
+    Entry_t* entryPtr;      ///< Entry found at the path.
+    char path[HUB_MAX_RESOURCE_PATH_BYTES]; ///< The path.
+}
+LookupCacheSlot_t;
+
+/// Number of slots in the entry lookup cache (a power of 2).
+#define LOOKUP_CACHE_SIZE 256
+
+/// Direct-mapped cache of recent path lookups, so that clients polling the same resources over
+/// and over don't have the tree walked for every call.
+static LookupCacheSlot_t LookupCache[LOOKUP_CACHE_SIZE];
+
+/// Incremented whenever an entry is added to or removed from the tree or marked deleted, which
+/// invalidates every slot in the LookupCache at once.
+static uint32_t TreeGeneration = 1;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Invalidate the entry lookup cache after a change in the shape of the tree.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TreeChanged
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    TreeGeneration++;
+
+    // If the generation count wrapped around, old slots could look valid again, so empty them.
+    if (TreeGeneration == 0)
+    {
+        memset(LookupCache, 0, sizeof(LookupCache));
+        TreeGeneration = 1;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the entry lookup cache hash of a path relative to a given base entry.
+ *
+ * @return The hash.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t HashLookup
+(
+    Entry_t* baseEntryPtr,
+    const char* path
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return atom_HashString(path) ^ (uint32_t)((uintptr_t)baseEntryPtr >> 3);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Put a child entry into the first free slot of its parent's child index, starting from the slot
+ * its name hashes to.  The index must have a free slot.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InsertIntoChildIndex
+(
+    Entry_t** indexPtr,     ///< Child index.
+    size_t indexSize,       ///< Number of slots in the index (a power of 2).
+    Entry_t* childPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t mask = indexSize - 1;
+    size_t slot = atom_GetHash(childPtr->name) & mask;
+
+    while (indexPtr[slot] != NULL)
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    indexPtr[slot] = childPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a new child entry to its parent's child index, growing the index if needed.  The child
+ * index is an open-addressing (linear probing) hash table of the entries in the parent's child
+ * list, so children can be found by name without walking the list.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddToChildIndex
+(
+    Entry_t* parentPtr,
+    Entry_t* childPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (((parentPtr->childCount + 1) * 2) > parentPtr->childIndexSize)
+    {
+        size_t newSize = parentPtr->childIndexSize * 2;
+        if (newSize < MIN_CHILD_INDEX_SIZE)
+        {
+            newSize = MIN_CHILD_INDEX_SIZE;
+        }
+
+        Entry_t** newIndexPtr = calloc(newSize, sizeof(Entry_t*));
+        LE_ASSERT(newIndexPtr != NULL);
+
+        size_t i;
+        for (i = 0; i < parentPtr->childIndexSize; i++)
+        {
+            if (parentPtr->childIndexPtr[i] != NULL)
+            {
+                InsertIntoChildIndex(newIndexPtr, newSize, parentPtr->childIndexPtr[i]);
+            }
+        }
+
+        free(parentPtr->childIndexPtr);
+        parentPtr->childIndexPtr = newIndexPtr;
+        parentPtr->childIndexSize = newSize;
+    }
+
+    InsertIntoChildIndex(parentPtr->childIndexPtr, parentPtr->childIndexSize, childPtr);
+    (parentPtr->childCount)++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a child entry from its parent's child index.  The entries after it in the same probe
+ * sequence are moved back to fill the gap, so that lookups never need to skip over removed slots.
+ * The index is freed along with the parent's last child.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveFromChildIndex
+(
+    Entry_t* parentPtr,
+    Entry_t* childPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Entry_t** indexPtr = parentPtr->childIndexPtr;
+    size_t mask = parentPtr->childIndexSize - 1;
+    size_t slot = atom_GetHash(childPtr->name) & mask;
+
+    while (indexPtr[slot] != childPtr)
+    {
+        LE_ASSERT(indexPtr[slot] != NULL);
+        slot = (slot + 1) & mask;
+    }
+
+    // Backward shift deletion: move each following entry in the cluster into the gap unless its
+    // home slot lies cyclically between the gap and its current slot.
+    size_t gap = slot;
+    slot = (slot + 1) & mask;
+    while (indexPtr[slot] != NULL)
+    {
+        size_t home = atom_GetHash(indexPtr[slot]->name) & mask;
+
+        if (((slot - home) & mask) >= ((slot - gap) & mask))
+        {
+            indexPtr[gap] = indexPtr[slot];
+            gap = slot;
+        }
+
+        slot = (slot + 1) & mask;
+    }
+    indexPtr[gap] = NULL;
+
+    (parentPtr->childCount)--;
+
+    if (parentPtr->childCount == 0)
+    {
+        free(parentPtr->childIndexPtr);
+        parentPtr->childIndexPtr = NULL;
+        parentPtr->childIndexSize = 0;
+    }
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -65,15 +274,22 @@ static Entry_t* AddChild
     {
         entryPtr = le_mem_Alloc(EntryPool);
 
-        if (LE_OK != le_utf8_Copy(entryPtr->name, name, sizeof(entryPtr->name), NULL))
+        char nameBuff[HUB_MAX_ENTRY_NAME_BYTES];
+        if (LE_OK != le_utf8_Copy(nameBuff, name, sizeof(nameBuff), NULL))
         {
             LE_ERROR("Resource tree entry name longer than %zu bytes max. Truncated to '%s'.",
-                     sizeof(entryPtr->name),
-                     name);
+                     sizeof(nameBuff),
+                     nameBuff);
         }
 
+        entryPtr->name = atom_Get(nameBuff);
         entryPtr->link = LE_DLS_LINK_INIT;
         entryPtr->childList = LE_DLS_LIST_INIT;
+        entryPtr->childIndexPtr = NULL;
+        entryPtr->childIndexSize = 0;
+        entryPtr->childCount = 0;
+        entryPtr->pathPtr = NULL;
+        entryPtr->pathLen = 0;
         entryPtr->type = ADMIN_ENTRY_TYPE_NAMESPACE;
 
         if (parentPtr != NULL)
@@ -86,6 +302,7 @@ static Entry_t* AddChild
             // Link to the parent entry.
             entryPtr->parentPtr = parentPtr;
             le_dls_Queue(&parentPtr->childList, &entryPtr->link);
+            AddToChildIndex(parentPtr, entryPtr);
         }
     }
     else
@@ -96,6 +313,9 @@ static Entry_t* AddChild
     }
 
     entryPtr->u.flags = RES_FLAG_NEW;
+
+    TreeChanged();
+
     return entryPtr;
 }
 
@@ -118,6 +338,15 @@ static void EntryDestructor
 
     // Remove from parent's list of children.
     le_dls_Remove(&entryPtr->parentPtr->childList, &entryPtr->link);
+    RemoveFromChildIndex(entryPtr->parentPtr, entryPtr);
+    le_mem_Release(entryPtr->name);
+
+    if (entryPtr->pathPtr != NULL)
+    {
+        le_mem_Release(entryPtr->pathPtr);
+    }
+
+    TreeChanged();
 
     // Release the reference to the parent.
     le_mem_Release(entryPtr->parentPtr);
@@ -141,6 +370,9 @@ void resTree_Init
     EntryPool = le_mem_CreatePool("Res Tree Entry", sizeof(Entry_t));
     le_mem_SetDestructor(EntryPool, EntryDestructor);
 
+    ShortPathPool = le_mem_CreatePool("Short Entry Path", SHORT_PATH_BYTES);
+    LongPathPool = le_mem_CreatePool("Long Entry Path", HUB_MAX_RESOURCE_PATH_BYTES);
+
     // Create the Root Namespace.
     RootPtr = AddChild(NULL, "", NULL);
 }
@@ -202,21 +434,38 @@ resTree_EntryRef_t resTree_FindChildEx
                                         ///< return it.
 )
 {
-    le_dls_Link_t* linkPtr = le_dls_Peek(&nsRef->childList);
+    if (nsRef->childIndexPtr == NULL)
+    {
+        return NULL;
+    }
 
-    while (linkPtr != NULL)
+    // Entry names are interned, so if there's no atom for this name, there's no such child.
+    // Otherwise, the atoms can be compared instead of the strings.
+    atom_Ref_t nameAtom = atom_Find(name);
+    if (nameAtom == NULL)
     {
-        Entry_t* childPtr = CONTAINER_OF(linkPtr, Entry_t, link);
+        return NULL;
+    }
 
-        if (withZombies || !resTree_IsDeleted(childPtr))
+    // Children's names are unique, including deleted children that are still around (which are
+    // resurrected rather than duplicated), so there is at most one match in the index.
+    size_t mask = nsRef->childIndexSize - 1;
+    size_t slot = atom_GetHash(nameAtom) & mask;
+    Entry_t* childPtr;
+
+    while ((childPtr = nsRef->childIndexPtr[slot]) != NULL)
+    {
+        if (childPtr->name == nameAtom)
         {
-            if (strncmp(name, childPtr->name, sizeof(childPtr->name)) == 0)
+            if (withZombies || !resTree_IsDeleted(childPtr))
             {
                 return childPtr;
             }
+
+            return NULL;
         }
 
-        linkPtr = le_dls_PeekNext(&nsRef->childList, linkPtr);
+        slot = (slot + 1) & mask;
     }
 
     return NULL;
@@ -247,6 +496,9 @@ resTree_EntryRef_t resTree_FindChild
  * Optionally will create a missing entry if doCreate is true.  If doCreate is false, won't
  * create any entries at all and will just return NULL if the entry doesn't exist.
  *
+ * Entries found are remembered in the LookupCache, so looking up the same path again while the
+ * tree hasn't changed doesn't walk the tree.
+ *
  * @return Reference to the object, or
  *         NULL if path malformed or if doCreate == false and entry doesn't exist.
  */
@@ -259,6 +511,18 @@ static resTree_EntryRef_t GoToEntry
 )
 //--------------------------------------------------------------------------------------------------
 {
+    // Only valid paths of existing entries get cached, so a hit can be returned right away.
+    uint32_t hash = HashLookup(baseNamespace, path);
+    LookupCacheSlot_t* slotPtr = &LookupCache[hash & (LOOKUP_CACHE_SIZE - 1)];
+
+    if (   (slotPtr->generation == TreeGeneration)
+        && (slotPtr->hash == hash)
+        && (slotPtr->baseEntryPtr == baseNamespace)
+        && (strcmp(slotPtr->path, path) == 0)  )
+    {
+        return slotPtr->entryPtr;
+    }
+
     // Validate the path.
     const char* illegalCharPtr = strpbrk(path, ".[]");
     if (illegalCharPtr != NULL)
@@ -328,6 +592,15 @@ static resTree_EntryRef_t GoToEntry
         i += nameLen;
     }
 
+    if (i < sizeof(slotPtr->path))
+    {
+        memcpy(slotPtr->path, path, i + 1);
+        slotPtr->generation = TreeGeneration;
+        slotPtr->hash = hash;
+        slotPtr->baseEntryPtr = baseNamespace;
+        slotPtr->entryPtr = currentEntry;
+    }
+
     return currentEntry;
 }
 
@@ -440,7 +713,7 @@ const char* resTree_GetEntryName
 )
 //--------------------------------------------------------------------------------------------------
 {
-    return entryRef->name;
+    return atom_GetString(entryRef->name);
 }
 
 
@@ -768,7 +1041,8 @@ resTree_EntryRef_t resTree_GetObservation
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the path of a given resource tree entry relative to a given namespace.
+ * Build the path of a given resource tree entry relative to a given namespace by walking up the
+ * tree, without using the cached absolute paths.
  *
  * @return
  *  - Number of bytes written to the string buffer (excluding null terminator) if successful.
@@ -776,7 +1050,7 @@ resTree_EntryRef_t resTree_GetObservation
  *  - LE_NOT_FOUND if the resource is not in the given namespace.
  */
 //--------------------------------------------------------------------------------------------------
-ssize_t resTree_GetPath
+static ssize_t BuildPath
 (
     char* stringBuffPtr,  ///< Ptr to where the path should be written.
     size_t stringBuffSize,  ///< Size of the string buffer, in bytes.
@@ -812,7 +1086,10 @@ ssize_t resTree_GetPath
             stringBuffSize--;
             bytesWritten = 1;
         }
-        if (LE_OK != le_utf8_Copy(stringBuffPtr, entryRef->name, stringBuffSize, &len))
+        if (LE_OK != le_utf8_Copy(stringBuffPtr,
+                                  atom_GetString(entryRef->name),
+                                  stringBuffSize,
+                                  &len))
         {
             return LE_OVERFLOW;
         }
@@ -830,10 +1107,7 @@ ssize_t resTree_GetPath
     // Otherwise, recursively traverse up the tree to the child of the base namespace and
     // print entry names and '/' separators as we unwind back to the current entry.
     size_t len;
-    ssize_t result = resTree_GetPath(stringBuffPtr,
-                                     stringBuffSize,
-                                     baseNamespace,
-                                     entryRef->parentPtr);
+    ssize_t result = BuildPath(stringBuffPtr, stringBuffSize, baseNamespace, entryRef->parentPtr);
 
     if (result < 0) // All the le_result_t codes (other than LE_OK) are negative.
     {
@@ -854,7 +1128,10 @@ ssize_t resTree_GetPath
     stringBuffPtr += len;
     stringBuffSize -= len;
 
-    if (LE_OK != le_utf8_Copy(stringBuffPtr, entryRef->name, stringBuffSize, &len))
+    if (LE_OK != le_utf8_Copy(stringBuffPtr,
+                              atom_GetString(entryRef->name),
+                              stringBuffSize,
+                              &len))
     {
         return LE_OVERFLOW;
     }
@@ -864,6 +1141,134 @@ ssize_t resTree_GetPath
     return bytesWritten;
 }
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the absolute path of a given resource tree entry, building and caching it (and the paths of
+ * its ancestors) if that hasn't been done already.
+ *
+ * Entries are never renamed or moved to a different parent, so a cached path stays valid for
+ * as long as the entry exists.
+ *
+ * @return Ptr to the path (owned by the entry), or NULL if the path is too long to cache.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* GetAbsolutePath
+(
+    Entry_t* entryPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (entryPtr == RootPtr)
+    {
+        return "";
+    }
+
+    if (entryPtr->pathPtr != NULL)
+    {
+        return entryPtr->pathPtr;
+    }
+
+    Entry_t* parentPtr = entryPtr->parentPtr;
+    const char* parentPath = GetAbsolutePath(parentPtr);
+    if (parentPath == NULL)
+    {
+        return NULL;
+    }
+
+    size_t parentLen = (parentPtr == RootPtr ? 0 : parentPtr->pathLen);
+    const char* name = atom_GetString(entryPtr->name);
+    size_t nameLen = strlen(name);
+    size_t size = parentLen + 1 + nameLen + 1;
+
+    char* pathPtr;
+    if (size <= SHORT_PATH_BYTES)
+    {
+        pathPtr = le_mem_ForceAlloc(ShortPathPool);
+    }
+    else if (size <= HUB_MAX_RESOURCE_PATH_BYTES)
+    {
+        pathPtr = le_mem_ForceAlloc(LongPathPool);
+    }
+    else
+    {
+        return NULL;
+    }
+
+    memcpy(pathPtr, parentPath, parentLen);
+    pathPtr[parentLen] = '/';
+    memcpy(pathPtr + parentLen + 1, name, nameLen + 1);
+
+    entryPtr->pathPtr = pathPtr;
+    entryPtr->pathLen = size - 1;
+
+    return pathPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the path of a given resource tree entry relative to a given namespace.
+ *
+ * @return
+ *  - Number of bytes written to the string buffer (excluding null terminator) if successful.
+ *  - LE_OVERFLOW if the string doesn't have space for the path.
+ *  - LE_NOT_FOUND if the resource is not in the given namespace.
+ */
+//--------------------------------------------------------------------------------------------------
+ssize_t resTree_GetPath
+(
+    char* stringBuffPtr,  ///< Ptr to where the path should be written.
+    size_t stringBuffSize,  ///< Size of the string buffer, in bytes.
+    resTree_EntryRef_t baseNamespace,
+    resTree_EntryRef_t entryRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Corner case: If the entry is the same as the base namespace,
+    // just null terminate, if there's space for that.
+    if (entryRef == baseNamespace)
+    {
+        LE_ASSERT(stringBuffSize > 0);
+        stringBuffPtr[0] = '\0';
+        return LE_OK;
+    }
+
+    const char* absPath = GetAbsolutePath(entryRef);
+    if (absPath == NULL)
+    {
+        return BuildPath(stringBuffPtr, stringBuffSize, baseNamespace, entryRef);
+    }
+
+    // The path relative to a namespace other than the Root is the tail of the absolute path
+    // that follows the base namespace's own absolute path and the '/' separator after it.
+    // The base namespace is an ancestor, so its path was cached when the entry's path was.
+    size_t offset = 0;
+    if (baseNamespace != RootPtr)
+    {
+        Entry_t* ancestorPtr = entryRef->parentPtr;
+        while (ancestorPtr != baseNamespace)
+        {
+            if (ancestorPtr == NULL)
+            {
+                return LE_NOT_FOUND;
+            }
+            ancestorPtr = ancestorPtr->parentPtr;
+        }
+        offset = baseNamespace->pathLen + 1;
+    }
+
+    size_t len = entryRef->pathLen - offset;
+    if (len >= stringBuffSize)
+    {
+        return LE_OVERFLOW;
+    }
+
+    memcpy(stringBuffPtr, absPath + offset, len + 1);
+
+    return len;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the parent of a given entry.
@@ -1369,6 +1774,43 @@ admin_TransformType_t resTree_GetTransform
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set an Observation to aggregate the samples it accepts over fixed-length (tumbling) windows
+ * of wall-clock time.  The Observation's value is only updated at the end of each window, with
+ * the aggregate of the samples accepted during the window.
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_SetAggregation
+(
+    resTree_EntryRef_t obsEntry,
+    admin_AggregationType_t aggregationType,
+    double period
+)
+//--------------------------------------------------------------------------------------------------
+{
+    res_SetAggregation(obsEntry->u.resourcePtr, aggregationType, period);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the type of aggregation currently applied to an Observation.
+ *
+ * @return The AggregationType
+ */
+//--------------------------------------------------------------------------------------------------
+admin_AggregationType_t resTree_GetAggregation
+(
+    resTree_EntryRef_t obsEntry,
+    double* periodPtr   ///< [OUT] Length of the aggregation windows (seconds).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return res_GetAggregation(obsEntry->u.resourcePtr, periodPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the maximum number of data samples to buffer in a given Observation.  Buffers are FIFO
@@ -1405,45 +1847,225 @@ uint32_t resTree_GetBufferMaxCount
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the minimum time between backups of an Observation's buffer to non-volatile storage.
- * If the buffer's size is non-zero and the backup period is non-zero, then the buffer will be
- * backed-up to non-volatile storage when it changes, but never more often than this period setting
- * specifies.
+ * Set whether a given Observation's numeric data samples should be buffered compressed.
+ * Compressed samples take much less memory (often only a few bits each), but reading or querying
+ * the buffer means decoding them.
  */
 //--------------------------------------------------------------------------------------------------
-void resTree_SetBufferBackupPeriod
+void resTree_SetBufferCompression
 (
     resTree_EntryRef_t obsEntry,
-    uint32_t seconds
+    bool compress
 )
 //--------------------------------------------------------------------------------------------------
 {
-    res_SetBufferBackupPeriod(obsEntry->u.resourcePtr, seconds);
+    res_SetBufferCompression(obsEntry->u.resourcePtr, compress);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the minimum time between backups of an Observation's buffer to non-volatile storage.
- * See admin_SetBufferBackupPeriod() for more information.
+ * Check whether a given Observation's numeric data samples are set to be buffered compressed.
+ * See admin_SetBufferCompression() for more information.
  *
- * @return The buffer backup period (in seconds) or 0 if backups are disabled or the Observation
- *         does not exist.
+ * @return true if they are.
  */
 //--------------------------------------------------------------------------------------------------
-uint32_t resTree_GetBufferBackupPeriod
+bool resTree_GetBufferCompression
 (
     resTree_EntryRef_t obsEntry
 )
 //--------------------------------------------------------------------------------------------------
 {
-    return res_GetBufferBackupPeriod(obsEntry->u.resourcePtr);
+    return res_GetBufferCompression(obsEntry->u.resourcePtr);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Mark an Output resource "optional".  (By default, they are marked "mandatory".)
+ * Set whether a given Observation's trigger, Boolean and numeric data samples should be buffered in
+ * a memory-mapped file.  See admin_SetBufferPersistence() for more information.
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_SetBufferPersistence
+(
+    resTree_EntryRef_t obsEntry,
+    bool persist,
+    uint32_t syncPeriod ///< Minimum number of seconds between syncs (0 = leave it to the OS).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    res_SetBufferPersistence(obsEntry->u.resourcePtr, persist, syncPeriod);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a given Observation's buffer is set to be kept in a memory-mapped file.
+ * See admin_SetBufferPersistence() for more information.
+ *
+ * @return true if it is.
+ */
+//--------------------------------------------------------------------------------------------------
+bool resTree_GetBufferPersistence
+(
+    resTree_EntryRef_t obsEntry,
+    uint32_t* syncPeriodPtr ///< [OUT] Minimum number of seconds between syncs.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return res_GetBufferPersistence(obsEntry->u.resourcePtr, syncPeriodPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the minimum time between backups of an Observation's buffer to non-volatile storage.
+ * If the buffer's size is non-zero and the backup period is non-zero, then the buffer will be
+ * backed-up to non-volatile storage when it changes, but never more often than this period setting
+ * specifies.
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_SetBufferBackupPeriod
+(
+    resTree_EntryRef_t obsEntry,
+    uint32_t seconds
+)
+//--------------------------------------------------------------------------------------------------
+{
+    res_SetBufferBackupPeriod(obsEntry->u.resourcePtr, seconds);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the minimum time between backups of an Observation's buffer to non-volatile storage.
+ * See admin_SetBufferBackupPeriod() for more information.
+ *
+ * @return The buffer backup period (in seconds) or 0 if backups are disabled or the Observation
+ *         does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t resTree_GetBufferBackupPeriod
+(
+    resTree_EntryRef_t obsEntry
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return res_GetBufferBackupPeriod(obsEntry->u.resourcePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set up a rollup tier of an Observation.  See admin_SetRollupTier() for more information.
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_SetRollupTier
+(
+    resTree_EntryRef_t obsEntry,
+    uint32_t tier,      ///< Tier number (0 = finest).
+    double period,      ///< Length of each bucket's period (seconds).
+    uint32_t maxCount   ///< Number of buckets to keep (0 = remove this tier and all coarser ones).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    res_SetRollupTier(obsEntry->u.resourcePtr, tier, period, maxCount);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the settings of a rollup tier of an Observation.
+ *
+ * @return The number of buckets kept in the tier, or 0 if the tier is not set.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t resTree_GetRollupTier
+(
+    resTree_EntryRef_t obsEntry,
+    uint32_t tier,      ///< Tier number (0 = finest).
+    double* periodPtr   ///< [OUT] Length of each bucket's period (seconds), or NAN if not set.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return res_GetRollupTier(obsEntry->u.resourcePtr, tier, periodPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the size of an Observation's quantile sketch.  See admin_SetQuantileSketch() for more
+ * information.
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_SetQuantileSketch
+(
+    resTree_EntryRef_t obsEntry,
+    uint32_t size       ///< Number of centroids per segment (0 = don't keep a sketch).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    res_SetQuantileSketch(obsEntry->u.resourcePtr, size);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the size of an Observation's quantile sketch.
+ *
+ * @return The number of centroids each segment of the sketch is compressed down to, or 0 if no
+ *         sketch is kept.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t resTree_GetQuantileSketch
+(
+    resTree_EntryRef_t obsEntry
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return res_GetQuantileSketch(obsEntry->u.resourcePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the bucket boundaries of an Observation's histogram.  See admin_SetHistogram() for more
+ * information.
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_SetHistogram
+(
+    resTree_EntryRef_t obsEntry,
+    const double* boundsPtr,    ///< Bucket boundaries, in increasing order.
+    size_t boundsSize           ///< Number of boundaries (0 = don't keep a histogram).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    res_SetHistogram(obsEntry->u.resourcePtr, boundsPtr, boundsSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the bucket boundaries of an Observation's histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_GetHistogram
+(
+    resTree_EntryRef_t obsEntry,
+    double* boundsPtr,      ///< [OUT] Bucket boundaries, in increasing order.
+    size_t* boundsSizePtr   ///< [INOUT] Room in the array, then number of boundaries (0 if none).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    res_GetHistogram(obsEntry->u.resourcePtr, boundsPtr, boundsSizePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mark an Output resource "optional".  (By default, they are marked "mandatory".)
  */
 //--------------------------------------------------------------------------------------------------
 void resTree_MarkOptional
@@ -1480,6 +2102,68 @@ bool resTree_IsMandatory
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a handle on an Input or Output resource, so data samples can be pushed to it without
+ * looking it up by path every time.
+ *
+ * The handle remains valid if the resource is deleted, but resTree_GetHandleEntry() will return
+ * NULL for it from then on, even if another resource is later created at the same path.
+ *
+ * @return Reference to the handle.  Must be closed using resTree_CloseHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+ioPoint_HandleRef_t resTree_OpenHandle
+(
+    resTree_EntryRef_t resEntry ///< Input or Output entry.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(   (resEntry->type == ADMIN_ENTRY_TYPE_INPUT)
+              || (resEntry->type == ADMIN_ENTRY_TYPE_OUTPUT));
+
+    return res_OpenHandle(resEntry->u.resourcePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a handle opened using resTree_OpenHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_CloseHandle
+(
+    ioPoint_HandleRef_t handleRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    res_CloseHandle(handleRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the resource tree entry a handle is open on.
+ *
+ * @return Reference to the entry, or NULL if the resource has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+resTree_EntryRef_t resTree_GetHandleEntry
+(
+    ioPoint_HandleRef_t handleRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    res_Resource_t* resPtr = res_GetHandleResource(handleRef);
+
+    if (resPtr == NULL)
+    {
+        return NULL;
+    }
+
+    return resPtr->entryRef;
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -1833,6 +2517,8 @@ void resTree_SetDeleted
     LE_ASSERT((resEntry->u.flags & RES_FLAG_NEW) == 0);
 
     resEntry->u.flags |= RES_FLAG_DELETED;
+
+    TreeChanged();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1971,12 +2657,149 @@ void resTree_ReadBufferJson
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read data out of a buffer.  Data is written to a given file descriptor in a packed binary format:
+ * a header giving the data type, followed by a record for each sample.
+ * See query_ReadBufferBinary() for details.
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_ReadBufferBinary
+(
+    resTree_EntryRef_t obsEntry, ///< Observation entry.
+    double startAfter,  ///< Start after this many seconds ago, or after an absolute number of
+                        ///< seconds since the Epoch (if startafter > 30 years).
+                        ///< Use NAN (not a number) to read the whole buffer.
+    int outputFile, ///< File descriptor to write the data to.
+    query_ReadCompletionFunc_t handlerPtr, ///< Completion callback.
+    void* contextPtr    ///< Value to be passed to completion callback.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(obsEntry->type == ADMIN_ENTRY_TYPE_OBSERVATION);
+    LE_ASSERT(obsEntry->u.resourcePtr != NULL);
+
+    res_ReadBufferBinary(obsEntry->u.resourcePtr, startAfter, outputFile, handlerPtr, contextPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a read cursor on an Observation's buffer, so the buffered samples newer than a given time
+ * can be read a batch at a time, with each batch carrying on from where the last one left off.
+ *
+ * @return Reference to the cursor.  Must be closed using resTree_CloseReadCursor().
+ */
+//--------------------------------------------------------------------------------------------------
+obs_ReadCursorRef_t resTree_OpenReadCursor
+(
+    resTree_EntryRef_t obsEntry, ///< Observation entry.
+    double startAfter   ///< Start after this many seconds ago, or after an absolute number of
+                        ///< seconds since the Epoch (if startafter > 30 years).
+                        ///< Use NAN (not a number) to read the whole buffer.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(obsEntry->type == ADMIN_ENTRY_TYPE_OBSERVATION);
+    LE_ASSERT(obsEntry->u.resourcePtr != NULL);
+
+    return res_OpenReadCursor(obsEntry->u.resourcePtr, startAfter);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a read cursor.
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_CloseReadCursor
+(
+    obs_ReadCursorRef_t cursorRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    res_CloseReadCursor(cursorRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of Boolean samples through a read cursor.
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).
+ *  - LE_FORMAT_ERROR if the buffered samples aren't Boolean.
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t resTree_ReadCursorBoolean
+(
+    obs_ReadCursorRef_t cursorRef,
+    double* timestampsPtr,  ///< [OUT] Array to store the timestamps in.
+    bool* valuesPtr,        ///< [OUT] Array to store the values in.
+    size_t* countPtr        ///< [INOUT] Size of the arrays / number of samples read.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return res_ReadCursorBoolean(cursorRef, timestampsPtr, valuesPtr, countPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of numeric samples through a read cursor.
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).
+ *  - LE_FORMAT_ERROR if the buffered samples aren't numeric.
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t resTree_ReadCursorNumeric
+(
+    obs_ReadCursorRef_t cursorRef,
+    double* timestampsPtr,  ///< [OUT] Array to store the timestamps in.
+    double* valuesPtr,      ///< [OUT] Array to store the values in.
+    size_t* countPtr        ///< [INOUT] Size of the arrays / number of samples read.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return res_ReadCursorNumeric(cursorRef, timestampsPtr, valuesPtr, countPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of samples (of any data type) through a read cursor, as a JSON array of as
+ * many samples as fit in a given buffer, in the same format as resTree_ReadBufferJson().
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).  The buffer holds an empty array.
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t resTree_ReadCursorJson
+(
+    obs_ReadCursorRef_t cursorRef,
+    char* buffPtr,      ///< [OUT] Ptr to buffer where the JSON array will be stored.
+    size_t buffSize     ///< [IN] Size of the buffer, in bytes (at least 3).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return res_ReadCursorJson(cursorRef, buffPtr, buffSize);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Find the oldest data sample held in a given Observation's buffer that is newer than a
  * given timestamp.
  *
- * @return Reference to the sample, or NULL if not found.
+ * @return Reference to the sample, or NULL if not found.  The caller is responsible for
+ *         releasing the reference.
  */
 //--------------------------------------------------------------------------------------------------
 dataSample_Ref_t resTree_FindBufferedSampleAfter
@@ -2227,3 +3050,75 @@ double resTree_QueryStdDev
     LE_ASSERT(obsEntry->u.resourcePtr != NULL);
     return res_QueryStdDev(obsEntry->u.resourcePtr, startTime);
 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the count, minimum, maximum, mean and standard deviation of all values found within a given
+ * time span in an Observation's data set, along with the time span they cover.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_NOT_FOUND if there are no values in the time span.
+ *  - LE_FORMAT_ERROR if the Observation's data set isn't numerical.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t resTree_QueryStats
+(
+    resTree_EntryRef_t obsEntry,    ///< Observation entry.
+    double startTime,   ///< If < 30 years then seconds before now; else seconds since the Epoch.
+    obs_Stats_t* statsPtr   ///< [OUT] The aggregates (count 0 and NANs unless LE_OK).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(obsEntry->type == ADMIN_ENTRY_TYPE_OBSERVATION);
+    LE_ASSERT(obsEntry->u.resourcePtr != NULL);
+    return res_QueryStats(obsEntry->u.resourcePtr, startTime, statsPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Estimate a percentile of the values found within a given time span in an Observation's buffer,
+ * using its quantile sketch.
+ *
+ * @return The value, or NAN (not-a-number) if the Observation doesn't keep a quantile sketch or
+ *         there's no numerical data in its buffer within the time span.
+ */
+//--------------------------------------------------------------------------------------------------
+double resTree_QueryPercentile
+(
+    resTree_EntryRef_t obsEntry,    ///< Observation entry.
+    double startTime,   ///< If < 30 years then seconds before now; else seconds since the Epoch.
+    double percentile   ///< Percentile (0 to 100).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(obsEntry->type == ADMIN_ENTRY_TYPE_OBSERVATION);
+    LE_ASSERT(obsEntry->u.resourcePtr != NULL);
+    return res_QueryPercentile(obsEntry->u.resourcePtr, startTime, percentile);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fetch the counts in each bucket of an Observation's histogram.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_NOT_FOUND if the Observation doesn't keep a histogram.
+ *  - LE_OVERFLOW if the array is too small to hold all the counts.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t resTree_QueryHistogram
+(
+    resTree_EntryRef_t obsEntry,    ///< Observation entry.
+    uint64_t* countsPtr,    ///< [OUT] Number of values in each bucket, lowest bucket first.
+    size_t* countsSizePtr   ///< [INOUT] Room in the array, then number of buckets.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(obsEntry->type == ADMIN_ENTRY_TYPE_OBSERVATION);
+    LE_ASSERT(obsEntry->u.resourcePtr != NULL);
+    return res_QueryHistogram(obsEntry->u.resourcePtr, countsPtr, countsSizePtr);
+}
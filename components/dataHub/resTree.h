@@ -629,6 +629,35 @@ admin_TransformType_t resTree_GetTransform
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set an Observation to aggregate the samples it accepts over fixed-length (tumbling) windows
+ * of wall-clock time.  The Observation's value is only updated at the end of each window, with
+ * the aggregate of the samples accepted during the window.
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_SetAggregation
+(
+    resTree_EntryRef_t obsEntry,
+    admin_AggregationType_t aggregationType,
+    double period
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the type of aggregation currently applied to an Observation.
+ *
+ * @return The AggregationType
+ */
+//--------------------------------------------------------------------------------------------------
+admin_AggregationType_t resTree_GetAggregation
+(
+    resTree_EntryRef_t obsEntry,
+    double* periodPtr   ///< [OUT] Length of the aggregation windows (seconds).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the maximum number of data samples to buffer in a given Observation.  Buffers are FIFO
@@ -655,6 +684,63 @@ uint32_t resTree_GetBufferMaxCount
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set whether a given Observation's numeric data samples should be buffered compressed.
+ * Compressed samples take much less memory (often only a few bits each), but reading or querying
+ * the buffer means decoding them.
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_SetBufferCompression
+(
+    resTree_EntryRef_t obsEntry,
+    bool compress
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a given Observation's numeric data samples are set to be buffered compressed.
+ * See admin_SetBufferCompression() for more information.
+ *
+ * @return true if they are.
+ */
+//--------------------------------------------------------------------------------------------------
+bool resTree_GetBufferCompression
+(
+    resTree_EntryRef_t obsEntry
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set whether a given Observation's trigger, Boolean and numeric data samples should be buffered in
+ * a memory-mapped file.  See admin_SetBufferPersistence() for more information.
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_SetBufferPersistence
+(
+    resTree_EntryRef_t obsEntry,
+    bool persist,
+    uint32_t syncPeriod ///< Minimum number of seconds between syncs (0 = leave it to the OS).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a given Observation's buffer is set to be kept in a memory-mapped file.
+ * See admin_SetBufferPersistence() for more information.
+ *
+ * @return true if it is.
+ */
+//--------------------------------------------------------------------------------------------------
+bool resTree_GetBufferPersistence
+(
+    resTree_EntryRef_t obsEntry,
+    uint32_t* syncPeriodPtr ///< [OUT] Minimum number of seconds between syncs.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the minimum time between backups of an Observation's buffer to non-volatile storage.
@@ -685,6 +771,89 @@ uint32_t resTree_GetBufferBackupPeriod
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set up a rollup tier of an Observation.  See admin_SetRollupTier() for more information.
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_SetRollupTier
+(
+    resTree_EntryRef_t obsEntry,
+    uint32_t tier,      ///< Tier number (0 = finest).
+    double period,      ///< Length of each bucket's period (seconds).
+    uint32_t maxCount   ///< Number of buckets to keep (0 = remove this tier and all coarser ones).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the settings of a rollup tier of an Observation.
+ *
+ * @return The number of buckets kept in the tier, or 0 if the tier is not set.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t resTree_GetRollupTier
+(
+    resTree_EntryRef_t obsEntry,
+    uint32_t tier,      ///< Tier number (0 = finest).
+    double* periodPtr   ///< [OUT] Length of each bucket's period (seconds), or NAN if not set.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the size of an Observation's quantile sketch.  See admin_SetQuantileSketch() for more
+ * information.
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_SetQuantileSketch
+(
+    resTree_EntryRef_t obsEntry,
+    uint32_t size       ///< Number of centroids per segment (0 = don't keep a sketch).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the size of an Observation's quantile sketch.
+ *
+ * @return The number of centroids each segment of the sketch is compressed down to, or 0 if no
+ *         sketch is kept.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t resTree_GetQuantileSketch
+(
+    resTree_EntryRef_t obsEntry
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the bucket boundaries of an Observation's histogram.  See admin_SetHistogram() for more
+ * information.
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_SetHistogram
+(
+    resTree_EntryRef_t obsEntry,
+    const double* boundsPtr,    ///< Bucket boundaries, in increasing order.
+    size_t boundsSize           ///< Number of boundaries (0 = don't keep a histogram).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the bucket boundaries of an Observation's histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_GetHistogram
+(
+    resTree_EntryRef_t obsEntry,
+    double* boundsPtr,      ///< [OUT] Bucket boundaries, in increasing order.
+    size_t* boundsSizePtr   ///< [INOUT] Room in the array, then number of boundaries (0 if none).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Mark an Output resource "optional".  (By default, they are marked "mandatory".)
@@ -709,6 +878,46 @@ LE_SHARED bool resTree_IsMandatory
     resTree_EntryRef_t resEntry
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a handle on an Input or Output resource, so data samples can be pushed to it without
+ * looking it up by path every time.
+ *
+ * The handle remains valid if the resource is deleted, but resTree_GetHandleEntry() will return
+ * NULL for it from then on, even if another resource is later created at the same path.
+ *
+ * @return Reference to the handle.  Must be closed using resTree_CloseHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+ioPoint_HandleRef_t resTree_OpenHandle
+(
+    resTree_EntryRef_t resEntry ///< Input or Output entry.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a handle opened using resTree_OpenHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_CloseHandle
+(
+    ioPoint_HandleRef_t handleRef
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the resource tree entry a handle is open on.
+ *
+ * @return Reference to the entry, or NULL if the resource has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+resTree_EntryRef_t resTree_GetHandleEntry
+(
+    ioPoint_HandleRef_t handleRef
+);
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -1005,12 +1214,119 @@ void resTree_ReadBufferJson
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read data out of a buffer.  Data is written to a given file descriptor in a packed binary format:
+ * a header giving the data type, followed by a record for each sample.
+ * See query_ReadBufferBinary() for details.
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_ReadBufferBinary
+(
+    resTree_EntryRef_t obsEntry, ///< Observation entry.
+    double startAfter,  ///< Start after this many seconds ago, or after an absolute number of
+                        ///< seconds since the Epoch (if startafter > 30 years).
+                        ///< Use NAN (not a number) to read the whole buffer.
+    int outputFile, ///< File descriptor to write the data to.
+    query_ReadCompletionFunc_t handlerPtr, ///< Completion callback.
+    void* contextPtr    ///< Value to be passed to completion callback.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a read cursor on an Observation's buffer, so the buffered samples newer than a given time
+ * can be read a batch at a time, with each batch carrying on from where the last one left off.
+ *
+ * @return Reference to the cursor.  Must be closed using resTree_CloseReadCursor().
+ */
+//--------------------------------------------------------------------------------------------------
+obs_ReadCursorRef_t resTree_OpenReadCursor
+(
+    resTree_EntryRef_t obsEntry, ///< Observation entry.
+    double startAfter   ///< Start after this many seconds ago, or after an absolute number of
+                        ///< seconds since the Epoch (if startafter > 30 years).
+                        ///< Use NAN (not a number) to read the whole buffer.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a read cursor.
+ */
+//--------------------------------------------------------------------------------------------------
+void resTree_CloseReadCursor
+(
+    obs_ReadCursorRef_t cursorRef
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of Boolean samples through a read cursor.
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).
+ *  - LE_FORMAT_ERROR if the buffered samples aren't Boolean.
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t resTree_ReadCursorBoolean
+(
+    obs_ReadCursorRef_t cursorRef,
+    double* timestampsPtr,  ///< [OUT] Array to store the timestamps in.
+    bool* valuesPtr,        ///< [OUT] Array to store the values in.
+    size_t* countPtr        ///< [INOUT] Size of the arrays / number of samples read.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of numeric samples through a read cursor.
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).
+ *  - LE_FORMAT_ERROR if the buffered samples aren't numeric.
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t resTree_ReadCursorNumeric
+(
+    obs_ReadCursorRef_t cursorRef,
+    double* timestampsPtr,  ///< [OUT] Array to store the timestamps in.
+    double* valuesPtr,      ///< [OUT] Array to store the values in.
+    size_t* countPtr        ///< [INOUT] Size of the arrays / number of samples read.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of samples (of any data type) through a read cursor, as a JSON array of as
+ * many samples as fit in a given buffer, in the same format as resTree_ReadBufferJson().
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).  The buffer holds an empty array.
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t resTree_ReadCursorJson
+(
+    obs_ReadCursorRef_t cursorRef,
+    char* buffPtr,      ///< [OUT] Ptr to buffer where the JSON array will be stored.
+    size_t buffSize     ///< [IN] Size of the buffer, in bytes (at least 3).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Find the oldest data sample held in a given Observation's buffer that is newer than a
  * given timestamp.
  *
- * @return Reference to the sample, or NULL if not found.
+ * @return Reference to the sample, or NULL if not found.  The caller is responsible for
+ *         releasing the reference.
  */
 //--------------------------------------------------------------------------------------------------
 dataSample_Ref_t resTree_FindBufferedSampleAfter
@@ -1165,4 +1481,58 @@ double resTree_QueryStdDev
     double startTime    ///< If < 30 years then seconds before now; else seconds since the Epoch.
 );
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the count, minimum, maximum, mean and standard deviation of all values found within a given
+ * time span in an Observation's data set, along with the time span they cover.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_NOT_FOUND if there are no values in the time span.
+ *  - LE_FORMAT_ERROR if the Observation's data set isn't numerical.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t resTree_QueryStats
+(
+    resTree_EntryRef_t obsEntry,    ///< Observation entry.
+    double startTime,   ///< If < 30 years then seconds before now; else seconds since the Epoch.
+    obs_Stats_t* statsPtr   ///< [OUT] The aggregates (count 0 and NANs unless LE_OK).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Estimate a percentile of the values found within a given time span in an Observation's buffer,
+ * using its quantile sketch.
+ *
+ * @return The value, or NAN (not-a-number) if the Observation doesn't keep a quantile sketch or
+ *         there's no numerical data in its buffer within the time span.
+ */
+//--------------------------------------------------------------------------------------------------
+double resTree_QueryPercentile
+(
+    resTree_EntryRef_t obsEntry,    ///< Observation entry.
+    double startTime,   ///< If < 30 years then seconds before now; else seconds since the Epoch.
+    double percentile   ///< Percentile (0 to 100).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fetch the counts in each bucket of an Observation's histogram.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_NOT_FOUND if the Observation doesn't keep a histogram.
+ *  - LE_OVERFLOW if the array is too small to hold all the counts.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t resTree_QueryHistogram
+(
+    resTree_EntryRef_t obsEntry,    ///< Observation entry.
+    uint64_t* countsPtr,    ///< [OUT] Number of values in each bucket, lowest bucket first.
+    size_t* countsSizePtr   ///< [INOUT] Room in the array, then number of buckets.
+);
+
 #endif // NAMESPACE_H_INCLUDE_GUARD
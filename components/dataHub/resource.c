@@ -119,7 +119,7 @@ void res_Construct
 //--------------------------------------------------------------------------------------------------
 {
     resPtr->entryRef = entryRef;
-    resPtr->units[0] = '\0';
+    resPtr->units = NULL;
     resPtr->currentValue = NULL;
     resPtr->currentType = IO_DATA_TYPE_TRIGGER;
     resPtr->pushedValue = NULL;
@@ -145,14 +145,53 @@ void res_Construct
 static void SetUnits
 (
     res_Resource_t* resPtr,
-    const char* units
+    atom_Ref_t units    ///< The units, or NULL if unspecified.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (le_utf8_Copy(resPtr->units, units, sizeof(resPtr->units), NULL) != LE_OK)
+    if (units != NULL)
+    {
+        le_mem_AddRef(units);
+    }
+
+    if (resPtr->units != NULL)
+    {
+        le_mem_Release(resPtr->units);
+    }
+
+    resPtr->units = units;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the Units of a resource from a units string.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetUnitsString
+(
+    res_Resource_t* resPtr,
+    const char* units   ///< The units, or "" if unspecified.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char unitsBuff[HUB_MAX_UNITS_BYTES];
+
+    if (le_utf8_Copy(unitsBuff, units, sizeof(unitsBuff), NULL) != LE_OK)
     {
         LE_CRIT("Units string too long!");
     }
+
+    if (unitsBuff[0] == '\0')
+    {
+        SetUnits(resPtr, NULL);
+    }
+    else
+    {
+        atom_Ref_t unitsAtom = atom_Get(unitsBuff);
+        SetUnits(resPtr, unitsAtom);
+        le_mem_Release(unitsAtom);
+    }
 }
 
 
@@ -174,7 +213,7 @@ res_Resource_t* res_CreateInput
     res_Resource_t* resPtr = ioPoint_CreateInput(dataType, entryRef);
 
     resPtr->currentType = dataType;
-    SetUnits(resPtr, units);
+    SetUnitsString(resPtr, units);
 
     return resPtr;
 }
@@ -198,7 +237,7 @@ res_Resource_t* res_CreateOutput
     res_Resource_t* resPtr = ioPoint_CreateOutput(dataType, entryRef);
 
     resPtr->currentType = dataType;
-    SetUnits(resPtr, units);
+    SetUnitsString(resPtr, units);
 
     return resPtr;
 }
@@ -273,6 +312,8 @@ void res_Destruct
 {
     resPtr->entryRef = NULL;
 
+    SetUnits(resPtr, NULL);
+
     if (resPtr->currentValue != NULL)
     {
         le_mem_Release(resPtr->currentValue);
@@ -327,7 +368,12 @@ const char* res_GetUnits
 )
 //--------------------------------------------------------------------------------------------------
 {
-    return resPtr->units;
+    if (resPtr->units == NULL)
+    {
+        return "";
+    }
+
+    return atom_GetString(resPtr->units);
 }
 
 
@@ -440,7 +486,7 @@ le_result_t res_SetSource
         if (   (entryType == ADMIN_ENTRY_TYPE_OBSERVATION)
             || (entryType == ADMIN_ENTRY_TYPE_PLACEHOLDER)  )
         {
-            SetUnits(destPtr, "");
+            SetUnits(destPtr, NULL);
         }
     }
 
@@ -548,49 +594,20 @@ static void UpdateCurrentValue
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Push a data sample to a resource.
+ * Accept a data sample pushed to a resource, after any Observation processing has been done.
  *
  * @note Takes ownership of the data sample reference.
  */
 //--------------------------------------------------------------------------------------------------
-void res_Push
+static void AcceptPush
 (
     res_Resource_t* resPtr,         ///< The resource to push to.
     io_DataType_t dataType,         ///< The data type.
-    const char* units,              ///< The units (NULL or "" = take on resource's units)
+    atom_Ref_t units,               ///< The units (NULL = take on resource's units)
     dataSample_Ref_t dataSample     ///< The data sample (timestamp + value).
 )
 //--------------------------------------------------------------------------------------------------
 {
-    LE_ASSERT(resPtr->entryRef != NULL);
-
-    if ((units != NULL) && (*units == '\0'))
-    {
-        units = NULL;
-    }
-
-    if (ADMIN_ENTRY_TYPE_OBSERVATION == resTree_GetEntryType(resPtr->entryRef))
-    {
-        // Do JSON extraction (if applicable) before filtering.
-        if (obs_DoJsonExtraction(resPtr, &dataType, &dataSample) != LE_OK)
-        {
-            le_mem_Release(dataSample);
-            return;
-        }
-
-        // Buffer and possibly backup the sample
-        obs_ProcessAccepted(resPtr, dataType, dataSample);
-
-        // Perform any transforms on the buffered data
-        dataSample = obs_ApplyTransform(resPtr, dataType, dataSample);
-
-        if (true != obs_ShouldAccept(resPtr, dataType, dataSample))
-        {
-            le_mem_Release(dataSample);
-            return;
-        }
-    }
-
     // Record this as the latest pushed value, even if it doesn't get accepted as the new
     // current value.
     if (resPtr->pushedValue != NULL)
@@ -632,13 +649,14 @@ void res_Push
             // Check for units mismatches.
             // But, ignore the units if the units are supposed to be obtained from the resource,
             // or if the receiving resource doesn't have units.
+            // Units are interned, so different atoms mean different units.
             if (   (units != NULL)
-                && (resPtr->units[0] != '\0')
-                && (strcmp(units, resPtr->units) != 0)  )
+                && (resPtr->units != NULL)
+                && (units != resPtr->units)  )
             {
                 LE_WARN("Rejecting push: units mismatch (pushing '%s' to '%s').",
-                        units,
-                        resPtr->units);
+                        atom_GetString(units),
+                        atom_GetString(resPtr->units));
                 le_mem_Release(dataSample);
                 return;
             }
@@ -674,6 +692,79 @@ void res_Push
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a data sample to a resource.
+ *
+ * @note Takes ownership of the data sample reference.
+ */
+//--------------------------------------------------------------------------------------------------
+void res_Push
+(
+    res_Resource_t* resPtr,         ///< The resource to push to.
+    io_DataType_t dataType,         ///< The data type.
+    atom_Ref_t units,               ///< The units (NULL = take on resource's units)
+    dataSample_Ref_t dataSample     ///< The data sample (timestamp + value).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(resPtr->entryRef != NULL);
+
+    if (ADMIN_ENTRY_TYPE_OBSERVATION == resTree_GetEntryType(resPtr->entryRef))
+    {
+        // Do JSON extraction (if applicable) before filtering.
+        if (obs_DoJsonExtraction(resPtr, &dataType, &dataSample) != LE_OK)
+        {
+            le_mem_Release(dataSample);
+            return;
+        }
+
+        // Buffer and possibly backup the sample
+        obs_ProcessAccepted(resPtr, dataType, dataSample);
+
+        // Perform any transforms on the buffered data
+        dataSample = obs_ApplyTransform(resPtr, dataType, dataSample);
+
+        if (true != obs_ShouldAccept(resPtr, dataType, dataSample))
+        {
+            le_mem_Release(dataSample);
+            return;
+        }
+
+        // If the Observation is aggregating, the sample only goes into the current aggregation
+        // window.  The aggregate will be pushed at the end of the window.
+        if (obs_Aggregate(resPtr, dataType, dataSample))
+        {
+            le_mem_Release(dataSample);
+            return;
+        }
+    }
+
+    AcceptPush(resPtr, dataType, units, dataSample);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push an aggregate generated by an Observation at the end of an aggregation window.  This skips
+ * the Observation's buffering, transform, filtering and aggregation, which the aggregated
+ * samples have already been through.
+ *
+ * @note Takes ownership of the data sample reference.
+ */
+//--------------------------------------------------------------------------------------------------
+void res_PushAggregate
+(
+    res_Resource_t* resPtr,         ///< The Observation.
+    io_DataType_t dataType,         ///< The data type.
+    dataSample_Ref_t dataSample     ///< The data sample (timestamp + value).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    AcceptPush(resPtr, dataType, NULL, dataSample);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Add a Push Handler to an Output resource.
@@ -1107,6 +1198,48 @@ admin_TransformType_t res_GetTransform
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set an Observation to aggregate the samples it accepts over fixed-length (tumbling) windows
+ * of wall-clock time.  The Observation's value is only updated at the end of each window, with
+ * the aggregate of the samples accepted during the window.
+ */
+//--------------------------------------------------------------------------------------------------
+void res_SetAggregation
+(
+    res_Resource_t* resPtr,
+    admin_AggregationType_t aggregationType,
+    double period
+)
+//--------------------------------------------------------------------------------------------------
+{
+    obs_SetAggregation(resPtr, (obs_AggregationType_t)aggregationType, period);
+
+    if (IsUpdateInProgress)
+    {
+        resPtr->flags |= RES_FLAG_CHANGING_CONFIG;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the type of aggregation currently applied to an Observation.
+ *
+ * @return The AggregationType
+ */
+//--------------------------------------------------------------------------------------------------
+admin_AggregationType_t res_GetAggregation
+(
+    res_Resource_t* resPtr,
+    double* periodPtr   ///< [OUT] Length of the aggregation windows (seconds).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (admin_AggregationType_t)obs_GetAggregation(resPtr, periodPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the maximum number of data samples to buffer in a given Observation.  Buffers are FIFO
@@ -1141,6 +1274,79 @@ uint32_t res_GetBufferMaxCount
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set whether a given Observation's numeric data samples should be buffered compressed.
+ * Compressed samples take much less memory (often only a few bits each), but reading or querying
+ * the buffer means decoding them.
+ */
+//--------------------------------------------------------------------------------------------------
+void res_SetBufferCompression
+(
+    res_Resource_t* resPtr,
+    bool compress
+)
+//--------------------------------------------------------------------------------------------------
+{
+    obs_SetBufferCompression(resPtr, compress);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a given Observation's numeric data samples are set to be buffered compressed.
+ * See admin_SetBufferCompression() for more information.
+ *
+ * @return true if they are.
+ */
+//--------------------------------------------------------------------------------------------------
+bool res_GetBufferCompression
+(
+    res_Resource_t* resPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return obs_GetBufferCompression(resPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set whether a given Observation's trigger, Boolean and numeric data samples should be buffered in
+ * a memory-mapped file.  See admin_SetBufferPersistence() for more information.
+ */
+//--------------------------------------------------------------------------------------------------
+void res_SetBufferPersistence
+(
+    res_Resource_t* resPtr,
+    bool persist,
+    uint32_t syncPeriod ///< Minimum number of seconds between syncs (0 = leave it to the OS).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    obs_SetBufferPersistence(resPtr, persist, syncPeriod);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a given Observation's buffer is set to be kept in a memory-mapped file.
+ * See admin_SetBufferPersistence() for more information.
+ *
+ * @return true if it is.
+ */
+//--------------------------------------------------------------------------------------------------
+bool res_GetBufferPersistence
+(
+    res_Resource_t* resPtr,
+    uint32_t* syncPeriodPtr ///< [OUT] Minimum number of seconds between syncs.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return obs_GetBufferPersistence(resPtr, syncPeriodPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the minimum time between backups of an Observation's buffer to non-volatile storage.
@@ -1179,6 +1385,128 @@ uint32_t res_GetBufferBackupPeriod
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set up a rollup tier of an Observation.  See admin_SetRollupTier() for more information.
+ */
+//--------------------------------------------------------------------------------------------------
+void res_SetRollupTier
+(
+    res_Resource_t* resPtr,
+    uint32_t tier,      ///< Tier number (0 = finest).
+    double period,      ///< Length of each bucket's period (seconds).
+    uint32_t maxCount   ///< Number of buckets to keep (0 = remove this tier and all coarser ones).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    obs_SetRollupTier(resPtr, tier, period, maxCount);
+
+    if (IsUpdateInProgress)
+    {
+        resPtr->flags |= RES_FLAG_CHANGING_CONFIG;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the settings of a rollup tier of an Observation.
+ *
+ * @return The number of buckets kept in the tier, or 0 if the tier is not set.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t res_GetRollupTier
+(
+    res_Resource_t* resPtr,
+    uint32_t tier,      ///< Tier number (0 = finest).
+    double* periodPtr   ///< [OUT] Length of each bucket's period (seconds), or NAN if not set.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return obs_GetRollupTier(resPtr, tier, periodPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the size of an Observation's quantile sketch.  See admin_SetQuantileSketch() for more
+ * information.
+ */
+//--------------------------------------------------------------------------------------------------
+void res_SetQuantileSketch
+(
+    res_Resource_t* resPtr,
+    uint32_t size       ///< Number of centroids per segment (0 = don't keep a sketch).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    obs_SetQuantileSketch(resPtr, size);
+
+    if (IsUpdateInProgress)
+    {
+        resPtr->flags |= RES_FLAG_CHANGING_CONFIG;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the size of an Observation's quantile sketch.
+ *
+ * @return The number of centroids each segment of the sketch is compressed down to, or 0 if no
+ *         sketch is kept.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t res_GetQuantileSketch
+(
+    res_Resource_t* resPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return obs_GetQuantileSketch(resPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the bucket boundaries of an Observation's histogram.  See admin_SetHistogram() for more
+ * information.
+ */
+//--------------------------------------------------------------------------------------------------
+void res_SetHistogram
+(
+    res_Resource_t* resPtr,
+    const double* boundsPtr,    ///< Bucket boundaries, in increasing order.
+    size_t boundsSize           ///< Number of boundaries (0 = don't keep a histogram).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    obs_SetHistogram(resPtr, boundsPtr, boundsSize);
+
+    if (IsUpdateInProgress)
+    {
+        resPtr->flags |= RES_FLAG_CHANGING_CONFIG;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the bucket boundaries of an Observation's histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+void res_GetHistogram
+(
+    res_Resource_t* resPtr,
+    double* boundsPtr,      ///< [OUT] Bucket boundaries, in increasing order.
+    size_t* boundsSizePtr   ///< [INOUT] Room in the array, then number of boundaries (0 if none).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    obs_GetHistogram(resPtr, boundsPtr, boundsSizePtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Mark an Output resource "optional".  (By default, they are marked "mandatory".)
@@ -1211,6 +1539,55 @@ bool res_IsMandatory
     return ioPoint_IsMandatory(resPtr);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a handle on an Input or Output resource, so data samples can be pushed to it without
+ * looking it up in the resource tree every time.
+ *
+ * @return Reference to the handle.  Must be closed using res_CloseHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+ioPoint_HandleRef_t res_OpenHandle
+(
+    res_Resource_t* resPtr  ///< Ptr to the Input or Output resource.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return ioPoint_OpenHandle(resPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a handle opened using res_OpenHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+void res_CloseHandle
+(
+    ioPoint_HandleRef_t handleRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ioPoint_CloseHandle(handleRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the resource a handle is open on.
+ *
+ * @return Ptr to the resource, or NULL if the resource has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+res_Resource_t* res_GetHandleResource
+(
+    ioPoint_HandleRef_t handleRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return ioPoint_GetHandleResource(handleRef);
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -1661,12 +2038,143 @@ void res_ReadBufferJson
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read data out of a buffer.  Data is written to a given file descriptor in a packed binary format:
+ * a header giving the data type, followed by a record for each sample.
+ * See query_ReadBufferBinary() for details.
+ */
+//--------------------------------------------------------------------------------------------------
+void res_ReadBufferBinary
+(
+    res_Resource_t* resPtr, ///< Ptr to the resource object for the Observation.
+    double startAfter,  ///< Start after this many seconds ago, or after an absolute number of
+                        ///< seconds since the Epoch (if startafter > 30 years).
+                        ///< Use NAN (not a number) to read the whole buffer.
+    int outputFile, ///< File descriptor to write the data to.
+    query_ReadCompletionFunc_t handlerPtr, ///< Completion callback.
+    void* contextPtr    ///< Value to be passed to completion callback.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    obs_ReadBufferBinary(resPtr, startAfter, outputFile, handlerPtr, contextPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a read cursor on an Observation's buffer, so the buffered samples newer than a given time
+ * can be read a batch at a time, with each batch carrying on from where the last one left off.
+ *
+ * @return Reference to the cursor.  Must be closed using res_CloseReadCursor().
+ */
+//--------------------------------------------------------------------------------------------------
+obs_ReadCursorRef_t res_OpenReadCursor
+(
+    res_Resource_t* resPtr, ///< Ptr to the resource object for the Observation.
+    double startAfter   ///< Start after this many seconds ago, or after an absolute number of
+                        ///< seconds since the Epoch (if startafter > 30 years).
+                        ///< Use NAN (not a number) to read the whole buffer.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return obs_OpenReadCursor(resPtr, startAfter);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a read cursor.
+ */
+//--------------------------------------------------------------------------------------------------
+void res_CloseReadCursor
+(
+    obs_ReadCursorRef_t cursorRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    obs_CloseReadCursor(cursorRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of Boolean samples through a read cursor.
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).
+ *  - LE_FORMAT_ERROR if the buffered samples aren't Boolean.
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t res_ReadCursorBoolean
+(
+    obs_ReadCursorRef_t cursorRef,
+    double* timestampsPtr,  ///< [OUT] Array to store the timestamps in.
+    bool* valuesPtr,        ///< [OUT] Array to store the values in.
+    size_t* countPtr        ///< [INOUT] Size of the arrays / number of samples read.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return obs_ReadCursorBoolean(cursorRef, timestampsPtr, valuesPtr, countPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of numeric samples through a read cursor.
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).
+ *  - LE_FORMAT_ERROR if the buffered samples aren't numeric.
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t res_ReadCursorNumeric
+(
+    obs_ReadCursorRef_t cursorRef,
+    double* timestampsPtr,  ///< [OUT] Array to store the timestamps in.
+    double* valuesPtr,      ///< [OUT] Array to store the values in.
+    size_t* countPtr        ///< [INOUT] Size of the arrays / number of samples read.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return obs_ReadCursorNumeric(cursorRef, timestampsPtr, valuesPtr, countPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of samples (of any data type) through a read cursor, as a JSON array of as
+ * many samples as fit in a given buffer, in the same format as res_ReadBufferJson().
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).  The buffer holds an empty array.
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t res_ReadCursorJson
+(
+    obs_ReadCursorRef_t cursorRef,
+    char* buffPtr,      ///< [OUT] Ptr to buffer where the JSON array will be stored.
+    size_t buffSize     ///< [IN] Size of the buffer, in bytes (at least 3).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return obs_ReadCursorJson(cursorRef, buffPtr, buffSize);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Find the oldest data sample held in a given Observation's buffer that is newer than a
  * given timestamp.
  *
- * @return Reference to the sample, or NULL if not found.
+ * @return Reference to the sample, or NULL if not found.  The caller is responsible for
+ *         releasing the reference.
  */
 //--------------------------------------------------------------------------------------------------
 dataSample_Ref_t res_FindBufferedSampleAfter
@@ -1883,3 +2391,69 @@ double res_QueryStdDev
 {
     return obs_QueryStdDev(resPtr, startTime);
 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the count, minimum, maximum, mean and standard deviation of all values found within a given
+ * time span in an Observation's data set, along with the time span they cover.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_NOT_FOUND if there are no values in the time span.
+ *  - LE_FORMAT_ERROR if the Observation's data set isn't numerical.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t res_QueryStats
+(
+    res_Resource_t* resPtr,    ///< Ptr to Observation resource.
+    double startTime,   ///< If < 30 years then seconds before now; else seconds since the Epoch.
+    obs_Stats_t* statsPtr   ///< [OUT] The aggregates (count 0 and NANs unless LE_OK).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return obs_QueryStats(resPtr, startTime, statsPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Estimate a percentile of the values found within a given time span in an Observation's buffer,
+ * using its quantile sketch.
+ *
+ * @return The value, or NAN (not-a-number) if the Observation doesn't keep a quantile sketch or
+ *         there's no numerical data in its buffer within the time span.
+ */
+//--------------------------------------------------------------------------------------------------
+double res_QueryPercentile
+(
+    res_Resource_t* resPtr,    ///< Ptr to Observation resource.
+    double startTime,   ///< If < 30 years then seconds before now; else seconds since the Epoch.
+    double percentile   ///< Percentile (0 to 100).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return obs_QueryPercentile(resPtr, startTime, percentile);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fetch the counts in each bucket of an Observation's histogram.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_NOT_FOUND if the Observation doesn't keep a histogram.
+ *  - LE_OVERFLOW if the array is too small to hold all the counts.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t res_QueryHistogram
+(
+    res_Resource_t* resPtr,    ///< Ptr to Observation resource.
+    uint64_t* countsPtr,    ///< [OUT] Number of values in each bucket, lowest bucket first.
+    size_t* countsSizePtr   ///< [INOUT] Room in the array, then number of buckets.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return obs_QueryHistogram(resPtr, countsPtr, countsSizePtr);
+}
@@ -0,0 +1,293 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file ringFile.c
+ *
+ * Implementation of the Ring File module.
+ *
+ * A ring file starts with a ringFile_Header_t holding the ring's head index, sample count and the
+ * oldest sample's sequence number, and is followed by a ring of fixed-size ringFile_Record_t
+ * records, each holding a sample and its sequence number.  Records are always written before the
+ * header is updated to count them in, so a crash of the Data Hub (whose writes to the mapping
+ * survive in the page cache) never leaves the header counting a record that wasn't written.  If
+ * power is lost, the file's pages may have reached non-volatile storage in any order, so a ring
+ * file is only trusted up to the first record whose sequence number doesn't follow on from the
+ * header's.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "ringFile.h"
+#include <sys/mman.h>
+
+/// Magic number at the start of a ring file ("DHRF" in little-endian byte order).
+#define RING_FILE_MAGIC 0x46524844
+
+/// Ring file format version written by this implementation.
+#define RING_FORMAT_VERSION 1
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map a ring file into memory, for reading and writing.
+ *
+ * @return Pointer to the header at the start of the mapping, or NULL if failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static ringFile_Header_t* MapRingFile
+(
+    int fd,             ///< The ring file.
+    size_t size,        ///< Size of the ring file, in bytes.
+    const char* path    ///< Path of the ring file (for logging).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED)
+    {
+        LE_CRIT("Failed to map ring file '%s' (%m).", path);
+        return NULL;
+    }
+
+    return addr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the size of a ring file holding a given number of records.
+ *
+ * @return The size, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t ringFile_GetBytes
+(
+    size_t maxCount
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return sizeof(ringFile_Header_t) + (maxCount * sizeof(ringFile_Record_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a pointer to the first record in the ring of a ring file mapped into memory.
+ *
+ * @return Pointer to the record.
+ */
+//--------------------------------------------------------------------------------------------------
+ringFile_Record_t* ringFile_GetRecords
+(
+    ringFile_Header_t* ringPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (ringFile_Record_t*)(ringPtr + 1);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a new ring file with a given number of records, and map it into memory.  The new file
+ * only replaces the existing one (if any) once it is committed by closing the file descriptor
+ * with le_atomFile_Close(), so a crash while it is being filled leaves the old one in place.
+ *
+ * @return Pointer to the header at the start of the mapping (with the buffer state still to be
+ *         filled in), or NULL if failed.
+ */
+//--------------------------------------------------------------------------------------------------
+ringFile_Header_t* ringFile_Create
+(
+    const char* path,
+    size_t maxCount,    ///< Number of records.
+    int* fdPtr          ///< [OUT] File descriptor to commit the file with.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int fd = le_atomFile_Create(path, LE_FLOCK_READ_AND_WRITE, LE_FLOCK_REPLACE_IF_EXIST, 0600);
+    if (fd < 0)
+    {
+        LE_CRIT("Unable to open file '%s' for writing (%s).", path, LE_RESULT_TXT(fd));
+        return NULL;
+    }
+
+    size_t size = ringFile_GetBytes(maxCount);
+    if (ftruncate(fd, size) != 0)
+    {
+        LE_CRIT("Failed to size ring file '%s' (%m).", path);
+        le_atomFile_Cancel(fd);
+        return NULL;
+    }
+
+    ringFile_Header_t* ringPtr = MapRingFile(fd, size, path);
+    if (ringPtr == NULL)
+    {
+        le_atomFile_Cancel(fd);
+        return NULL;
+    }
+
+    memset(ringPtr, 0, sizeof(*ringPtr));
+    ringPtr->magic = RING_FILE_MAGIC;
+    ringPtr->version = RING_FORMAT_VERSION;
+    ringPtr->maxCount = maxCount;
+
+    *fdPtr = fd;
+
+    return ringPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open an existing ring file and map it into memory, if it is a valid one.  The file is used at
+ * the size it was created with.
+ *
+ * @return Pointer to the header at the start of the mapping, or NULL if there is no file at the
+ *         path or it isn't valid.
+ */
+//--------------------------------------------------------------------------------------------------
+ringFile_Header_t* ringFile_Open
+(
+    const char* path
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int fd = open(path, O_RDWR);
+    if (fd == -1)
+    {
+        if (errno != ENOENT)
+        {
+            LE_CRIT("Failed to open ring file '%s' (%m).", path);
+        }
+        return NULL;
+    }
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || (st.st_size < (off_t)sizeof(ringFile_Header_t)))
+    {
+        LE_WARN("Ignoring invalid ring file '%s'.", path);
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = st.st_size;
+    ringFile_Header_t* ringPtr = MapRingFile(fd, size, path);
+    close(fd);
+    if (ringPtr == NULL)
+    {
+        return NULL;
+    }
+
+    io_DataType_t dataType = ringPtr->dataType;
+    if (   (ringPtr->magic != RING_FILE_MAGIC)
+        || (ringPtr->version != RING_FORMAT_VERSION)
+        || (ringPtr->maxCount == 0)
+        || (size != ringFile_GetBytes(ringPtr->maxCount))
+        || (ringPtr->oldestIndex >= ringPtr->maxCount)
+        || (ringPtr->count > ringPtr->maxCount)
+        || (   (dataType != IO_DATA_TYPE_TRIGGER)
+            && (dataType != IO_DATA_TYPE_BOOLEAN)
+            && (dataType != IO_DATA_TYPE_NUMERIC)  )  )
+    {
+        LE_WARN("Ignoring invalid ring file '%s'.", path);
+        munmap(ringPtr, size);
+        return NULL;
+    }
+
+    return ringPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count the records of a ring file mapped into memory that hold the samples its header says they
+ * should.  If power was lost before all of the file's pages were written to non-volatile storage,
+ * its header may count records that hold older samples, so only the samples up to the first one
+ * out of order can be trusted.
+ *
+ * @return The number of samples that can be trusted, starting with the oldest.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t ringFile_CheckRecords
+(
+    ringFile_Header_t* ringPtr,
+    const char* path    ///< Path of the ring file (for logging).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const ringFile_Record_t* recordsPtr = ringFile_GetRecords(ringPtr);
+    const ringFile_Record_t* prevPtr = NULL;
+
+    size_t i;
+    for (i = 0; i < ringPtr->count; i++)
+    {
+        const ringFile_Record_t* recordPtr =
+            &recordsPtr[(ringPtr->oldestIndex + i) % ringPtr->maxCount];
+
+        if (   (recordPtr->seq != (ringPtr->oldestSeq + i))
+            || (!isfinite(recordPtr->timestamp))
+            || ((prevPtr != NULL) && (recordPtr->timestamp < prevPtr->timestamp))  )
+        {
+            LE_WARN("Ring file '%s' is missing samples. Keeping %zu of %u.",
+                    path,
+                    i,
+                    (unsigned int)ringPtr->count);
+            break;
+        }
+
+        prevPtr = recordPtr;
+    }
+
+    return i;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Flush the changes to a ring file mapped into memory to non-volatile storage.  Can be queued to
+ * another thread with le_event_QueueFunctionToThread().
+ */
+//--------------------------------------------------------------------------------------------------
+void ringFile_Sync
+(
+    void* ringPtr,      ///< [IN] Header at the start of the mapping.
+    void* unusedPtr     ///< [IN] Not used.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_UNUSED(unusedPtr);
+
+    size_t size = ringFile_GetBytes(((ringFile_Header_t*)ringPtr)->maxCount);
+
+    if (msync(ringPtr, size, MS_SYNC) != 0)
+    {
+        LE_CRIT("Failed to sync ring file (%m).");
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unmap a ring file from memory.  The file is left as it is.  Can be queued to another thread with
+ * le_event_QueueFunctionToThread(), so that it comes after any syncs queued before.
+ */
+//--------------------------------------------------------------------------------------------------
+void ringFile_Unmap
+(
+    void* ringPtr,      ///< [IN] Header at the start of the mapping.
+    void* unusedPtr     ///< [IN] Not used.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_UNUSED(unusedPtr);
+
+    size_t size = ringFile_GetBytes(((ringFile_Header_t*)ringPtr)->maxCount);
+
+    if (munmap(ringPtr, size) != 0)
+    {
+        LE_CRIT("Failed to unmap ring file (%m).");
+    }
+}
@@ -0,0 +1,148 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file ringFile.h
+ *
+ * Interface to the Ring File module, which creates, validates and maps into memory the files that
+ * hold persistent data sample buffers.  A ring file mapped into memory is used as the buffer in
+ * place.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef RING_FILE_H_INCLUDE_GUARD
+#define RING_FILE_H_INCLUDE_GUARD
+
+
+/// Header of a ring file holding a persistent data sample buffer.  The ring of records follows
+/// it, so the buffer can be used in place where the file is mapped into memory.
+typedef struct
+{
+    uint32_t magic;         ///< Magic number identifying a ring file.
+    uint8_t version;        ///< Ring file format version.
+    uint8_t dataType;       ///< Data type of the samples (io_DataType_t).
+    uint16_t reserved;      ///< Zero.
+    uint32_t maxCount;      ///< Number of records in the ring.
+    uint32_t oldestIndex;   ///< Index of the oldest sample's record (the head of the ring).
+    uint32_t count;         ///< Number of samples (the tail is count records after the head).
+    uint32_t reserved2;     ///< Zero.
+    uint64_t oldestSeq;     ///< Sequence number of the oldest sample.
+}
+ringFile_Header_t;
+
+
+/// Record in the ring of a ring file.  Its layout is the same whatever the platform, and its size
+/// divides the page size, so no record straddles two pages of the file.
+typedef struct
+{
+    double timestamp;   ///< Timestamp of the sample.
+    double value;       ///< Value of a numeric sample, 1 or 0 for a Boolean sample, else 0.
+    uint64_t seq;       ///< Sequence number of the sample.
+    uint64_t reserved;  ///< Zero.
+}
+ringFile_Record_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the size of a ring file holding a given number of records.
+ *
+ * @return The size, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t ringFile_GetBytes
+(
+    size_t maxCount
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a pointer to the first record in the ring of a ring file mapped into memory.
+ *
+ * @return Pointer to the record.
+ */
+//--------------------------------------------------------------------------------------------------
+ringFile_Record_t* ringFile_GetRecords
+(
+    ringFile_Header_t* ringPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a new ring file with a given number of records, and map it into memory.  The new file
+ * only replaces the existing one (if any) once it is committed by closing the file descriptor
+ * with le_atomFile_Close(), so a crash while it is being filled leaves the old one in place.
+ *
+ * @return Pointer to the header at the start of the mapping (with the buffer state still to be
+ *         filled in), or NULL if failed.
+ */
+//--------------------------------------------------------------------------------------------------
+ringFile_Header_t* ringFile_Create
+(
+    const char* path,
+    size_t maxCount,    ///< Number of records.
+    int* fdPtr          ///< [OUT] File descriptor to commit the file with.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open an existing ring file and map it into memory, if it is a valid one.  The file is used at
+ * the size it was created with.
+ *
+ * @return Pointer to the header at the start of the mapping, or NULL if there is no file at the
+ *         path or it isn't valid.
+ */
+//--------------------------------------------------------------------------------------------------
+ringFile_Header_t* ringFile_Open
+(
+    const char* path
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count the records of a ring file mapped into memory that hold the samples its header says they
+ * should.  If power was lost before all of the file's pages were written to non-volatile storage,
+ * its header may count records that hold older samples, so only the samples up to the first one
+ * out of order can be trusted.
+ *
+ * @return The number of samples that can be trusted, starting with the oldest.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t ringFile_CheckRecords
+(
+    ringFile_Header_t* ringPtr,
+    const char* path    ///< Path of the ring file (for logging).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Flush the changes to a ring file mapped into memory to non-volatile storage.  Can be queued to
+ * another thread with le_event_QueueFunctionToThread().
+ */
+//--------------------------------------------------------------------------------------------------
+void ringFile_Sync
+(
+    void* ringPtr,      ///< [IN] Header at the start of the mapping.
+    void* unusedPtr     ///< [IN] Not used.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unmap a ring file from memory.  The file is left as it is.  Can be queued to another thread with
+ * le_event_QueueFunctionToThread(), so that it comes after any syncs queued before.
+ */
+//--------------------------------------------------------------------------------------------------
+void ringFile_Unmap
+(
+    void* ringPtr,      ///< [IN] Header at the start of the mapping.
+    void* unusedPtr     ///< [IN] Not used.
+);
+
+
+#endif // RING_FILE_H_INCLUDE_GUARD
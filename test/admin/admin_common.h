@@ -35,6 +35,20 @@
 //--------------------------------------------------------------------------------------------------
 #define ADMIN_MAX_TRANSFORM_PARAMETERS 8
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of rollup tiers an Observation can keep.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ADMIN_MAX_ROLLUP_TIERS 4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of an Observation's quantile sketch.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ADMIN_MAX_SKETCH_SIZE 500
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Enumerates the different types of entries that can exist in the resource tree.
@@ -88,12 +102,50 @@ typedef enum
         ///< Standard Deviation
     ADMIN_OBS_TRANSFORM_TYPE_MAX = 3,
         ///< Maximum value in buffer
-    ADMIN_OBS_TRANSFORM_TYPE_MIN = 4
+    ADMIN_OBS_TRANSFORM_TYPE_MIN = 4,
         ///< Minimum value in buffer
+    ADMIN_OBS_TRANSFORM_TYPE_MOVING_MEAN = 5,
+        ///< Mean of a moving window (params: period, count)
+    ADMIN_OBS_TRANSFORM_TYPE_MOVING_STDDEV = 6,
+        ///< Standard Deviation of a moving window
+    ADMIN_OBS_TRANSFORM_TYPE_MOVING_MAX = 7,
+        ///< Maximum value in a moving window
+    ADMIN_OBS_TRANSFORM_TYPE_MOVING_MIN = 8,
+        ///< Minimum value in a moving window
+    ADMIN_OBS_TRANSFORM_TYPE_EWMA = 9,
+        ///< Exponentially weighted moving average (param: weight)
+    ADMIN_OBS_TRANSFORM_TYPE_RATE = 10
+        ///< Rate of change per second
 }
 admin_TransformType_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enumerates the different aggregates an observation can report at the end of each aggregation
+ * window.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    ADMIN_OBS_AGGREGATION_TYPE_NONE = 0,
+        ///< No aggregation
+    ADMIN_OBS_AGGREGATION_TYPE_MEAN = 1,
+        ///< Mean of the values received in the window
+    ADMIN_OBS_AGGREGATION_TYPE_MIN = 2,
+        ///< Minimum value received in the window
+    ADMIN_OBS_AGGREGATION_TYPE_MAX = 3,
+        ///< Maximum value received in the window
+    ADMIN_OBS_AGGREGATION_TYPE_COUNT = 4,
+        ///< Number of samples received in the window
+    ADMIN_OBS_AGGREGATION_TYPE_LAST = 5,
+        ///< Last sample received in the window
+    ADMIN_OBS_AGGREGATION_TYPE_HISTOGRAM = 6
+        ///< Histogram of the values received in the window
+}
+admin_AggregationType_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Reference type used by Add/Remove functions for EVENT 'admin_TriggerPush'
@@ -760,6 +812,42 @@ LE_SHARED admin_TransformType_t ifgen_admin_GetTransform
         ///< [IN] Path within the /obs/ namespace.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set an Observation to aggregate the samples it accepts over fixed-length (tumbling) windows
+ * of wall-clock time.  The Observation's value is only updated at the end of each window, with
+ * the aggregate of the samples accepted during the window.
+ *
+ * Set the aggregation type to OBS_AGGREGATION_TYPE_NONE to stop aggregating.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void ifgen_admin_SetAggregation
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+        admin_AggregationType_t aggregationType,
+        ///< [IN] Type of aggregate to report
+        double period
+        ///< [IN] Length of the aggregation windows (seconds)
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the type of aggregation currently applied to an Observation.
+ *
+ * @return The AggregationType
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED admin_AggregationType_t ifgen_admin_GetAggregation
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+        double* periodPtr
+        ///< [OUT] Length of the aggregation windows (seconds)
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the JSON member/element specifier for extraction of data from within a structured JSON
@@ -831,6 +919,73 @@ LE_SHARED uint32_t ifgen_admin_GetBufferMaxCount
         ///< [IN] Path within the /obs/ namespace.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set whether a given Observation's numeric data samples should be buffered compressed.
+ * Compressed samples take much less memory (often only a few bits each), but reading or querying
+ * the buffer means decoding them.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void ifgen_admin_SetBufferCompression
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+        bool compress
+        ///< [IN] true = compress numeric samples, false = don't (the default).
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a given Observation's numeric data samples are set to be buffered compressed.
+ * See admin_SetBufferCompression() for more information.
+ *
+ * @return true if they are, false if not or the Observation does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED bool ifgen_admin_GetBufferCompression
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        const char* LE_NONNULL path
+        ///< [IN] Path within the /obs/ namespace.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set whether a given Observation's trigger, Boolean and numeric data samples should be buffered in
+ * a memory-mapped file in non-volatile storage, so the buffer survives a restart of the Data Hub
+ * without having to be backed up.  Changes are flushed to non-volatile storage at most once per
+ * sync period, or whenever the operating system chooses to, if the sync period is zero.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void ifgen_admin_SetBufferPersistence
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+        bool persist,
+        ///< [IN] true = keep the buffer in a file, false = in memory only (the default).
+        uint32_t syncPeriod
+        ///< [IN] Minimum number of seconds between syncs of the file (0 = leave it to the OS).
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a given Observation's buffer is set to be kept in a memory-mapped file.
+ * See admin_SetBufferPersistence() for more information.
+ *
+ * @return true if it is, false if not or the Observation does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED bool ifgen_admin_GetBufferPersistence
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+        uint32_t* syncPeriodPtr
+        ///< [OUT] Minimum number of seconds between syncs of the file.
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the minimum time between backups of an Observation's buffer to non-volatile storage.
@@ -864,6 +1019,121 @@ LE_SHARED uint32_t ifgen_admin_GetBufferBackupPeriod
         ///< [IN] Path within the /obs/ namespace.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set up a rollup tier of an Observation, which keeps a fixed number of buckets summarizing the
+ * numerical values received during consecutive fixed-length periods.  Tier 0 is the finest, and
+ * each tier's period must be longer than the previous tier's.
+ *
+ * Setting maxCount to 0 removes the tier and all coarser ones.  Invalid settings are logged and
+ * ignored.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void ifgen_admin_SetRollupTier
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+        uint32_t tier,
+        ///< [IN] Tier number (0 = finest, < MAX_ROLLUP_TIERS).
+        double period,
+        ///< [IN] Length of each bucket's period (seconds).
+        uint32_t maxCount
+        ///< [IN] Number of buckets to keep (0 = remove the tier).
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the settings of a rollup tier of an Observation.
+ * See admin_SetRollupTier() for more information.
+ *
+ * @return The number of buckets kept in the tier, or 0 if the tier is not set or the Observation
+ *         does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED uint32_t ifgen_admin_GetRollupTier
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+        uint32_t tier,
+        ///< [IN] Tier number (0 = finest).
+        double* periodPtr
+        ///< [OUT] Length of each bucket's period (seconds).
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the size of the quantile sketch an Observation keeps of the numerical values in its buffer,
+ * to estimate percentiles of them (see query_GetPercentile()).  The size is the number of
+ * clusters of values kept for each part of the buffer, which bounds the sketch's memory use.
+ *
+ * Setting the size to 0 stops keeping a sketch.  Sizes above MAX_SKETCH_SIZE are logged and
+ * ignored.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void ifgen_admin_SetQuantileSketch
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+        uint32_t size
+        ///< [IN] Size of the sketch (0 = don't keep one).
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the size of an Observation's quantile sketch.
+ * See admin_SetQuantileSketch() for more information.
+ *
+ * @return The size, or 0 if no sketch is kept or the Observation does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED uint32_t ifgen_admin_GetQuantileSketch
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        const char* LE_NONNULL path
+        ///< [IN] Path within the /obs/ namespace.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the bucket boundaries of the histogram an Observation keeps of the numerical values it
+ * receives (see query_GetHistogram()).  The counts start again from zero whenever the boundaries
+ * are set.
+ *
+ * Setting no boundaries stops keeping a histogram.  More than MAX_HISTOGRAM_BUCKETS - 1
+ * boundaries, or boundaries that aren't finite and strictly increasing, are logged and ignored.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void ifgen_admin_SetHistogram
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+        const double* boundsPtr,
+        ///< [IN] Bucket boundaries, in increasing order.
+        size_t boundsSize
+        ///< [IN]
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the bucket boundaries of an Observation's histogram.
+ * See admin_SetHistogram() for more information.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void ifgen_admin_GetHistogram
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+        double* boundsPtr,
+        ///< [OUT] Bucket boundaries (none if not kept).
+        size_t* boundsSizePtr
+        ///< [INOUT]
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the default value of a resource to a Boolean value.
@@ -267,9 +267,26 @@
  *  - OBS_TRANSFORM_TYPE_STDDEV - Standard Deviation
  *  - OBS_TRANSFORM_TYPE_MAX    - Maximum value in buffer
  *  - OBS_TRANSFORM_TYPE_MIN    - Minimum value in buffer
- *
- * The optional parameters are dependent upon the transform being applied - e.g. Tap coefficients
- * for Z-transforms, such as IIR or FIR filtering.  Currently unused
+ *  - OBS_TRANSFORM_TYPE_MOVING_MEAN   - Mean of a moving window of values
+ *  - OBS_TRANSFORM_TYPE_MOVING_STDDEV - Standard Deviation of a moving window of values
+ *  - OBS_TRANSFORM_TYPE_MOVING_MAX    - Maximum value in a moving window
+ *  - OBS_TRANSFORM_TYPE_MOVING_MIN    - Minimum value in a moving window
+ *  - OBS_TRANSFORM_TYPE_EWMA          - Exponentially weighted moving average
+ *  - OBS_TRANSFORM_TYPE_RATE          - Rate of change (per second) since the previous value
+ *
+ * The optional parameters are dependent upon the transform being applied (missing parameters are
+ * taken as 0):
+ *  - Moving window transforms: parameter 0 is the window period in seconds (0 = not limited by
+ *    time) and parameter 1 is the maximum number of values in the window (0 = not limited by
+ *    count).  At least one of them must be non-zero.  The window is kept separately from the
+ *    Observation's buffer, so the buffer size doesn't need to be set to shape the window.
+ *  - OBS_TRANSFORM_TYPE_EWMA: parameter 0 is the weight given to the newest value (greater than 0
+ *    and at most 1).  The first value is reported as is.
+ *  - The other transforms take no parameters.
+ *
+ * Transforms that operate on a moving window, the weighted average and the rate of change are all
+ * updated incrementally as each new value arrives.  A transform setting with an unknown type or
+ * invalid parameters is ignored.
  *
  * The Following function can be used to retrieve the transform type:
  *  - admin_GetTransform(path)
@@ -280,6 +297,45 @@
  * admin_SetTransform(obsPath, OBS_TRANSFORM_TYPE_MEAN, NULL, 0);
  * @endcode
  *
+ * Or to report the maximum of the values received in the last 60 seconds:
+ *
+ * @code
+ * double params[] = { 60, 0 };
+ * admin_SetTransform(obsPath, OBS_TRANSFORM_TYPE_MOVING_MAX, params, 2);
+ * @endcode
+ *
+ *
+ * @subsubsection c_dataHubAdmin_ObsAggregation Aggregation
+ *
+ * An Observation can aggregate the samples it accepts over fixed-length (tumbling) windows of
+ * wall-clock time, such as 10 seconds.  Instead of updating its value (and pushing to its
+ * destinations and push handlers) for every accepted sample, the Observation updates its value
+ * once at the end of each window, with an aggregate of the samples accepted during the window.
+ * This greatly reduces the downstream traffic for high-rate sensors.
+ *
+ * Aggregation is applied after buffering, transforms and filtering.  Windows are aligned to
+ * multiples of the period since the Epoch, and the aggregate is timestamped with the end of its
+ * window.  Nothing is pushed for a window in which no samples were accepted.
+ *
+ *  - admin_SetAggregation(path, type, period)
+ *  - admin_GetAggregation(path, &period)
+ *
+ * The type of aggregate is determined by the argument to the function:
+ *  - OBS_AGGREGATION_TYPE_NONE  - No aggregation (every accepted sample updates the value)
+ *  - OBS_AGGREGATION_TYPE_MEAN  - Mean of the numeric (or Boolean, as 0 or 1) values
+ *  - OBS_AGGREGATION_TYPE_MIN   - Minimum numeric (or Boolean) value
+ *  - OBS_AGGREGATION_TYPE_MAX   - Maximum numeric (or Boolean) value
+ *  - OBS_AGGREGATION_TYPE_COUNT - Number of samples of any type
+ *  - OBS_AGGREGATION_TYPE_LAST  - Last sample (of any type)
+ *  - OBS_AGGREGATION_TYPE_HISTOGRAM - Histogram of the numeric (or Boolean) values, in the
+ *    Observation's histogram buckets (see @ref c_dataHubAdmin_ObsHistogram)
+ *
+ * For example, to report the mean of a high-rate sensor's values every 10 seconds:
+ *
+ * @code
+ * admin_SetAggregation(obsPath, OBS_AGGREGATION_TYPE_MEAN, 10);
+ * @endcode
+ *
  *
  * @subsubsection c_dataHubAdmin_JsonExtraction Extracting Structured JSON Data
  *
@@ -322,10 +378,14 @@
  * The following functions can be used to configure buffering of data samples that pass the
  * Observation's filtering criteria:
  *  - admin_SetBufferMaxCount() - set the buffer size
+ *  - admin_SetBufferCompression() - compress buffered numeric samples
+ *  - admin_SetBufferPersistence() - keep the buffer in a memory-mapped file
  *  - admin_SetBufferBackupPeriod() - enable periodic backups of the buffer to non-volatile storage
  *
  * The following functions can be used to read the buffer configuration settings:
  *  - admin_GetBufferMaxCount()
+ *  - admin_GetBufferCompression()
+ *  - admin_GetBufferPersistence()
  *  - admin_GetBufferBackupPeriod()
  *
  * If the buffer backup period is set to a non-zero number of seconds, then
@@ -343,6 +403,103 @@
  *  - the Data Hub application is uninstalled from the device
  *  - the Observation changes data type (because its data source pushed a different type of data)
  *
+ * Buffered numeric samples can be compressed, using admin_SetBufferCompression(), to fit a longer
+ * history in the same memory.  Timestamps are stored as the change in the interval between
+ * samples, and values as the bits that differ from the previous value, in fixed-size blocks that
+ * are discarded whole as they age out.  Samples arriving at a regular rate with slowly-changing
+ * values typically take a few bits each.  Compression is lossless, but reading and querying a
+ * compressed buffer takes more CPU time, as its samples have to be decoded.  Buffers of other
+ * data types are never compressed.
+ *
+ * Trigger, Boolean and numeric samples can instead be buffered in a memory-mapped file, using
+ * admin_SetBufferPersistence().  Every sample added to the buffer goes straight into the file, so
+ * nothing is lost if the Data Hub is stopped or crashes, and the buffer is back in place as soon as
+ * the Observation's buffer size and persistence are set again after a restart (although the
+ * Observation doesn't get a current value until it receives a new sample).  How much can be lost
+ * if power fails depends on how often the file is synced to non-volatile storage.  A persistent
+ * buffer isn't compressed.  Buffers of string and JSON samples are kept in memory.
+ *
+ *
+ * @subsubsection c_dataHubAdmin_ObsRollupTiers Rollup Tiers
+ *
+ * Keeping a long history of a high-rate sensor in a buffer takes a lot of memory.  Instead, an
+ * Observation can keep up to @c ADMIN_MAX_ROLLUP_TIERS tiers of downsampled numerical history
+ * alongside (or instead of) its buffer.  Each tier holds a fixed number of buckets, each
+ * summarizing the count, mean, standard deviation, minimum and maximum of the numeric (or
+ * Boolean, as 0 or 1) values received during one fixed-length period.  Periods are aligned to
+ * multiples of the period length since the Epoch.
+ *
+ *  - admin_SetRollupTier(path, tier, period, maxCount)
+ *  - admin_GetRollupTier(path, tier, &period)
+ *
+ * Tier 0 is the finest.  Tiers must be set up in order, and each tier's period must be longer
+ * than the previous tier's.  Setting a tier's @c maxCount to 0 removes that tier and all
+ * coarser ones.
+ *
+ * For example, to keep 60 one-minute buckets and 24 one-hour buckets:
+ *
+ * @code
+ * admin_SetRollupTier(obsPath, 0, 60, 60);
+ * admin_SetRollupTier(obsPath, 1, 3600, 24);
+ * @endcode
+ *
+ * When the buffer doesn't go back as far as the start time of a query made using
+ * query_GetMin(), query_GetMax(), query_GetMean() or query_GetStdDev(), the query is answered
+ * from the finest tier that does (or, if none do, from the tier that goes back the furthest).
+ * The answer then includes whole buckets, so it can include values received up to one bucket
+ * period before the start time.
+ *
+ * Rollup tiers are included in the Observation's buffer backups.
+ *
+ *
+ * @subsubsection c_dataHubAdmin_ObsQuantileSketch Quantile Sketch
+ *
+ * Percentiles of the numeric (or Boolean, as 0 or 1) values in an Observation's buffer, fetched
+ * using query_GetPercentile(), are estimated from a quantile sketch that the Observation keeps
+ * alongside its buffer, so the buffer doesn't have to be fetched and sorted to get them.  The
+ * sketch is only kept if it has been given a size:
+ *
+ *  - admin_SetQuantileSketch(path, size)
+ *  - admin_GetQuantileSketch(path)
+ *
+ * The size (up to @c ADMIN_MAX_SKETCH_SIZE) sets how many clusters of values the sketch keeps
+ * for each eighth or so of the buffer, which bounds its memory use.  Larger sizes give more
+ * accurate percentiles; 100 is usually plenty.  Percentiles near 0 and 100 are more accurate than
+ * the ones in between.
+ *
+ * Values leave the sketch an eighth or so of the buffer at a time, so it can include some values
+ * that have just left the buffer (or that were received a little before the start time of the
+ * query).  The sketch isn't backed up, but is rebuilt from the buffer when it is restored.
+ *
+ *
+ * @subsubsection c_dataHubAdmin_ObsHistogram Histogram
+ *
+ * An Observation can count the numeric (or Boolean, as 0 or 1) values it receives in a histogram
+ * with fixed buckets.  The values are counted as they arrive, so the histogram doesn't need a
+ * buffer, and covers every value received since the buckets were set.  The buckets are set by
+ * their boundaries, in increasing order:
+ *
+ *  - admin_SetHistogram(path, bounds, boundCount)
+ *  - admin_GetHistogram(path, bounds, &boundCount)
+ *
+ * There is one more bucket than there are boundaries (up to @c IO_MAX_HISTOGRAM_BUCKETS buckets).
+ * The first bucket counts the values below the first boundary, and each boundary is the lowest
+ * value counted in the bucket above it.  The counts are fetched using query_GetHistogram().
+ *
+ * Like the buffer, the histogram counts values before transforms and filtering.  To push the
+ * histogram of the samples accepted during each aggregation window instead, use
+ * OBS_AGGREGATION_TYPE_HISTOGRAM (see @ref c_dataHubAdmin_ObsAggregation).  The aggregate is a
+ * JSON value holding the boundaries and the counts, such as {"bounds":[10,20],"counts":[3,5,0]}.
+ *
+ * The histogram isn't backed up.
+ *
+ * For example, to count values below 10, from 10 to 20, and from 20 up:
+ *
+ * @code
+ * double bounds[] = { 10, 20 };
+ * admin_SetHistogram(obsPath, bounds, 2);
+ * @endcode
+ *
  *
  * @subsection c_dataHubAdmin_Defaults Default Values
  *
@@ -452,8 +609,14 @@
  *  - admin_GetHighLimit()
  *  - admin_GetChangeBy()
  *  - admin_GetTransform()
+ *  - admin_GetAggregation()
  *  - admin_GetBufferMaxCount()
+ *  - admin_GetBufferCompression()
+ *  - admin_GetBufferPersistence()
  *  - admin_GetBufferBackupPeriod()
+ *  - admin_GetRollupTier()
+ *  - admin_GetQuantileSketch()
+ *  - admin_GetHistogram()
  *
  * Inspection functions that can be used with Outputs only are:
  *  - admin_IsMandatory()
@@ -1245,6 +1408,40 @@ admin_TransformType_t admin_GetTransform
         ///< [IN] Path within the /obs/ namespace.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set an Observation to aggregate the samples it accepts over fixed-length (tumbling) windows
+ * of wall-clock time.  The Observation's value is only updated at the end of each window, with
+ * the aggregate of the samples accepted during the window.
+ *
+ * Set the aggregation type to OBS_AGGREGATION_TYPE_NONE to stop aggregating.
+ */
+//--------------------------------------------------------------------------------------------------
+void admin_SetAggregation
+(
+    const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+    admin_AggregationType_t aggregationType,
+        ///< [IN] Type of aggregate to report
+    double period
+        ///< [IN] Length of the aggregation windows (seconds)
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the type of aggregation currently applied to an Observation.
+ *
+ * @return The AggregationType
+ */
+//--------------------------------------------------------------------------------------------------
+admin_AggregationType_t admin_GetAggregation
+(
+    const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+    double* periodPtr
+        ///< [OUT] Length of the aggregation windows (seconds)
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the JSON member/element specifier for extraction of data from within a structured JSON
@@ -1312,6 +1509,69 @@ uint32_t admin_GetBufferMaxCount
         ///< [IN] Path within the /obs/ namespace.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set whether a given Observation's numeric data samples should be buffered compressed.
+ * Compressed samples take much less memory (often only a few bits each), but reading or querying
+ * the buffer means decoding them.
+ */
+//--------------------------------------------------------------------------------------------------
+void admin_SetBufferCompression
+(
+    const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+    bool compress
+        ///< [IN] true = compress numeric samples, false = don't (the default).
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a given Observation's numeric data samples are set to be buffered compressed.
+ * See admin_SetBufferCompression() for more information.
+ *
+ * @return true if they are, false if not or the Observation does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+bool admin_GetBufferCompression
+(
+    const char* LE_NONNULL path
+        ///< [IN] Path within the /obs/ namespace.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set whether a given Observation's trigger, Boolean and numeric data samples should be buffered in
+ * a memory-mapped file in non-volatile storage, so the buffer survives a restart of the Data Hub
+ * without having to be backed up.  Changes are flushed to non-volatile storage at most once per
+ * sync period, or whenever the operating system chooses to, if the sync period is zero.
+ */
+//--------------------------------------------------------------------------------------------------
+void admin_SetBufferPersistence
+(
+    const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+    bool persist,
+        ///< [IN] true = keep the buffer in a file, false = in memory only (the default).
+    uint32_t syncPeriod
+        ///< [IN] Minimum number of seconds between syncs of the file (0 = leave it to the OS).
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a given Observation's buffer is set to be kept in a memory-mapped file.
+ * See admin_SetBufferPersistence() for more information.
+ *
+ * @return true if it is, false if not or the Observation does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+bool admin_GetBufferPersistence
+(
+    const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+    uint32_t* syncPeriodPtr
+        ///< [OUT] Minimum number of seconds between syncs of the file.
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the minimum time between backups of an Observation's buffer to non-volatile storage.
@@ -1343,6 +1603,115 @@ uint32_t admin_GetBufferBackupPeriod
         ///< [IN] Path within the /obs/ namespace.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set up a rollup tier of an Observation, which keeps a fixed number of buckets summarizing the
+ * numerical values received during consecutive fixed-length periods.  Tier 0 is the finest, and
+ * each tier's period must be longer than the previous tier's.
+ *
+ * Setting maxCount to 0 removes the tier and all coarser ones.  Invalid settings are logged and
+ * ignored.
+ */
+//--------------------------------------------------------------------------------------------------
+void admin_SetRollupTier
+(
+    const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+    uint32_t tier,
+        ///< [IN] Tier number (0 = finest, < MAX_ROLLUP_TIERS).
+    double period,
+        ///< [IN] Length of each bucket's period (seconds).
+    uint32_t maxCount
+        ///< [IN] Number of buckets to keep (0 = remove the tier).
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the settings of a rollup tier of an Observation.
+ * See admin_SetRollupTier() for more information.
+ *
+ * @return The number of buckets kept in the tier, or 0 if the tier is not set or the Observation
+ *         does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t admin_GetRollupTier
+(
+    const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+    uint32_t tier,
+        ///< [IN] Tier number (0 = finest).
+    double* periodPtr
+        ///< [OUT] Length of each bucket's period (seconds).
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the size of the quantile sketch an Observation keeps of the numerical values in its buffer,
+ * to estimate percentiles of them (see query_GetPercentile()).  The size is the number of
+ * clusters of values kept for each part of the buffer, which bounds the sketch's memory use.
+ *
+ * Setting the size to 0 stops keeping a sketch.  Sizes above MAX_SKETCH_SIZE are logged and
+ * ignored.
+ */
+//--------------------------------------------------------------------------------------------------
+void admin_SetQuantileSketch
+(
+    const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+    uint32_t size
+        ///< [IN] Size of the sketch (0 = don't keep one).
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the size of an Observation's quantile sketch.
+ * See admin_SetQuantileSketch() for more information.
+ *
+ * @return The size, or 0 if no sketch is kept or the Observation does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t admin_GetQuantileSketch
+(
+    const char* LE_NONNULL path
+        ///< [IN] Path within the /obs/ namespace.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the bucket boundaries of the histogram an Observation keeps of the numerical values it
+ * receives (see query_GetHistogram()).  The counts start again from zero whenever the boundaries
+ * are set.
+ *
+ * Setting no boundaries stops keeping a histogram.  More than MAX_HISTOGRAM_BUCKETS - 1
+ * boundaries, or boundaries that aren't finite and strictly increasing, are logged and ignored.
+ */
+//--------------------------------------------------------------------------------------------------
+void admin_SetHistogram
+(
+    const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+    const double* boundsPtr,
+        ///< [IN] Bucket boundaries, in increasing order.
+    size_t boundsSize
+        ///< [IN]
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the bucket boundaries of an Observation's histogram.
+ * See admin_SetHistogram() for more information.
+ */
+//--------------------------------------------------------------------------------------------------
+void admin_GetHistogram
+(
+    const char* LE_NONNULL path,
+        ///< [IN] Path within the /obs/ namespace.
+    double* boundsPtr,
+        ///< [OUT] Bucket boundaries (none if not kept).
+    size_t* boundsSizePtr
+        ///< [INOUT]
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the default value of a resource to a Boolean value.
@@ -52,6 +52,13 @@
 //--------------------------------------------------------------------------------------------------
 #define IO_MAX_UNITS_NAME_LEN 23
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of buckets in an Observation's histogram (see admin_SetHistogram()).
+ */
+//--------------------------------------------------------------------------------------------------
+#define IO_MAX_HISTOGRAM_BUCKETS 32
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Enumerates the data types supported.
@@ -73,6 +80,14 @@ typedef enum
 io_DataType_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a handle on an Input or Output resource.  See io_GetResourceHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct io_ResourceHandle* io_ResourceHandleRef_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Reference type used by Add/Remove functions for EVENT 'io_TriggerPush'
@@ -400,6 +415,119 @@ LE_SHARED void ifgen_io_PushJson
         ///< [IN]
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a handle on an Input or Output resource, for pushing data samples to it without the
+ * Data Hub having to look up the resource's path for every push.
+ *
+ * If the resource is deleted, samples pushed through the handle are discarded, even if another
+ * resource is later created at the same path.
+ *
+ * @return Reference to the handle, or NULL if the resource doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED io_ResourceHandleRef_t ifgen_io_GetResourceHandle
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        const char* LE_NONNULL path
+        ///< [IN] Resource path within the client app's namespace.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a handle obtained using io_GetResourceHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void ifgen_io_ReleaseResourceHandle
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        io_ResourceHandleRef_t handle
+        ///< [IN]
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a trigger type data sample through a handle obtained using io_GetResourceHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void ifgen_io_PushTriggerH
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        io_ResourceHandleRef_t handle,
+        ///< [IN]
+        double timestamp
+        ///< [IN] Timestamp in seconds since the Epoch 1970-01-01 00:00:00 +0000 (UTC).
+        ///< IO_NOW = now (i.e., generate a timestamp for me).
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a Boolean type data sample through a handle obtained using io_GetResourceHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void ifgen_io_PushBooleanH
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        io_ResourceHandleRef_t handle,
+        ///< [IN]
+        double timestamp,
+        ///< [IN] Timestamp in seconds since the Epoch 1970-01-01 00:00:00 +0000 (UTC).
+        ///< IO_NOW = now (i.e., generate a timestamp for me).
+        bool value
+        ///< [IN]
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a numeric type data sample through a handle obtained using io_GetResourceHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void ifgen_io_PushNumericH
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        io_ResourceHandleRef_t handle,
+        ///< [IN]
+        double timestamp,
+        ///< [IN] Timestamp in seconds since the Epoch 1970-01-01 00:00:00 +0000 (UTC).
+        ///< IO_NOW = now (i.e., generate a timestamp for me).
+        double value
+        ///< [IN]
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a string type data sample through a handle obtained using io_GetResourceHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void ifgen_io_PushStringH
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        io_ResourceHandleRef_t handle,
+        ///< [IN]
+        double timestamp,
+        ///< [IN] Timestamp in seconds since the Epoch 1970-01-01 00:00:00 +0000 (UTC).
+        ///< IO_NOW = now (i.e., generate a timestamp for me).
+        const char* LE_NONNULL value
+        ///< [IN]
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a JSON data sample through a handle obtained using io_GetResourceHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void ifgen_io_PushJsonH
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        io_ResourceHandleRef_t handle,
+        ///< [IN]
+        double timestamp,
+        ///< [IN] Timestamp in seconds since the Epoch 1970-01-01 00:00:00 +0000 (UTC).
+        ///< IO_NOW = now (i.e., generate a timestamp for me).
+        const char* LE_NONNULL value
+        ///< [IN]
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Add handler function for EVENT 'io_TriggerPush'
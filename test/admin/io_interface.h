@@ -209,6 +209,20 @@
  *
  * @endcode
  *
+ * A client that pushes to the same resource often can save the Data Hub from looking up the
+ * resource's path on every push by getting a handle on the resource using io_GetResourceHandle()
+ * and pushing through that handle instead:
+ * - io_PushTriggerH()
+ * - io_PushBooleanH()
+ * - io_PushNumericH()
+ * - io_PushStringH()
+ * - io_PushJsonH()
+ *
+ * If the resource is deleted, anything pushed through the handle is discarded (and an error is
+ * logged), even if a new resource is later created at the same path.  Get a new handle then.
+ * Handles are released using io_ReleaseResourceHandle(), or automatically when the client app
+ * disconnects from the Data Hub.
+ *
  *
  * @section c_dataHubIo_ReceivingOutput Receiving Output From the Data Hub
  *
@@ -673,6 +687,112 @@ void io_PushJson
         ///< [IN]
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a handle on an Input or Output resource, for pushing data samples to it without the
+ * Data Hub having to look up the resource's path for every push.
+ *
+ * If the resource is deleted, samples pushed through the handle are discarded, even if another
+ * resource is later created at the same path.
+ *
+ * @return Reference to the handle, or NULL if the resource doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+io_ResourceHandleRef_t io_GetResourceHandle
+(
+    const char* LE_NONNULL path
+        ///< [IN] Resource path within the client app's namespace.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a handle obtained using io_GetResourceHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+void io_ReleaseResourceHandle
+(
+    io_ResourceHandleRef_t handle
+        ///< [IN]
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a trigger type data sample through a handle obtained using io_GetResourceHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+void io_PushTriggerH
+(
+    io_ResourceHandleRef_t handle,
+        ///< [IN]
+    double timestamp
+        ///< [IN] Timestamp in seconds since the Epoch 1970-01-01 00:00:00 +0000 (UTC).
+        ///< IO_NOW = now (i.e., generate a timestamp for me).
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a Boolean type data sample through a handle obtained using io_GetResourceHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+void io_PushBooleanH
+(
+    io_ResourceHandleRef_t handle,
+        ///< [IN]
+    double timestamp,
+        ///< [IN] Timestamp in seconds since the Epoch 1970-01-01 00:00:00 +0000 (UTC).
+        ///< IO_NOW = now (i.e., generate a timestamp for me).
+    bool value
+        ///< [IN]
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a numeric type data sample through a handle obtained using io_GetResourceHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+void io_PushNumericH
+(
+    io_ResourceHandleRef_t handle,
+        ///< [IN]
+    double timestamp,
+        ///< [IN] Timestamp in seconds since the Epoch 1970-01-01 00:00:00 +0000 (UTC).
+        ///< IO_NOW = now (i.e., generate a timestamp for me).
+    double value
+        ///< [IN]
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a string type data sample through a handle obtained using io_GetResourceHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+void io_PushStringH
+(
+    io_ResourceHandleRef_t handle,
+        ///< [IN]
+    double timestamp,
+        ///< [IN] Timestamp in seconds since the Epoch 1970-01-01 00:00:00 +0000 (UTC).
+        ///< IO_NOW = now (i.e., generate a timestamp for me).
+    const char* LE_NONNULL value
+        ///< [IN]
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a JSON data sample through a handle obtained using io_GetResourceHandle().
+ */
+//--------------------------------------------------------------------------------------------------
+void io_PushJsonH
+(
+    io_ResourceHandleRef_t handle,
+        ///< [IN]
+    double timestamp,
+        ///< [IN] Timestamp in seconds since the Epoch 1970-01-01 00:00:00 +0000 (UTC).
+        ///< IO_NOW = now (i.e., generate a timestamp for me).
+    const char* LE_NONNULL value
+        ///< [IN]
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Add handler function for EVENT 'io_TriggerPush'
@@ -3,6 +3,16 @@
  *
  * unit test admin API functions:
  *  CreateInput, CreateOutput, DeleteResource, SetJsonExample and MarkOptional
+ * I/O API pushes through resource handles:
+ *  GetResourceHandle, PushNumericH and ReleaseResourceHandle
+ * and Observation buffering:
+ *  CreateObs, SetBufferMaxCount, SetBufferCompression, SetBufferPersistence (including taking
+ *  over ring files left by a previous run), SetBufferBackupPeriod (restoring backups lazily, and
+ *  exactly as they were, from a snapshot and journal, but not damaged ones, disabling backups
+ *  while they are being written, and scheduling backups with different periods), SetTransform,
+ *  SetAggregation, SetRollupTier, SetQuantileSketch, SetHistogram, and the query API buffer
+ *  statistics, combined statistics, percentiles, histograms, sample reads, buffer cursors and
+ *  JSON and binary buffer reads through a pipe
  *
  * Copyright (C) Sierra Wireless, Inc. Use of this work is subject to license.
  */
@@ -12,10 +22,19 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <cmocka.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include "interfaces.h"
+#include "json.h"
 
 extern void initDataHub(void);
+extern char* simulateAppName;
 
 static int setup(void **state) {
     // Init Data Hub component
@@ -246,6 +265,1867 @@ static void test_admin_set_json_example
     }
 }
 
+static void test_admin_many_children
+(
+    void** state
+)
+{
+    (void)state;
+    char path[64];
+    io_DataType_t dataType;
+    int i;
+
+    // Enough children in one namespace to grow its child index several times.
+    for (i = 0; i < 300; i++)
+    {
+        snprintf(path, sizeof(path), "/app/manyChildren/r%d", i);
+        assert_true(LE_OK == admin_CreateInput(path, IO_DATA_TYPE_NUMERIC, ""));
+    }
+
+    // Remove every other child, which shifts entries around in the index.
+    for (i = 0; i < 300; i += 2)
+    {
+        snprintf(path, sizeof(path), "/app/manyChildren/r%d", i);
+        admin_DeleteResource(path);
+    }
+    for (i = 0; i < 300; i++)
+    {
+        snprintf(path, sizeof(path), "/app/manyChildren/r%d", i);
+        if ((i % 2) == 0)
+        {
+            assert_true(ADMIN_ENTRY_TYPE_NONE == admin_GetEntryType(path));
+        }
+        else
+        {
+            assert_true(LE_OK == query_GetDataType(path, &dataType));
+            assert_true(IO_DATA_TYPE_NUMERIC == dataType);
+        }
+    }
+
+    // Removed children can be created again.
+    for (i = 0; i < 300; i += 2)
+    {
+        snprintf(path, sizeof(path), "/app/manyChildren/r%d", i);
+        assert_true(LE_OK == admin_CreateInput(path, IO_DATA_TYPE_STRING, ""));
+    }
+    for (i = 0; i < 300; i++)
+    {
+        snprintf(path, sizeof(path), "/app/manyChildren/r%d", i);
+        assert_true(LE_OK == query_GetDataType(path, &dataType));
+        assert_true(((i % 2) == 0 ? IO_DATA_TYPE_STRING : IO_DATA_TYPE_NUMERIC) == dataType);
+        admin_DeleteResource(path);
+    }
+    assert_true(ADMIN_ENTRY_TYPE_NONE == admin_GetEntryType("/app/manyChildren/r1"));
+}
+
+static void test_admin_lookup_after_delete
+(
+    void** state
+)
+{
+    (void)state;
+    double timestamp;
+    double value;
+    bool boolValue;
+
+    // Repeated lookups of the same paths must see resources deleted and re-created in between.
+    assert_true(LE_OK == admin_CreateInput("/app/lookup/sensor/value", IO_DATA_TYPE_NUMERIC, ""));
+    admin_PushNumeric("/app/lookup/sensor/value", 100.0, 1.5);
+    assert_true(LE_OK == query_GetNumeric("/app/lookup/sensor/value", &timestamp, &value));
+    assert_true(1.5 == value);
+
+    admin_DeleteResource("/app/lookup/sensor/value");
+    assert_true(ADMIN_ENTRY_TYPE_NONE == admin_GetEntryType("/app/lookup/sensor/value"));
+    assert_true(LE_NOT_FOUND == query_GetNumeric("/app/lookup/sensor/value", &timestamp, &value));
+
+    assert_true(LE_OK == admin_CreateInput("/app/lookup/sensor/value", IO_DATA_TYPE_BOOLEAN, ""));
+    assert_true(LE_UNAVAILABLE
+                == query_GetBoolean("/app/lookup/sensor/value", &timestamp, &boolValue));
+    admin_PushBoolean("/app/lookup/sensor/value", 101.0, true);
+    assert_true(LE_OK == query_GetBoolean("/app/lookup/sensor/value", &timestamp, &boolValue));
+    assert_true(boolValue);
+
+    admin_DeleteResource("/app/lookup/sensor/value");
+    assert_true(ADMIN_ENTRY_TYPE_NONE == admin_GetEntryType("/app/lookup/sensor/value"));
+}
+
+static void test_admin_units_routing
+(
+    void** state
+)
+{
+    (void)state;
+    char units[IO_MAX_UNITS_NAME_LEN + 1];
+    double timestamp;
+    double value;
+
+    // An Observation takes on the units of its source and passes them on to its destinations,
+    // which only accept samples with matching units.
+    assert_true(LE_OK == admin_CreateInput("/app/units/in", IO_DATA_TYPE_NUMERIC, "degC"));
+    assert_true(LE_OK == admin_CreateObs("/obs/units"));
+    assert_true(LE_OK == admin_CreateOutput("/app/units/outC", IO_DATA_TYPE_NUMERIC, "degC"));
+    assert_true(LE_OK == admin_CreateOutput("/app/units/outF", IO_DATA_TYPE_NUMERIC, "degF"));
+    assert_true(LE_OK == admin_SetSource("/obs/units", "/app/units/in"));
+    assert_true(LE_OK == admin_SetSource("/app/units/outC", "/obs/units"));
+    assert_true(LE_OK == admin_SetSource("/app/units/outF", "/obs/units"));
+
+    admin_PushNumeric("/app/units/in", 100.0, 21.5);
+    assert_true(LE_OK == query_GetUnits("/obs/units", units, sizeof(units)));
+    assert_string_equal("degC", units);
+    assert_true(LE_OK == query_GetNumeric("/app/units/outC", &timestamp, &value));
+    assert_true(21.5 == value);
+    assert_true(LE_UNAVAILABLE == query_GetNumeric("/app/units/outF", &timestamp, &value));
+    assert_true(LE_OK == query_GetUnits("/app/units/outF", units, sizeof(units)));
+    assert_string_equal("degF", units);
+
+    admin_RemoveSource("/app/units/outF");
+    admin_RemoveSource("/app/units/outC");
+    admin_RemoveSource("/obs/units");
+    assert_true(LE_OK == query_GetUnits("/obs/units", units, sizeof(units)));
+    assert_string_equal("", units);
+    admin_DeleteObs("/obs/units");
+    admin_DeleteResource("/app/units/outF");
+    admin_DeleteResource("/app/units/outC");
+    admin_DeleteResource("/app/units/in");
+}
+
+static void test_admin_entry_paths
+(
+    void** state
+)
+{
+    (void)state;
+    char path[IO_MAX_RESOURCE_PATH_LEN + 1];
+
+    // Entries cache their absolute paths, so check the paths reported across tree changes.
+    assert_true(LE_OK == admin_CreateInput("/app/paths/a/in", IO_DATA_TYPE_NUMERIC, ""));
+    assert_true(LE_OK == admin_GetFirstChild("/app/paths", path, sizeof(path)));
+    assert_string_equal("/app/paths/a", path);
+    assert_true(LE_OK == admin_GetFirstChild("/app/paths/a", path, sizeof(path)));
+    assert_string_equal("/app/paths/a/in", path);
+
+    assert_true(LE_OK == admin_CreateInput("/app/paths/a/in2", IO_DATA_TYPE_NUMERIC, ""));
+    assert_true(LE_OK == admin_GetNextSibling("/app/paths/a/in", path, sizeof(path)));
+    assert_string_equal("/app/paths/a/in2", path);
+    assert_true(LE_OVERFLOW == admin_GetFirstChild("/app/paths/a", path, 15));
+    admin_DeleteResource("/app/paths/a/in2");
+
+    admin_DeleteResource("/app/paths/a/in");
+    assert_true(LE_OK == admin_CreateInput("/app/paths/b/in", IO_DATA_TYPE_NUMERIC, ""));
+    assert_true(LE_OK == admin_GetFirstChild("/app/paths/b", path, sizeof(path)));
+    assert_string_equal("/app/paths/b/in", path);
+    admin_DeleteResource("/app/paths/b/in");
+}
+
+static void test_io_resource_handle
+(
+    void** state
+)
+{
+    (void)state;
+    double timestamp;
+    double value;
+
+    simulateAppName = "handleApp";
+
+    assert_true(LE_OK == io_CreateInput("sensor/value", IO_DATA_TYPE_NUMERIC, ""));
+    assert_null(io_GetResourceHandle("sensor/missing"));
+
+    io_ResourceHandleRef_t handle = io_GetResourceHandle("sensor/value");
+    assert_non_null(handle);
+
+    // Pushing through the handle does the same as pushing by path.
+    io_PushNumericH(handle, 100.0, 1.5);
+    assert_true(LE_OK == query_GetNumeric("/app/handleApp/sensor/value", &timestamp, &value));
+    assert_true((100.0 == timestamp) && (1.5 == value));
+    io_PushNumeric("sensor/value", 101.0, 2.5);
+    io_PushNumericH(handle, 102.0, 3.5);
+    assert_true(LE_OK == query_GetNumeric("/app/handleApp/sensor/value", &timestamp, &value));
+    assert_true((102.0 == timestamp) && (3.5 == value));
+
+    // Once the resource is deleted, pushes through the handle are dropped, even if the resource
+    // is created again.
+    io_DeleteResource("sensor/value");
+    assert_true(LE_OK == io_CreateInput("sensor/value", IO_DATA_TYPE_NUMERIC, ""));
+    io_PushNumericH(handle, 103.0, 4.5);
+    assert_true(LE_UNAVAILABLE
+                == query_GetNumeric("/app/handleApp/sensor/value", &timestamp, &value));
+    io_ReleaseResourceHandle(handle);
+
+    io_DeleteResource("sensor/value");
+    assert_true(ADMIN_ENTRY_TYPE_NONE == admin_GetEntryType("/app/handleApp/sensor/value"));
+}
+
+/* Observation used for buffer tests */
+#define TEST_OBS_NAME "/obs/bufferTest"
+
+static void test_obs_buffer_wrap
+(
+    void** state
+)
+{
+    (void)state;
+    double timestamp;
+    double value;
+
+    assert_true(LE_OK == admin_CreateObs(TEST_OBS_NAME));
+    admin_SetBufferMaxCount(TEST_OBS_NAME, 4);
+
+    // Push more samples than the buffer can hold, so the oldest ones are dropped.
+    for (int i = 1 ; i <= 10 ; i++)
+    {
+        admin_PushNumeric(TEST_OBS_NAME, 1000000000.0 + i, i);
+    }
+
+    // Only the newest 4 samples (7..10) should be left.
+    assert_true(7 == query_GetMin(TEST_OBS_NAME, NAN));
+    assert_true(10 == query_GetMax(TEST_OBS_NAME, NAN));
+    assert_true(8.5 == query_GetMean(TEST_OBS_NAME, NAN));
+    assert_true(fabs(query_GetStdDev(TEST_OBS_NAME, NAN) - sqrt(1.25)) < 1e-9);
+
+    assert_true(LE_OK == query_ReadBufferSampleNumeric(TEST_OBS_NAME, NAN, &timestamp, &value));
+    assert_true(1000000007.0 == timestamp);
+    assert_true(7 == value);
+    assert_true(LE_OK == query_ReadBufferSampleNumeric(TEST_OBS_NAME,
+                                                       timestamp,
+                                                       &timestamp,
+                                                       &value));
+    assert_true(8 == value);
+    assert_true(LE_NOT_FOUND == query_ReadBufferSampleNumeric(TEST_OBS_NAME,
+                                                              1000000010.0,
+                                                              &timestamp,
+                                                              &value));
+
+    // Shrinking the buffer keeps the newest samples.
+    admin_SetBufferMaxCount(TEST_OBS_NAME, 2);
+    assert_true(9 == query_GetMin(TEST_OBS_NAME, NAN));
+
+    // Growing it again keeps them in order and makes room for more.
+    admin_SetBufferMaxCount(TEST_OBS_NAME, 8);
+    admin_PushNumeric(TEST_OBS_NAME, 1000000011.0, 11);
+    admin_PushNumeric(TEST_OBS_NAME, 1000000012.0, 12);
+    assert_true(9 == query_GetMin(TEST_OBS_NAME, NAN));
+    assert_true(10.5 == query_GetMean(TEST_OBS_NAME, NAN));
+    assert_true(11 == query_GetMin(TEST_OBS_NAME, 1000000010.5));
+
+    admin_DeleteObs(TEST_OBS_NAME);
+}
+
+static void test_obs_buffer_types
+(
+    void** state
+)
+{
+    (void)state;
+    double timestamp;
+    bool boolValue;
+    char stringValue[IO_MAX_STRING_VALUE_LEN + 1];
+
+    assert_true(LE_OK == admin_CreateObs(TEST_OBS_NAME));
+    admin_SetBufferMaxCount(TEST_OBS_NAME, 3);
+
+    admin_PushBoolean(TEST_OBS_NAME, 1000000001.0, true);
+    admin_PushBoolean(TEST_OBS_NAME, 1000000002.0, false);
+    assert_true(0.5 == query_GetMean(TEST_OBS_NAME, NAN));
+    assert_true(LE_OK == query_ReadBufferSampleBoolean(TEST_OBS_NAME, NAN, &timestamp, &boolValue));
+    assert_true(boolValue);
+
+    // Changing the data type flushes the buffer.
+    admin_PushString(TEST_OBS_NAME, 1000000003.0, "one");
+    admin_PushString(TEST_OBS_NAME, 1000000004.0, "two");
+    admin_PushString(TEST_OBS_NAME, 1000000005.0, "three");
+    admin_PushString(TEST_OBS_NAME, 1000000006.0, "four");
+    assert_true(isnan(query_GetMean(TEST_OBS_NAME, NAN)));
+    assert_true(LE_OK == query_ReadBufferSampleString(TEST_OBS_NAME,
+                                                      NAN,
+                                                      &timestamp,
+                                                      stringValue,
+                                                      sizeof(stringValue)));
+    assert_true(1000000004.0 == timestamp);
+    assert_true(0 == strcmp(stringValue, "two"));
+    assert_true(LE_OK == query_ReadBufferSampleJson(TEST_OBS_NAME,
+                                                    1000000005.0,
+                                                    &timestamp,
+                                                    stringValue,
+                                                    sizeof(stringValue)));
+    assert_true(0 == strcmp(stringValue, "\"four\""));
+
+    admin_DeleteObs(TEST_OBS_NAME);
+}
+
+static void test_obs_buffer_time_lookup
+(
+    void** state
+)
+{
+    (void)state;
+    const double timestamps[] = { 1000000001.0, 1000000002.0, 1000000002.0, 1000000003.5,
+                                  1000000007.0, 1000000007.0, 1000000007.0, 1000000009.0 };
+    const int samplesNb = sizeof(timestamps) / sizeof(timestamps[0]);
+    double timestamp;
+    double value;
+
+    assert_true(LE_OK == admin_CreateObs(TEST_OBS_NAME));
+    admin_SetBufferMaxCount(TEST_OBS_NAME, 6);
+
+    // Wrap around the ring so lookups have to cross the end of the array.
+    for (int i = 0 ; i < samplesNb ; i++)
+    {
+        admin_PushNumeric(TEST_OBS_NAME, timestamps[i], i);
+    }
+
+    // The buffer now holds samples 2..7.  Look up the sample after each possible start time.
+    const double startAfter[] = { 1000000000.0, 1000000002.0, 1000000003.0, 1000000003.5,
+                                  1000000008.0 };
+    const double expectedValue[] = { 2, 3, 3, 4, 7 };
+    for (int i = 0 ; i < sizeof(startAfter) / sizeof(startAfter[0]) ; i++)
+    {
+        assert_true(LE_OK == query_ReadBufferSampleNumeric(TEST_OBS_NAME,
+                                                           startAfter[i],
+                                                           &timestamp,
+                                                           &value));
+        assert_true(expectedValue[i] == value);
+    }
+    assert_true(LE_NOT_FOUND == query_ReadBufferSampleNumeric(TEST_OBS_NAME,
+                                                              1000000009.0,
+                                                              &timestamp,
+                                                              &value));
+
+    // Statistics over a time span include samples at exactly the start time.
+    assert_true(4 == query_GetMin(TEST_OBS_NAME, 1000000007.0));
+    assert_true(5.5 == query_GetMean(TEST_OBS_NAME, 1000000007.0));
+    assert_true(isnan(query_GetMax(TEST_OBS_NAME, 1000000010.0)));
+
+    admin_DeleteObs(TEST_OBS_NAME);
+}
+
+static void test_obs_transform_matches_query
+(
+    void** state
+)
+{
+    (void)state;
+    const admin_TransformType_t transforms[] =
+    {
+        ADMIN_OBS_TRANSFORM_TYPE_MEAN,
+        ADMIN_OBS_TRANSFORM_TYPE_STDDEV,
+        ADMIN_OBS_TRANSFORM_TYPE_MAX,
+        ADMIN_OBS_TRANSFORM_TYPE_MIN
+    };
+    double timestamp;
+    double value;
+
+    assert_true(LE_OK == admin_CreateObs(TEST_OBS_NAME));
+
+    for (int t = 0 ; t < sizeof(transforms) / sizeof(transforms[0]) ; t++)
+    {
+        admin_SetBufferMaxCount(TEST_OBS_NAME, 7);
+        admin_SetTransform(TEST_OBS_NAME, transforms[t], NULL, 0);
+
+        // The transformed value must match a full scan of the buffer after every push,
+        // both while the buffer fills and after it starts dropping old samples.
+        srand(t);
+        for (int i = 1 ; i <= 50 ; i++)
+        {
+            admin_PushNumeric(TEST_OBS_NAME, 1000000000.0 + i, (rand() % 2001) - 1000.0);
+
+            double expected = NAN;
+            switch (transforms[t])
+            {
+                case ADMIN_OBS_TRANSFORM_TYPE_MEAN:
+                    expected = query_GetMean(TEST_OBS_NAME, NAN);
+                    break;
+                case ADMIN_OBS_TRANSFORM_TYPE_STDDEV:
+                    expected = query_GetStdDev(TEST_OBS_NAME, NAN);
+                    break;
+                case ADMIN_OBS_TRANSFORM_TYPE_MAX:
+                    expected = query_GetMax(TEST_OBS_NAME, NAN);
+                    break;
+                case ADMIN_OBS_TRANSFORM_TYPE_MIN:
+                    expected = query_GetMin(TEST_OBS_NAME, NAN);
+                    break;
+                default:
+                    break;
+            }
+
+            assert_true(LE_OK == query_GetNumeric(TEST_OBS_NAME, &timestamp, &value));
+            assert_true(fabs(value - expected) < 1e-6);
+
+            // Shrink the buffer part way through.
+            if (i == 30)
+            {
+                admin_SetBufferMaxCount(TEST_OBS_NAME, 3);
+            }
+        }
+    }
+
+    admin_DeleteObs(TEST_OBS_NAME);
+}
+
+static void test_obs_windowed_transforms
+(
+    void** state
+)
+{
+    (void)state;
+    double timestamp;
+    double value;
+
+    // Moving windows are kept separately from the buffer, so no buffer is needed.
+    assert_true(LE_OK == admin_CreateObs(TEST_OBS_NAME));
+    admin_SetBufferMaxCount(TEST_OBS_NAME, 0);
+
+    // Window of the last 3 values.
+    const double countWindow[] = { 0, 3 };
+    const double expectedMeans[] = { 1, 1.5, 2, 3, 4 };
+    admin_SetTransform(TEST_OBS_NAME, ADMIN_OBS_TRANSFORM_TYPE_MOVING_MEAN, countWindow, 2);
+    for (int i = 0 ; i < 5 ; i++)
+    {
+        admin_PushNumeric(TEST_OBS_NAME, 1000000000.0 + i, i + 1);
+        assert_true(LE_OK == query_GetNumeric(TEST_OBS_NAME, &timestamp, &value));
+        assert_true(value == expectedMeans[i]);
+    }
+
+    // Window of the last 2.5 seconds.
+    const double timeWindow[] = { 2.5 };
+    const double values[] = { 5, 1, 2, 0 };
+    const double expectedMaxes[] = { 5, 5, 5, 2 };
+    admin_SetTransform(TEST_OBS_NAME, ADMIN_OBS_TRANSFORM_TYPE_MOVING_MAX, timeWindow, 1);
+    for (int i = 0 ; i < 4 ; i++)
+    {
+        admin_PushNumeric(TEST_OBS_NAME, 1000000010.0 + i, values[i]);
+        assert_true(LE_OK == query_GetNumeric(TEST_OBS_NAME, &timestamp, &value));
+        assert_true(value == expectedMaxes[i]);
+    }
+
+    // Exponentially weighted moving average.
+    const double alpha = 0.5;
+    admin_SetTransform(TEST_OBS_NAME, ADMIN_OBS_TRANSFORM_TYPE_EWMA, &alpha, 1);
+    admin_PushNumeric(TEST_OBS_NAME, 1000000020.0, 4);
+    assert_true(LE_OK == query_GetNumeric(TEST_OBS_NAME, &timestamp, &value));
+    assert_true(value == 4);
+    admin_PushNumeric(TEST_OBS_NAME, 1000000021.0, 8);
+    assert_true(LE_OK == query_GetNumeric(TEST_OBS_NAME, &timestamp, &value));
+    assert_true(value == 6);
+
+    // Rate of change.
+    admin_SetTransform(TEST_OBS_NAME, ADMIN_OBS_TRANSFORM_TYPE_RATE, NULL, 0);
+    admin_PushNumeric(TEST_OBS_NAME, 1000000030.0, 10);
+    admin_PushNumeric(TEST_OBS_NAME, 1000000032.0, 16);
+    assert_true(LE_OK == query_GetNumeric(TEST_OBS_NAME, &timestamp, &value));
+    assert_true(value == 3);
+    admin_PushNumeric(TEST_OBS_NAME, 1000000033.0, 13);
+    assert_true(LE_OK == query_GetNumeric(TEST_OBS_NAME, &timestamp, &value));
+    assert_true(value == -3);
+
+    // Invalid parameters are ignored.
+    const double badAlpha = 0;
+    admin_SetTransform(TEST_OBS_NAME, ADMIN_OBS_TRANSFORM_TYPE_EWMA, &badAlpha, 1);
+    admin_SetTransform(TEST_OBS_NAME, ADMIN_OBS_TRANSFORM_TYPE_MOVING_MIN, NULL, 0);
+    assert_true(ADMIN_OBS_TRANSFORM_TYPE_RATE == admin_GetTransform(TEST_OBS_NAME));
+
+    admin_DeleteObs(TEST_OBS_NAME);
+}
+
+static void test_obs_aggregation
+(
+    void** state
+)
+{
+    (void)state;
+    const char* path = "/obs/aggregationTest";
+    double timestamp;
+    double value;
+    double period;
+
+    assert_true(LE_OK == admin_CreateObs(path));
+    assert_true(ADMIN_OBS_AGGREGATION_TYPE_NONE == admin_GetAggregation(path, &period));
+
+    // While aggregating, accepted samples don't update the value until the window ends.
+    admin_SetAggregation(path, ADMIN_OBS_AGGREGATION_TYPE_MEAN, 3600);
+    assert_true(ADMIN_OBS_AGGREGATION_TYPE_MEAN == admin_GetAggregation(path, &period));
+    assert_true(period == 3600);
+    admin_PushNumeric(path, 1000000000.0, 1);
+    admin_PushNumeric(path, 1000000001.0, 2);
+    assert_true(LE_OK != query_GetNumeric(path, &timestamp, &value));
+
+    // Invalid periods are ignored.
+    admin_SetAggregation(path, ADMIN_OBS_AGGREGATION_TYPE_MAX, 0);
+    assert_true(ADMIN_OBS_AGGREGATION_TYPE_MEAN == admin_GetAggregation(path, &period));
+
+    // Once aggregation is turned off, each accepted sample updates the value again.
+    admin_SetAggregation(path, ADMIN_OBS_AGGREGATION_TYPE_NONE, 0);
+    admin_PushNumeric(path, 1000000002.0, 3);
+    assert_true(LE_OK == query_GetNumeric(path, &timestamp, &value));
+    assert_true(value == 3);
+
+    admin_DeleteObs(path);
+}
+
+
+static void test_obs_rollup_tiers
+(
+    void** state
+)
+{
+    (void)state;
+    const char* path = "/obs/rollupTest";
+    double period;
+    int i;
+
+    assert_true(LE_OK == admin_CreateObs(path));
+    assert_true(0 == admin_GetRollupTier(path, 0, &period));
+
+    admin_SetBufferMaxCount(path, 2);
+    admin_SetRollupTier(path, 0, 10, 10);
+    admin_SetRollupTier(path, 1, 100, 10);
+    assert_true(10 == admin_GetRollupTier(path, 0, &period));
+    assert_true(period == 10);
+    assert_true(10 == admin_GetRollupTier(path, 1, &period));
+    assert_true(period == 100);
+
+    // Tiers must be contiguous and get coarser, otherwise the setting is ignored.
+    admin_SetRollupTier(path, 3, 1000, 10);
+    assert_true(0 == admin_GetRollupTier(path, 3, &period));
+    admin_SetRollupTier(path, 1, 5, 10);
+    assert_true(10 == admin_GetRollupTier(path, 1, &period));
+    assert_true(period == 100);
+
+    for (i = 0; i < 30; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + i, i + 1);
+    }
+
+    // The buffer only holds the last two values, so longer ranges are answered from the tiers.
+    assert_true(29 == query_GetMin(path, 1000000028.0));
+    assert_true(1 == query_GetMin(path, 1000000000.0));
+    assert_true(30 == query_GetMax(path, 1000000000.0));
+    assert_true(15.5 == query_GetMean(path, 1000000000.0));
+    assert_true(fabs(query_GetStdDev(path, 1000000000.0) - sqrt(899.0 / 12)) < 1e-9);
+
+    // Tiers summarize whole buckets.
+    assert_true(11 == query_GetMin(path, 1000000015.0));
+
+    // Removing a tier removes the coarser ones too.
+    admin_SetRollupTier(path, 0, 0, 0);
+    assert_true(0 == admin_GetRollupTier(path, 1, &period));
+    assert_true(29 == query_GetMin(path, 1000000000.0));
+
+    admin_DeleteObs(path);
+}
+
+static void test_obs_buffer_compression
+(
+    void** state
+)
+{
+    (void)state;
+    const char* path = "/obs/compressTest";
+    const int samplesNb = 500;
+    double timestamp;
+    double value;
+    char stringValue[IO_MAX_STRING_VALUE_LEN + 1];
+    int i;
+
+    assert_true(LE_OK == admin_CreateObs(path));
+    assert_false(admin_GetBufferCompression(path));
+    admin_SetBufferMaxCount(path, 300);
+    admin_SetBufferCompression(path, true);
+    assert_true(admin_GetBufferCompression(path));
+
+    // Mostly regular timestamps with some jitter, a few that aren't whole microseconds, and
+    // values that range from repeated to arbitrary.
+    for (i = 0; i < samplesNb; i++)
+    {
+        timestamp = 1000000000.0 + i + ((i % 7 == 0) ? 0.000123 : 0) + ((i % 50 == 0) ? 1e-9 : 0);
+        value = (i % 3 == 0) ? 20.5 : ((i % 3 == 1) ? i * 0.1 : -sqrt(i));
+        admin_PushNumeric(path, timestamp, value);
+    }
+
+    // The newest 300 samples are kept, and read back exactly.
+    timestamp = NAN;
+    for (i = samplesNb - 300; i < samplesNb; i++)
+    {
+        double expectedTimestamp = 1000000000.0 + i + ((i % 7 == 0) ? 0.000123 : 0)
+                                   + ((i % 50 == 0) ? 1e-9 : 0);
+        double expectedValue = (i % 3 == 0) ? 20.5 : ((i % 3 == 1) ? i * 0.1 : -sqrt(i));
+
+        assert_true(LE_OK == query_ReadBufferSampleNumeric(path, timestamp, &timestamp, &value));
+        assert_true(expectedTimestamp == timestamp);
+        assert_true(expectedValue == value);
+    }
+    assert_true(LE_NOT_FOUND == query_ReadBufferSampleNumeric(path, timestamp, &timestamp, &value));
+
+    assert_true(-sqrt(497) == query_GetMin(path, NAN));
+    assert_true(499 * 0.1 == query_GetMax(path, NAN));
+    assert_true(20.5 == query_GetMin(path, 1000000497.5));
+    assert_true(LE_OK == query_ReadBufferSampleNumeric(path, 1000000450.5, &timestamp, &value));
+    assert_true(1000000451.0 == timestamp);
+
+    // Turning compression off keeps the buffered samples.
+    admin_SetBufferCompression(path, false);
+    assert_false(admin_GetBufferCompression(path));
+    assert_true(-sqrt(497) == query_GetMin(path, NAN));
+    assert_true(LE_OK == query_ReadBufferSampleNumeric(path, NAN, &timestamp, &value));
+    assert_true(1000000200.0 == timestamp);
+
+    // Other data types are buffered uncompressed, even with compression on.
+    admin_SetBufferCompression(path, true);
+    assert_true(20.5 == query_GetMin(path, 1000000497.5));
+    admin_PushString(path, 1000000600.0, "one");
+    admin_PushString(path, 1000000601.0, "two");
+    assert_true(LE_OK == query_ReadBufferSampleString(path,
+                                                      1000000600.0,
+                                                      &timestamp,
+                                                      stringValue,
+                                                      sizeof(stringValue)));
+    assert_true(0 == strcmp(stringValue, "two"));
+    admin_PushNumeric(path, 1000000602.0, 1);
+    admin_PushNumeric(path, 1000000603.0, 2);
+    assert_true(1.5 == query_GetMean(path, NAN));
+
+    admin_DeleteObs(path);
+}
+
+static void test_obs_buffer_persistence
+(
+    void** state
+)
+{
+    (void)state;
+    const char* path = "/obs/persistTest";
+    double timestamp;
+    double value;
+    bool boolValue;
+    uint32_t syncPeriod;
+    int i;
+
+    assert_true(LE_OK == admin_CreateObs(path));
+    assert_false(admin_GetBufferPersistence(path, &syncPeriod));
+    assert_true(0 == syncPeriod);
+    admin_SetBufferMaxCount(path, 10);
+    for (i = 0; i < 5; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + i, i);
+    }
+
+    // Samples already buffered move into the ring file.
+    admin_SetBufferPersistence(path, true, 60);
+    assert_true(admin_GetBufferPersistence(path, &syncPeriod));
+    assert_true(60 == syncPeriod);
+    assert_true(2 == query_GetMean(path, NAN));
+
+    // The ring file wraps like a buffer in memory, and can be resized.
+    for (i = 5; i < 25; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + i, i);
+    }
+    assert_true(15 == query_GetMin(path, NAN));
+    admin_SetBufferMaxCount(path, 4);
+    assert_true(21 == query_GetMin(path, NAN));
+    admin_PushNumeric(path, 1000000025.0, 25);
+    assert_true(LE_OK == query_ReadBufferSampleNumeric(path, NAN, &timestamp, &value));
+    assert_true(1000000022.0 == timestamp);
+    assert_true(22 == value);
+
+    // Compression doesn't apply to a persistent buffer.
+    admin_SetBufferCompression(path, true);
+    assert_true(23.5 == query_GetMean(path, NAN));
+
+    // Boolean samples are persisted too.
+    admin_PushBoolean(path, 1000000026.0, true);
+    admin_PushBoolean(path, 1000000027.0, false);
+    assert_true(LE_OK == query_ReadBufferSampleBoolean(path, NAN, &timestamp, &boolValue));
+    assert_true(1000000026.0 == timestamp);
+    assert_true(boolValue);
+
+    // Turning persistence off keeps the buffered samples in memory.
+    admin_SetBufferCompression(path, false);
+    admin_SetBufferPersistence(path, false, 0);
+    assert_false(admin_GetBufferPersistence(path, &syncPeriod));
+    assert_true(0.5 == query_GetMean(path, NAN));
+
+    admin_DeleteObs(path);
+}
+
+/* Copy a file, to put back the backup files an Observation leaves behind, as after a restart */
+static void CopyFile
+(
+    const char* fromPath,
+    const char* toPath
+)
+{
+    char buff[4096];
+    size_t count;
+    FILE* fromFile = fopen(fromPath, "rb");
+    FILE* toFile = fopen(toPath, "wb");
+
+    assert_non_null(fromFile);
+    assert_non_null(toFile);
+    while ((count = fread(buff, 1, sizeof(buff), fromFile)) > 0)
+    {
+        assert_true(count == fwrite(buff, 1, count, toFile));
+    }
+    fclose(fromFile);
+    assert_true(0 == fclose(toFile));
+}
+
+/* Run the event loop for a while, so that backup timers expire and backup jobs complete */
+static void ServiceEventLoop
+(
+    int ms
+)
+{
+    int i;
+
+    for (i = 0; i < ms; i++)
+    {
+        while (LE_OK == le_event_ServiceLoop())
+        {
+        }
+        usleep(1000);
+    }
+}
+
+/* Run the event loop until a backup file reaches a given size, showing the backup was written */
+static void WaitForFileSize
+(
+    const char* path,
+    off_t size
+)
+{
+    struct stat st = {0};
+    int ms;
+
+    for (ms = 0; ms < 5000; ms++)
+    {
+        if ((0 == stat(path, &st)) && (size == st.st_size))
+        {
+            break;
+        }
+        ServiceEventLoop(1);
+    }
+    assert_true(size == st.st_size);
+
+    // Let the Backup Thread hand the job back to the main thread.
+    ServiceEventLoop(50);
+}
+
+static void test_obs_ring_file_adopt
+(
+    void** state
+)
+{
+    (void)state;
+    const char* path = "/obs/ringTest";
+    const char* ringPath = "backup/ringTest.ring";
+    const char* savedPath = "ringTest.saved";
+    struct stat st;
+    query_BufferCursorRef_t cursor;
+    double timestamps[8];
+    double values[8];
+    size_t timestampsSize = 8;
+    size_t valuesSize = 8;
+    uint64_t seq;
+    FILE* file;
+    int i;
+
+    assert_true(LE_OK == admin_CreateObs(path));
+    admin_SetBufferMaxCount(path, 8);
+    admin_SetBufferPersistence(path, true, 0);
+    for (i = 0; i < 6; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + i, i * 1.5);
+    }
+    CopyFile(ringPath, savedPath);
+
+    // The ring file goes with the Observation.
+    admin_DeleteObs(path);
+    assert_true(0 != stat(ringPath, &st));
+
+    // An Observation made persistent again takes over the ring file left by a previous run, and
+    // gets back exactly the samples that were in it.
+    CopyFile(savedPath, ringPath);
+    assert_true(LE_OK == admin_CreateObs(path));
+    admin_SetBufferMaxCount(path, 8);
+    admin_SetBufferPersistence(path, true, 0);
+    cursor = query_OpenBufferCursor(path, NAN);
+    assert_non_null(cursor);
+    assert_true(LE_OK == query_ReadBufferCursorNumeric(cursor,
+                                                       timestamps,
+                                                       &timestampsSize,
+                                                       values,
+                                                       &valuesSize));
+    query_CloseBufferCursor(cursor);
+    assert_true(6 == timestampsSize);
+    for (i = 0; i < 6; i++)
+    {
+        assert_true(1000000000.0 + i == timestamps[i]);
+        assert_true(i * 1.5 == values[i]);
+    }
+    admin_PushNumeric(path, 1000000006.0, 9);
+    assert_true(9 == query_GetMax(path, NAN));
+    assert_true(4.5 == query_GetMean(path, NAN));
+    admin_DeleteObs(path);
+
+    // A record that doesn't hold the sample its position calls for (here, the fourth one, whose
+    // sequence number follows its timestamp and value) ends the buffer there.
+    CopyFile(savedPath, ringPath);
+    file = fopen(ringPath, "r+b");
+    assert_non_null(file);
+    seq = UINT64_MAX;
+    assert_true(0 == fseek(file, 32 + (3 * 32) + 16, SEEK_SET));
+    assert_true(1 == fwrite(&seq, sizeof(seq), 1, file));
+    assert_true(0 == fclose(file));
+    assert_true(LE_OK == admin_CreateObs(path));
+    admin_SetBufferMaxCount(path, 8);
+    admin_SetBufferPersistence(path, true, 0);
+    assert_true(0 == query_GetMin(path, NAN));
+    assert_true(3 == query_GetMax(path, NAN));
+    admin_DeleteObs(path);
+
+    unlink(savedPath);
+}
+
+static void test_obs_lazy_restore
+(
+    void** state
+)
+{
+    (void)state;
+    const char* path = "/obs/lazyTest";
+    const char* copyNames[] = { "lazyQuery", "lazyTimer", "lazyGone" };
+    char copyPath[64];
+    char bakPath[64];
+    char logPath[64];
+    double timestamp;
+    double value;
+    int i;
+    int j;
+
+    // A snapshot of the first five samples, and a journal holding the next three.
+    assert_true(LE_OK == admin_CreateObs(path));
+    admin_SetBufferMaxCount(path, 10);
+    admin_SetBufferBackupPeriod(path, 1);
+    for (i = 0; i < 5; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + i, i);
+    }
+    WaitForFileSize("backup/lazyTest.bak.log", 18);
+    for (i = 5; i < 8; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + i, i);
+    }
+    WaitForFileSize("backup/lazyTest.bak.log", 18 + (3 * 16));
+
+    for (j = 0; j < 3; j++)
+    {
+        snprintf(copyPath, sizeof(copyPath), "/obs/%s", copyNames[j]);
+        snprintf(bakPath, sizeof(bakPath), "backup/%s.bak", copyNames[j]);
+        snprintf(logPath, sizeof(logPath), "backup/%s.bak.log", copyNames[j]);
+        CopyFile("backup/lazyTest.bak", bakPath);
+        CopyFile("backup/lazyTest.bak.log", logPath);
+
+        // Only the newest sample is read when the Observation is created, to be its current value.
+        assert_true(LE_OK == admin_CreateObs(copyPath));
+        assert_true(LE_OK == query_GetNumeric(copyPath, &timestamp, &value));
+        assert_true(1000000007.0 == timestamp);
+        assert_true(7 == value);
+
+        // The rest of the buffer is loaded the first time it's needed (here, by the first query),
+        // or else by a background timer.  After that the backup files aren't read again, but if
+        // they are gone before then, only the newest sample is left.
+        if (j == 1)
+        {
+            ServiceEventLoop(300);
+        }
+        if (j > 0)
+        {
+            unlink(bakPath);
+            unlink(logPath);
+        }
+        assert_true(((j == 2) ? 7 : 3.5) == query_GetMean(copyPath, NAN));
+        unlink(bakPath);
+        unlink(logPath);
+        assert_true(((j == 2) ? 7 : 0) == query_GetMin(copyPath, NAN));
+        admin_DeleteObs(copyPath);
+    }
+
+    admin_DeleteObs(path);
+}
+
+/* Copy an Observation's backup file and journal, to be restored by another Observation */
+static void CopyBackup
+(
+    const char* name,
+    const char* copyName
+)
+{
+    char fromPath[64];
+    char toPath[64];
+
+    snprintf(fromPath, sizeof(fromPath), "backup/%s.bak", name);
+    snprintf(toPath, sizeof(toPath), "backup/%s.bak", copyName);
+    CopyFile(fromPath, toPath);
+    snprintf(fromPath, sizeof(fromPath), "backup/%s.bak.log", name);
+    snprintf(toPath, sizeof(toPath), "backup/%s.bak.log", copyName);
+    CopyFile(fromPath, toPath);
+}
+
+/* Delete an Observation that restored a copied backup, along with the copy */
+static void DeleteCopy
+(
+    const char* copyName
+)
+{
+    char path[64];
+
+    snprintf(path, sizeof(path), "/obs/%s", copyName);
+    admin_DeleteObs(path);
+    snprintf(path, sizeof(path), "backup/%s.bak", copyName);
+    unlink(path);
+    snprintf(path, sizeof(path), "backup/%s.bak.log", copyName);
+    unlink(path);
+}
+
+/* Check that two Observations' buffers hold the same samples, and return how many there are */
+static int CompareBuffers
+(
+    const char* path,
+    const char* copyPath,
+    io_DataType_t dataType
+)
+{
+    char value[IO_MAX_STRING_VALUE_LEN + 1];
+    char copyValue[IO_MAX_STRING_VALUE_LEN + 1];
+    double startAfter = NAN;
+    double timestamp;
+    double copyTimestamp;
+    double number;
+    double copyNumber;
+    le_result_t result;
+    int count = 0;
+
+    for (;;)
+    {
+        if (dataType == IO_DATA_TYPE_NUMERIC)
+        {
+            result = query_ReadBufferSampleNumeric(path, startAfter, &timestamp, &number);
+            assert_true(result == query_ReadBufferSampleNumeric(copyPath,
+                                                                startAfter,
+                                                                &copyTimestamp,
+                                                                &copyNumber));
+            assert_true((result != LE_OK) || (number == copyNumber));
+        }
+        else if (dataType == IO_DATA_TYPE_STRING)
+        {
+            result = query_ReadBufferSampleString(path,
+                                                  startAfter,
+                                                  &timestamp,
+                                                  value,
+                                                  sizeof(value));
+            assert_true(result == query_ReadBufferSampleString(copyPath,
+                                                               startAfter,
+                                                               &copyTimestamp,
+                                                               copyValue,
+                                                               sizeof(copyValue)));
+            assert_true((result != LE_OK) || (0 == strcmp(value, copyValue)));
+        }
+        else
+        {
+            result = query_ReadBufferSampleJson(path,
+                                                startAfter,
+                                                &timestamp,
+                                                value,
+                                                sizeof(value));
+            assert_true(result == query_ReadBufferSampleJson(copyPath,
+                                                             startAfter,
+                                                             &copyTimestamp,
+                                                             copyValue,
+                                                             sizeof(copyValue)));
+            assert_true((result != LE_OK) || (0 == strcmp(value, copyValue)));
+        }
+        if (result != LE_OK)
+        {
+            break;
+        }
+        assert_true(timestamp == copyTimestamp);
+        startAfter = timestamp;
+        count++;
+    }
+    assert_true(LE_NOT_FOUND == result);
+
+    return count;
+}
+
+/* Restore a backup file that has been damaged, and check that none of it is used */
+static void RestoreDamagedBackup
+(
+    long offset,        // Where to overwrite the file, or -1 to leave it as it is.
+    const void* bytes,
+    size_t size,
+    off_t truncateSize  // Size to truncate the file to, or -1 to leave it as it is.
+)
+{
+    const char* path = "backup/tripDamaged.bak";
+    double timestamp;
+    double value;
+    FILE* file;
+
+    CopyFile("backup/tripNumeric.bak", path);
+    if (offset >= 0)
+    {
+        file = fopen(path, "r+b");
+        assert_non_null(file);
+        assert_true(0 == fseek(file, offset, SEEK_SET));
+        assert_true(1 == fwrite(bytes, size, 1, file));
+        assert_true(0 == fclose(file));
+    }
+    if (truncateSize >= 0)
+    {
+        assert_true(0 == truncate(path, truncateSize));
+    }
+
+    assert_true(LE_OK == admin_CreateObs("/obs/tripDamaged"));
+    assert_true(LE_UNAVAILABLE == query_GetNumeric("/obs/tripDamaged", &timestamp, &value));
+    assert_true(isnan(query_GetMean("/obs/tripDamaged", NAN)));
+    DeleteCopy("tripDamaged");
+}
+
+static void test_obs_backup_round_trip
+(
+    void** state
+)
+{
+    (void)state;
+    const char* names[] = { "tripNumeric", "tripString", "tripJson", "tripRollup" };
+    char path[64];
+    char copyPath[64];
+    char value[32];
+    uint8_t byte;
+    uint32_t count;
+    int i;
+    int j;
+
+    for (j = 0; j < 4; j++)
+    {
+        snprintf(path, sizeof(path), "/obs/%s", names[j]);
+        assert_true(LE_OK == admin_CreateObs(path));
+        admin_SetBufferMaxCount(path, (j == 3) ? 2 : 20);
+        admin_SetBufferBackupPeriod(path, 1);
+    }
+    admin_SetRollupTier("/obs/tripRollup", 0, 10, 10);
+    admin_SetRollupTier("/obs/tripRollup", 1, 100, 10);
+
+    for (i = 0; i < 30; i++)
+    {
+        admin_PushNumeric("/obs/tripNumeric", 1000000000.0 + i + 0.000123, -sqrt(i) * 0.1);
+        snprintf(value, sizeof(value), (i % 2) ? "value %d" : "", i);
+        admin_PushString("/obs/tripString", 1000000000.0 + i, value);
+        snprintf(value, sizeof(value), (i % 2) ? "{\"a\":%d}" : "[%d,\"b\"]", i);
+        admin_PushJson("/obs/tripJson", 1000000000.0 + i, value);
+        admin_PushNumeric("/obs/tripRollup", 1000000000.0 + i, i + 1);
+    }
+
+    // Each Observation's first backup is a snapshot, followed by an empty journal.  Restoring a
+    // copy of it gets back exactly the same samples.
+    for (j = 0; j < 4; j++)
+    {
+        snprintf(path, sizeof(path), "backup/%s.bak.log", names[j]);
+        WaitForFileSize(path, 18);
+    }
+    for (j = 0; j < 3; j++)
+    {
+        snprintf(copyPath, sizeof(copyPath), "%sCopy", names[j]);
+        CopyBackup(names[j], copyPath);
+        snprintf(copyPath, sizeof(copyPath), "/obs/%sCopy", names[j]);
+        snprintf(path, sizeof(path), "/obs/%s", names[j]);
+        assert_true(LE_OK == admin_CreateObs(copyPath));
+        assert_true(20 == CompareBuffers(path,
+                                         copyPath,
+                                         (j == 0) ? IO_DATA_TYPE_NUMERIC
+                                                  : ((j == 1) ? IO_DATA_TYPE_STRING
+                                                              : IO_DATA_TYPE_JSON)));
+        snprintf(copyPath, sizeof(copyPath), "%sCopy", names[j]);
+        DeleteCopy(copyPath);
+    }
+
+    // The rollup tiers come back too, and answer queries the buffer can't.
+    CopyBackup("tripRollup", "tripRollupCopy");
+    assert_true(LE_OK == admin_CreateObs("/obs/tripRollupCopy"));
+    assert_true(2 == CompareBuffers("/obs/tripRollup",
+                                    "/obs/tripRollupCopy",
+                                    IO_DATA_TYPE_NUMERIC));
+    assert_true(1 == query_GetMin("/obs/tripRollupCopy", 1000000000.0));
+    assert_true(11 == query_GetMin("/obs/tripRollupCopy", 1000000015.0));
+    assert_true(30 == query_GetMax("/obs/tripRollupCopy", 1000000000.0));
+    assert_true(15.5 == query_GetMean("/obs/tripRollupCopy", 1000000000.0));
+    assert_true(query_GetStdDev("/obs/tripRollup", 1000000000.0)
+                == query_GetStdDev("/obs/tripRollupCopy", 1000000000.0));
+    DeleteCopy("tripRollupCopy");
+
+    // A backup file with a damaged header isn't restored at all: one cut short, one with an
+    // unknown format version, and one that claims more records than it holds.
+    RestoreDamagedBackup(-1, NULL, 0, 12);
+    RestoreDamagedBackup(-1, NULL, 0, 2);
+    byte = 99;
+    RestoreDamagedBackup(0, &byte, 1, -1);
+    count = 21;
+    RestoreDamagedBackup(3, &count, 4, -1);
+
+    for (j = 0; j < 4; j++)
+    {
+        snprintf(path, sizeof(path), "/obs/%s", names[j]);
+        admin_DeleteObs(path);
+    }
+}
+
+/* Check that an Observation's buffer holds exactly the journal test's samples first to last */
+static void CheckJournalSamples
+(
+    const char* path,
+    int first,
+    int last
+)
+{
+    double startAfter = NAN;
+    double timestamp;
+    double value;
+    int i;
+
+    for (i = first; i <= last; i++)
+    {
+        assert_true(LE_OK == query_ReadBufferSampleNumeric(path, startAfter, &timestamp, &value));
+        assert_true(1000000000.0 + (i * 0.5) == timestamp);
+        assert_true((i * 0.7) - 3 == value);
+        startAfter = timestamp;
+    }
+    assert_true(LE_NOT_FOUND == query_ReadBufferSampleNumeric(path,
+                                                              startAfter,
+                                                              &timestamp,
+                                                              &value));
+}
+
+static void test_obs_backup_journal
+(
+    void** state
+)
+{
+    (void)state;
+    const char* path = "/obs/journalTest";
+    const char* logPath = "backup/journalTest.bak.log";
+    double timestamp;
+    double value;
+    int i;
+
+    assert_true(LE_OK == admin_CreateObs(path));
+    admin_SetBufferMaxCount(path, 10);
+    admin_SetBufferBackupPeriod(path, 1);
+
+    // A snapshot of the first four samples, then a journal of the next eight.
+    for (i = 0; i < 4; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + (i * 0.5), (i * 0.7) - 3);
+    }
+    WaitForFileSize(logPath, 18);
+    for (i = 4; i < 12; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + (i * 0.5), (i * 0.7) - 3);
+    }
+    WaitForFileSize(logPath, 18 + (8 * 16));
+
+    // Journalling four more would make the journal longer than the buffer, so the next backup is
+    // a new snapshot of the ten newest samples instead, with a new journal for the three after.
+    for (i = 12; i < 16; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + (i * 0.5), (i * 0.7) - 3);
+    }
+    WaitForFileSize("backup/journalTest.bak", 16 + (10 * 16));
+    WaitForFileSize(logPath, 18);
+    for (i = 16; i < 19; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + (i * 0.5), (i * 0.7) - 3);
+    }
+    WaitForFileSize(logPath, 18 + (3 * 16));
+
+    // Restoring the snapshot and replaying the journal gets back exactly what was pushed.
+    CopyBackup("journalTest", "journalCopy");
+    assert_true(LE_OK == admin_CreateObs("/obs/journalCopy"));
+    CheckJournalSamples("/obs/journalCopy", 9, 18);
+    DeleteCopy("journalCopy");
+
+    // If the last journal record was only partly written, the journal is replayed up to it.
+    CopyBackup("journalTest", "journalCopy");
+    assert_true(0 == truncate("backup/journalCopy.bak.log", 18 + (3 * 16) - 5));
+    assert_true(LE_OK == admin_CreateObs("/obs/journalCopy"));
+    assert_true(LE_OK == query_GetNumeric("/obs/journalCopy", &timestamp, &value));
+    assert_true(1000000000.0 + (17 * 0.5) == timestamp);
+    assert_true((17 * 0.7) - 3 == value);
+    CheckJournalSamples("/obs/journalCopy", 8, 17);
+    DeleteCopy("journalCopy");
+
+    admin_DeleteObs(path);
+}
+
+/* Run the event loop until it handles one event, such as the backup timer expiring, when nothing
+   else is due */
+static void ServiceOneEvent
+(
+    void
+)
+{
+    int ms;
+
+    for (ms = 0; ms < 5000; ms++)
+    {
+        if (LE_OK == le_event_ServiceLoop())
+        {
+            return;
+        }
+        usleep(1000);
+    }
+    assert_true(ms < 5000);
+}
+
+/* Wait without running the event loop until the Backup Thread has written a file to a given size,
+   so that the job is done but the main thread hasn't been told yet */
+static void WaitForBackupThread
+(
+    const char* path,
+    off_t size
+)
+{
+    struct stat st = {0};
+    int ms;
+
+    for (ms = 0; ms < 5000; ms++)
+    {
+        if ((0 == stat(path, &st)) && (size == st.st_size))
+        {
+            // Give the Backup Thread time to pass the job back.
+            usleep(50000);
+            return;
+        }
+        usleep(1000);
+    }
+    assert_true(size == st.st_size);
+}
+
+static void test_obs_backup_disable
+(
+    void** state
+)
+{
+    (void)state;
+    const char* path = "/obs/disableTest";
+    const char* bakPath = "backup/disableTest.bak";
+    const char* logPath = "backup/disableTest.bak.log";
+    struct stat st;
+    int i;
+
+    assert_true(LE_OK == admin_CreateObs(path));
+    admin_SetBufferMaxCount(path, 10);
+    admin_SetBufferBackupPeriod(path, 1);
+    ServiceEventLoop(200);
+
+    // Backups are disabled and enabled again while the first snapshot is still on its way back
+    // from the Backup Thread.  The snapshot's journal is deleted with it, so the next backup is a
+    // new snapshot, which gets a new journal.
+    for (i = 0; i < 4; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + i, i);
+    }
+    ServiceOneEvent();
+    WaitForBackupThread(logPath, 18);
+    admin_SetBufferBackupPeriod(path, 0);
+    admin_SetBufferBackupPeriod(path, 1);
+    for (i = 4; i < 6; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + i, i);
+    }
+    WaitForFileSize(bakPath, 16 + (6 * 16));
+    WaitForFileSize(logPath, 18);
+    for (i = 6; i < 8; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + i, i);
+    }
+    WaitForFileSize(logPath, 18 + (2 * 16));
+    CopyBackup("disableTest", "disableCopy");
+    assert_true(LE_OK == admin_CreateObs("/obs/disableCopy"));
+    assert_true(8 == CompareBuffers(path, "/obs/disableCopy", IO_DATA_TYPE_NUMERIC));
+    DeleteCopy("disableCopy");
+    ServiceEventLoop(200);
+
+    // Backups disabled while a journal append is on its way back stay disabled, and the files are
+    // deleted after the append.
+    admin_PushNumeric(path, 1000000008.0, 8);
+    ServiceOneEvent();
+    WaitForBackupThread(logPath, 18 + (3 * 16));
+    admin_SetBufferBackupPeriod(path, 0);
+    ServiceEventLoop(100);
+    assert_true(0 != stat(bakPath, &st));
+    assert_true(0 != stat(logPath, &st));
+    admin_PushNumeric(path, 1000000009.0, 9);
+    ServiceEventLoop(1500);
+    assert_true(0 != stat(bakPath, &st));
+    assert_true(0 != stat(logPath, &st));
+
+    // Deleting the Observation while a snapshot is on its way back deletes the files after it.
+    admin_SetBufferBackupPeriod(path, 1);
+    admin_PushNumeric(path, 1000000010.0, 10);
+    ServiceOneEvent();
+    WaitForBackupThread(logPath, 18);
+    admin_DeleteObs(path);
+    ServiceEventLoop(100);
+    assert_true(0 != stat(bakPath, &st));
+    assert_true(0 != stat(logPath, &st));
+}
+
+static void test_obs_backup_schedule
+(
+    void** state
+)
+{
+    (void)state;
+    const char* fastLogPath = "backup/scheduleFast.bak.log";
+    const char* slowLogPath = "backup/scheduleSlow.bak.log";
+    struct stat st;
+    int i;
+
+    assert_true(LE_OK == admin_CreateObs("/obs/scheduleFast"));
+    assert_true(LE_OK == admin_CreateObs("/obs/scheduleSlow"));
+    admin_SetBufferMaxCount("/obs/scheduleFast", 10);
+    admin_SetBufferMaxCount("/obs/scheduleSlow", 10);
+    admin_SetBufferBackupPeriod("/obs/scheduleFast", 1);
+    admin_SetBufferBackupPeriod("/obs/scheduleSlow", 3);
+
+    // Both first backups are due straight away.
+    admin_PushNumeric("/obs/scheduleFast", 1000000000.0, 0);
+    admin_PushNumeric("/obs/scheduleSlow", 1000000000.0, 0);
+    WaitForFileSize(fastLogPath, 18);
+    WaitForFileSize(slowLogPath, 18);
+
+    // After that, each Observation is backed up once its own period has passed, so the one with
+    // the shorter period is backed up twice before the other is backed up at all.  The other's
+    // backup then holds both its new samples.
+    for (i = 1; i < 3; i++)
+    {
+        admin_PushNumeric("/obs/scheduleFast", 1000000000.0 + i, i);
+        admin_PushNumeric("/obs/scheduleSlow", 1000000000.0 + i, i);
+        WaitForFileSize(fastLogPath, 18 + (i * 16));
+        assert_true(0 == stat(slowLogPath, &st));
+        assert_true(18 == st.st_size);
+    }
+    WaitForFileSize(slowLogPath, 18 + (2 * 16));
+    assert_true(0 == stat(fastLogPath, &st));
+    assert_true(18 + (2 * 16) == st.st_size);
+
+    admin_DeleteObs("/obs/scheduleFast");
+    admin_DeleteObs("/obs/scheduleSlow");
+}
+
+static void test_obs_buffer_cursor
+(
+    void** state
+)
+{
+    (void)state;
+    const char* path = "/obs/cursorTest";
+    double timestamps[40];
+    double values[40];
+    bool boolValues[40];
+    char json[IO_MAX_STRING_VALUE_LEN + 1];
+    size_t timestampsSize;
+    size_t valuesSize;
+    int i;
+
+    assert_true(LE_OK == admin_CreateObs(path));
+    admin_SetBufferMaxCount(path, 100);
+    for (i = 0; i < 100; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + i, i);
+    }
+
+    // Pages carry on from where the last one left off.
+    query_BufferCursorRef_t cursor = query_OpenBufferCursor(path, 1000000009.0);
+    assert_non_null(cursor);
+    for (i = 10; i < 100; i += 40)
+    {
+        timestampsSize = 40;
+        valuesSize = 40;
+        assert_true(LE_OK == query_ReadBufferCursorNumeric(cursor,
+                                                           timestamps,
+                                                           &timestampsSize,
+                                                           values,
+                                                           &valuesSize));
+        assert_true(timestampsSize == ((i < 90) ? 40 : 10));
+        assert_true(valuesSize == timestampsSize);
+        assert_true(1000000000.0 + i == timestamps[0]);
+        assert_true(i == values[0]);
+        assert_true(i + timestampsSize - 1 == values[timestampsSize - 1]);
+    }
+    timestampsSize = 40;
+    valuesSize = 40;
+    assert_true(LE_NOT_FOUND == query_ReadBufferCursorNumeric(cursor,
+                                                              timestamps,
+                                                              &timestampsSize,
+                                                              values,
+                                                              &valuesSize));
+    assert_true(0 == timestampsSize);
+
+    // New samples are read when the cursor gets to them, and if the samples it hasn't read yet
+    // are discarded, it carries on from the oldest one left.
+    admin_PushNumeric(path, 1000000100.0, 100);
+    assert_true(LE_OK == query_ReadBufferCursorJson(cursor, json, sizeof(json)));
+    assert_string_equal(json, "[{\"t\":1000000100.000000,\"v\":100.000000}]");
+    for (i = 101; i < 250; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + i, i);
+    }
+    timestampsSize = 40;
+    valuesSize = 40;
+    assert_true(LE_OK == query_ReadBufferCursorNumeric(cursor,
+                                                       timestamps,
+                                                       &timestampsSize,
+                                                       values,
+                                                       &valuesSize));
+    assert_true(150 == values[0]);
+
+    // The cursor can only read the type of sample in the buffer.
+    admin_PushBoolean(path, 1000000250.0, true);
+    timestampsSize = 40;
+    valuesSize = 40;
+    assert_true(LE_FORMAT_ERROR == query_ReadBufferCursorNumeric(cursor,
+                                                                 timestamps,
+                                                                 &timestampsSize,
+                                                                 values,
+                                                                 &valuesSize));
+    timestampsSize = 40;
+    valuesSize = 40;
+    assert_true(LE_OK == query_ReadBufferCursorBoolean(cursor,
+                                                       timestamps,
+                                                       &timestampsSize,
+                                                       boolValues,
+                                                       &valuesSize));
+    assert_true(1 == timestampsSize);
+    assert_true(boolValues[0]);
+    assert_true(LE_NOT_FOUND == query_ReadBufferCursorJson(cursor, json, sizeof(json)));
+    assert_string_equal(json, "[]");
+    query_CloseBufferCursor(cursor);
+
+    assert_null(query_OpenBufferCursor("/obs/noSuchObs", NAN));
+
+    admin_DeleteObs(path);
+}
+
+/* Completion callback for buffer reads, which records the result */
+static void ReadCompletion
+(
+    le_result_t result,
+    void* contextPtr
+)
+{
+    *(le_result_t*)contextPtr = result;
+}
+
+/* Read from a non-blocking pipe until a given number of bytes have been read or the writer has
+   closed it, running the event loop whenever the pipe is empty so that a buffer read carries on */
+static size_t ReadPipe
+(
+    int fd,
+    char* buffPtr,
+    size_t count
+)
+{
+    size_t len = 0;
+    ssize_t result;
+    int ms = 0;
+
+    while (len < count)
+    {
+        result = read(fd, buffPtr + len, count - len);
+        if (result == 0)
+        {
+            break;
+        }
+        if (result > 0)
+        {
+            len += result;
+        }
+        else
+        {
+            assert_true((errno == EAGAIN) && (ms < 5000));
+            ServiceEventLoop(1);
+            ms++;
+        }
+    }
+
+    return len;
+}
+
+static void test_obs_read_buffer_json
+(
+    void** state
+)
+{
+    (void)state;
+    const char* path = "/obs/readJsonTest";
+    const size_t outputSize = 1024 * 1024;
+    char* outputPtr = malloc(outputSize);
+    char* posPtr;
+    le_result_t result = LE_FAULT;
+    size_t len;
+    double timestamp;
+    double value;
+    int expected;
+    int skipped = 0;
+    int fds[2];
+    int i;
+
+    assert_non_null(outputPtr);
+    assert_true(LE_OK == admin_CreateObs(path));
+    admin_SetBufferMaxCount(path, 5000);
+    for (i = 0; i < 5000; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + i, i);
+    }
+
+    // The output is several times bigger than the pipe, so the read waits for the reader to drain
+    // it, a batch of samples at a time.
+    assert_true(0 == pipe(fds));
+    assert_true(0 == fcntl(fds[0], F_SETFL, O_NONBLOCK));
+    assert_true(LE_OK == query_ReadBufferJson(path, NAN, fds[1], ReadCompletion, &result));
+    len = ReadPipe(fds[0], outputPtr, 16 * 1024);
+    assert_true(16 * 1024 == len);
+    assert_true(LE_FAULT == result);
+
+    // Meanwhile, every sample left to read is pushed out of the buffer.  The read carries on from
+    // the oldest sample still buffered.
+    for (i = 5000; i < 10000; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + i, i);
+    }
+    len += ReadPipe(fds[0], outputPtr + len, outputSize - len - 1);
+    close(fds[0]);
+    outputPtr[len] = '\0';
+    assert_true(LE_OK == result);
+    assert_true(len > 64 * 1024);
+    assert_true(json_IsValid(outputPtr));
+
+    // The samples are in order, and only the ones that were pushed out before they could be
+    // written are missing.
+    expected = 0;
+    posPtr = outputPtr + 1;
+    while (*posPtr != ']')
+    {
+        assert_true(2 == sscanf(posPtr, "{\"t\":%lf,\"v\":%lf}", &timestamp, &value));
+        if (value != expected)
+        {
+            assert_true((skipped == 0) && (value > expected) && (value <= 5000));
+            skipped = value - expected;
+            expected = value;
+        }
+        assert_true(1000000000.0 + expected == timestamp);
+        expected++;
+        posPtr = strchr(posPtr, '}') + 1;
+        if (*posPtr == ',')
+        {
+            posPtr++;
+        }
+    }
+    assert_true(10000 == expected);
+    assert_true(skipped > 0);
+
+    admin_DeleteObs(path);
+    free(outputPtr);
+}
+
+static void test_obs_read_buffer_binary
+(
+    void** state
+)
+{
+    (void)state;
+    const char* numericPath = "/obs/readBinaryNumeric";
+    const char* stringPath = "/obs/readBinaryString";
+    char output[8192];
+    char value[64];
+    const char* posPtr;
+    le_result_t result;
+    size_t len;
+    uint32_t magic;
+    uint32_t stringLen;
+    double timestamp;
+    double number;
+    int fds[2];
+    int i;
+
+    assert_true(LE_OK == admin_CreateObs(numericPath));
+    assert_true(LE_OK == admin_CreateObs(stringPath));
+    admin_SetBufferMaxCount(numericPath, 100);
+    admin_SetBufferMaxCount(stringPath, 100);
+    for (i = 0; i < 100; i++)
+    {
+        admin_PushNumeric(numericPath, 1000000000.0 + i + 0.000123, -sqrt(i));
+    }
+    for (i = 0; i < 40; i++)
+    {
+        memset(value, 'a' + (i % 26), i);
+        value[i] = '\0';
+        admin_PushString(stringPath, 1000000000.0 + i, value);
+    }
+
+    // Numeric samples are 8-byte timestamps and values, after the header, with full precision.
+    assert_true(0 == pipe(fds));
+    assert_true(0 == fcntl(fds[0], F_SETFL, O_NONBLOCK));
+    result = LE_FAULT;
+    assert_true(LE_OK == query_ReadBufferBinary(numericPath, NAN, fds[1], ReadCompletion, &result));
+    len = ReadPipe(fds[0], output, sizeof(output));
+    close(fds[0]);
+    assert_true(LE_OK == result);
+    assert_true(8 + (100 * 16) == len);
+    memcpy(&magic, output, sizeof(magic));
+    assert_true(0x52424844 == magic);
+    assert_true(0 == output[4]);
+    assert_true(IO_DATA_TYPE_NUMERIC == output[5]);
+    assert_true((0 == output[6]) && (0 == output[7]));
+    posPtr = output + 8;
+    for (i = 0; i < 100; i++)
+    {
+        memcpy(&timestamp, posPtr, sizeof(timestamp));
+        memcpy(&number, posPtr + 8, sizeof(number));
+        assert_true(1000000000.0 + i + 0.000123 == timestamp);
+        assert_true(-sqrt(i) == number);
+        posPtr += 16;
+    }
+
+    // String samples are followed by their lengths and contents.
+    assert_true(0 == pipe(fds));
+    assert_true(0 == fcntl(fds[0], F_SETFL, O_NONBLOCK));
+    result = LE_FAULT;
+    assert_true(LE_OK == query_ReadBufferBinary(stringPath, NAN, fds[1], ReadCompletion, &result));
+    len = ReadPipe(fds[0], output, sizeof(output));
+    close(fds[0]);
+    assert_true(LE_OK == result);
+    memcpy(&magic, output, sizeof(magic));
+    assert_true(0x52424844 == magic);
+    assert_true(IO_DATA_TYPE_STRING == output[5]);
+    posPtr = output + 8;
+    for (i = 0; i < 40; i++)
+    {
+        memcpy(&timestamp, posPtr, sizeof(timestamp));
+        memcpy(&stringLen, posPtr + 8, sizeof(stringLen));
+        assert_true(1000000000.0 + i == timestamp);
+        assert_true(i == stringLen);
+        memset(value, 'a' + (i % 26), i);
+        assert_true(0 == memcmp(posPtr + 12, value, stringLen));
+        posPtr += 12 + stringLen;
+    }
+    assert_true(output + len == posPtr);
+
+    admin_DeleteObs(numericPath);
+    admin_DeleteObs(stringPath);
+}
+
+static void test_obs_stats
+(
+    void** state
+)
+{
+    (void)state;
+    const char* path = "/obs/statsTest";
+    uint32_t count;
+    double min;
+    double max;
+    double mean;
+    double stdDev;
+    double first;
+    double last;
+    int i;
+
+    assert_true(LE_OK == admin_CreateObs(path));
+    admin_SetBufferMaxCount(path, 10);
+    for (i = 1; i <= 20; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + i, 1000000 + i);
+    }
+
+    // Everything comes from the buffer's newest 10 samples, and matches the separate queries.
+    assert_true(LE_OK == query_GetStats(path, NAN, &count, &min, &max, &mean, &stdDev,
+                                        &first, &last));
+    assert_true(10 == count);
+    assert_true(1000011 == min);
+    assert_true(1000020 == max);
+    assert_true(1000015.5 == mean);
+    assert_true(fabs(stdDev - sqrt(8.25)) < 1e-9);
+    assert_true(fabs(stdDev - query_GetStdDev(path, NAN)) < 1e-9);
+    assert_true(1000000011.0 == first);
+    assert_true(1000000020.0 == last);
+
+    assert_true(LE_OK == query_GetStats(path, 1000000016.0, &count, &min, &max, &mean, &stdDev,
+                                        &first, &last));
+    assert_true(5 == count);
+    assert_true(1000016 == min);
+    assert_true(1000018 == mean);
+    assert_true(fabs(stdDev - sqrt(2)) < 1e-9);
+    assert_true(1000000016.0 == first);
+
+    // A whole-buffer transform's running stats give the same answer.
+    admin_SetTransform(path, ADMIN_OBS_TRANSFORM_TYPE_MEAN, NULL, 0);
+    admin_SetBufferMaxCount(path, 10);
+    for (i = 1; i <= 20; i++)
+    {
+        admin_PushNumeric(path, 1000000020.0 + i, 1000000 + i);
+    }
+    assert_true(LE_OK == query_GetStats(path, NAN, &count, &min, &max, &mean, &stdDev,
+                                        &first, &last));
+    assert_true(10 == count);
+    assert_true(1000011 == min);
+    assert_true(1000020 == max);
+    assert_true(fabs(mean - 1000015.5) < 1e-6);
+    assert_true(fabs(stdDev - sqrt(8.25)) < 1e-6);
+    assert_true(1000000031.0 == first);
+    assert_true(1000000040.0 == last);
+
+    // Times before the buffer's oldest sample are answered from the rollup tiers.
+    admin_SetRollupTier(path, 0, 10, 10);
+    for (i = 1; i <= 20; i++)
+    {
+        admin_PushNumeric(path, 1000000040.0 + i, i);
+    }
+    assert_true(LE_OK == query_GetStats(path, 1000000041.0, &count, &min, &max, &mean, &stdDev,
+                                        &first, &last));
+    assert_true(20 == count);
+    assert_true(1 == min);
+    assert_true(20 == max);
+    assert_true(10.5 == mean);
+    assert_true(1000000041.0 == first);
+    assert_true(1000000070.0 == last);
+
+    // Non-numerical data has no stats, and neither does a missing Observation.
+    admin_PushString(path, 1000000061.0, "text");
+    assert_true(LE_FORMAT_ERROR == query_GetStats(path, NAN, &count, &min, &max, &mean, &stdDev,
+                                                  &first, &last));
+    assert_true(LE_NOT_FOUND == query_GetStats("/obs/noSuchObs", NAN, &count, &min, &max, &mean,
+                                               &stdDev, &first, &last));
+    assert_true(0 == count);
+    assert_true(isnan(mean));
+
+    admin_DeleteObs(path);
+}
+
+static void test_obs_percentile
+(
+    void** state
+)
+{
+    (void)state;
+    const char* path = "/obs/percentileTest";
+    int i;
+
+    assert_true(LE_OK == admin_CreateObs(path));
+    admin_SetBufferMaxCount(path, 1000);
+    assert_true(isnan(query_GetPercentile(path, NAN, 50)));
+
+    // Sizes beyond the maximum are ignored.
+    admin_SetQuantileSketch(path, ADMIN_MAX_SKETCH_SIZE + 1);
+    assert_true(0 == admin_GetQuantileSketch(path));
+    admin_SetQuantileSketch(path, 20);
+    assert_true(20 == admin_GetQuantileSketch(path));
+    assert_true(isnan(query_GetPercentile(path, NAN, 50)));
+
+    // Push 1 to 1000 out of order.  The extremes are exact, and the rest are close.
+    for (i = 0; i < 1000; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + i, ((i * 7919) % 1000) + 1);
+    }
+    assert_true(1 == query_GetPercentile(path, NAN, 0));
+    assert_true(1000 == query_GetPercentile(path, NAN, 100));
+    assert_true(fabs(query_GetPercentile(path, NAN, 50) - 500.5) < 10);
+    assert_true(fabs(query_GetPercentile(path, NAN, 95) - 950.5) < 5);
+    assert_true(fabs(query_GetPercentile(path, NAN, 99) - 990.5) < 2);
+
+    // Values leave the sketch as they leave the buffer, a segment at a time.
+    for (i = 1000; i < 2200; i++)
+    {
+        admin_PushNumeric(path, 1000000000.0 + i, i + 1);
+    }
+    assert_true(query_GetPercentile(path, NAN, 0) > 1000);
+    assert_true(2200 == query_GetPercentile(path, NAN, 100));
+
+    // Earlier segments can be left out by the start time.
+    assert_true(query_GetPercentile(path, 1000002100.0, 0) > 2000);
+
+    admin_SetQuantileSketch(path, 0);
+    assert_true(0 == admin_GetQuantileSketch(path));
+    assert_true(isnan(query_GetPercentile(path, NAN, 50)));
+
+    admin_DeleteObs(path);
+}
+
+static void test_obs_histogram
+(
+    void** state
+)
+{
+    (void)state;
+    const char* path = "/obs/histogramTest";
+    double bounds[IO_MAX_HISTOGRAM_BUCKETS];
+    size_t boundCount = IO_MAX_HISTOGRAM_BUCKETS;
+    uint64_t counts[IO_MAX_HISTOGRAM_BUCKETS];
+    size_t countCount = IO_MAX_HISTOGRAM_BUCKETS;
+    double period;
+
+    assert_true(LE_OK == admin_CreateObs(path));
+    admin_GetHistogram(path, bounds, &boundCount);
+    assert_true(0 == boundCount);
+    assert_true(LE_NOT_FOUND == query_GetHistogram(path, counts, &countCount));
+
+    // Boundaries that aren't strictly increasing are ignored.
+    const double badBounds[] = { 10, 10, 20 };
+    admin_SetHistogram(path, badBounds, 3);
+    countCount = IO_MAX_HISTOGRAM_BUCKETS;
+    assert_true(LE_NOT_FOUND == query_GetHistogram(path, counts, &countCount));
+
+    const double goodBounds[] = { 10, 20 };
+    admin_SetHistogram(path, goodBounds, 2);
+    boundCount = IO_MAX_HISTOGRAM_BUCKETS;
+    admin_GetHistogram(path, bounds, &boundCount);
+    assert_true(2 == boundCount);
+    assert_true((10 == bounds[0]) && (20 == bounds[1]));
+
+    // Values are counted without a buffer.  Each boundary belongs to the bucket above it.
+    admin_PushNumeric(path, 1000000000.0, 5);
+    admin_PushNumeric(path, 1000000001.0, 10);
+    admin_PushNumeric(path, 1000000002.0, 15);
+    admin_PushNumeric(path, 1000000003.0, 25);
+    admin_PushBoolean(path, 1000000004.0, true);
+    countCount = IO_MAX_HISTOGRAM_BUCKETS;
+    assert_true(LE_OK == query_GetHistogram(path, counts, &countCount));
+    assert_true(3 == countCount);
+    assert_true((2 == counts[0]) && (2 == counts[1]) && (1 == counts[2]));
+
+    // Histogram aggregation is accepted, and the counts keep going meanwhile.
+    admin_SetAggregation(path, ADMIN_OBS_AGGREGATION_TYPE_HISTOGRAM, 3600);
+    assert_true(ADMIN_OBS_AGGREGATION_TYPE_HISTOGRAM == admin_GetAggregation(path, &period));
+    admin_PushNumeric(path, 1000000005.0, 30);
+    countCount = IO_MAX_HISTOGRAM_BUCKETS;
+    assert_true(LE_OK == query_GetHistogram(path, counts, &countCount));
+    assert_true(2 == counts[2]);
+    admin_SetAggregation(path, ADMIN_OBS_AGGREGATION_TYPE_NONE, 0);
+
+    // Setting the boundaries again starts the counts again, and no boundaries stops counting.
+    admin_SetHistogram(path, goodBounds, 2);
+    countCount = IO_MAX_HISTOGRAM_BUCKETS;
+    assert_true(LE_OK == query_GetHistogram(path, counts, &countCount));
+    assert_true((0 == counts[0]) && (0 == counts[1]) && (0 == counts[2]));
+    admin_SetHistogram(path, NULL, 0);
+    countCount = IO_MAX_HISTOGRAM_BUCKETS;
+    assert_true(LE_NOT_FOUND == query_GetHistogram(path, counts, &countCount));
+
+    admin_DeleteObs(path);
+}
+
 int main(int argc, char **argv)
 {
     (void)argc;
@@ -259,7 +2139,33 @@ int main(int argc, char **argv)
         cmocka_unit_test(test_admin_create_output_bad_path),
         cmocka_unit_test(test_admin_create_output_duplicate),
         cmocka_unit_test(test_admin_mark_optional),
-        cmocka_unit_test(test_admin_set_json_example)
+        cmocka_unit_test(test_admin_set_json_example),
+        cmocka_unit_test(test_admin_many_children),
+        cmocka_unit_test(test_admin_lookup_after_delete),
+        cmocka_unit_test(test_admin_units_routing),
+        cmocka_unit_test(test_admin_entry_paths),
+        cmocka_unit_test(test_io_resource_handle),
+        cmocka_unit_test(test_obs_buffer_wrap),
+        cmocka_unit_test(test_obs_buffer_types),
+        cmocka_unit_test(test_obs_buffer_time_lookup),
+        cmocka_unit_test(test_obs_transform_matches_query),
+        cmocka_unit_test(test_obs_windowed_transforms),
+        cmocka_unit_test(test_obs_aggregation),
+        cmocka_unit_test(test_obs_rollup_tiers),
+        cmocka_unit_test(test_obs_buffer_compression),
+        cmocka_unit_test(test_obs_buffer_persistence),
+        cmocka_unit_test(test_obs_ring_file_adopt),
+        cmocka_unit_test(test_obs_lazy_restore),
+        cmocka_unit_test(test_obs_backup_round_trip),
+        cmocka_unit_test(test_obs_backup_journal),
+        cmocka_unit_test(test_obs_backup_disable),
+        cmocka_unit_test(test_obs_backup_schedule),
+        cmocka_unit_test(test_obs_buffer_cursor),
+        cmocka_unit_test(test_obs_read_buffer_json),
+        cmocka_unit_test(test_obs_read_buffer_binary),
+        cmocka_unit_test(test_obs_stats),
+        cmocka_unit_test(test_obs_percentile),
+        cmocka_unit_test(test_obs_histogram)
     };
     return cmocka_run_group_tests(tests, setup, teardown);
 }
@@ -27,6 +27,21 @@
 //--------------------------------------------------------------------------------------------------
 #define QUERY_BEGINNING_OF_TIME 0
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of samples that can be read through a buffer cursor in one call.
+ */
+//--------------------------------------------------------------------------------------------------
+#define QUERY_MAX_CURSOR_SAMPLES 1000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a cursor open on an Observation's buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct query_BufferCursor* query_BufferCursorRef_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Reference type used by Add/Remove functions for EVENT 'query_TriggerPush'
@@ -95,7 +110,8 @@ typedef uint32_t query_SnapshotFlag_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Completion callbacks for query_ReadBufferJson() must look like this.
+ * Completion callbacks for query_ReadBufferJson() and query_ReadBufferBinary() must look like
+ * this.
  */
 //--------------------------------------------------------------------------------------------------
 typedef void (*query_ReadCompletionFunc_t)
@@ -259,6 +275,47 @@ LE_SHARED le_result_t ifgen_query_ReadBufferJson
         ///< [IN]
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read data out of a buffer in a packed binary format, which is much cheaper to produce and to
+ * parse than JSON.  Data is written to a given file descriptor as an 8-byte header followed by a
+ * record for each sample, all in the native byte order of the Data Hub's host, without padding:
+ *  - header: uint32 magic number 0x52424844 ("DHBR" in little-endian byte order), uint8 format
+ *    version (0), uint8 data type of the samples (io_DataType_t), then two zero bytes.
+ *  - trigger record: double timestamp.
+ *  - Boolean record: double timestamp, then uint8 value (0 or 1).
+ *  - numeric record: double timestamp, then double value.
+ *  - string or JSON record: double timestamp, uint32 length, then that many bytes of the value
+ *    (without a null terminator).
+ *
+ * Timestamps are in seconds since the Epoch, with full precision.  If the data type of the
+ * Observation's samples changes during the read, the read ends early, as the buffered samples of
+ * the type given in the header are discarded.
+ *
+ * @return
+ *  - LE_OK if the read operation started successfully.
+ *  - LE_NOT_FOUND if the Observation doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t ifgen_query_ReadBufferBinary
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        const char* LE_NONNULL obsPath,
+        ///< [IN] Observation path. Can be absolute
+        ///< (beginning with a '/') or relative to /obs/.
+        double startAfter,
+        ///< [IN] Start after this many seconds ago,
+        ///< or after an absolute number of seconds since the Epoch
+        ///< (if startafter > 30 years).
+        ///< Use NAN (not a number) to read the whole buffer.
+        int outputFile,
+        ///< [IN] File descriptor to write the data to.
+        query_ReadCompletionFunc_t completionFuncPtr,
+        ///< [IN] Completion callback to be called when operation finishes.
+        void* contextPtr
+        ///< [IN]
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Read the timestamp of a single sample from a buffer.
@@ -408,6 +465,126 @@ LE_SHARED le_result_t ifgen_query_ReadBufferSampleJson
         ///< [IN]
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a cursor on an Observation's buffer, to read the samples newer than a given time a batch at
+ * a time.  Each read through the cursor carries on from the sample after the last one read, so
+ * reading the whole buffer this way takes time in proportion to the number of samples, unlike
+ * repeated calls to the query_ReadBufferSample functions.
+ *
+ * If the samples the cursor hasn't read yet are discarded from the buffer to make room for new
+ * ones, the cursor carries on from the oldest sample left.  Samples added to the buffer after the
+ * cursor was opened are read too, when the cursor gets to them.
+ *
+ * @return Reference to the cursor, or NULL if the Observation doesn't exist.
+ *         Must be closed using query_CloseBufferCursor() when no longer needed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED query_BufferCursorRef_t ifgen_query_OpenBufferCursor
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        const char* LE_NONNULL obsPath,
+        ///< [IN] Observation path. Can be absolute
+        ///< (beginning with a '/') or relative to /obs/.
+        double startAfter
+        ///< [IN] Start after this many seconds ago,
+        ///< or after an absolute number of seconds since the Epoch
+        ///< (if startafter > 30 years).
+        ///< Use NAN (not a number) to read the whole buffer.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a cursor opened using query_OpenBufferCursor().
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void ifgen_query_CloseBufferCursor
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        query_BufferCursorRef_t cursor
+        ///< [IN]
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of Boolean samples through a buffer cursor.
+ *
+ * @warning This can only be used with Boolean type samples.
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).
+ *  - LE_FORMAT_ERROR if the buffered samples aren't Boolean.
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t ifgen_query_ReadBufferCursorBoolean
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        query_BufferCursorRef_t cursor,
+        ///< [IN]
+        double* timestampPtr,
+        ///< [OUT] Timestamps of the samples read.
+        size_t* timestampSizePtr,
+        ///< [INOUT]
+        bool* valuePtr,
+        ///< [OUT] Values of the samples read.
+        size_t* valueSizePtr
+        ///< [INOUT]
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of numeric samples through a buffer cursor.
+ *
+ * @warning This can only be used with numeric type samples.
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).
+ *  - LE_FORMAT_ERROR if the buffered samples aren't numeric.
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t ifgen_query_ReadBufferCursorNumeric
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        query_BufferCursorRef_t cursor,
+        ///< [IN]
+        double* timestampPtr,
+        ///< [OUT] Timestamps of the samples read.
+        size_t* timestampSizePtr,
+        ///< [INOUT]
+        double* valuePtr,
+        ///< [OUT] Values of the samples read.
+        size_t* valueSizePtr
+        ///< [INOUT]
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next batch of samples through a buffer cursor, as a JSON array of as many samples as
+ * fit in the buffer provided, in the same format as query_ReadBufferJson().
+ *
+ * @note This can be used with any type of sample.
+ *
+ * @return
+ *  - LE_OK if at least one sample was read.
+ *  - LE_NOT_FOUND if there are no more samples to read (yet).
+ *  - LE_CLOSED if the Observation has been deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t ifgen_query_ReadBufferCursorJson
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        query_BufferCursorRef_t cursor,
+        ///< [IN]
+        char* json,
+        ///< [OUT] JSON array of the samples read.
+        size_t jsonSize
+        ///< [IN]
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the minimum value found in an Observation's data set within a given time span.
@@ -485,6 +662,87 @@ LE_SHARED double ifgen_query_GetStdDev
         ///< [IN] If < 30 years then seconds before now; else seconds since the Epoch.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number, minimum, maximum, mean and standard deviation of all values found within a given
+ * time span in an Observation's buffer, along with the timestamps of the oldest and newest values.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_NOT_FOUND if there's no numerical data in the time span (or no such Observation).
+ *  - LE_FORMAT_ERROR if the Observation's buffer contains data of a non-numerical type.
+ *
+ * @note On failure, the count is 0 and the other outputs are NAN (not-a-number).
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t ifgen_query_GetStats
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        const char* LE_NONNULL obsPath,
+        ///< [IN] Observation path. Can be absolute
+        ///< (beginning with a '/') or relative to /obs/.
+        double startTime,
+        ///< [IN] If < 30 years then seconds before now; else seconds since the Epoch.
+        uint32_t* countPtr,
+        ///< [OUT] Number of values.
+        double* minPtr,
+        ///< [OUT] Smallest value.
+        double* maxPtr,
+        ///< [OUT] Largest value.
+        double* meanPtr,
+        ///< [OUT] Mean of the values.
+        double* stdDevPtr,
+        ///< [OUT] Standard deviation of the values.
+        double* firstTimestampPtr,
+        ///< [OUT] Timestamp of the oldest value (seconds since the Epoch).
+        double* lastTimestampPtr
+        ///< [OUT] Timestamp of the newest value (seconds since the Epoch).
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Estimate a percentile of the values found within a given time span in an Observation's buffer,
+ * such as the median (50) or the 95th percentile.  The estimate comes from the Observation's
+ * quantile sketch (see admin_SetQuantileSketch()), so the buffer isn't scanned.
+ *
+ * @return The value, or NAN (not-a-number) if the Observation doesn't keep a quantile sketch or
+ *         there's no numerical data in its buffer within the time span.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED double ifgen_query_GetPercentile
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        const char* LE_NONNULL obsPath,
+        ///< [IN] Observation path. Can be absolute
+        ///< (beginning with a '/') or relative to /obs/.
+        double startTime,
+        ///< [IN] If < 30 years then seconds before now; else seconds since the Epoch.
+        double percentile
+        ///< [IN] Percentile (0 to 100).
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fetch the counts in each bucket of an Observation's histogram (see admin_SetHistogram()),
+ * lowest bucket first.  There is one more bucket than there are bucket boundaries.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_NOT_FOUND if the Observation doesn't exist or doesn't keep a histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t ifgen_query_GetHistogram
+(
+    le_msg_SessionRef_t _ifgen_sessionRef,
+        const char* LE_NONNULL obsPath,
+        ///< [IN] Observation path. Can be absolute
+        ///< (beginning with a '/') or relative to /obs/.
+        uint64_t* countsPtr,
+        ///< [OUT] Number of values counted in each bucket.
+        size_t* countsSizePtr
+        ///< [INOUT]
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the current data type of a resource.